@@ -0,0 +1,139 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#ifndef APRCL_H
+#define APRCL_H
+
+#include <stdio.h>
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/*
+   The APR-CL (Jacobi sum) primality test of Adleman, Pomerance, Rumely,
+   Cohen and Lenstra, as given in Algorithm 9.1.28 of Cohen's "A Course in
+   Computational Algebraic Number Theory".
+*/
+
+#define APRCL_MAX_T 73513440UL /* largest t used, allowing n < 2^6400 */
+#define APRCL_MAX_Q 1024       /* more than the number of divisors of t */
+#define APRCL_EXTRA_Q 50       /* extra primes q tried per prime p of t */
+
+typedef struct
+{
+    ulong p;
+    ulong q;
+    ulong h;   /* the Jacobi sum test for (p, q) gave zeta_{p^k}^h */
+}
+aprcl_pair_struct;
+
+typedef struct
+{
+    fmpz_t n;
+    ulong t;   /* zero when n is a single limb, proved by n_is_prime */
+    slong num;
+    slong alloc;
+    aprcl_pair_struct * pairs;
+}
+aprcl_cert_struct;
+
+typedef aprcl_cert_struct aprcl_cert_t[1];
+
+/* Arithmetic in Z[zeta_{p^k}]/nZ *******************************************/
+
+/*
+   Elements are vectors of the p^k - p^(k-1) coefficients of their 
+   representatives modulo the cyclotomic polynomial, reduced modulo n
+*/
+
+void _aprcl_unity_reduce(fmpz * r, fmpz * t, slong len, 
+                                     ulong p, ulong pk, const fmpz_t n);
+
+void _aprcl_unity_mul(fmpz * r, const fmpz * a, const fmpz * b, fmpz * t, 
+                                     ulong p, ulong pk, const fmpz_t n);
+
+void _aprcl_unity_sqr(fmpz * r, const fmpz * a, fmpz * t, 
+                                     ulong p, ulong pk, const fmpz_t n);
+
+void _aprcl_unity_pow_fmpz(fmpz * r, const fmpz * a, const fmpz_t e, 
+                                     ulong p, ulong pk, const fmpz_t n);
+
+void _aprcl_unity_sigma(fmpz * r, const fmpz * a, ulong x, 
+                                     ulong p, ulong pk, const fmpz_t n);
+
+slong _aprcl_unity_root_index(const fmpz * a, 
+                                     ulong p, ulong pk, const fmpz_t n);
+
+/* Jacobi sums ***************************************************************/
+
+unsigned int * _aprcl_dlog_table(ulong q);
+
+void _aprcl_jacobi_sum(fmpz * J, const unsigned int * ind, ulong q, 
+               ulong a, ulong b, ulong d, ulong p, ulong pk, const fmpz_t n);
+
+int _aprcl_pair_test(ulong * h, int * lp, const fmpz_t n, 
+                                   ulong p, ulong q, const unsigned int * ind);
+
+int _aprcl_pairs_test(aprcl_pair_struct * pairs, int * lp, slong num, 
+                                                            const fmpz_t n);
+
+/* Parameters and final division *********************************************/
+
+slong _aprcl_e_t(ulong * q, fmpz_t s, ulong t);
+
+ulong aprcl_select_t(fmpz_t s, const fmpz_t n);
+
+int _aprcl_final_division(const fmpz_t n, const fmpz_t s, ulong t);
+
+/* Certificates **************************************************************/
+
+void aprcl_cert_init(aprcl_cert_t cert);
+
+void aprcl_cert_clear(aprcl_cert_t cert);
+
+void aprcl_cert_add_pair(aprcl_cert_t cert, ulong p, ulong q, ulong h);
+
+int aprcl_cert_fprint(FILE * file, const aprcl_cert_t cert);
+
+static __inline__
+int aprcl_cert_print(const aprcl_cert_t cert)
+{
+    return aprcl_cert_fprint(stdout, cert);
+}
+
+int aprcl_cert_fread(FILE * file, aprcl_cert_t cert);
+
+int aprcl_cert_verify(const aprcl_cert_t cert);
+
+/* Primality testing *********************************************************/
+
+int aprcl_is_prime_cert(aprcl_cert_t cert, const fmpz_t n);
+
+int aprcl_is_prime(const fmpz_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,40 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "aprcl.h"
+
+void
+aprcl_cert_add_pair(aprcl_cert_t cert, ulong p, ulong q, ulong h)
+{
+    if (cert->num == cert->alloc)
+    {
+        cert->alloc = FLINT_MAX(16, 2 * cert->alloc);
+        cert->pairs = flint_realloc(cert->pairs, 
+                                    cert->alloc * sizeof(aprcl_pair_struct));
+    }
+
+    cert->pairs[cert->num].p = p;
+    cert->pairs[cert->num].q = q;
+    cert->pairs[cert->num].h = h;
+    cert->num++;
+}
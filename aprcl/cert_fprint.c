@@ -0,0 +1,42 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "aprcl.h"
+
+int
+aprcl_cert_fprint(FILE * file, const aprcl_cert_t cert)
+{
+    int r;
+    slong i;
+
+    r = fmpz_fprint(file, cert->n);
+    if (r > 0)
+        r = fprintf(file, "\n%lu %ld\n", cert->t, cert->num);
+
+    for (i = 0; i < cert->num && r > 0; i++)
+        r = fprintf(file, "%lu %lu %lu\n", cert->pairs[i].p, 
+                                          cert->pairs[i].q, cert->pairs[i].h);
+
+    return r;
+}
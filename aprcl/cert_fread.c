@@ -0,0 +1,50 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "aprcl.h"
+
+int
+aprcl_cert_fread(FILE * file, aprcl_cert_t cert)
+{
+    ulong p, q, h;
+    slong i, num;
+
+    cert->num = 0;
+
+    if (fmpz_fread(file, cert->n) <= 0)
+        return 0;
+
+    if (fscanf(file, "%lu %ld", &cert->t, &num) != 2 || num < 0)
+        return 0;
+
+    for (i = 0; i < num; i++)
+    {
+        if (fscanf(file, "%lu %lu %lu", &p, &q, &h) != 3)
+            return 0;
+
+        aprcl_cert_add_pair(cert, p, q, h);
+    }
+
+    return 1;
+}
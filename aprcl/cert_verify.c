@@ -0,0 +1,153 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdlib.h>
+#include <limits.h>
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "aprcl.h"
+
+static int
+_aprcl_pair_cmp(const void * a, const void * b)
+{
+    const aprcl_pair_struct * x = (const aprcl_pair_struct *) a;
+    const aprcl_pair_struct * y = (const aprcl_pair_struct *) b;
+
+    if (x->q != y->q)
+        return x->q < y->q ? -1 : 1;
+
+    return x->p < y->p ? -1 : (x->p > y->p);
+}
+
+int
+aprcl_cert_verify(const aprcl_cert_t cert)
+{
+    ulong q[APRCL_MAX_Q], * h, t, p, qi;
+    aprcl_pair_struct * pairs;
+    n_factor_t fac;
+    slong i, j, k, num, num_q;
+    int * lp, l, result;
+    fmpz_t s, u;
+
+    if (fmpz_cmp_ui(cert->n, 1) <= 0)
+        return 0;
+
+    if (!COEFF_IS_MPZ(*cert->n))
+        return n_is_prime(*cert->n);
+
+    t = cert->t;
+    num = cert->num;
+
+    if (t == 0 || t > APRCL_MAX_T)
+        return 0;
+
+    fmpz_init(s);
+    fmpz_init(u);
+
+    num_q = _aprcl_e_t(q, s, t);
+
+    /* s^2 > n and gcd(n, t s) = 1 */
+    fmpz_mul(u, s, s);
+    result = (fmpz_cmp(u, cert->n) > 0);
+
+    fmpz_mul_ui(u, s, t);
+    fmpz_gcd(u, u, cert->n);
+    result = result && fmpz_is_one(u);
+
+    pairs = flint_malloc(FLINT_MAX(num, 1) * sizeof(aprcl_pair_struct));
+    h = flint_malloc(FLINT_MAX(num, 1) * sizeof(ulong));
+    lp = flint_malloc(FLINT_MAX(num, 1) * sizeof(int));
+
+    for (i = 0; i < num; i++)
+        pairs[i] = cert->pairs[i];
+
+    qsort(pairs, num, sizeof(aprcl_pair_struct), _aprcl_pair_cmp);
+
+    /* every pair must have p | t, p | q - 1, q prime and q coprime to n */
+    for (i = 0; i < num && result; i++)
+    {
+        p = pairs[i].p;
+        qi = pairs[i].q;
+
+        result = (p >= 2 && qi > 2 && qi <= UINT_MAX && t % p == 0 
+                  && n_is_prime(p) && n_is_prime(qi) && (qi - 1) % p == 0
+                  && fmpz_fdiv_ui(cert->n, qi) != 0
+                  && (i == 0 || pairs[i].p != pairs[i - 1].p 
+                             || pairs[i].q != pairs[i - 1].q));
+
+        h[i] = pairs[i].h;
+    }
+
+    /* every p | q - 1 with q - 1 | t must be covered */
+    for (i = 0; i < num_q && result; i++)
+    {
+        if (q[i] == 2)
+            continue;
+
+        n_factor_init(&fac);
+        n_factor(&fac, q[i] - 1, 1);
+
+        for (j = 0; j < fac.num && result; j++)
+        {
+            for (k = 0; k < num; k++)
+                if (pairs[k].p == fac.p[j] && pairs[k].q == q[i])
+                    break;
+
+            result = (k < num);
+        }
+    }
+
+    /* rerun the Jacobi sum tests, which must give the recorded roots */
+    if (result)
+        result = _aprcl_pairs_test(pairs, lp, num, cert->n);
+
+    for (i = 0; i < num && result; i++)
+        result = (pairs[i].h == h[i]);
+
+    /* Lenstra's condition for each prime p dividing t */
+    n_factor_init(&fac);
+    n_factor(&fac, t, 1);
+
+    for (i = 0; i < fac.num && result; i++)
+    {
+        p = fac.p[i];
+
+        l = (p > 2 && n_powmod2(fmpz_fdiv_ui(cert->n, p * p), 
+                                                   p - 1, p * p) != 1);
+
+        for (j = 0; j < num && !l; j++)
+            l = (pairs[j].p == p && lp[j]);
+
+        result = l;
+    }
+
+    if (result)
+        result = _aprcl_final_division(cert->n, s, t);
+
+    flint_free(pairs);
+    flint_free(h);
+    flint_free(lp);
+    fmpz_clear(s);
+    fmpz_clear(u);
+
+    return result;
+}
@@ -0,0 +1,58 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "aprcl.h"
+
+unsigned int *
+_aprcl_dlog_table(ulong q)
+{
+    unsigned int * ind;
+    n_factor_t fac;
+    ulong g, x, y;
+    slong i;
+
+    /* smallest primitive root g modulo q */
+    n_factor_init(&fac);
+    n_factor(&fac, q - 1, 1);
+
+    for (g = 2; ; g++)
+    {
+        for (i = 0; i < fac.num; i++)
+            if (n_powmod2(g, (q - 1) / fac.p[i], q) == 1UL)
+                break;
+
+        if (i == fac.num)
+            break;
+    }
+
+    ind = flint_malloc(q * sizeof(unsigned int));
+    ind[0] = 0;
+
+    for (x = 0, y = 1; x < q - 1; x++)
+    {
+        ind[y] = x;
+        y = (y * g) % q;
+    }
+
+    return ind;
+}
@@ -0,0 +1,80 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "aprcl.h"
+
+slong
+_aprcl_e_t(ulong * q, fmpz_t s, ulong t)
+{
+    n_factor_t fac;
+    ulong * div, d, qi, u;
+    slong i, j, k, num, len, old;
+
+    n_factor_init(&fac);
+    n_factor(&fac, t, 1);
+
+    /* the divisors of t */
+    div = flint_malloc(APRCL_MAX_Q * sizeof(ulong));
+    div[0] = 1;
+    len = 1;
+
+    for (i = 0; i < fac.num; i++)
+    {
+        old = len;
+
+        for (d = fac.p[i], j = 0; j < fac.exp[i]; j++, d *= fac.p[i])
+            for (k = 0; k < old; k++)
+                div[len++] = div[k] * d;
+    }
+
+    /* s = 2 prod q^(v_q(t) + 1) over the primes q with q - 1 | t */
+    fmpz_set_ui(s, 2);
+
+    num = 0;
+    for (i = 0; i < len; i++)
+    {
+        qi = div[i] + 1;
+
+        if (!n_is_prime(qi))
+            continue;
+
+        q[num++] = qi;
+
+        for (u = t; u % qi == 0; u /= qi)
+            fmpz_mul_ui(s, s, qi);
+        fmpz_mul_ui(s, s, qi);
+    }
+
+    flint_free(div);
+
+    /* sort the primes, insertion sort being enough here */
+    for (i = 1; i < num; i++)
+    {
+        for (qi = q[i], j = i; j > 0 && q[j - 1] > qi; j--)
+            q[j] = q[j - 1];
+        q[j] = qi;
+    }
+
+    return num;
+}
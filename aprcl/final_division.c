@@ -0,0 +1,112 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "aprcl.h"
+#include "thread_pool.h"
+
+typedef struct
+{
+    const fmpz * n;
+    const fmpz * s;
+    ulong start;
+    ulong stop;
+    int found;
+}
+_aprcl_final_arg_struct;
+
+static void
+_aprcl_final_worker(void * varg)
+{
+    _aprcl_final_arg_struct * arg = (_aprcl_final_arg_struct *) varg;
+    fmpz_t r, m;
+    ulong i;
+    slong bits;
+
+    fmpz_init(r);
+    fmpz_init(m);
+
+    /* 
+       If n passed the Jacobi sum tests, each divisor of n is n^i mod s for
+       some 0 <= i < t. As s^2 > n, only r = n^i mod s at most sqrt(n) 
+       need be tried: the least prime factor of a composite n is such an r.
+    */
+    bits = (fmpz_bits(arg->n) + 1) / 2;
+
+    fmpz_mod(m, arg->n, arg->s);
+    fmpz_powm_ui(r, m, arg->start, arg->s);
+
+    for (i = arg->start; i < arg->stop && !arg->found; i++)
+    {
+        if (fmpz_bits(r) <= bits && !fmpz_is_one(r) 
+                                 && fmpz_divisible(arg->n, r))
+            arg->found = 1;
+
+        fmpz_mul(r, r, m);
+        fmpz_mod(r, r, arg->s);
+    }
+
+    fmpz_clear(r);
+    fmpz_clear(m);
+}
+
+int
+_aprcl_final_division(const fmpz_t n, const fmpz_t s, ulong t)
+{
+    thread_pool_handle * threads;
+    _aprcl_final_arg_struct * args;
+    slong i, num_workers;
+    int result;
+
+    num_workers = flint_request_threads(&threads, flint_get_num_threads());
+
+    args = flint_malloc(sizeof(_aprcl_final_arg_struct) * (num_workers + 1));
+
+    for (i = 0; i <= num_workers; i++)
+    {
+        args[i].n = n;
+        args[i].s = s;
+        args[i].start = (t * i) / (num_workers + 1);
+        args[i].stop = (t * (i + 1)) / (num_workers + 1);
+        args[i].found = 0;
+    }
+
+    for (i = 0; i < num_workers; i++)
+        thread_pool_wake(global_thread_pool, threads[i],
+                                             _aprcl_final_worker, args + i + 1);
+
+    _aprcl_final_worker(args);
+
+    for (i = 0; i < num_workers; i++)
+        thread_pool_wait(global_thread_pool, threads[i]);
+
+    flint_give_back_threads(threads, num_workers);
+
+    result = 1;
+    for (i = 0; i <= num_workers; i++)
+        if (args[i].found)
+            result = 0;
+
+    flint_free(args);
+
+    return result;
+}
@@ -0,0 +1,140 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "aprcl.h"
+
+int
+aprcl_is_prime_cert(aprcl_cert_t cert, const fmpz_t n)
+{
+    ulong q[APRCL_MAX_Q], t, p, qi, h;
+    unsigned int * ind;
+    n_factor_t fac;
+    slong i, j, num_q, count;
+    int * lp, l, result;
+    fmpz_t s, u;
+
+    fmpz_set(cert->n, n);
+    cert->t = 0;
+    cert->num = 0;
+
+    if (fmpz_cmp_ui(n, 1) <= 0)
+        return 0;
+
+    if (!COEFF_IS_MPZ(*n))
+        return n_is_prime(*n);
+
+    /* almost every composite is caught here */
+    if (!fmpz_is_probabprime_BPSW(n))
+        return 0;
+
+    fmpz_init(s);
+    fmpz_init(u);
+
+    t = aprcl_select_t(s, n);
+    if (t == 0)
+    {
+        printf("Exception (aprcl_is_prime_cert). n too large.\n");
+        abort();
+    }
+
+    num_q = _aprcl_e_t(q, s, t);
+
+    /* n is larger than any prime dividing t s */
+    fmpz_mul_ui(u, s, t);
+    fmpz_gcd(u, u, n);
+    result = fmpz_is_one(u);
+
+    /* the pairs (p, q) with q prime, q - 1 | t and p | q - 1 */
+    for (i = 0; i < num_q; i++)
+    {
+        if (q[i] == 2)
+            continue;
+
+        n_factor_init(&fac);
+        n_factor(&fac, q[i] - 1, 1);
+
+        for (j = 0; j < fac.num; j++)
+            aprcl_cert_add_pair(cert, fac.p[j], q[i], 0);
+    }
+
+    lp = flint_malloc(cert->num * sizeof(int));
+
+    if (result)
+        result = _aprcl_pairs_test(cert->pairs, lp, cert->num, n);
+
+    /* Lenstra's condition for each prime p dividing t */
+    n_factor_init(&fac);
+    n_factor(&fac, t, 1);
+
+    for (i = 0; i < fac.num && result; i++)
+    {
+        p = fac.p[i];
+
+        l = (p > 2 && n_powmod2(fmpz_fdiv_ui(n, p * p), p - 1, p * p) != 1);
+
+        for (j = 0; j < cert->num && !l; j++)
+            l = (cert->pairs[j].p == p && lp[j]);
+
+        /* otherwise try further primes q = 1 mod p */
+        for (qi = p + 1, count = 0; !l && result && count < APRCL_EXTRA_Q; 
+                                                                   qi += p)
+        {
+            if (!n_is_prime(qi) || t % (qi - 1) == 0 
+                                || fmpz_fdiv_ui(n, qi) == 0)
+                continue;
+
+            ind = _aprcl_dlog_table(qi);
+            result = _aprcl_pair_test(&h, &l, n, p, qi, ind);
+            flint_free(ind);
+
+            if (result)
+                aprcl_cert_add_pair(cert, p, qi, h);
+
+            count++;
+        }
+
+        if (result && !l)
+        {
+            printf("Exception (aprcl_is_prime_cert). Lenstra condition "
+                   "not satisfied for p = %lu.\n", p);
+            abort();
+        }
+    }
+
+    if (result)
+        result = _aprcl_final_division(n, s, t);
+
+    if (result)
+        cert->t = t;
+    else
+        cert->num = 0;
+
+    flint_free(lp);
+    fmpz_clear(s);
+    fmpz_clear(u);
+
+    return result;
+}
@@ -0,0 +1,50 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+#include "aprcl.h"
+
+void
+_aprcl_jacobi_sum(fmpz * J, const unsigned int * ind, ulong q, 
+               ulong a, ulong b, ulong d, ulong p, ulong pk, const fmpz_t n)
+{
+    ulong * c, y;
+    fmpz * t;
+    slong i;
+
+    c = flint_calloc(d, sizeof(ulong));
+
+    /* c[e] counts the x with a ind(x) + b ind(1 - x) = e mod d, 1 < x < q */
+    for (y = 2; y < q; y++)
+        c[(a * ind[y] + b * ind[q + 1 - y]) % d]++;
+
+    /* zeta_d = zeta_pk^(pk/d) */
+    t = _fmpz_vec_init(pk);
+    for (i = 0; i < d; i++)
+        fmpz_set_ui(t + i * (pk / d), c[i]);
+
+    _aprcl_unity_reduce(J, t, pk, p, pk, n);
+
+    _fmpz_vec_clear(t, pk);
+    flint_free(c);
+}
@@ -0,0 +1,185 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+#include "aprcl.h"
+
+int
+_aprcl_pair_test(ulong * h, int * lp, const fmpz_t n, 
+                                   ulong p, ulong q, const unsigned int * ind)
+{
+    fmpz * J, * S, * Sa, * T, * U, * t;
+    fmpz_t e, f;
+    ulong k, pk, x, r;
+    slong m, hh;
+    int result;
+
+    for (k = 0, pk = 1, x = q - 1; x % p == 0; x /= p)
+    {
+        k++;
+        pk *= p;
+    }
+
+    *lp = 0;
+
+    fmpz_init(e);
+    fmpz_init(f);
+
+    if (p == 2 && k == 1)
+    {
+        /* S = (-q)^((n - 1)/2) must be +-1 */
+        fmpz_sub_ui(e, n, 1);
+        fmpz_fdiv_q_2exp(e, e, 1);
+        fmpz_sub_ui(f, n, q);
+        fmpz_powm(f, f, e, n);
+        fmpz_add_ui(e, f, 1);
+
+        result = 1;
+        if (fmpz_is_one(f))
+            *h = 0;
+        else if (fmpz_equal(e, n))
+        {
+            *h = 1;
+            *lp = (fmpz_fdiv_ui(n, 4) == 1);
+        }
+        else
+            result = 0;
+
+        fmpz_clear(e);
+        fmpz_clear(f);
+
+        return result;
+    }
+
+    m = pk - pk / p;
+
+    J = _fmpz_vec_init(m);
+    S = _fmpz_vec_init(m);
+    Sa = _fmpz_vec_init(m);
+    T = _fmpz_vec_init(m);
+    U = _fmpz_vec_init(m);
+    t = _fmpz_vec_init(2 * pk);
+
+    if (p == 2 && k == 2)
+    {
+        /* S = (q J^2)^floor(n/4), times J^2 if n = 3 mod 4 */
+        _aprcl_jacobi_sum(J, ind, q, 1, 1, 4, p, pk, n);
+        _aprcl_unity_sqr(J, J, t, p, pk, n);
+        _fmpz_vec_scalar_mul_ui(T, J, m, q);
+        _fmpz_vec_scalar_mod_fmpz(T, T, m, n);
+
+        fmpz_fdiv_q_2exp(e, n, 2);
+        _aprcl_unity_pow_fmpz(S, T, e, p, pk, n);
+
+        if (fmpz_fdiv_ui(n, 4) == 3)
+            _aprcl_unity_mul(S, S, J, t, p, pk, n);
+    }
+    else
+    {
+        /* 
+           J(chi, chi) for p odd, J(chi, chi) J(chi^2, chi) for p = 2, 
+           where chi has order pk
+        */
+        _aprcl_jacobi_sum(J, ind, q, 1, 1, pk, p, pk, n);
+        if (p == 2)
+        {
+            _aprcl_jacobi_sum(T, ind, q, 2, 1, pk, p, pk, n);
+            _aprcl_unity_mul(J, J, T, t, p, pk, n);
+        }
+
+        /*
+           With E the x in [1, pk) prime to p, and congruent to 1 or 3 
+           mod 8 if p = 2, S = prod_{x in E} sigma_x^-1(J)^floor(n x/pk), 
+           computed as the floor(n/pk)-th power of prod sigma_x^-1(J)^x 
+           times prod sigma_x^-1(J)^floor(r x/pk), where r = n mod pk
+        */
+        r = fmpz_fdiv_ui(n, pk);
+
+        _fmpz_vec_zero(S, m);
+        fmpz_one(S);
+        _fmpz_vec_zero(Sa, m);
+        fmpz_one(Sa);
+
+        for (x = 1; x < pk; x++)
+        {
+            if (x % p == 0 || (p == 2 && x % 8 != 1 && x % 8 != 3))
+                continue;
+
+            _aprcl_unity_sigma(T, J, n_invmod(x, pk), p, pk, n);
+
+            fmpz_set_ui(f, x);
+            _aprcl_unity_pow_fmpz(U, T, f, p, pk, n);
+            _aprcl_unity_mul(S, S, U, t, p, pk, n);
+
+            fmpz_set_ui(f, (r * x) / pk);
+            _aprcl_unity_pow_fmpz(U, T, f, p, pk, n);
+            _aprcl_unity_mul(Sa, Sa, U, t, p, pk, n);
+        }
+
+        fmpz_fdiv_q_ui(e, n, pk);
+        _aprcl_unity_pow_fmpz(S, S, e, p, pk, n);
+        _aprcl_unity_mul(S, S, Sa, t, p, pk, n);
+
+        /* times J(chi_8^3, chi_8)^2 unless n = 1, 3 mod 8 */
+        if (p == 2 && (r % 8 == 5 || r % 8 == 7))
+        {
+            _aprcl_jacobi_sum(T, ind, q, 3, 1, 8, p, pk, n);
+            _aprcl_unity_sqr(T, T, t, p, pk, n);
+            _aprcl_unity_mul(S, S, T, t, p, pk, n);
+        }
+    }
+
+    hh = _aprcl_unity_root_index(S, p, pk, n);
+    result = (hh >= 0);
+
+    if (result)
+    {
+        *h = hh;
+
+        if (p != 2)
+            *lp = (hh % p != 0);
+        else if (hh % 2 == 1)
+        {
+            /* for p = 2 we also need q^((n - 1)/2) = -1 mod n */
+            fmpz_sub_ui(e, n, 1);
+            fmpz_fdiv_q_2exp(e, e, 1);
+            fmpz_set_ui(f, q);
+            fmpz_powm(f, f, e, n);
+            fmpz_add_ui(f, f, 1);
+            *lp = fmpz_equal(f, n);
+        }
+    }
+
+    _fmpz_vec_clear(J, m);
+    _fmpz_vec_clear(S, m);
+    _fmpz_vec_clear(Sa, m);
+    _fmpz_vec_clear(T, m);
+    _fmpz_vec_clear(U, m);
+    _fmpz_vec_clear(t, 2 * pk);
+
+    fmpz_clear(e);
+    fmpz_clear(f);
+
+    return result;
+}
@@ -0,0 +1,124 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "aprcl.h"
+#include "thread_pool.h"
+
+typedef struct
+{
+    aprcl_pair_struct * pairs;
+    int * lp;
+    int * ok;
+    const slong * group;   /* pairs with the same q, pairs[group[i]] onwards */
+    slong num_groups;
+    slong start;
+    slong step;
+    const fmpz * n;
+}
+_aprcl_pairs_arg_struct;
+
+static void
+_aprcl_pairs_worker(void * varg)
+{
+    _aprcl_pairs_arg_struct * arg = (_aprcl_pairs_arg_struct *) varg;
+    aprcl_pair_struct * pair;
+    unsigned int * ind;
+    slong i, j;
+
+    for (i = arg->start; i < arg->num_groups; i += arg->step)
+    {
+        /* one table of discrete logarithms serves every p dividing q - 1 */
+        ind = _aprcl_dlog_table(arg->pairs[arg->group[i]].q);
+
+        for (j = arg->group[i]; j < arg->group[i + 1]; j++)
+        {
+            pair = arg->pairs + j;
+            arg->ok[j] = _aprcl_pair_test(&pair->h, arg->lp + j, arg->n,
+                                                       pair->p, pair->q, ind);
+        }
+
+        flint_free(ind);
+    }
+}
+
+int
+_aprcl_pairs_test(aprcl_pair_struct * pairs, int * lp, slong num, 
+                                                            const fmpz_t n)
+{
+    thread_pool_handle * threads;
+    _aprcl_pairs_arg_struct * args;
+    slong i, num_groups, num_workers;
+    slong * group;
+    int * ok, result;
+
+    if (num == 0)
+        return 1;
+
+    group = flint_malloc((num + 1) * sizeof(slong));
+    ok = flint_malloc(num * sizeof(int));
+
+    num_groups = 0;
+    for (i = 0; i < num; i++)
+        if (i == 0 || pairs[i].q != pairs[i - 1].q)
+            group[num_groups++] = i;
+    group[num_groups] = num;
+
+    num_workers = flint_request_threads(&threads,
+                            FLINT_MIN(flint_get_num_threads(), num_groups));
+
+    args = flint_malloc(sizeof(_aprcl_pairs_arg_struct) * (num_workers + 1));
+
+    /* interleave the groups, the larger q being the more expensive */
+    for (i = 0; i <= num_workers; i++)
+    {
+        args[i].pairs = pairs;
+        args[i].lp = lp;
+        args[i].ok = ok;
+        args[i].group = group;
+        args[i].num_groups = num_groups;
+        args[i].start = i;
+        args[i].step = num_workers + 1;
+        args[i].n = n;
+    }
+
+    for (i = 0; i < num_workers; i++)
+        thread_pool_wake(global_thread_pool, threads[i],
+                                             _aprcl_pairs_worker, args + i + 1);
+
+    _aprcl_pairs_worker(args);
+
+    for (i = 0; i < num_workers; i++)
+        thread_pool_wait(global_thread_pool, threads[i]);
+
+    flint_give_back_threads(threads, num_workers);
+
+    result = 1;
+    for (i = 0; i < num; i++)
+        result &= ok[i];
+
+    flint_free(args);
+    flint_free(group);
+    flint_free(ok);
+
+    return result;
+}
@@ -0,0 +1,57 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "aprcl.h"
+
+/* values of t with many primes q such that q - 1 divides t */
+static const ulong aprcl_t_tab[] = {
+    2UL, 12UL, 60UL, 180UL, 840UL, 1260UL, 1680UL, 2520UL, 5040UL, 
+    15120UL, 55440UL, 110880UL, 720720UL, 1441440UL, 4324320UL, 
+    24504480UL, 73513440UL
+};
+
+ulong
+aprcl_select_t(fmpz_t s, const fmpz_t n)
+{
+    ulong q[APRCL_MAX_Q];
+    fmpz_t s2;
+    slong i;
+
+    fmpz_init(s2);
+
+    for (i = 0; i < sizeof(aprcl_t_tab) / sizeof(ulong); i++)
+    {
+        _aprcl_e_t(q, s, aprcl_t_tab[i]);
+        fmpz_mul(s2, s, s);
+
+        if (fmpz_cmp(s2, n) > 0)
+        {
+            fmpz_clear(s2);
+            return aprcl_t_tab[i];
+        }
+    }
+
+    fmpz_clear(s2);
+
+    return 0;
+}
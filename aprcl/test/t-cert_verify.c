@@ -0,0 +1,191 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "aprcl.h"
+
+/* the certificate for n that the Jacobi sum tests alone would give */
+void forge_cert(aprcl_cert_t cert, const fmpz_t n)
+{
+    ulong q[APRCL_MAX_Q];
+    n_factor_t fac;
+    slong i, j, num_q;
+    int * lp;
+    fmpz_t s;
+
+    fmpz_init(s);
+
+    fmpz_set(cert->n, n);
+    cert->num = 0;
+    cert->t = aprcl_select_t(s, n);
+    num_q = _aprcl_e_t(q, s, cert->t);
+
+    for (i = 0; i < num_q; i++)
+    {
+        if (q[i] == 2)
+            continue;
+
+        n_factor_init(&fac);
+        n_factor(&fac, q[i] - 1, 1);
+
+        for (j = 0; j < fac.num; j++)
+            aprcl_cert_add_pair(cert, fac.p[j], q[i], 0);
+    }
+
+    lp = flint_malloc(cert->num * sizeof(int));
+    _aprcl_pairs_test(cert->pairs, lp, cert->num, n);
+    flint_free(lp);
+
+    fmpz_clear(s);
+}
+
+int main(void)
+{
+    int i, result;
+    flint_rand_t state;
+
+    printf("cert_verify....");
+    fflush(stdout);
+
+    flint_randinit(state);
+
+    /* round trip through a file, and tampering */
+    for (i = 0; i < 20 * flint_test_multiplier(); i++)
+    {
+        fmpz_t n;
+        aprcl_cert_t cert, cert2;
+        FILE * file;
+        slong j;
+
+        fmpz_init(n);
+        aprcl_cert_init(cert);
+        aprcl_cert_init(cert2);
+
+        fmpz_randbits(n, state, n_randint(state, 200) + 70);
+        fmpz_abs(n, n);
+        fmpz_setbit(n, 0);
+        while (!fmpz_is_probabprime_BPSW(n))
+            fmpz_add_ui(n, n, 2);
+
+        aprcl_is_prime_cert(cert, n);
+
+        file = tmpfile();
+        aprcl_cert_fprint(file, cert);
+        rewind(file);
+        result = aprcl_cert_fread(file, cert2);
+        fclose(file);
+
+        result = result && fmpz_equal(cert2->n, n) && cert2->t == cert->t
+                        && cert2->num == cert->num && aprcl_cert_verify(cert2);
+        if (!result)
+        {
+            printf("FAIL (round trip):\n");
+            fmpz_print(n); printf("\n");
+            abort();
+        }
+
+        /* a wrong root of unity */
+        j = n_randint(state, cert2->num);
+        cert2->pairs[j].h++;
+        result = !aprcl_cert_verify(cert2);
+        cert2->pairs[j].h--;
+
+        /* a missing pair */
+        cert2->pairs[j] = cert2->pairs[--cert2->num];
+        result = result && !aprcl_cert_verify(cert2);
+
+        /* too small a t */
+        cert->t = 2;
+        result = result && !aprcl_cert_verify(cert);
+
+        if (!result)
+        {
+            printf("FAIL (tampered certificate accepted):\n");
+            fmpz_print(n); printf("\n");
+            abort();
+        }
+
+        fmpz_clear(n);
+        aprcl_cert_clear(cert);
+        aprcl_cert_clear(cert2);
+    }
+
+    /* forged certificates for composites, including Carmichael numbers */
+    for (i = 0; i < 100 * flint_test_multiplier(); i++)
+    {
+        fmpz_t n;
+        aprcl_cert_t cert;
+        ulong k;
+
+        fmpz_init(n);
+        aprcl_cert_init(cert);
+
+        if (n_randint(state, 2))
+        {
+            do {
+                k = n_randint(state, 1UL << 30) + 1;
+            } while (!n_is_prime(6 * k + 1) || !n_is_prime(12 * k + 1) 
+                                            || !n_is_prime(18 * k + 1));
+
+            fmpz_set_ui(n, 6 * k + 1);
+            fmpz_mul_ui(n, n, 12 * k + 1);
+            fmpz_mul_ui(n, n, 18 * k + 1);
+        }
+        else
+        {
+            fmpz_t a;
+
+            fmpz_init(a);
+            do {
+                fmpz_randtest_unsigned(n, state, n_randint(state, 100) + 3);
+                fmpz_randtest_unsigned(a, state, n_randint(state, 100) + 3);
+                fmpz_add_ui(n, n, 3);
+                fmpz_add_ui(a, a, 3);
+                fmpz_setbit(n, 0);
+                fmpz_setbit(a, 0);
+                fmpz_mul(n, n, a);
+            } while (!COEFF_IS_MPZ(*n));
+            fmpz_clear(a);
+        }
+
+        forge_cert(cert, n);
+
+        result = !aprcl_cert_verify(cert);
+        if (!result)
+        {
+            printf("FAIL (composite accepted):\n");
+            fmpz_print(n); printf("\n");
+            abort();
+        }
+
+        fmpz_clear(n);
+        aprcl_cert_clear(cert);
+    }
+
+    flint_randclear(state);
+    flint_cleanup();
+    printf("PASS\n");
+    return 0;
+}
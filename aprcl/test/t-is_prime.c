@@ -0,0 +1,120 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "aprcl.h"
+
+int main(void)
+{
+    int i, result;
+    flint_rand_t state;
+
+    printf("is_prime....");
+    fflush(stdout);
+
+    flint_randinit(state);
+
+    /* primes */
+    for (i = 0; i < 100 * flint_test_multiplier(); i++)
+    {
+        fmpz_t n;
+        aprcl_cert_t cert;
+
+        fmpz_init(n);
+        aprcl_cert_init(cert);
+
+        do {
+            fmpz_randtest_unsigned(n, state, n_randint(state, 300) + 2);
+            fmpz_setbit(n, 0);
+        } while (fmpz_cmp_ui(n, 2) <= 0);
+
+        while (!fmpz_is_probabprime_BPSW(n))
+            fmpz_add_ui(n, n, 2);
+
+        result = (aprcl_is_prime_cert(cert, n) == 1 && fmpz_equal(cert->n, n)
+                  && aprcl_cert_verify(cert) == 1);
+        if (!result)
+        {
+            printf("FAIL (prime):\n");
+            fmpz_print(n); printf("\n");
+            abort();
+        }
+
+        fmpz_clear(n);
+        aprcl_cert_clear(cert);
+    }
+
+    /* composites */
+    for (i = 0; i < 1000 * flint_test_multiplier(); i++)
+    {
+        fmpz_t a, b, n;
+
+        fmpz_init(a);
+        fmpz_init(b);
+        fmpz_init(n);
+
+        fmpz_randtest_unsigned(a, state, n_randint(state, 200) + 2);
+        fmpz_randtest_unsigned(b, state, n_randint(state, 200) + 2);
+        fmpz_add_ui(a, a, 2);
+        fmpz_add_ui(b, b, 2);
+        fmpz_mul(n, a, b);
+
+        result = (aprcl_is_prime(n) == 0);
+        if (!result)
+        {
+            printf("FAIL (composite):\n");
+            fmpz_print(n); printf("\n");
+            abort();
+        }
+
+        fmpz_clear(a);
+        fmpz_clear(b);
+        fmpz_clear(n);
+    }
+
+    /* small values */
+    for (i = -10; i < 1000; i++)
+    {
+        fmpz_t n;
+
+        fmpz_init(n);
+        fmpz_set_si(n, i);
+
+        result = (aprcl_is_prime(n) == (i > 1 && n_is_prime(i)));
+        if (!result)
+        {
+            printf("FAIL (small):\n");
+            printf("n = %d\n", i);
+            abort();
+        }
+
+        fmpz_clear(n);
+    }
+
+    flint_randclear(state);
+    flint_cleanup();
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,160 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+#include "aprcl.h"
+
+int main(void)
+{
+    int i, result;
+    flint_rand_t state;
+
+    printf("unity_pow_fmpz....");
+    fflush(stdout);
+
+    flint_randinit(state);
+
+    /* a^(e1 + e2) = a^e1 a^e2, sigma_x(a^e) = sigma_x(a)^e */
+    for (i = 0; i < 200 * flint_test_multiplier(); i++)
+    {
+        static const ulong pks[][2] = { {2, 2}, {2, 8}, {2, 32}, {3, 3}, 
+                                        {3, 27}, {5, 25}, {7, 7}, {13, 13} };
+        fmpz * a, * b, * c, * d, * t;
+        fmpz_t n, e1, e2, e;
+        ulong p, pk, x;
+        slong j, m;
+
+        j = n_randint(state, 8);
+        p = pks[j][0];
+        pk = pks[j][1];
+        m = pk - pk / p;
+
+        fmpz_init(n);
+        fmpz_init(e1);
+        fmpz_init(e2);
+        fmpz_init(e);
+
+        fmpz_randtest_unsigned(n, state, 200);
+        fmpz_add_ui(n, n, 2);
+        fmpz_randtest_unsigned(e1, state, 200);
+        fmpz_randtest_unsigned(e2, state, 200);
+        fmpz_add(e, e1, e2);
+
+        a = _fmpz_vec_init(m);
+        b = _fmpz_vec_init(m);
+        c = _fmpz_vec_init(m);
+        d = _fmpz_vec_init(m);
+        t = _fmpz_vec_init(2 * pk);
+
+        _fmpz_vec_randtest_unsigned(a, state, m, 200);
+        _fmpz_vec_scalar_mod_fmpz(a, a, m, n);
+
+        _aprcl_unity_pow_fmpz(b, a, e1, p, pk, n);
+        _aprcl_unity_pow_fmpz(c, a, e2, p, pk, n);
+        _aprcl_unity_mul(b, b, c, t, p, pk, n);
+        _aprcl_unity_pow_fmpz(d, a, e, p, pk, n);
+
+        result = _fmpz_vec_equal(b, d, m);
+
+        do {
+            x = n_randint(state, pk);
+        } while (x % p == 0);
+
+        _aprcl_unity_sigma(b, d, x, p, pk, n);
+        _aprcl_unity_sigma(c, a, x, p, pk, n);
+        _aprcl_unity_pow_fmpz(c, c, e, p, pk, n);
+
+        result = result && _fmpz_vec_equal(b, c, m);
+        if (!result)
+        {
+            printf("FAIL:\n");
+            printf("p = %lu, pk = %lu, x = %lu\n", p, pk, x);
+            printf("n = "), fmpz_print(n), printf("\n");
+            abort();
+        }
+
+        _fmpz_vec_clear(a, m);
+        _fmpz_vec_clear(b, m);
+        _fmpz_vec_clear(c, m);
+        _fmpz_vec_clear(d, m);
+        _fmpz_vec_clear(t, 2 * pk);
+
+        fmpz_clear(n);
+        fmpz_clear(e1);
+        fmpz_clear(e2);
+        fmpz_clear(e);
+    }
+
+    /* zeta^h is recognised */
+    for (i = 0; i < 100 * flint_test_multiplier(); i++)
+    {
+        fmpz * a, * b;
+        fmpz_t n, e;
+        ulong p, pk, h;
+        slong m;
+
+        p = n_randint(state, 2) ? 2 : 3;
+        pk = p * p * p;
+        m = pk - pk / p;
+        h = n_randint(state, pk);
+
+        fmpz_init(n);
+        fmpz_init(e);
+
+        fmpz_randtest_unsigned(n, state, 100);
+        fmpz_add_ui(n, n, 100);
+        fmpz_set_ui(e, h);
+
+        a = _fmpz_vec_init(m);
+        b = _fmpz_vec_init(m);
+
+        fmpz_one(a + 1);
+        _aprcl_unity_pow_fmpz(b, a, e, p, pk, n);
+
+        result = (_aprcl_unity_root_index(b, p, pk, n) == h);
+
+        fmpz_add_ui(b, b, 1);
+        fmpz_mod(b, b, n);
+        result = result && (_aprcl_unity_root_index(b, p, pk, n) == -1);
+        if (!result)
+        {
+            printf("FAIL (root index):\n");
+            printf("p = %lu, pk = %lu, h = %lu\n", p, pk, h);
+            abort();
+        }
+
+        _fmpz_vec_clear(a, m);
+        _fmpz_vec_clear(b, m);
+
+        fmpz_clear(n);
+        fmpz_clear(e);
+    }
+
+    flint_randclear(state);
+    flint_cleanup();
+    printf("PASS\n");
+    return 0;
+}
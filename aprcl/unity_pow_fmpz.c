@@ -0,0 +1,98 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+#include "aprcl.h"
+
+void
+_aprcl_unity_pow_fmpz(fmpz * r, const fmpz * a, const fmpz_t e, 
+                                      ulong p, ulong pk, const fmpz_t n)
+{
+    slong i, j, k, l, w, m, bits;
+    fmpz * tab, * t;
+    int started;
+
+    m = pk - pk / p;
+    bits = fmpz_bits(e);
+
+    if (bits == 0)
+    {
+        _fmpz_vec_zero(r, m);
+        fmpz_one(r);
+        return;
+    }
+
+    if (bits < 8)        k = 1;
+    else if (bits < 25)  k = 2;
+    else if (bits < 81)  k = 3;
+    else if (bits < 241) k = 4;
+    else                 k = 5;
+
+    tab = _fmpz_vec_init(m << (k - 1));
+    t = _fmpz_vec_init(2 * pk);
+
+    /* tab holds a, a^3, a^5, ..., a^(2^k - 1) */
+    _fmpz_vec_set(tab, a, m);
+    if (k > 1)
+    {
+        _aprcl_unity_sqr(r, a, t, p, pk, n);
+        for (i = 1; i < (1L << (k - 1)); i++)
+            _aprcl_unity_mul(tab + i * m, tab + (i - 1) * m, r, t, p, pk, n);
+    }
+
+    /* left to right sliding windows */
+    started = 0;
+    for (i = bits - 1; i >= 0; )
+    {
+        if (!fmpz_tstbit(e, i))
+        {
+            _aprcl_unity_sqr(r, r, t, p, pk, n);
+            i--;
+            continue;
+        }
+
+        j = FLINT_MAX(i - k + 1, 0);
+        while (!fmpz_tstbit(e, j))
+            j++;
+
+        for (w = 0, l = i; l >= j; l--)
+            w = 2 * w + fmpz_tstbit(e, l);
+
+        if (started)
+        {
+            for (l = i; l >= j; l--)
+                _aprcl_unity_sqr(r, r, t, p, pk, n);
+            _aprcl_unity_mul(r, r, tab + (w / 2) * m, t, p, pk, n);
+        }
+        else
+        {
+            _fmpz_vec_set(r, tab + (w / 2) * m, m);
+            started = 1;
+        }
+
+        i = j - 1;
+    }
+
+    _fmpz_vec_clear(tab, m << (k - 1));
+    _fmpz_vec_clear(t, 2 * pk);
+}
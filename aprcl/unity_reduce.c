@@ -0,0 +1,49 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+#include "aprcl.h"
+
+void
+_aprcl_unity_reduce(fmpz * r, fmpz * t, slong len, 
+                                      ulong p, ulong pk, const fmpz_t n)
+{
+    slong i, j, m, pk1;
+
+    pk1 = pk / p;
+    m = pk - pk1;
+
+    /* zeta^pk = 1 */
+    for (i = pk; i < len; i++)
+        fmpz_add(t + i - pk, t + i - pk, t + i);
+
+    /* zeta^i = -(zeta^(i - pk1) + ... + zeta^(i - (p - 1) pk1)) for i >= m */
+    for (i = FLINT_MIN(len, pk) - 1; i >= m; i--)
+        for (j = 1; j < p; j++)
+            fmpz_sub(t + i - j * pk1, t + i - j * pk1, t + i);
+
+    _fmpz_vec_scalar_mod_fmpz(r, t, FLINT_MIN(len, m), n);
+
+    if (len < m)
+        _fmpz_vec_zero(r + len, m - len);
+}
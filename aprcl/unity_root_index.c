@@ -0,0 +1,65 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "aprcl.h"
+
+slong
+_aprcl_unity_root_index(const fmpz * a, ulong p, ulong pk, const fmpz_t n)
+{
+    slong i, first, num, m, pk1;
+    fmpz_t nm1;
+    int ok = 1;
+
+    pk1 = pk / p;
+    m = pk - pk1;
+
+    first = -1;
+    num = 0;
+    for (i = 0; i < m; i++)
+    {
+        if (!fmpz_is_zero(a + i))
+        {
+            if (first == -1)
+                first = i;
+            num++;
+        }
+    }
+
+    /* zeta^h for h < m */
+    if (num == 1 && fmpz_is_one(a + first))
+        return first;
+
+    /* zeta^h = -(zeta^(h - pk1) + ... + zeta^(h - (p - 1) pk1)) for h >= m */
+    if (num != p - 1)
+        return -1;
+
+    fmpz_init(nm1);
+    fmpz_sub_ui(nm1, n, 1);
+
+    for (i = 0; i < p - 1 && ok; i++)
+        ok = (first + i * pk1 < m && fmpz_equal(a + first + i * pk1, nm1));
+
+    fmpz_clear(nm1);
+
+    return ok ? first + (p - 1) * pk1 : -1;
+}
@@ -0,0 +1,43 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+#include "aprcl.h"
+
+void
+_aprcl_unity_sigma(fmpz * r, const fmpz * a, ulong x, 
+                                      ulong p, ulong pk, const fmpz_t n)
+{
+    slong i, m = pk - pk / p;
+    fmpz * t;
+
+    t = _fmpz_vec_init(pk);
+
+    /* zeta^i -> zeta^(i x), a permutation of the powers as x is a unit */
+    for (i = 0; i < m; i++)
+        fmpz_set(t + (i * x) % pk, a + i);
+
+    _aprcl_unity_reduce(r, t, pk, p, pk, n);
+
+    _fmpz_vec_clear(t, pk);
+}
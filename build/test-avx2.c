@@ -0,0 +1,16 @@
+#include <immintrin.h>
+__attribute__((target("avx2,fma"))) static int f(int x)
+{
+   __m256i a = _mm256_add_epi64(_mm256_set1_epi64x(x), _mm256_set1_epi64x(1));
+   __m256d b = _mm256_fmadd_pd(_mm256_set1_pd(1.0), _mm256_set1_pd(2.0), _mm256_set1_pd(3.0));
+   long long r[4]; double s[4];
+   _mm256_storeu_si256((__m256i *) r, a); _mm256_storeu_pd(s, b);
+   return r[0] == x + 1 && s[0] == 5.0;
+}
+int main(int argc, char ** argv)
+{
+   __builtin_cpu_init();
+   if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+      return !f(argc);
+   return 0;
+}
@@ -0,0 +1 @@
+int main(int argc, char ** argv) {return __builtin_popcountl(argc) == 100;}
@@ -0,0 +1,6 @@
+/* This file is autogenerated by ./configure -- do not edit! */
+#define POPCNT_INTRINSICS
+#define HAVE_BLAS 0
+#define HAVE_TLS 1
+#define HAVE_PTHREAD 1
+#define HAVE_AVX2 1
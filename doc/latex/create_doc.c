@@ -55,7 +55,9 @@ static char * docsin[] = {
     "../../interfaces/doc/interfaces.txt",
     "../../fft/doc/fft.txt",
     "../../qsieve/doc/qsieve.txt",
+    "../../aprcl/doc/aprcl.txt",
     "../../perm/doc/perm.txt",
+    "../../thread_pool/doc/thread_pool.txt",
 };
 
 static char * docsout[] = {
@@ -85,7 +87,9 @@ static char * docsout[] = {
     "input/interfaces.tex",
     "input/fft.tex",
     "input/qsieve.tex",
+    "input/aprcl.tex",
     "input/perm.tex",
+    "input/thread_pool.tex",
 };
 
 
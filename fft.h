@@ -104,6 +104,61 @@ mpn_sumdiff_n(mp_ptr s, mp_ptr d, mp_srcptr x, mp_srcptr y, mp_size_t n)
       yy = __ptr; \
    } while (0)
 
+/* 
+   minimum number of limbs of data per thread in the threaded matrix
+   Fourier transforms
+*/
+#define FFT_MFA_THREAD_LIMBS 65536
+
+/*
+   The butterflies swap scratch buffers with entries of the coefficient
+   array. When each thread of a threaded transform has its own scratch
+   buffers own[0], ..., own[k - 1], these can end up in the array. This
+   moves the data of any entry ii[start], ii[start + step], ... below end
+   which is one of the own buffers into one of the buffers cur[0], ...,
+   cur[k - 1] currently held by the thread, so that afterwards the thread
+   holds exactly its own buffers again.
+*/
+static __inline__ void
+_fft_reclaim_scratch(mp_limb_t ** ii, mp_size_t start, mp_size_t end, 
+   mp_size_t step, mp_limb_t ** own, mp_limb_t ** cur, int k, mp_size_t limbs)
+{
+   mp_size_t j;
+   int a, b, c;
+
+   for (j = start; j < end; j += step)
+   {
+      for (a = 0; a < k && ii[j] != own[a]; a++) ;
+      if (a == k)
+         continue;
+
+      /* some held buffer must belong to the array */
+      for (b = 0; b < k; b++)
+      {
+         for (c = 0; c < k && cur[b] != own[c]; c++) ;
+         if (c == k)
+            break;
+      }
+
+      flint_mpn_copyi(cur[b], ii[j], limbs + 1);
+      SWAP_PTRS(ii[j], cur[b]);
+   }
+}
+
+/* precomputed transform of a fixed operand, see flint_mpn_mul_fft_precache */
+typedef struct
+{
+   mp_size_t n1;      /* maximum number of limbs of the other operand */
+   mp_size_t n2;      /* number of limbs of the fixed operand */
+   mp_bitcnt_t depth;
+   mp_size_t limbs;   /* limbs per coefficient of the transform */
+   mp_bitcnt_t bits;  /* bits per coefficient the operands are split into */
+   mp_size_t j2;      /* number of coefficients of the fixed operand */
+   mp_limb_t ** jj;   /* the transform of the fixed operand */
+} fft_mul_precache_struct;
+
+typedef fft_mul_precache_struct fft_mul_precache_t[1];
+
 /* used for generating random values mod p in test code */
 #define random_fermat(nn, state, limbs) \
    do { \
@@ -251,6 +306,14 @@ void fft_mfa_truncate_sqrt2_inner(mp_limb_t ** ii, mp_limb_t ** jj,
             mp_size_t n, mp_bitcnt_t w, mp_limb_t ** t1, mp_limb_t ** t2, 
                 mp_limb_t ** temp, mp_size_t n1, mp_size_t trunc, mp_limb_t * tt);
 
+void fft_mfa_truncate_sqrt2_inner_precache(mp_limb_t ** ii, mp_limb_t ** jj, 
+            mp_size_t n, mp_bitcnt_t w, mp_limb_t ** t1, mp_limb_t ** t2, 
+                mp_limb_t ** temp, mp_size_t n1, mp_size_t trunc, mp_limb_t * tt);
+
+void fft_mfa_truncate_sqrt2_inner_forward(mp_limb_t ** ii, mp_size_t n, 
+                       mp_bitcnt_t w, mp_limb_t ** t1, mp_limb_t ** t2, 
+                                              mp_size_t n1, mp_size_t trunc);
+
 void ifft_mfa_truncate_sqrt2_outer(mp_limb_t ** ii, mp_size_t n, 
                         mp_bitcnt_t w, mp_limb_t ** t1, mp_limb_t ** t2, 
                                 mp_limb_t ** temp, mp_size_t n1, mp_size_t trunc);
@@ -279,6 +342,21 @@ void fft_convolution(mp_limb_t ** ii, mp_limb_t ** jj, slong depth,
                                  slong limbs, slong trunc, mp_limb_t ** t1, 
                                 mp_limb_t ** t2, mp_limb_t ** s1, mp_limb_t * tt);
 
+void fft_precache(mp_limb_t ** jj, slong depth, slong limbs, slong trunc, 
+                           mp_limb_t ** t1, mp_limb_t ** t2, mp_limb_t ** s1);
+
+void fft_convolution_precache(mp_limb_t ** ii, mp_limb_t ** jj, slong depth, 
+                                 slong limbs, slong trunc, mp_limb_t ** t1, 
+                                mp_limb_t ** t2, mp_limb_t ** s1, mp_limb_t * tt);
+
+void fft_mul_precache_init(fft_mul_precache_t pre, 
+                                mp_srcptr i2, mp_size_t n2, mp_size_t n1);
+
+void fft_mul_precache_clear(fft_mul_precache_t pre);
+
+void flint_mpn_mul_fft_precache(mp_ptr r1, mp_srcptr i1, mp_size_t n1, 
+                                              const fft_mul_precache_t pre);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,100 @@
+/*
+
+Copyright 2008-2011 William Hart. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are
+permitted provided that the following conditions are met:
+
+   1. Redistributions of source code must retain the above copyright notice, this list of
+      conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above copyright notice, this list
+      of conditions and the following disclaimer in the documentation and/or other materials
+      provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY William Hart ``AS IS'' AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL William Hart OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those of the
+authors and should not be interpreted as representing official policies, either expressed
+or implied, of William Hart.
+
+*/
+
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "fft.h"
+
+void fft_precache(mp_limb_t ** jj, slong depth, slong limbs, slong trunc, 
+               mp_limb_t ** t1, mp_limb_t ** t2, mp_limb_t ** s1)
+{
+   slong n = (1L<<depth), j;
+   slong w = (limbs*FLINT_BITS)/n;
+   slong sqrt = (1L<<(depth/2));
+   
+   if (depth <= 6)
+   {
+      trunc = 2*((trunc + 1)/2);
+      
+      fft_truncate_sqrt2(jj, n, w, t1, t2, s1, trunc);
+   
+      for (j = 0; j < trunc; j++)
+         mpn_normmod_2expp1(jj[j], limbs);
+   } else
+   {
+      trunc = 2*sqrt*((trunc + 2*sqrt - 1)/(2*sqrt));
+      
+      fft_mfa_truncate_sqrt2_outer(jj, n, w, t1, t2, s1, sqrt, trunc);
+      
+      fft_mfa_truncate_sqrt2_inner_forward(jj, n, w, t1, t2, sqrt, trunc);
+   }
+}
+
+void fft_convolution_precache(mp_limb_t ** ii, mp_limb_t ** jj, slong depth, 
+                              slong limbs, slong trunc, mp_limb_t ** t1, 
+                          mp_limb_t ** t2, mp_limb_t ** s1, mp_limb_t * tt)
+{
+   slong n = (1L<<depth), j;
+   slong w = (limbs*FLINT_BITS)/n;
+   slong sqrt = (1L<<(depth/2));
+   
+   if (depth <= 6)
+   {
+      trunc = 2*((trunc + 1)/2);
+      
+      fft_truncate_sqrt2(ii, n, w, t1, t2, s1, trunc);
+   
+      for (j = 0; j < trunc; j++)
+      {
+         mpn_normmod_2expp1(ii[j], limbs);
+         
+         fft_mulmod_2expp1(ii[j], ii[j], jj[j], n, w, tt);
+      }
+
+      ifft_truncate_sqrt2(ii, n, w, t1, t2, s1, trunc);
+
+      for (j = 0; j < trunc; j++)
+      {
+         mpn_div_2expmod_2expp1(ii[j], ii[j], limbs, depth + 2);
+         mpn_normmod_2expp1(ii[j], limbs);
+      }
+   } else
+   {
+      trunc = 2*sqrt*((trunc + 2*sqrt - 1)/(2*sqrt));
+      
+      fft_mfa_truncate_sqrt2_outer(ii, n, w, t1, t2, s1, sqrt, trunc);
+      
+      fft_mfa_truncate_sqrt2_inner_precache(ii, jj, n, w, 
+                                            t1, t2, s1, sqrt, trunc, tt);
+      
+      ifft_mfa_truncate_sqrt2_outer(ii, n, w, t1, t2, s1, sqrt, trunc);
+   }
+}
@@ -32,6 +32,7 @@ or implied, of William Hart.
 #include "flint.h"
 #include "ulong_extras.h"
 #include "fft.h"
+#include "thread_pool.h"
       
 void fft_butterfly_twiddle(mp_limb_t * u, mp_limb_t * v, 
     mp_limb_t * s, mp_limb_t * t, mp_size_t limbs, mp_bitcnt_t b1, mp_bitcnt_t b2)
@@ -237,89 +238,170 @@ void fft_mfa_truncate_sqrt2(mp_limb_t ** ii, mp_size_t n,
    }
 }
 
-void fft_mfa_truncate_sqrt2_outer(mp_limb_t ** ii, mp_size_t n, 
+/* 
+   Outer layers of the transform on column i of both halves. The column
+   of the second half depends only on the same column of the first half.
+*/
+static void
+_fft_mfa_outer_column(mp_limb_t ** ii, mp_size_t n, 
                    mp_bitcnt_t w, mp_limb_t ** t1, mp_limb_t ** t2, 
-                             mp_limb_t ** temp, mp_size_t n1, mp_size_t trunc)
+      mp_limb_t ** temp, mp_size_t n1, mp_size_t trunc, mp_size_t i)
 {
-   mp_size_t i, j;
+   mp_size_t j;
    mp_size_t n2 = (2*n)/n1;
    mp_size_t trunc2 = (trunc - 2*n)/n1;
    mp_size_t limbs = (n*w)/FLINT_BITS;
    mp_bitcnt_t depth = 0;
-   mp_bitcnt_t depth2 = 0;
    
    while ((1UL<<depth) < n2) depth++;
-   while ((1UL<<depth2) < n1) depth2++;
 
    /* first half matrix fourier FFT : n2 rows, n1 cols */
    
-   /* FFTs on columns */
-   for (i = 0; i < n1; i++)
-   {   
-      /* relevant part of first layer of full sqrt2 FFT */
-      if (w & 1)
-      {
-         for (j = i; j < trunc - 2*n; j+=n1) 
-         {   
-            if (j & 1)
-               fft_butterfly_sqrt2(*t1, *t2, ii[j], ii[2*n+j], j, limbs, w, *temp);
-            else
-               fft_butterfly(*t1, *t2, ii[j], ii[2*n+j], j/2, limbs, w);     
+   /* relevant part of first layer of full sqrt2 FFT */
+   if (w & 1)
+   {
+      for (j = i; j < trunc - 2*n; j+=n1) 
+      {   
+         if (j & 1)
+            fft_butterfly_sqrt2(*t1, *t2, ii[j], ii[2*n+j], j, limbs, w, *temp);
+         else
+            fft_butterfly(*t1, *t2, ii[j], ii[2*n+j], j/2, limbs, w);     
 
-            SWAP_PTRS(ii[j],     *t1);
-            SWAP_PTRS(ii[2*n+j], *t2);
-         }
+         SWAP_PTRS(ii[j],     *t1);
+         SWAP_PTRS(ii[2*n+j], *t2);
+      }
 
-         for ( ; j < 2*n; j+=n1)
-         {
-             if (i & 1)
-                fft_adjust_sqrt2(ii[j + 2*n], ii[j], j, limbs, w, *temp); 
-             else
-                fft_adjust(ii[j + 2*n], ii[j], j/2, limbs, w); 
-         }
-      } else
+      for ( ; j < 2*n; j+=n1)
       {
-         for (j = i; j < trunc - 2*n; j+=n1) 
-         {   
-            fft_butterfly(*t1, *t2, ii[j], ii[2*n+j], j, limbs, w/2);
+          if (i & 1)
+             fft_adjust_sqrt2(ii[j + 2*n], ii[j], j, limbs, w, *temp); 
+          else
+             fft_adjust(ii[j + 2*n], ii[j], j/2, limbs, w); 
+      }
+   } else
+   {
+      for (j = i; j < trunc - 2*n; j+=n1) 
+      {   
+         fft_butterfly(*t1, *t2, ii[j], ii[2*n+j], j, limbs, w/2);
    
-            SWAP_PTRS(ii[j],     *t1);
-            SWAP_PTRS(ii[2*n+j], *t2);
-         }
-
-         for ( ; j < 2*n; j+=n1)
-            fft_adjust(ii[j + 2*n], ii[j], j, limbs, w/2);
+         SWAP_PTRS(ii[j],     *t1);
+         SWAP_PTRS(ii[2*n+j], *t2);
       }
+
+      for ( ; j < 2*n; j+=n1)
+         fft_adjust(ii[j + 2*n], ii[j], j, limbs, w/2);
+   }
    
-      /* 
-         FFT of length n2 on column i, applying z^{r*i} for rows going up in steps 
-         of 1 starting at row 0, where z => w bits
-      */
+   /* 
+      FFT of length n2 on column i, applying z^{r*i} for rows going up in steps 
+      of 1 starting at row 0, where z => w bits
+   */
       
-      fft_radix2_twiddle(ii + i, n1, n2/2, w*n1, t1, t2, w, 0, i, 1);
-      for (j = 0; j < n2; j++)
-      {
-         mp_size_t s = n_revbin(j, depth);
-         if (j < s) SWAP_PTRS(ii[i+j*n1], ii[i+s*n1]);
-      }
+   fft_radix2_twiddle(ii + i, n1, n2/2, w*n1, t1, t2, w, 0, i, 1);
+   for (j = 0; j < n2; j++)
+   {
+      mp_size_t s = n_revbin(j, depth);
+      if (j < s) SWAP_PTRS(ii[i+j*n1], ii[i+s*n1]);
    }
       
    /* second half matrix fourier FFT : n2 rows, n1 cols */
    ii += 2*n;
 
-   /* FFTs on columns */
-   for (i = 0; i < n1; i++)
-   {   
-      /*
-         FFT of length n2 on column i, applying z^{r*i} for rows going up in steps 
-         of 1 starting at row 0, where z => w bits
-      */
+   /*
+      FFT of length n2 on column i, applying z^{r*i} for rows going up in steps 
+      of 1 starting at row 0, where z => w bits
+   */
       
-      fft_truncate1_twiddle(ii + i, n1, n2/2, w*n1, t1, t2, w, 0, i, 1, trunc2);
-      for (j = 0; j < n2; j++)
-      {
-         mp_size_t s = n_revbin(j, depth);
-         if (j < s) SWAP_PTRS(ii[i+j*n1], ii[i+s*n1]);
-      }
+   fft_truncate1_twiddle(ii + i, n1, n2/2, w*n1, t1, t2, w, 0, i, 1, trunc2);
+   for (j = 0; j < n2; j++)
+   {
+      mp_size_t s = n_revbin(j, depth);
+      if (j < s) SWAP_PTRS(ii[i+j*n1], ii[i+s*n1]);
+   }
+}
+
+typedef struct
+{
+   mp_limb_t ** ii;
+   mp_size_t n;
+   mp_bitcnt_t w;
+   mp_size_t n1;
+   mp_size_t trunc;
+   mp_size_t start;
+   mp_size_t stop;
+} _fft_mfa_outer_arg_t;
+
+static void
+_fft_mfa_outer_worker(void * arg_ptr)
+{
+   _fft_mfa_outer_arg_t * arg = (_fft_mfa_outer_arg_t *) arg_ptr;
+   mp_size_t n = arg->n, n1 = arg->n1, i;
+   mp_size_t limbs = (n*arg->w)/FLINT_BITS;
+   mp_limb_t * own[2], * cur[2], * temp;
+
+   own[0] = flint_malloc((3*(limbs + 1))*sizeof(mp_limb_t));
+   own[1] = own[0] + limbs + 1;
+   temp = own[1] + limbs + 1;
+   cur[0] = own[0];
+   cur[1] = own[1];
+
+   for (i = arg->start; i < arg->stop; i++)
+      _fft_mfa_outer_column(arg->ii, n, arg->w, cur + 0, cur + 1, &temp,
+                                                      n1, arg->trunc, i);
+
+   for (i = arg->start; i < arg->stop; i++)
+      _fft_reclaim_scratch(arg->ii, i, 4*n, n1, own, cur, 2, limbs);
+
+   flint_free(own[0]);
+}
+
+void fft_mfa_truncate_sqrt2_outer(mp_limb_t ** ii, mp_size_t n, 
+                   mp_bitcnt_t w, mp_limb_t ** t1, mp_limb_t ** t2, 
+                             mp_limb_t ** temp, mp_size_t n1, mp_size_t trunc)
+{
+   mp_size_t i;
+   mp_size_t limbs = (n*w)/FLINT_BITS;
+   slong num_workers;
+   thread_pool_handle * threads;
+   _fft_mfa_outer_arg_t * args;
+
+   /* the columns are independent */
+   num_workers = flint_request_threads(&threads, 
+                   FLINT_MIN(n1, (2*n*(limbs + 1))/FFT_MFA_THREAD_LIMBS));
+
+   if (num_workers == 0)
+   {
+      flint_give_back_threads(threads, num_workers);
+
+      for (i = 0; i < n1; i++)
+         _fft_mfa_outer_column(ii, n, w, t1, t2, temp, n1, trunc, i);
+
+      return;
    }
+
+   args = flint_malloc((num_workers + 1)*sizeof(_fft_mfa_outer_arg_t));
+
+   for (i = 0; i <= num_workers; i++)
+   {
+      args[i].ii = ii;
+      args[i].n = n;
+      args[i].w = w;
+      args[i].n1 = n1;
+      args[i].trunc = trunc;
+      args[i].start = (i*n1)/(num_workers + 1);
+      args[i].stop = ((i + 1)*n1)/(num_workers + 1);
+   }
+
+   for (i = 0; i < num_workers; i++)
+      thread_pool_wake(global_thread_pool, threads[i],
+                       _fft_mfa_outer_worker, &args[i]);
+
+   _fft_mfa_outer_worker(&args[num_workers]);
+
+   for (i = 0; i < num_workers; i++)
+      thread_pool_wait(global_thread_pool, threads[i]);
+
+   flint_give_back_threads(threads, num_workers);
+
+   flint_free(args);
 }
@@ -32,60 +32,190 @@ or implied, of William Hart.
 #include "flint.h"
 #include "ulong_extras.h"
 #include "fft.h"
+#include "thread_pool.h"
 
-void fft_mfa_truncate_sqrt2_inner(mp_limb_t ** ii, mp_limb_t ** jj, mp_size_t n, 
+/* what the inner layers compute on each row */
+#define MFA_INNER_CONV     0 /* transform ii and jj, multiply, inverse */
+#define MFA_INNER_PRECACHE 1 /* jj is already transformed */
+#define MFA_INNER_FORWARD  2 /* transform and normalise ii only */
+
+/* convolution on the row of length n1 starting at ii, jj */
+static void
+_fft_mfa_inner_row(mp_limb_t ** ii, mp_limb_t ** jj, mp_size_t n, 
                    mp_bitcnt_t w, mp_limb_t ** t1, mp_limb_t ** t2, 
-                  mp_limb_t ** temp, mp_size_t n1, mp_size_t trunc, mp_limb_t * tt)
+                   mp_size_t n1, mp_size_t n2, mp_limb_t * tt, int mode)
+{
+   mp_size_t j;
+   mp_size_t limbs = (n*w)/FLINT_BITS;
+   int fft_jj = (mode == MFA_INNER_CONV && ii != jj);
+
+   fft_radix2(ii, n1/2, w*n2, t1, t2);
+   if (fft_jj) fft_radix2(jj, n1/2, w*n2, t1, t2);
+      
+   for (j = 0; j < n1; j++)
+   {
+      mpn_normmod_2expp1(ii[j], limbs);
+      if (fft_jj) mpn_normmod_2expp1(jj[j], limbs);
+      if (mode != MFA_INNER_FORWARD)
+         fft_mulmod_2expp1(ii[j], ii[j], jj[j], n, w, tt);
+   }      
+      
+   if (mode != MFA_INNER_FORWARD)
+      ifft_radix2(ii, n1/2, w*n2, t1, t2);
+}
+
+/* 
+   Offset of row s, where rows 0, ..., trunc2 - 1 are the relevant rows
+   of the second half in bit reversed order and the remaining n2 rows are
+   those of the first half.
+*/
+static mp_size_t
+_fft_mfa_inner_row_offset(mp_size_t s, mp_size_t n, mp_size_t n1, 
+                          mp_size_t trunc2, mp_bitcnt_t depth)
+{
+   if (s < trunc2)
+      return 2*n + n_revbin(s, depth)*n1;
+   else
+      return (s - trunc2)*n1;
+}
+
+typedef struct
+{
+   mp_limb_t ** ii;
+   mp_limb_t ** jj;
+   mp_size_t n;
+   mp_bitcnt_t w;
+   mp_size_t n1;
+   mp_size_t trunc2;
+   mp_bitcnt_t depth;
+   mp_size_t start;
+   mp_size_t stop;
+   int mode;
+} _fft_mfa_inner_arg_t;
+
+static void
+_fft_mfa_inner_worker(void * arg_ptr)
+{
+   _fft_mfa_inner_arg_t * arg = (_fft_mfa_inner_arg_t *) arg_ptr;
+   mp_size_t n = arg->n, n1 = arg->n1, n2 = (2*n)/n1;
+   mp_size_t limbs = (n*arg->w)/FLINT_BITS;
+   mp_limb_t ** ii = arg->ii, ** jj = arg->jj;
+   mp_limb_t * own[2], * cur[2], * tt;
+   mp_size_t s, off;
+
+   own[0] = flint_malloc((4*(limbs + 1))*sizeof(mp_limb_t));
+   own[1] = own[0] + limbs + 1;
+   tt = own[1] + limbs + 1;
+   cur[0] = own[0];
+   cur[1] = own[1];
+
+   for (s = arg->start; s < arg->stop; s++)
+   {
+      off = _fft_mfa_inner_row_offset(s, n, n1, arg->trunc2, arg->depth);
+      _fft_mfa_inner_row(ii + off, jj + off, n, arg->w,
+                         cur + 0, cur + 1, n1, n2, tt, arg->mode);
+   }
+
+   for (s = arg->start; s < arg->stop; s++)
+   {
+      off = _fft_mfa_inner_row_offset(s, n, n1, arg->trunc2, arg->depth);
+      _fft_reclaim_scratch(ii, off, off + n1, 1, own, cur, 2, limbs);
+      if (arg->mode == MFA_INNER_CONV && ii != jj)
+         _fft_reclaim_scratch(jj, off, off + n1, 1, own, cur, 2, limbs);
+   }
+
+   flint_free(own[0]);
+}
+
+static void
+_fft_mfa_truncate_sqrt2_inner(mp_limb_t ** ii, mp_limb_t ** jj, mp_size_t n, 
+                   mp_bitcnt_t w, mp_limb_t ** t1, mp_limb_t ** t2, 
+                   mp_size_t n1, mp_size_t trunc, mp_limb_t * tt, int mode)
 {
-   mp_size_t i, j, s;
+   mp_size_t i, s, num_rows, off;
    mp_size_t n2 = (2*n)/n1;
    mp_size_t trunc2 = (trunc - 2*n)/n1;
    mp_size_t limbs = (n*w)/FLINT_BITS;
    mp_bitcnt_t depth = 0;
-   mp_bitcnt_t depth2 = 0;
+   slong num_workers;
+   thread_pool_handle * threads;
+   _fft_mfa_inner_arg_t * args;
    
    while ((1UL<<depth) < n2) depth++;
-   while ((1UL<<depth2) < n1) depth2++;
 
-   ii += 2*n;
-   jj += 2*n;
+   /* 
+      convolutions on relevant rows of the second half, then on the rows
+      of the first half, which are all independent
+   */
+   num_rows = trunc2 + n2;
 
-   /* convolutions on relevant rows */
-   for (s = 0; s < trunc2; s++)
+   num_workers = flint_request_threads(&threads, FLINT_MIN(num_rows,
+                                 (2*n*(limbs + 1))/FFT_MFA_THREAD_LIMBS));
+
+   if (num_workers == 0)
    {
-      i = n_revbin(s, depth);
-      fft_radix2(ii + i*n1, n1/2, w*n2, t1, t2);
-      if (ii != jj) fft_radix2(jj + i*n1, n1/2, w*n2, t1, t2);
-      
-      for (j = 0; j < n1; j++)
+      flint_give_back_threads(threads, num_workers);
+
+      for (s = 0; s < num_rows; s++)
       {
-         mp_size_t t = i*n1 + j;
-         mpn_normmod_2expp1(ii[t], limbs);
-         if (ii != jj) mpn_normmod_2expp1(jj[t], limbs);
-         fft_mulmod_2expp1(ii[t], ii[t], jj[t], n, w, tt);
-      }      
-      
-      ifft_radix2(ii + i*n1, n1/2, w*n2, t1, t2);
+         off = _fft_mfa_inner_row_offset(s, n, n1, trunc2, depth);
+         _fft_mfa_inner_row(ii + off, jj + off, n, w, t1, t2, 
+                                                   n1, n2, tt, mode);
+      }
+
+      return;
    }
 
-   ii -= 2*n;
-   jj -= 2*n;
+   args = flint_malloc((num_workers + 1)*sizeof(_fft_mfa_inner_arg_t));
 
-   /* convolutions on rows */
-   for (i = 0; i < n2; i++)
+   for (i = 0; i <= num_workers; i++)
    {
-      fft_radix2(ii + i*n1, n1/2, w*n2, t1, t2);
-      if (ii != jj) fft_radix2(jj + i*n1, n1/2, w*n2, t1, t2);
-
-      for (j = 0; j < n1; j++)
-      {
-         mp_size_t t = i*n1 + j;
-         mpn_normmod_2expp1(ii[t], limbs);
-         if (ii != jj) mpn_normmod_2expp1(jj[t], limbs);
-         fft_mulmod_2expp1(ii[t], ii[t], jj[t], n, w, tt);
-      }      
-      
-      ifft_radix2(ii + i*n1, n1/2, w*n2, t1, t2);
+      args[i].ii = ii;
+      args[i].jj = jj;
+      args[i].n = n;
+      args[i].w = w;
+      args[i].n1 = n1;
+      args[i].trunc2 = trunc2;
+      args[i].depth = depth;
+      args[i].start = (i*num_rows)/(num_workers + 1);
+      args[i].stop = ((i + 1)*num_rows)/(num_workers + 1);
+      args[i].mode = mode;
    }
+
+   for (i = 0; i < num_workers; i++)
+      thread_pool_wake(global_thread_pool, threads[i],
+                       _fft_mfa_inner_worker, &args[i]);
+
+   _fft_mfa_inner_worker(&args[num_workers]);
+
+   for (i = 0; i < num_workers; i++)
+      thread_pool_wait(global_thread_pool, threads[i]);
+
+   flint_give_back_threads(threads, num_workers);
+
+   flint_free(args);
+}
+
+void fft_mfa_truncate_sqrt2_inner(mp_limb_t ** ii, mp_limb_t ** jj, mp_size_t n, 
+                   mp_bitcnt_t w, mp_limb_t ** t1, mp_limb_t ** t2, 
+                  mp_limb_t ** temp, mp_size_t n1, mp_size_t trunc, mp_limb_t * tt)
+{
+   _fft_mfa_truncate_sqrt2_inner(ii, jj, n, w, t1, t2, 
+                                 n1, trunc, tt, MFA_INNER_CONV);
 }
 
+void fft_mfa_truncate_sqrt2_inner_precache(mp_limb_t ** ii, mp_limb_t ** jj, 
+                   mp_size_t n, mp_bitcnt_t w, mp_limb_t ** t1, mp_limb_t ** t2, 
+                  mp_limb_t ** temp, mp_size_t n1, mp_size_t trunc, mp_limb_t * tt)
+{
+   _fft_mfa_truncate_sqrt2_inner(ii, jj, n, w, t1, t2, 
+                                 n1, trunc, tt, MFA_INNER_PRECACHE);
+}
+
+void fft_mfa_truncate_sqrt2_inner_forward(mp_limb_t ** ii, mp_size_t n, 
+                   mp_bitcnt_t w, mp_limb_t ** t1, mp_limb_t ** t2, 
+                                              mp_size_t n1, mp_size_t trunc)
+{
+   _fft_mfa_truncate_sqrt2_inner(ii, ii, n, w, t1, t2, 
+                                 n1, trunc, NULL, MFA_INNER_FORWARD);
+}
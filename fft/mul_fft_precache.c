@@ -0,0 +1,182 @@
+/*
+
+Copyright 2008-2011 William Hart. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are
+permitted provided that the following conditions are met:
+
+   1. Redistributions of source code must retain the above copyright notice, this list of
+      conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above copyright notice, this list
+      of conditions and the following disclaimer in the documentation and/or other materials
+      provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY William Hart ``AS IS'' AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL William Hart OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those of the
+authors and should not be interpreted as representing official policies, either expressed
+or implied, of William Hart.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "gmp.h"
+#include "flint.h"
+#include "fft.h"
+#include "ulong_extras.h"
+#include "fft_tuning.h"
+
+static int fft_tuning_table[5][2] = FFT_TAB;
+
+void fft_mul_precache_init(fft_mul_precache_t pre, 
+                                 mp_srcptr i2, mp_size_t n2, mp_size_t n1)
+{
+   mp_size_t off, depth = 6;
+   mp_size_t w = 1;
+   mp_size_t n = ((mp_size_t) 1 << depth);
+   mp_bitcnt_t bits = (n*w - (depth+1))/2;
+
+   mp_bitcnt_t bits1 = n1*FLINT_BITS;
+   mp_bitcnt_t bits2 = n2*FLINT_BITS;
+
+   mp_size_t j1 = (bits1 - 1)/bits + 1;
+   mp_size_t j2 = (bits2 - 1)/bits + 1;
+
+   mp_size_t i, j, size, trunc;
+   mp_limb_t ** jj, * t1, * t2, * s1, * ptr;
+
+   FLINT_ASSERT(n1 > 0);
+   FLINT_ASSERT(n2 > 0);
+
+   /* choose n and w exactly as flint_mpn_mul_fft_main would */
+   while (j1 + j2 - 1 > 4*n)
+   {
+      if (w == 1) w = 2;
+      else 
+      {
+         depth++;
+         w = 1;
+         n *= 2;
+      }
+
+      bits = (n*w - (depth+1))/2;
+      j1 = (bits1 - 1)/bits + 1;
+      j2 = (bits2 - 1)/bits + 1;
+   }
+   
+   if (depth < 11)
+   {
+      mp_size_t wadj = 1;
+      
+      off = fft_tuning_table[depth - 6][w - 1]; /* adjust n and w */
+      depth -= off;
+      n = ((mp_size_t) 1 << depth);
+      w *= ((mp_size_t) 1 << (2*off));
+      
+      if (depth < 6) wadj = ((mp_size_t) 1 << (6 - depth));
+
+      if (w > wadj)
+      {
+         do { /* see if a smaller w will work */
+            w -= wadj;
+            bits = (n*w - (depth+1))/2;
+            j1 = (bits1 - 1)/bits + 1;
+            j2 = (bits2 - 1)/bits + 1;
+         } while (j1 + j2 - 1 <= 4*n && w > wadj);  
+         w += wadj;
+      }
+   } else if (j1 + j2 - 1 <= 3*n)
+   {
+      depth--;
+      n /= 2;
+      w *= 3;
+   }
+
+   bits = (n*w - (depth+1))/2;
+
+   pre->n1 = n1;
+   pre->n2 = n2;
+   pre->depth = depth;
+   pre->limbs = (n*w)/FLINT_BITS;
+   pre->bits = bits;
+
+   size = pre->limbs + 1;
+
+   jj = flint_malloc((4*(n + n*size) + 3*size)*sizeof(mp_limb_t));
+   for (i = 0, ptr = (mp_limb_t *) jj + 4*n; i < 4*n; i++, ptr += size) 
+      jj[i] = ptr;
+   t1 = ptr;
+   t2 = t1 + size;
+   s1 = t2 + size;
+
+   pre->j2 = fft_split_bits(jj, i2, n2, bits, pre->limbs);
+   for (j = pre->j2; j < 4*n; j++)
+      flint_mpn_zero(jj[j], pre->limbs + 1);
+
+   /* the longest product that will be required */
+   trunc = (n1*FLINT_BITS - 1)/bits + 1 + pre->j2 - 1;
+   if (trunc <= 2*n) trunc = 2*n + 1; /* trunc must be greater than 2n */
+
+   fft_precache(jj, depth, pre->limbs, trunc, &t1, &t2, &s1);
+
+   /* 
+      the transform may have swapped the scratch space into jj, so the
+      pointers are kept together with the block they point into
+   */
+   pre->jj = jj;
+}
+
+void fft_mul_precache_clear(fft_mul_precache_t pre)
+{
+   flint_free(pre->jj);
+}
+
+void flint_mpn_mul_fft_precache(mp_ptr r1, mp_srcptr i1, mp_size_t n1, 
+                                               const fft_mul_precache_t pre)
+{
+   mp_size_t n = ((mp_size_t) 1 << pre->depth);
+   mp_size_t limbs = pre->limbs;
+   mp_size_t size = limbs + 1;
+   mp_size_t r_limbs = n1 + pre->n2;
+   mp_size_t i, j1, trunc;
+   mp_limb_t ** ii, * t1, * t2, * s1, * tt, * ptr;
+
+   if (n1 > pre->n1)
+   {
+      printf("Exception (flint_mpn_mul_fft_precache). Operand too long.\n");
+      abort();
+   }
+
+   ii = flint_malloc((4*(n + n*size) + 5*size)*sizeof(mp_limb_t));
+   for (i = 0, ptr = (mp_limb_t *) ii + 4*n; i < 4*n; i++, ptr += size) 
+      ii[i] = ptr;
+   t1 = ptr;
+   t2 = t1 + size;
+   s1 = t2 + size;
+   tt = s1 + size;
+
+   j1 = fft_split_bits(ii, i1, n1, pre->bits, limbs);
+   for (i = j1; i < 4*n; i++)
+      flint_mpn_zero(ii[i], limbs + 1);
+
+   trunc = j1 + pre->j2 - 1;
+   if (trunc <= 2*n) trunc = 2*n + 1; /* trunc must be greater than 2n */
+
+   fft_convolution_precache(ii, pre->jj, pre->depth, limbs, trunc, 
+                                                     &t1, &t2, &s1, tt);
+
+   flint_mpn_zero(r1, r_limbs);
+   fft_combine_bits(r1, ii, j1 + pre->j2 - 1, pre->bits, limbs, r_limbs);
+
+   flint_free(ii);
+}
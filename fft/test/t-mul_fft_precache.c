@@ -0,0 +1,114 @@
+/* 
+
+Copyright 2009, 2011 William Hart. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are
+permitted provided that the following conditions are met:
+
+   1. Redistributions of source code must retain the above copyright notice, this list of
+      conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above copyright notice, this list
+      of conditions and the following disclaimer in the documentation and/or other materials
+      provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY William Hart ``AS IS'' AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL William Hart OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those of the
+authors and should not be interpreted as representing official policies, either expressed
+or implied, of William Hart.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fft.h"
+
+int
+main(void)
+{
+    slong i, k;
+    
+    flint_rand_t state;
+
+    printf("mul_fft_precache....");
+    fflush(stdout);
+
+    flint_randinit(state);
+    _flint_rand_init_gmp(state);
+
+    for (i = 0; i < 200; i++)
+    {
+        fft_mul_precache_t pre;
+        mp_size_t n1, n2, m, j;
+        mp_limb_t * i1, * i2, * r1, * r2;
+
+        /* occasionally large enough for the matrix Fourier algorithm */
+        if (i % 20 == 0)
+        {
+            n1 = n_randint(state, 40000) + 1;
+            n2 = n_randint(state, 40000) + 1;
+        } else
+        {
+            n1 = n_randint(state, 2000) + 1;
+            n2 = n_randint(state, 2000) + 1;
+        }
+
+        if (i % 2 == 0)
+            flint_set_num_threads(n_randint(state, 4) + 1);
+
+        i1 = flint_malloc((n1 + n2 + 2*(n1 + n2))*sizeof(mp_limb_t));
+        i2 = i1 + n1;
+        r1 = i2 + n2;
+        r2 = r1 + n1 + n2;
+
+        flint_mpn_urandomb(i2, state->gmp_state, n2*FLINT_BITS);
+
+        fft_mul_precache_init(pre, i2, n2, n1);
+
+        for (k = 0; k < 3; k++)
+        {
+            m = n_randint(state, n1) + 1;
+
+            flint_mpn_urandomb(i1, state->gmp_state, m*FLINT_BITS);
+
+            if (m >= n2)
+                mpn_mul(r2, i1, m, i2, n2);
+            else
+                mpn_mul(r2, i2, n2, i1, m);
+
+            flint_mpn_mul_fft_precache(r1, i1, m, pre);
+
+            for (j = 0; j < m + n2; j++)
+            {
+                if (r1[j] != r2[j]) 
+                {
+                    printf("FAIL:\n");
+                    printf("n1 = %ld, n2 = %ld, m = %ld\n", n1, n2, m);
+                    printf("error in limb %ld, %lx != %lx\n", j, r1[j], r2[j]);
+                    abort();
+                }
+            }
+        }
+
+        fft_mul_precache_clear(pre);
+
+        flint_free(i1);
+    }
+
+    flint_set_num_threads(1);
+    flint_randclear(state);
+    
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,19 @@
+/* fft_tuning.h -- autogenerated by tune-fft */
+
+#ifndef FFT_TUNING_H
+#define FFT_TUNING_H
+
+#include "gmp.h"
+
+#define FFT_TAB \
+   { { 4, 4 }, { 4, 3 }, { 3, 2 }, { 2, 1 }, { 2, 1 } }
+
+#define MULMOD_TAB \
+   { 4, 4, 4, 4, 4, 3, 3, 3, 3, 3, 3, 3, 2, 2, 2, 2, 2, 1, 1 }
+
+#define FFT_N_NUM 19
+
+#define FFT_MULMOD_2EXPP1_CUTOFF 128
+
+#endif
+
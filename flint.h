@@ -56,6 +56,51 @@ void * flint_realloc(void * ptr, size_t size);
 void * flint_calloc(size_t num, size_t size);
 void flint_free(void * ptr);
 
+void __flint_set_memory_functions(void * (* alloc_func)(size_t),
+     void * (* calloc_func)(size_t, size_t), 
+     void * (* realloc_func)(void *, size_t), void (* free_func)(void *));
+
+void __flint_get_memory_functions(void * (** alloc_func)(size_t),
+     void * (** calloc_func)(size_t, size_t), 
+     void * (** realloc_func)(void *, size_t), void (** free_func)(void *));
+
+typedef struct
+{
+    size_t num_allocs;       /* calls to flint_malloc and flint_calloc */
+    size_t num_reallocs;
+    size_t num_frees;
+    size_t bytes_allocated;  /* bytes requested by the above */
+    size_t num_stack_allocs; /* calls to flint_stack_alloc */
+    size_t stack_bytes;      /* bytes requested from the stack */
+    size_t stack_peak;       /* maximum bytes in use on the stack */
+} flint_memory_stats_struct;
+
+typedef flint_memory_stats_struct flint_memory_stats_t[1];
+
+/* 
+   the statistics are per thread: allocations made by the workers of the
+   thread pool are not counted in the statistics of the calling thread
+*/
+void flint_get_memory_stats(flint_memory_stats_t stats);
+void flint_reset_memory_stats(void);
+
+typedef struct
+{
+    void * block;
+    size_t used;
+    size_t in_use;
+} flint_stack_mark_t;
+
+flint_stack_mark_t flint_stack_get_mark(void);
+void * flint_stack_alloc(size_t size);
+void flint_stack_release(flint_stack_mark_t mark);
+
+/* temporaries on the per thread stack, released in LIFO order */
+#define TMP_INIT flint_stack_mark_t __flint_tmp_mark
+#define TMP_START __flint_tmp_mark = flint_stack_get_mark()
+#define TMP_ALLOC(size) flint_stack_alloc(size)
+#define TMP_END flint_stack_release(__flint_tmp_mark)
+
 typedef void (*flint_cleanup_function_t)(void);
 void flint_register_cleanup_function(flint_cleanup_function_t cleanup_function);
 void flint_cleanup(void);
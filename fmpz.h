@@ -67,6 +67,8 @@ void _fmpz_cleanup(void);
 
 __mpz_struct * _fmpz_promote(fmpz_t f);
 
+__mpz_struct * _fmpz_promote_limbs(fmpz_t f, slong limbs);
+
 __mpz_struct * _fmpz_promote_val(fmpz_t f);
 
 static __inline__
@@ -104,8 +106,8 @@ void fmpz_init_set(fmpz_t f, const fmpz_t g)
     {
         __mpz_struct *ptr;
 
-        ptr = _fmpz_new_mpz();
-        *f = PTR_TO_COEFF(ptr);
+        *f = 0L;
+        ptr = _fmpz_promote_limbs(f, FLINT_ABS(COEFF_TO_PTR(*g)->_mp_size));
         mpz_set(ptr, COEFF_TO_PTR(*g));
     }
 }
@@ -382,15 +384,70 @@ fmpz_neg(fmpz_t f1, const fmpz_t f2)
 
 void fmpz_abs(fmpz_t f1, const fmpz_t f2);
 
-void fmpz_add(fmpz_t f, const fmpz_t g, const fmpz_t h);
+/*
+   The arithmetic functions below are inline, but fmpz/inlines.c defines
+   FMPZ_INLINES_C to give them external definitions in the library too,
+   so that they can still be linked against by name.
+*/
+#ifdef FMPZ_INLINES_C
+#define FMPZ_INLINE
+#else
+#define FMPZ_INLINE static __inline__
+#endif
+
+void _fmpz_add_slow(fmpz_t f, const fmpz_t g, const fmpz_t h);
+
+FMPZ_INLINE
+void fmpz_add(fmpz_t f, const fmpz_t g, const fmpz_t h)
+{
+    fmpz c1 = *g, c2 = *h;
+
+    if (!COEFF_IS_MPZ(c1) && !COEFF_IS_MPZ(c2))  /* cannot overflow a slong */
+        fmpz_set_si(f, c1 + c2);
+    else
+        _fmpz_add_slow(f, g, h);
+}
+
+void _fmpz_sub_slow(fmpz_t f, const fmpz_t g, const fmpz_t h);
+
+FMPZ_INLINE
+void fmpz_sub(fmpz_t f, const fmpz_t g, const fmpz_t h)
+{
+    fmpz c1 = *g, c2 = *h;
 
-void fmpz_sub(fmpz_t f, const fmpz_t g, const fmpz_t h);
+    if (!COEFF_IS_MPZ(c1) && !COEFF_IS_MPZ(c2))  /* cannot overflow a slong */
+        fmpz_set_si(f, c1 - c2);
+    else
+        _fmpz_sub_slow(f, g, h);
+}
 
 void fmpz_mul_ui(fmpz_t f, const fmpz_t g, ulong x);
 
 void fmpz_mul_si(fmpz_t f, const fmpz_t g, slong x);
 
-void fmpz_mul(fmpz_t f, const fmpz_t g, const fmpz_t h);
+void _fmpz_mul_slow(fmpz_t f, const fmpz_t g, const fmpz_t h);
+
+FMPZ_INLINE
+void fmpz_mul(fmpz_t f, const fmpz_t g, const fmpz_t h)
+{
+    fmpz c1 = *g, c2 = *h;
+
+    if (!COEFF_IS_MPZ(c1) && !COEFF_IS_MPZ(c2))
+    {
+        mp_limb_t hi, lo;
+
+        smul_ppmm(hi, lo, c1, c2);
+
+        /* product fits in a slong */
+        if (hi == (mp_limb_t) (((slong) lo) >> (FLINT_BITS - 1)))
+        {
+            fmpz_set_si(f, lo);
+            return;
+        }
+    }
+
+    _fmpz_mul_slow(f, g, h);
+}
 
 void fmpz_mul_2exp(fmpz_t f, const fmpz_t g, ulong exp);
 
@@ -402,9 +459,59 @@ void fmpz_addmul_ui(fmpz_t f, const fmpz_t g, ulong x);
 
 void fmpz_submul_ui(fmpz_t f, const fmpz_t g, ulong x);
 
-void fmpz_addmul(fmpz_t f, const fmpz_t g, const fmpz_t h);
+void _fmpz_addmul_slow(fmpz_t f, const fmpz_t g, const fmpz_t h);
+
+void _fmpz_submul_slow(fmpz_t f, const fmpz_t g, const fmpz_t h);
 
-void fmpz_submul(fmpz_t f, const fmpz_t g, const fmpz_t h);
+FMPZ_INLINE
+void fmpz_addmul(fmpz_t f, const fmpz_t g, const fmpz_t h)
+{
+    fmpz c1 = *g, c2 = *h, r = *f;
+
+    if (!COEFF_IS_MPZ(c1) && !COEFF_IS_MPZ(c2) && !COEFF_IS_MPZ(r))
+    {
+        mp_limb_t hi, lo;
+        slong p;
+
+        smul_ppmm(hi, lo, c1, c2);
+        p = (slong) lo;
+
+        /* product is small, so adding it to r cannot overflow a slong */
+        if (hi == (mp_limb_t) (p >> (FLINT_BITS - 1))
+            && p >= COEFF_MIN && p <= COEFF_MAX)
+        {
+            fmpz_set_si(f, r + p);
+            return;
+        }
+    }
+
+    _fmpz_addmul_slow(f, g, h);
+}
+
+FMPZ_INLINE
+void fmpz_submul(fmpz_t f, const fmpz_t g, const fmpz_t h)
+{
+    fmpz c1 = *g, c2 = *h, r = *f;
+
+    if (!COEFF_IS_MPZ(c1) && !COEFF_IS_MPZ(c2) && !COEFF_IS_MPZ(r))
+    {
+        mp_limb_t hi, lo;
+        slong p;
+
+        smul_ppmm(hi, lo, c1, c2);
+        p = (slong) lo;
+
+        /* product is small, so adding it to r cannot overflow a slong */
+        if (hi == (mp_limb_t) (p >> (FLINT_BITS - 1))
+            && p >= COEFF_MIN && p <= COEFF_MAX)
+        {
+            fmpz_set_si(f, r - p);
+            return;
+        }
+    }
+
+    _fmpz_submul_slow(f, g, h);
+}
 
 void fmpz_pow_ui(fmpz_t f, const fmpz_t g, ulong exp);
 
@@ -412,6 +519,34 @@ void fmpz_powm_ui(fmpz_t f, const fmpz_t g, ulong exp, const fmpz_t m);
 
 void fmpz_powm(fmpz_t f, const fmpz_t g, const fmpz_t e, const fmpz_t m);
 
+/*
+   Montgomery form modulo a fixed odd modulus m of n limbs, to amortise the
+   setup over many operations with the same modulus
+*/
+typedef struct
+{
+    fmpz_t m;
+    mp_size_t n;
+    mp_limb_t minv;  /* -1/m mod 2^FLINT_BITS */
+    mp_ptr d;        /* limbs of m */
+    mp_ptr one;      /* R mod m, where R = 2^(FLINT_BITS n) */
+    mp_ptr r2;       /* R^2 mod m */
+}
+fmpz_mont_struct;
+
+typedef fmpz_mont_struct fmpz_mont_t[1];
+
+void fmpz_mont_init(fmpz_mont_t ctx, const fmpz_t m);
+
+void fmpz_mont_clear(fmpz_mont_t ctx);
+
+void _fmpz_mont_set_fmpz(mp_ptr r, const fmpz_t g, const fmpz_mont_t ctx);
+
+void _fmpz_mont_get_fmpz(fmpz_t f, mp_srcptr a, const fmpz_mont_t ctx);
+
+void fmpz_powm_mont(fmpz_t f, const fmpz_t g, const fmpz_t e, 
+                                                    const fmpz_mont_t ctx);
+
 void fmpz_setbit(fmpz_t f, ulong i);
 
 int fmpz_tstbit(const fmpz_t f, ulong i);
@@ -645,6 +780,12 @@ int fmpz_is_probabprime(const fmpz_t p);
 
 int fmpz_is_prime_pseudosquare(const fmpz_t n);
 
+int fmpz_is_strong_probabprime(const fmpz_t n, const fmpz_t a);
+
+int fmpz_is_probabprime_lucas(const fmpz_t n);
+
+int fmpz_is_probabprime_BPSW(const fmpz_t n);
+
 #ifdef __cplusplus
 }
 #endif
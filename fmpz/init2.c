@@ -31,14 +31,8 @@
 void
 fmpz_init2(fmpz_t f, ulong limbs)
 {
+    (*f) = 0L;
+
     if (limbs)
-    {
-        __mpz_struct *mpz_ptr = _fmpz_new_mpz();
-        *f = PTR_TO_COEFF(mpz_ptr);
-        _mpz_realloc(mpz_ptr, limbs);
-    }
-    else
-    {
-        (*f) = 0L;
-    }
+        _fmpz_promote_limbs(f, limbs);
 }
@@ -23,6 +23,8 @@
 
 ******************************************************************************/
 
+#define FMPZ_INLINES_C
+
 #undef ulong /* prevent clash with stdlib */
 #include <stdlib.h>
 #define ulong mp_limb_t
@@ -26,6 +26,7 @@
 #include <gmp.h>
 #include "flint.h"
 #include "ulong_extras.h"
+#include "mpn_extras.h"
 #include "fmpz.h"
 
 int
@@ -40,9 +41,12 @@ fmpz_is_probabprime(const fmpz_t p)
        return n_is_probabprime(c);
     else
     {
-       int ret;
-       
-       ret = (mpz_probab_prime_p(COEFF_TO_PTR(c), 25) != 0);
-       return ret;
+       __mpz_struct * z = COEFF_TO_PTR(c);
+
+       if ((z->_mp_d[0] & 1UL) == 0
+              || flint_mpn_factor_trial(z->_mp_d, z->_mp_size, 1, 64))
+          return 0;
+
+       return fmpz_is_probabprime_BPSW(p);
     }
 }
@@ -0,0 +1,49 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+
+int
+fmpz_is_probabprime_BPSW(const fmpz_t n)
+{
+    fmpz_t b;
+    int result;
+
+    if (fmpz_cmp_ui(n, 1) <= 0)
+        return 0;
+
+    if (!COEFF_IS_MPZ(*n))
+        return n_is_probabprime_BPSW(*n);
+
+    if (fmpz_is_even(n))
+        return 0;
+
+    fmpz_init_set_ui(b, 2);
+
+    result = fmpz_is_strong_probabprime(n, b)
+               && fmpz_is_probabprime_lucas(n);
+
+    fmpz_clear(b);
+
+    return result;
+}
@@ -0,0 +1,164 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "mpn_extras.h"
+
+/* r = a - b mod m, for fully reduced a and b */
+static void
+_mont_sub(mp_ptr r, mp_srcptr a, mp_srcptr b, mp_srcptr m, mp_size_t n)
+{
+    if (mpn_sub_n(r, a, b, n))
+        mpn_add_n(r, r, m, n);
+}
+
+/*
+   Sets (x, y) to (V_m, V_{m+1}) for the Lucas sequence V_0 = 2, V_1 = a,
+   everything being in Montgomery form, with two = 2 R mod n
+*/
+static void
+_fmpz_lchain(mp_ptr x, mp_ptr y, const fmpz_t m, mp_srcptr a,
+                                      mp_srcptr two, const fmpz_mont_t ctx)
+{
+    mp_size_t n = ctx->n;
+    mp_ptr xy, t;
+    slong i;
+    TMP_INIT;
+
+    TMP_START;
+    xy = TMP_ALLOC(3 * n * sizeof(mp_limb_t));
+    t = xy + n;
+
+    flint_mpn_copyi(x, two, n);
+    flint_mpn_copyi(y, a, n);
+
+    for (i = fmpz_bits(m) - 1; i >= 0; i--)
+    {
+        flint_mpn_mont_mul(xy, x, y, t, ctx->d, n, ctx->minv);
+        _mont_sub(xy, xy, a, ctx->d, n);
+
+        if (fmpz_tstbit(m, i))
+        {
+            flint_mpn_mont_sqr(y, y, t, ctx->d, n, ctx->minv);
+            _mont_sub(y, y, two, ctx->d, n);
+            flint_mpn_copyi(x, xy, n);
+        }
+        else
+        {
+            flint_mpn_mont_sqr(x, x, t, ctx->d, n, ctx->minv);
+            _mont_sub(x, x, two, ctx->d, n);
+            flint_mpn_copyi(y, xy, n);
+        }
+    }
+
+    TMP_END;
+}
+
+int
+fmpz_is_probabprime_lucas(const fmpz_t n)
+{
+    fmpz_t A, t, m;
+    fmpz_mont_t ctx;
+    mp_ptr x, y, a, two, u, t2;
+    mp_size_t k;
+    slong i, D, Q;
+    int result;
+
+    if (fmpz_cmp_ui(n, 2) <= 0 || fmpz_is_even(n))
+        return fmpz_cmp_ui(n, 2) == 0;
+
+    if (!COEFF_IS_MPZ(*n))
+        return n_is_probabprime_lucas(*n) == 1;
+
+    /* Selfridge: first D in 5, -7, 9, -11, ... with (D/n) = -1 */
+    fmpz_init(t);
+
+    for (i = 0; ; i++)
+    {
+        D = 5 + 2 * i;
+
+        if (n_gcd(D, fmpz_fdiv_ui(n, D)) != 1UL)
+        {
+            fmpz_clear(t);
+            return 0;
+        }
+
+        if (i % 2 == 1)
+            D = -D;
+
+        fmpz_set_si(t, D);
+        if (fmpz_jacobi(t, n) == -1)
+            break;
+
+        /* no such D exists if n is a square */
+        if (i == 10 && fmpz_is_square(n))
+        {
+            fmpz_clear(t);
+            return 0;
+        }
+    }
+
+    fmpz_init(A);
+    fmpz_init(m);
+
+    /* A = 1/Q - 2 with Q = (1 - D)/4 */
+    Q = (1 - D) / 4;
+    fmpz_set_si(t, Q);
+    fmpz_mod(t, t, n);
+    fmpz_invmod(A, t, n);
+    fmpz_sub_ui(A, A, 2);
+
+    fmpz_mont_init(ctx, n);
+    k = ctx->n;
+
+    x = flint_malloc(5 * k * sizeof(mp_limb_t));
+    y = x + k;
+    a = x + 2 * k;
+    two = x + 3 * k;
+    u = x + 4 * k;
+
+    _fmpz_mont_set_fmpz(a, A, ctx);
+    if (mpn_add_n(two, ctx->one, ctx->one, k)
+        || mpn_cmp(two, ctx->d, k) >= 0)
+        mpn_sub_n(two, two, ctx->d, k);
+
+    fmpz_add_ui(m, n, 1);
+    _fmpz_lchain(x, y, m, a, two, ctx);
+
+    /* A V_m = 2 V_{m+1} mod n */
+    t2 = flint_malloc(2 * k * sizeof(mp_limb_t));
+    flint_mpn_mont_mul(u, x, a, t2, ctx->d, k, ctx->minv);
+    if (mpn_add_n(y, y, y, k) || mpn_cmp(y, ctx->d, k) >= 0)
+        mpn_sub_n(y, y, ctx->d, k);
+
+    result = (mpn_cmp(u, y, k) == 0);
+
+    flint_free(t2);
+    flint_free(x);
+    fmpz_mont_clear(ctx);
+    fmpz_clear(A);
+    fmpz_clear(t);
+    fmpz_clear(m);
+
+    return result;
+}
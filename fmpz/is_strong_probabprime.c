@@ -0,0 +1,85 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "mpn_extras.h"
+
+int
+fmpz_is_strong_probabprime(const fmpz_t n, const fmpz_t a)
+{
+    fmpz_t d, nm1;
+    fmpz_mont_t ctx;
+    mp_ptr y, b, m1, t;
+    mp_limb_t d1;
+    mp_size_t k;
+    slong i, s;
+    int result;
+
+    fmpz_init(d);
+    fmpz_init(nm1);
+
+    fmpz_sub_ui(nm1, n, 1);
+    s = fmpz_val2(nm1);
+    fmpz_fdiv_q_2exp(d, nm1, s);
+
+    /* work in Montgomery form, where 1 is R mod n and -1 is n - R mod n */
+    fmpz_mont_init(ctx, n);
+    k = ctx->n;
+
+    y = flint_malloc(5 * k * sizeof(mp_limb_t));
+    b = y + k;
+    m1 = y + 2 * k;
+    t = y + 3 * k;
+
+    _fmpz_mont_set_fmpz(b, a, ctx);
+    mpn_sub_n(m1, ctx->d, ctx->one, k);
+
+    if (!COEFF_IS_MPZ(*d))
+    {
+        d1 = *d;
+        flint_mpn_mont_powm(y, b, &d1, 1, 
+                                           ctx->one, ctx->d, k, ctx->minv);
+    }
+    else
+        flint_mpn_mont_powm(y, b, COEFF_TO_PTR(*d)->_mp_d, 
+              COEFF_TO_PTR(*d)->_mp_size, ctx->one, ctx->d, k, ctx->minv);
+
+    result = (mpn_cmp(y, ctx->one, k) == 0 || mpn_cmp(y, m1, k) == 0);
+
+    for (i = 1; i < s && !result; i++)
+    {
+        flint_mpn_mont_sqr(y, y, t, ctx->d, k, ctx->minv);
+
+        if (mpn_cmp(y, ctx->one, k) == 0)
+            break;
+
+        result = (mpn_cmp(y, m1, k) == 0);
+    }
+
+    flint_free(y);
+    fmpz_mont_clear(ctx);
+    fmpz_clear(d);
+    fmpz_clear(nm1);
+
+    return result;
+}
@@ -113,6 +113,20 @@ __mpz_struct * _fmpz_promote(fmpz_t f)
         return COEFF_TO_PTR(*f);
 }
 
+__mpz_struct * _fmpz_promote_limbs(fmpz_t f, slong limbs)
+{
+    if (!COEFF_IS_MPZ(*f)) /* f is small so promote it first */
+    {
+        __mpz_struct * mpz_ptr = _fmpz_new_mpz();
+        if (mpz_ptr->_mp_alloc < limbs)
+            _mpz_realloc(mpz_ptr, limbs);
+        (*f) = PTR_TO_COEFF(mpz_ptr);
+        return mpz_ptr;
+    }
+    else /* f is large already, just return the pointer */
+        return COEFF_TO_PTR(*f);
+}
+
 __mpz_struct * _fmpz_promote_val(fmpz_t f)
 {
     fmpz c = (*f);
@@ -31,61 +31,167 @@
 /* Always free larger mpz's to avoid wasting too much heap space */
 #define FLINT_MPZ_MAX_CACHE_LIMBS 64
 
-/* The number of new mpz's allocated at a time */
-#define MPZ_BLOCK 64 
+/* 
+   Cached mpz's are kept in separate free lists according to the number
+   of limbs allocated, class k holding those with 2^(k-1) < alloc <= 2^k,
+   and class 0 those with at most one limb.
+*/
+#define MPZ_CLASSES 7
 
-FLINT_TLS_PREFIX __mpz_struct ** mpz_free_arr = NULL;
-FLINT_TLS_PREFIX ulong mpz_free_num = 0;
-FLINT_TLS_PREFIX ulong mpz_free_alloc = 0;
+/* 
+   The mpz structs themselves are allocated MPZ_BLOCK pages at a time, so
+   that a vector of large fmpz's costs one allocation per entry, namely
+   that of its limbs, and its mpz structs are contiguous. Each page starts
+   with a header giving the thread in whose cache its structs were created
+   and the block it belongs to. The first page counts the structs of the
+   block which have not been cleared.
+*/
+#define MPZ_PAGE_SIZE 4096
+#define MPZ_BLOCK 16
 
-__mpz_struct * _fmpz_new_mpz(void)
+typedef struct
+{
+    void * address; /* the block, as returned by flint_malloc */
+    void * owner;   /* identifies the thread which created the block */
+    slong count;    /* structs of the block not yet cleared, first page */
+    void * first;   /* the first page of the block */
+} mpz_page_header;
+
+#define MPZ_PAGE_OFFSET \
+    (((sizeof(mpz_page_header) - 1)/sizeof(__mpz_struct) + 1)*sizeof(__mpz_struct))
+
+#define MPZ_PER_PAGE ((MPZ_PAGE_SIZE - MPZ_PAGE_OFFSET)/sizeof(__mpz_struct))
+
+#define MPZ_PAGE(ptr) \
+    ((mpz_page_header *) ((ulong) (ptr) & ~((ulong) MPZ_PAGE_SIZE - 1)))
+
+#if defined(__GNUC__)
+#define MPZ_COUNT_DEC(x) __sync_sub_and_fetch(&(x), 1)
+#else
+#define MPZ_COUNT_DEC(x) (--(x))
+#endif
+
+static FLINT_TLS_PREFIX char mpz_thread_tag;
+
+FLINT_TLS_PREFIX __mpz_struct ** mpz_free_arr[MPZ_CLASSES];
+FLINT_TLS_PREFIX ulong mpz_free_num[MPZ_CLASSES];
+FLINT_TLS_PREFIX ulong mpz_free_alloc[MPZ_CLASSES];
+
+static __inline__ int _mpz_class(slong alloc)
+{
+    return alloc <= 1 ? 0 : FLINT_CLOG2(alloc);
+}
+
+static void _fmpz_push_mpz(__mpz_struct * ptr)
 {
-    if (mpz_free_num != 0)
+    int k = _mpz_class(ptr->_mp_alloc);
+
+    if (mpz_free_num[k] == mpz_free_alloc[k])
     {
-        return mpz_free_arr[--mpz_free_num];
+        mpz_free_alloc[k] = FLINT_MAX(64, mpz_free_alloc[k] * 2);
+        mpz_free_arr[k] = flint_realloc(mpz_free_arr[k], 
+                                  mpz_free_alloc[k] * sizeof(__mpz_struct *));
     }
-    else
+
+    mpz_free_arr[k][mpz_free_num[k]++] = ptr;
+}
+
+/* finally clear an mpz struct, releasing its block if it was the last */
+static void _fmpz_release_mpz(__mpz_struct * ptr)
+{
+    mpz_page_header * first = MPZ_PAGE(ptr)->first;
+
+    mpz_clear(ptr);
+
+    if (MPZ_COUNT_DEC(first->count) == 0)
+        flint_free(first->address);
+}
+
+static void _fmpz_new_mpz_block(void)
+{
+    char * address, * page;
+    mpz_page_header * header;
+    slong i, j;
+
+    address = flint_malloc((MPZ_BLOCK + 1)*MPZ_PAGE_SIZE);
+    page = (char *) MPZ_PAGE(address + MPZ_PAGE_SIZE - 1);
+
+    /* push in reverse, so that structs are handed out in address order */
+    for (i = MPZ_BLOCK - 1; i >= 0; i--)
     {
-        __mpz_struct * z = flint_malloc(sizeof(__mpz_struct));
-        mpz_init(z);
-        return z;
+        header = (mpz_page_header *) (page + i*MPZ_PAGE_SIZE);
+        header->address = address;
+        header->owner = &mpz_thread_tag;
+        header->count = MPZ_BLOCK*MPZ_PER_PAGE;
+        header->first = page;
+
+        for (j = MPZ_PER_PAGE - 1; j >= 0; j--)
+        {
+            __mpz_struct * z = (__mpz_struct *) 
+                      ((char *) header + MPZ_PAGE_OFFSET) + j;
+            mpz_init(z);
+            _fmpz_push_mpz(z);
+        }
     }
 }
 
+__mpz_struct * _fmpz_new_mpz(void)
+{
+    int k;
+
+    for (k = 0; k < MPZ_CLASSES; k++)
+    {
+        if (mpz_free_num[k] != 0)
+            return mpz_free_arr[k][--mpz_free_num[k]];
+    }
+
+    _fmpz_new_mpz_block();
+
+    return _fmpz_new_mpz();
+}
+
 void _fmpz_clear_mpz(fmpz f)
 {
     __mpz_struct * ptr = COEFF_TO_PTR(f);
 
-    if (ptr->_mp_alloc > FLINT_MPZ_MAX_CACHE_LIMBS)
-        mpz_realloc2(ptr, 1);
-
-    if (mpz_free_num == mpz_free_alloc)
+    /* structs created by another thread are not cached */
+    if (MPZ_PAGE(ptr)->owner != &mpz_thread_tag)
     {
-        mpz_free_alloc = FLINT_MAX(64, mpz_free_alloc * 2);
-        mpz_free_arr = flint_realloc(mpz_free_arr, mpz_free_alloc * sizeof(__mpz_struct *));
+        _fmpz_release_mpz(ptr);
+        return;
     }
 
-    mpz_free_arr[mpz_free_num++] = ptr;
+    if (ptr->_mp_alloc > FLINT_MPZ_MAX_CACHE_LIMBS)
+        mpz_realloc2(ptr, 1);
+
+    _fmpz_push_mpz(ptr);
 }
 
 void _fmpz_cleanup_mpz_content(void)
 {
     ulong i;
+    int k;
 
-    for (i = 0; i < mpz_free_num; i++)
+    for (k = 0; k < MPZ_CLASSES; k++)
     {
-        mpz_clear(mpz_free_arr[i]);
-        flint_free(mpz_free_arr[i]);
-    }
+        for (i = 0; i < mpz_free_num[k]; i++)
+            _fmpz_release_mpz(mpz_free_arr[k][i]);
 
-    mpz_free_num = mpz_free_alloc = 0;
+        mpz_free_num[k] = mpz_free_alloc[k] = 0;
+    }
 }
 
 void _fmpz_cleanup(void)
 {
+    int k;
+
     _fmpz_cleanup_mpz_content();
-    flint_free(mpz_free_arr);
-    mpz_free_arr = NULL;
+
+    for (k = 0; k < MPZ_CLASSES; k++)
+    {
+        flint_free(mpz_free_arr[k]);
+        mpz_free_arr[k] = NULL;
+    }
 }
 
 __mpz_struct * _fmpz_promote(fmpz_t f)
@@ -100,6 +206,38 @@ __mpz_struct * _fmpz_promote(fmpz_t f)
         return COEFF_TO_PTR(*f);
 }
 
+__mpz_struct * _fmpz_promote_limbs(fmpz_t f, slong limbs)
+{
+    __mpz_struct * mpz_ptr;
+    int k;
+
+    if (COEFF_IS_MPZ(*f)) /* f is large already, just return the pointer */
+        return COEFF_TO_PTR(*f);
+
+    mpz_ptr = NULL;
+
+    /* the smallest cached mpz with enough limbs */
+    for (k = _mpz_class(limbs); k < MPZ_CLASSES; k++)
+    {
+        if (mpz_free_num[k] != 0 
+            && mpz_free_arr[k][mpz_free_num[k] - 1]->_mp_alloc >= limbs)
+        {
+            mpz_ptr = mpz_free_arr[k][--mpz_free_num[k]];
+            break;
+        }
+    }
+
+    if (mpz_ptr == NULL)
+    {
+        mpz_ptr = _fmpz_new_mpz();
+        if (mpz_ptr->_mp_alloc < limbs)
+            _mpz_realloc(mpz_ptr, limbs);
+    }
+
+    (*f) = PTR_TO_COEFF(mpz_ptr);
+    return mpz_ptr;
+}
+
 __mpz_struct * _fmpz_promote_val(fmpz_t f)
 {
     fmpz c = (*f);
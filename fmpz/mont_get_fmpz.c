@@ -0,0 +1,51 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "mpn_extras.h"
+
+void
+_fmpz_mont_get_fmpz(fmpz_t f, mp_srcptr a, const fmpz_mont_t ctx)
+{
+    mp_size_t n = ctx->n;
+    __mpz_struct * z;
+    mp_ptr t;
+    TMP_INIT;
+
+    TMP_START;
+    t = TMP_ALLOC(2 * n * sizeof(mp_limb_t));
+
+    flint_mpn_copyi(t, a, n);
+    flint_mpn_zero(t + n, n);
+
+    z = _fmpz_promote(f);
+    if (z->_mp_alloc < n)
+        mpz_realloc2(z, n * FLINT_BITS);
+
+    flint_mpn_mont_redc(z->_mp_d, t, ctx->d, n, ctx->minv);
+
+    MPN_NORM(z->_mp_d, n);
+    z->_mp_size = n;
+    _fmpz_demote_val(f);
+
+    TMP_END;
+}
@@ -0,0 +1,74 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "mpn_extras.h"
+
+void
+fmpz_mont_init(fmpz_mont_t ctx, const fmpz_t m)
+{
+    __mpz_struct * z;
+    mp_ptr num, q;
+    mp_size_t n;
+
+    if (fmpz_sgn(m) <= 0 || fmpz_is_even(m))
+    {
+        printf("Exception (fmpz_mont_init). Modulus must be odd and positive.\n");
+        abort();
+    }
+
+    fmpz_init_set(ctx->m, m);
+
+    if (!COEFF_IS_MPZ(*m))
+    {
+        n = 1;
+        ctx->d = flint_malloc(3 * n * sizeof(mp_limb_t));
+        ctx->d[0] = *m;
+    }
+    else
+    {
+        z = COEFF_TO_PTR(*m);
+        n = z->_mp_size;
+        ctx->d = flint_malloc(3 * n * sizeof(mp_limb_t));
+        flint_mpn_copyi(ctx->d, z->_mp_d, n);
+    }
+
+    ctx->n = n;
+    ctx->one = ctx->d + n;
+    ctx->r2 = ctx->d + 2 * n;
+    ctx->minv = flint_mpn_mont_minv(ctx->d[0]);
+
+    num = flint_calloc(2 * n + 1, sizeof(mp_limb_t));
+    q = flint_malloc((n + 2) * sizeof(mp_limb_t));
+
+    num[n] = 1;
+    mpn_tdiv_qr(q, ctx->one, 0, num, n + 1, ctx->d, n);
+
+    num[n] = 0;
+    num[2 * n] = 1;
+    mpn_tdiv_qr(q, ctx->r2, 0, num, 2 * n + 1, ctx->d, n);
+
+    flint_free(num);
+    flint_free(q);
+}
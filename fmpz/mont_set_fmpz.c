@@ -0,0 +1,53 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "mpn_extras.h"
+
+void
+_fmpz_mont_set_fmpz(mp_ptr r, const fmpz_t g, const fmpz_mont_t ctx)
+{
+    mp_size_t n = ctx->n;
+    __mpz_struct * z;
+    mp_ptr t;
+    fmpz_t h;
+    TMP_INIT;
+
+    fmpz_init(h);
+    fmpz_mod(h, g, ctx->m);
+
+    flint_mpn_zero(r, n);
+    if (!COEFF_IS_MPZ(*h))
+        r[0] = *h;
+    else
+    {
+        z = COEFF_TO_PTR(*h);
+        flint_mpn_copyi(r, z->_mp_d, z->_mp_size);
+    }
+
+    fmpz_clear(h);
+
+    TMP_START;
+    t = TMP_ALLOC(2 * n * sizeof(mp_limb_t));
+    flint_mpn_mont_mul(r, r, ctx->r2, t, ctx->d, n, ctx->minv);
+    TMP_END;
+}
@@ -29,7 +29,7 @@
 #include "fmpz.h"
 
 void
-fmpz_mul(fmpz_t f, const fmpz_t g, const fmpz_t h)
+_fmpz_mul_slow(fmpz_t f, const fmpz_t g, const fmpz_t h)
 {
     fmpz c1, c2;
     __mpz_struct *mpz_ptr;
@@ -50,10 +50,18 @@ fmpz_mul(fmpz_t f, const fmpz_t g, const fmpz_t h)
         return;
     }
 
-    mpz_ptr = _fmpz_promote(f); /* h is saved, g is already large */
-
     if (!COEFF_IS_MPZ(c2))      /* g is large, h is small */
+    {
+        /* h is saved, g is already large */
+        mpz_ptr = _fmpz_promote_limbs(f,
+                     FLINT_ABS(COEFF_TO_PTR(c1)->_mp_size) + 1);
         mpz_mul_si(mpz_ptr, COEFF_TO_PTR(c1), c2);
+    }
     else                        /* c1 and c2 are large */
+    {
+        mpz_ptr = _fmpz_promote_limbs(f,
+                     FLINT_ABS(COEFF_TO_PTR(c1)->_mp_size)
+                   + FLINT_ABS(COEFF_TO_PTR(c2)->_mp_size));
         mpz_mul(mpz_ptr, COEFF_TO_PTR(c1), COEFF_TO_PTR(c2));
+    }
 }
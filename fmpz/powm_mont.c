@@ -0,0 +1,65 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "mpn_extras.h"
+
+void
+fmpz_powm_mont(fmpz_t f, const fmpz_t g, const fmpz_t e, 
+                                                     const fmpz_mont_t ctx)
+{
+    mp_size_t n = ctx->n, en;
+    mp_srcptr ep;
+    mp_limb_t e1;
+    mp_ptr a, r;
+    TMP_INIT;
+
+    if (fmpz_sgn(e) < 0)
+    {
+        printf("Exception (fmpz_powm_mont). Negative exponent.\n");
+        abort();
+    }
+
+    if (!COEFF_IS_MPZ(*e))
+    {
+        e1 = *e;
+        ep = &e1;
+        en = (e1 != 0);
+    }
+    else
+    {
+        ep = COEFF_TO_PTR(*e)->_mp_d;
+        en = COEFF_TO_PTR(*e)->_mp_size;
+    }
+
+    TMP_START;
+    a = TMP_ALLOC(2 * n * sizeof(mp_limb_t));
+    r = a + n;
+
+    _fmpz_mont_set_fmpz(a, g, ctx);
+    flint_mpn_mont_powm(r, a, ep, en, ctx->one, ctx->d, n, ctx->minv);
+    _fmpz_mont_get_fmpz(f, r, ctx);
+
+    TMP_END;
+}
@@ -41,7 +41,8 @@ fmpz_set(fmpz_t f, const fmpz_t g)
     }
     else                        /* g is large */
     {
-        __mpz_struct *mpz_ptr = _fmpz_promote(f);
+        __mpz_struct *mpz_ptr =
+            _fmpz_promote_limbs(f, FLINT_ABS(COEFF_TO_PTR(*g)->_mp_size));
         mpz_set(mpz_ptr, COEFF_TO_PTR(*g));
     }
 }
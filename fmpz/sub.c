@@ -29,7 +29,7 @@
 #include "fmpz.h"
 
 void
-fmpz_sub(fmpz_t f, const fmpz_t g, const fmpz_t h)
+_fmpz_sub_slow(fmpz_t f, const fmpz_t g, const fmpz_t h)
 {
     fmpz c1 = *g;
     fmpz c2 = *h;
@@ -29,7 +29,7 @@
 #include "fmpz.h"
 
 void
-fmpz_submul(fmpz_t f, const fmpz_t g, const fmpz_t h)
+_fmpz_submul_slow(fmpz_t f, const fmpz_t g, const fmpz_t h)
 {
     fmpz c1 = *g;
     if (!COEFF_IS_MPZ(c1))      /* g is small */
@@ -0,0 +1,221 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+
+/*
+   Checks fmpz_add, fmpz_sub, fmpz_mul, fmpz_addmul and fmpz_submul on 
+   operands at the boundaries of the inline fast paths, with all aliasing
+   patterns, against the corresponding mpz functions.
+*/
+
+#define NUM_VALS 34
+
+typedef void (*fmpz_op)(fmpz_t, const fmpz_t, const fmpz_t);
+typedef void (*mpz_op)(mpz_ptr, mpz_srcptr, mpz_srcptr);
+
+static fmpz vals[NUM_VALS];
+
+static void
+init_vals(void)
+{
+    const slong s = 1L << (FLINT_BITS/2 - 1); /* s^2 = COEFF_MAX + 1 */
+    slong i = 0;
+
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, 0);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, 1);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, -1);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, 2);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, -2);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, 3);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, COEFF_MAX);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, COEFF_MAX - 1);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, COEFF_MAX + 1);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, COEFF_MIN);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, COEFF_MIN + 1);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, COEFF_MIN - 1);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, COEFF_MAX/2);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, COEFF_MAX/2 + 1);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, COEFF_MIN/2);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, COEFF_MIN/2 - 1);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, COEFF_MAX/3);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, COEFF_MAX/3 + 1);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, s);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, s - 1);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, s + 1);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, -s);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, -s + 1);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, -s - 1);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, 2*s);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, -2*s);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, 2*s - 1);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, -2*s + 1);
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, (slong) (~0UL >> 1));
+    fmpz_init(vals + i); fmpz_set_si(vals + i++, -(slong) (~0UL >> 1) - 1);
+    fmpz_init(vals + i); fmpz_set_ui(vals + i++, ~0UL);
+    fmpz_init(vals + i); fmpz_set_ui(vals + i++, COEFF_MAX);
+    fmpz_init(vals + i); fmpz_mul_2exp(vals + i, vals + 6, FLINT_BITS); i++;
+    fmpz_init(vals + i); fmpz_neg(vals + i, vals + i - 1); i++;
+}
+
+static void
+clear_vals(void)
+{
+    slong i;
+
+    for (i = 0; i < NUM_VALS; i++)
+        fmpz_clear(vals + i);
+}
+
+static void
+check(const char * name, const fmpz_t r, const mpz_t e, 
+      const fmpz_t f, const fmpz_t g, const fmpz_t h, const char * alias)
+{
+    mpz_t t;
+    int result;
+
+    mpz_init(t);
+    fmpz_get_mpz(t, r);
+
+    result = (mpz_cmp(t, e) == 0);
+
+    /* results which fit in a small fmpz must be demoted */
+    if (result && COEFF_IS_MPZ(*r) && mpz_cmpabs_ui(t, COEFF_MAX) <= 0)
+        result = 0;
+
+    if (!result)
+    {
+        printf("FAIL (%s, %s):\n", name, alias);
+        printf("f = "), fmpz_print(f), printf("\n");
+        printf("g = "), fmpz_print(g), printf("\n");
+        printf("h = "), fmpz_print(h), printf("\n");
+        printf("r = "), fmpz_print(r), printf("\n");
+        gmp_printf("expected %Zd\n", e);
+        abort();
+    }
+
+    mpz_clear(t);
+}
+
+static void
+test_op(const char * name, fmpz_op op, mpz_op mop)
+{
+    slong i, j, k;
+    fmpz_t f, g, h;
+    mpz_t mf, mg, mh, e;
+
+    fmpz_init(f);
+    fmpz_init(g);
+    fmpz_init(h);
+    mpz_init(mf);
+    mpz_init(mg);
+    mpz_init(mh);
+    mpz_init(e);
+
+    for (i = 0; i < NUM_VALS; i++)
+    {
+        for (j = 0; j < NUM_VALS; j++)
+        {
+            fmpz_get_mpz(mg, vals + i);
+            fmpz_get_mpz(mh, vals + j);
+
+            for (k = 0; k < NUM_VALS; k++)
+            {
+                /* no aliasing */
+                fmpz_set(f, vals + k);
+                fmpz_set(g, vals + i);
+                fmpz_set(h, vals + j);
+                fmpz_get_mpz(e, f);
+                mop(e, mg, mh);
+                op(f, g, h);
+                check(name, f, e, vals + k, vals + i, vals + j, "none");
+            }
+
+            /* aliasing f and g */
+            fmpz_set(f, vals + i);
+            fmpz_set(h, vals + j);
+            mpz_set(e, mg);
+            mop(e, mg, mh);
+            op(f, f, h);
+            check(name, f, e, vals + i, vals + i, vals + j, "f == g");
+
+            /* aliasing f and h */
+            fmpz_set(g, vals + i);
+            fmpz_set(f, vals + j);
+            mpz_set(e, mh);
+            mop(e, mg, mh);
+            op(f, g, f);
+            check(name, f, e, vals + j, vals + i, vals + j, "f == h");
+        }
+
+        for (k = 0; k < NUM_VALS; k++)
+        {
+            /* aliasing g and h */
+            fmpz_set(f, vals + k);
+            fmpz_set(g, vals + i);
+            fmpz_get_mpz(e, f);
+            mop(e, mg, mg);
+            op(f, g, g);
+            check(name, f, e, vals + k, vals + i, vals + i, "g == h");
+        }
+
+        /* aliasing f, g and h */
+        fmpz_set(f, vals + i);
+        fmpz_get_mpz(mg, vals + i);
+        mpz_set(e, mg);
+        mop(e, mg, mg);
+        op(f, f, f);
+        check(name, f, e, vals + i, vals + i, vals + i, "f == g == h");
+    }
+
+    fmpz_clear(f);
+    fmpz_clear(g);
+    fmpz_clear(h);
+    mpz_clear(mf);
+    mpz_clear(mg);
+    mpz_clear(mh);
+    mpz_clear(e);
+}
+
+int
+main(void)
+{
+    printf("inlines....");
+    fflush(stdout);
+
+    init_vals();
+
+    test_op("add", fmpz_add, mpz_add);
+    test_op("sub", fmpz_sub, mpz_sub);
+    test_op("mul", fmpz_mul, mpz_mul);
+    test_op("addmul", fmpz_addmul, mpz_addmul);
+    test_op("submul", fmpz_submul, mpz_submul);
+
+    clear_vals();
+
+    flint_cleanup();
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,80 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+
+int
+main(void)
+{
+    int i, result;
+    flint_rand_t state;
+
+    printf("is_probabprime_BPSW....");
+    fflush(stdout);
+
+    flint_randinit(state);
+
+    for (i = 0; i < 10000 * flint_test_multiplier(); i++)
+    {
+        fmpz_t n;
+        mpz_t t;
+        int r1, r2;
+
+        fmpz_init(n);
+        mpz_init(t);
+
+        fmpz_randtest(n, state, n_randint(state, 500) + 1);
+
+        /* make primes likely */
+        if (n_randint(state, 2) && fmpz_sgn(n) > 0)
+        {
+            fmpz_get_mpz(t, n);
+            mpz_nextprime(t, t);
+            fmpz_set_mpz(n, t);
+        }
+
+        fmpz_get_mpz(t, n);
+
+        r1 = fmpz_is_probabprime_BPSW(n);
+        r2 = (mpz_sgn(t) > 0 && mpz_probab_prime_p(t, 25) != 0);
+
+        result = (r1 == r2);
+        if (!result)
+        {
+            printf("FAIL:\n");
+            fmpz_print(n); printf("\n");
+            printf("r1 = %d, r2 = %d\n", r1, r2);
+            abort();
+        }
+
+        fmpz_clear(n);
+        mpz_clear(t);
+    }
+
+    flint_randclear(state);
+    flint_cleanup();
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,131 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+
+int
+main(void)
+{
+    int i, result;
+    flint_rand_t state;
+
+    printf("is_probabprime_lucas....");
+    fflush(stdout);
+
+    flint_randinit(state);
+
+    /* primes pass */
+    for (i = 0; i < 1000 * flint_test_multiplier(); i++)
+    {
+        fmpz_t p;
+        mpz_t t;
+
+        fmpz_init(p);
+        mpz_init(t);
+
+        fmpz_randtest_unsigned(p, state, n_randint(state, 400) + 1);
+        fmpz_get_mpz(t, p);
+        mpz_nextprime(t, t);
+        fmpz_set_mpz(p, t);
+
+        result = fmpz_is_probabprime_lucas(p);
+        if (!result)
+        {
+            printf("FAIL (prime):\n");
+            fmpz_print(p); printf("\n");
+            abort();
+        }
+
+        fmpz_clear(p);
+        mpz_clear(t);
+    }
+
+    /* squares and products of two primes fail */
+    for (i = 0; i < 1000 * flint_test_multiplier(); i++)
+    {
+        fmpz_t p, q, n;
+        mpz_t t;
+
+        fmpz_init(p);
+        fmpz_init(q);
+        fmpz_init(n);
+        mpz_init(t);
+
+        fmpz_randtest_unsigned(p, state, n_randint(state, 200) + 33);
+        fmpz_get_mpz(t, p);
+        mpz_nextprime(t, t);
+        fmpz_set_mpz(p, t);
+
+        if (n_randint(state, 2))
+        {
+            fmpz_set(q, p);
+        }
+        else
+        {
+            fmpz_randtest_unsigned(q, state, n_randint(state, 200) + 33);
+            fmpz_get_mpz(t, q);
+            mpz_nextprime(t, t);
+            fmpz_set_mpz(q, t);
+        }
+
+        fmpz_mul(n, p, q);
+
+        result = !fmpz_is_probabprime_lucas(n);
+        if (!result)
+        {
+            printf("FAIL (composite):\n");
+            fmpz_print(p); printf("\n");
+            fmpz_print(q); printf("\n");
+            abort();
+        }
+
+        fmpz_clear(p);
+        fmpz_clear(q);
+        fmpz_clear(n);
+        mpz_clear(t);
+    }
+
+    /* a strong pseudoprime to the bases 2, 3, ..., 37 */
+    {
+        fmpz_t n;
+
+        fmpz_init(n);
+        fmpz_set_str(n, "3317044064679887385961981", 10);
+
+        if (fmpz_is_probabprime_lucas(n))
+        {
+            printf("FAIL (pseudoprime):\n");
+            fmpz_print(n); printf("\n");
+            abort();
+        }
+
+        fmpz_clear(n);
+    }
+
+    flint_randclear(state);
+    flint_cleanup();
+    printf("PASS\n");
+    return 0;
+}
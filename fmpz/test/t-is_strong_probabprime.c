@@ -0,0 +1,148 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+
+/* reference Miller-Rabin test with GMP */
+static int
+_ref_strong(const mpz_t n, const mpz_t a)
+{
+    mpz_t d, y, nm1;
+    ulong s, i;
+    int r;
+
+    mpz_init(d);
+    mpz_init(y);
+    mpz_init(nm1);
+
+    mpz_sub_ui(nm1, n, 1);
+    s = mpz_scan1(nm1, 0);
+    mpz_tdiv_q_2exp(d, nm1, s);
+    mpz_powm(y, a, d, n);
+
+    r = (mpz_cmp_ui(y, 1) == 0 || mpz_cmp(y, nm1) == 0);
+    for (i = 1; i < s && !r; i++)
+    {
+        mpz_powm_ui(y, y, 2, n);
+        r = (mpz_cmp(y, nm1) == 0);
+    }
+
+    mpz_clear(d);
+    mpz_clear(y);
+    mpz_clear(nm1);
+
+    return r;
+}
+
+int
+main(void)
+{
+    int i, result;
+    flint_rand_t state;
+
+    printf("is_strong_probabprime....");
+    fflush(stdout);
+
+    flint_randinit(state);
+
+    for (i = 0; i < 10000 * flint_test_multiplier(); i++)
+    {
+        fmpz_t n, a;
+        mpz_t nn, aa;
+        int r1, r2;
+
+        fmpz_init(n);
+        fmpz_init(a);
+        mpz_init(nn);
+        mpz_init(aa);
+
+        do {
+            fmpz_randtest_unsigned(n, state, n_randint(state, 300) + 3);
+        } while (fmpz_cmp_ui(n, 3) <= 0 || fmpz_is_even(n));
+
+        /* make primes likely */
+        if (n_randint(state, 2))
+        {
+            fmpz_get_mpz(nn, n);
+            mpz_nextprime(nn, nn);
+            fmpz_set_mpz(n, nn);
+        }
+
+        fmpz_sub_ui(a, n, 3);
+        fmpz_randm(a, state, a);
+        fmpz_add_ui(a, a, 2);
+
+        fmpz_get_mpz(nn, n);
+        fmpz_get_mpz(aa, a);
+
+        r1 = fmpz_is_strong_probabprime(n, a);
+        r2 = _ref_strong(nn, aa);
+
+        result = (r1 == r2);
+        if (!result)
+        {
+            printf("FAIL:\n");
+            fmpz_print(n); printf("\n");
+            fmpz_print(a); printf("\n");
+            printf("r1 = %d, r2 = %d\n", r1, r2);
+            abort();
+        }
+
+        fmpz_clear(n);
+        fmpz_clear(a);
+        mpz_clear(nn);
+        mpz_clear(aa);
+    }
+
+    /* a strong pseudoprime to the bases 2, 3, ..., 37 */
+    {
+        fmpz_t n, a;
+
+        fmpz_init(n);
+        fmpz_init(a);
+
+        fmpz_set_str(n, "3317044064679887385961981", 10);
+
+        for (i = 0; i < 12; i++)
+        {
+            fmpz_set_ui(a, flint_primes_small[i]);
+
+            if (!fmpz_is_strong_probabprime(n, a))
+            {
+                printf("FAIL (pseudoprime):\n");
+                fmpz_print(a); printf("\n");
+                abort();
+            }
+        }
+
+        fmpz_clear(n);
+        fmpz_clear(a);
+    }
+
+    flint_randclear(state);
+    flint_cleanup();
+    printf("PASS\n");
+    return 0;
+}
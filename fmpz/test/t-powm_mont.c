@@ -0,0 +1,135 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+
+int
+main(void)
+{
+    int i, result;
+    flint_rand_t state;
+
+    printf("powm_mont....");
+    fflush(stdout);
+
+    flint_randinit(state);
+
+    /* Compare with fmpz_powm */
+    for (i = 0; i < 2000 * flint_test_multiplier(); i++)
+    {
+        fmpz_t a, b, c, m, e;
+        fmpz_mont_t ctx;
+
+        fmpz_init(a);
+        fmpz_init(b);
+        fmpz_init(c);
+        fmpz_init(m);
+        fmpz_init(e);
+
+        fmpz_randtest_unsigned(m, state, 400);
+        fmpz_setbit(m, 0);
+        fmpz_randtest(a, state, 500);
+        fmpz_randtest_unsigned(e, state, n_randint(state, 2) ? 20 : 1000);
+
+        fmpz_mont_init(ctx, m);
+
+        fmpz_powm(b, a, e, m);
+        fmpz_powm_mont(c, a, e, ctx);
+
+        result = fmpz_equal(b, c);
+        if (!result)
+        {
+            printf("FAIL (cmp with fmpz_powm):\n");
+            printf("a = "), fmpz_print(a), printf("\n");
+            printf("e = "), fmpz_print(e), printf("\n");
+            printf("m = "), fmpz_print(m), printf("\n");
+            printf("b = "), fmpz_print(b), printf("\n");
+            printf("c = "), fmpz_print(c), printf("\n");
+            abort();
+        }
+
+        fmpz_mont_clear(ctx);
+
+        fmpz_clear(a);
+        fmpz_clear(b);
+        fmpz_clear(c);
+        fmpz_clear(m);
+        fmpz_clear(e);
+    }
+
+    /* Check aliasing of f and g, and of f and e */
+    for (i = 0; i < 2000 * flint_test_multiplier(); i++)
+    {
+        fmpz_t a, b, c, m, e;
+        fmpz_mont_t ctx;
+
+        fmpz_init(a);
+        fmpz_init(b);
+        fmpz_init(c);
+        fmpz_init(m);
+        fmpz_init(e);
+
+        fmpz_randtest_unsigned(m, state, 300);
+        fmpz_setbit(m, 0);
+        fmpz_randtest(a, state, 300);
+        fmpz_randtest_unsigned(e, state, 300);
+
+        fmpz_mont_init(ctx, m);
+
+        fmpz_powm_mont(b, a, e, ctx);
+        fmpz_set(c, a);
+        fmpz_powm_mont(c, c, e, ctx);
+
+        result = fmpz_equal(b, c);
+
+        fmpz_set(c, e);
+        fmpz_powm_mont(c, a, c, ctx);
+
+        result = result && fmpz_equal(b, c);
+        if (!result)
+        {
+            printf("FAIL (aliasing):\n");
+            printf("a = "), fmpz_print(a), printf("\n");
+            printf("e = "), fmpz_print(e), printf("\n");
+            printf("m = "), fmpz_print(m), printf("\n");
+            printf("b = "), fmpz_print(b), printf("\n");
+            printf("c = "), fmpz_print(c), printf("\n");
+            abort();
+        }
+
+        fmpz_mont_clear(ctx);
+
+        fmpz_clear(a);
+        fmpz_clear(b);
+        fmpz_clear(c);
+        fmpz_clear(m);
+        fmpz_clear(e);
+    }
+
+    flint_randclear(state);
+    flint_cleanup();
+    printf("PASS\n");
+    return 0;
+}
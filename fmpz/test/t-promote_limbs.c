@@ -0,0 +1,285 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "thread_pool.h"
+
+/* number of blocks from flint_malloc not yet freed, over all threads */
+static volatile slong outstanding = 0;
+
+static void * hook_malloc(size_t size)
+{
+    __sync_fetch_and_add(&outstanding, 1);
+    return malloc(size);
+}
+
+static void * hook_calloc(size_t num, size_t size)
+{
+    __sync_fetch_and_add(&outstanding, 1);
+    return calloc(num, size);
+}
+
+static void * hook_realloc(void * ptr, size_t size)
+{
+    if (ptr == NULL)
+        __sync_fetch_and_add(&outstanding, 1);
+    return realloc(ptr, size);
+}
+
+static void hook_free(void * ptr)
+{
+    __sync_fetch_and_sub(&outstanding, 1);
+    free(ptr);
+}
+
+#define NUM_VALS 1000
+
+typedef struct
+{
+    fmpz * vals;
+    slong start;
+    slong stop;
+    int create;
+}
+work_struct;
+
+/* the value stored in entry i, of between 1 and 200 limbs */
+static void
+value(fmpz_t f, slong i)
+{
+    fmpz_set_ui(f, i + 1);
+    fmpz_mul_2exp(f, f, (i % 200) * FLINT_BITS + FLINT_BITS/2);
+    fmpz_neg(f, f);
+}
+
+/* creates entries [start, stop), or checks and clears them */
+static void
+work(void * varg)
+{
+    work_struct * arg = (work_struct *) varg;
+    fmpz_t t;
+    slong i;
+
+    fmpz_init(t);
+
+    for (i = arg->start; i < arg->stop; i++)
+    {
+        if (arg->create)
+        {
+            fmpz_init(arg->vals + i);
+            value(arg->vals + i, i);
+        }
+        else
+        {
+            value(t, i);
+            if (!fmpz_equal(arg->vals + i, t))
+            {
+                printf("FAIL:\n");
+                printf("value %ld is wrong\n", i);
+                abort();
+            }
+            fmpz_clear(arg->vals + i);
+        }
+    }
+
+    fmpz_clear(t);
+}
+
+/* 
+   creates the values on the workers and clears them on the calling 
+   thread, or the other way round
+*/
+static void
+check_threads(int create_on_workers)
+{
+    thread_pool_handle * threads;
+    slong i, n, num_workers;
+    work_struct args[4], all;
+    fmpz * vals;
+
+    vals = flint_malloc(NUM_VALS * sizeof(fmpz));
+
+    num_workers = flint_request_threads(&threads, 4);
+    n = FLINT_MAX(num_workers, 1);
+
+    for (i = 0; i < n; i++)
+    {
+        args[i].vals = vals;
+        args[i].start = (i * NUM_VALS) / n;
+        args[i].stop = ((i + 1) * NUM_VALS) / n;
+        args[i].create = create_on_workers;
+    }
+
+    all.vals = vals;
+    all.start = 0;
+    all.stop = NUM_VALS;
+    all.create = !create_on_workers;
+
+    if (!create_on_workers)
+        work(&all);
+
+    if (num_workers == 0)
+        work(args);
+
+    for (i = 0; i < num_workers; i++)
+        thread_pool_wake(global_thread_pool, threads[i], work, args + i);
+    for (i = 0; i < num_workers; i++)
+        thread_pool_wait(global_thread_pool, threads[i]);
+
+    if (create_on_workers)
+        work(&all);
+
+    flint_give_back_threads(threads, num_workers);
+
+    flint_free(vals);
+}
+
+int
+main(void)
+{
+    int i, j, result;
+    slong base;
+    flint_rand_t state;
+
+    __flint_set_memory_functions(hook_malloc, hook_calloc, 
+                                 hook_realloc, hook_free);
+
+    printf("promote_limbs....");
+    fflush(stdout);
+
+    flint_randinit(state);
+
+    /* promote to each size class */
+    for (i = 0; i < 100 * flint_test_multiplier(); i++)
+    {
+        for (j = 0; j <= 8; j++)
+        {
+            slong limbs = (1L << j) - n_randint(state, (1L << j)/2 + 1);
+            fmpz_t f, g, h;
+            mpz_t z;
+            __mpz_struct * ptr;
+
+            limbs = FLINT_MAX(limbs, 1);
+
+            mpz_init(z);
+            fmpz_init(h);
+            fmpz_randtest_not_zero(h, state, limbs * FLINT_BITS);
+            fmpz_get_mpz(z, h);
+            fmpz_clear(h);
+
+            fmpz_init(f);
+            ptr = _fmpz_promote_limbs(f, limbs);
+            result = (ptr == COEFF_TO_PTR(*f) && ptr->_mp_alloc >= limbs);
+            mpz_set(ptr, z);
+            _fmpz_demote_val(f);
+            result = result && (fmpz_cmp_ui(f, 0) != 0 || mpz_sgn(z) == 0);
+
+            fmpz_init2(g, limbs);
+            result = result && COEFF_IS_MPZ(*g)
+                            && COEFF_TO_PTR(*g)->_mp_alloc >= limbs;
+            fmpz_set_mpz(g, z);
+
+            fmpz_init(h);
+            fmpz_set(h, g);
+            result = result && (!COEFF_IS_MPZ(*h) 
+                || COEFF_TO_PTR(*h)->_mp_alloc >= FLINT_ABS(z->_mp_size));
+
+            result = result && fmpz_equal(f, g) && fmpz_equal(g, h);
+
+            if (!result)
+            {
+                printf("FAIL:\n");
+                printf("limbs = %ld\n", limbs);
+                printf("f = "), fmpz_print(f), printf("\n");
+                printf("g = "), fmpz_print(g), printf("\n");
+                printf("h = "), fmpz_print(h), printf("\n");
+                abort();
+            }
+
+            fmpz_clear(f);
+            fmpz_clear(g);
+            fmpz_clear(h);
+            mpz_clear(z);
+        }
+    }
+
+    /* a cleared mpz is handed out again with its limbs */
+    for (j = 0; j <= 6; j++)
+    {
+        fmpz_t f;
+        __mpz_struct * ptr, * ptr2;
+        slong limbs = 1L << j;
+
+        fmpz_init(f);
+        ptr = _fmpz_promote_limbs(f, limbs);
+        fmpz_clear(f);
+
+        fmpz_init(f);
+        ptr2 = _fmpz_promote_limbs(f, limbs);
+        result = (ptr == ptr2 && ptr2->_mp_alloc >= limbs);
+        fmpz_clear(f);
+
+        if (!result)
+        {
+            printf("FAIL:\n");
+            printf("cached mpz not reused for %ld limbs\n", limbs);
+            abort();
+        }
+    }
+
+    flint_cleanup();
+
+    /* the pool itself counts towards the baseline */
+    flint_set_num_threads(4);
+    flint_set_num_threads(1);
+    base = outstanding;
+
+    /* create and clear on different threads */
+    for (i = 0; i < 10 * flint_test_multiplier(); i++)
+    {
+        flint_set_num_threads(2 + n_randint(state, 3));
+
+        check_threads(1);
+        check_threads(0);
+
+        /* the workers release their caches when they exit */
+        flint_set_num_threads(1);
+        flint_cleanup();
+
+        result = (outstanding == base);
+        if (!result)
+        {
+            printf("FAIL:\n");
+            printf("%ld blocks leaked\n", (slong) (outstanding - base));
+            abort();
+        }
+    }
+
+    flint_randclear(state);
+    flint_cleanup();
+
+    printf("PASS\n");
+    return 0;
+}
@@ -58,6 +58,8 @@ void _fmpz_factor_fit_length(fmpz_factor_t factor, slong len);
 
 void _fmpz_factor_append_ui(fmpz_factor_t factor, mp_limb_t p, ulong exp);
 
+void _fmpz_factor_append(fmpz_factor_t factor, const fmpz_t p, ulong exp);
+
 void _fmpz_factor_set_length(fmpz_factor_t factor, slong newlen);
 
 /* Factoring *****************************************************************/
@@ -71,9 +73,14 @@ void fmpz_factor(fmpz_factor_t factor, const fmpz_t n);
 
 void fmpz_factor_si(fmpz_factor_t factor, slong n);
 
+void fmpz_factor_no_trial(fmpz_factor_t factor, const fmpz_t n);
+
 int fmpz_factor_pp1(fmpz_t factor, const fmpz_t n, 
                                        ulong B1, ulong B2_sqrt, ulong c);
 
+int fmpz_factor_ecm(fmpz_t f, ulong curves, ulong B1, ulong B2,
+                    flint_rand_t state, const fmpz_t n);
+
 /* Expansion *****************************************************************/
 
 void fmpz_factor_expand_iterative(fmpz_t n, const fmpz_factor_t factor);
@@ -113,10 +113,19 @@ fmpz_factor(fmpz_factor_t factor, const fmpz_t n)
         }
         else
         {
-            /* Insert primality test, perfect power test, other factoring
-               algorithms here... */
-            trial_start = trial_stop;
-            trial_stop = trial_start + 1000;
+            /* No small factors, so factor the remaining cofactor with 
+               primality and perfect power tests and the quadratic sieve */
+            fmpz_t c;
+
+            fmpz_init(c);
+            x->_mp_size = xsize;
+            fmpz_set_mpz(c, x);
+
+            fmpz_factor_no_trial(factor, c);
+
+            fmpz_clear(c);
+            xd[0] = 1;
+            xsize = 1;
         }
     }
 
@@ -0,0 +1,467 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#undef ulong /* avoid clash with stdlib */
+#include <stdlib.h>
+#define ulong mp_limb_t
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "fmpz_factor.h"
+#include "mpn_extras.h"
+#include "ulong_extras.h"
+
+/*
+   Multi-limb arithmetic on Montgomery curves, using only the projective
+   coordinates (X : Z). Residues are nn limb arrays, shifted left by norm
+   so that flint_mpn_mulmod_preinvn can be used with the normalised
+   modulus n.
+*/
+
+#define ECM_D 210 /* giant step size for stage 2 */
+
+static void
+ecm_addmod(mp_ptr r, mp_srcptr a, mp_srcptr b, mp_srcptr n, mp_size_t nn)
+{
+    if (mpn_add_n(r, a, b, nn) || mpn_cmp(r, n, nn) >= 0)
+        mpn_sub_n(r, r, n, nn);
+}
+
+static void
+ecm_submod(mp_ptr r, mp_srcptr a, mp_srcptr b, mp_srcptr n, mp_size_t nn)
+{
+    if (mpn_sub_n(r, a, b, nn))
+        mpn_add_n(r, r, n, nn);
+}
+
+/* (x : z) = 2 (x0 : z0), where a24 = (A + 2)/4, t has space for 3nn limbs */
+static void
+ecm_double(mp_ptr x, mp_ptr z, mp_srcptr x0, mp_srcptr z0, mp_srcptr a24,
+           mp_srcptr n, mp_srcptr ninv, mp_size_t nn, ulong norm, mp_ptr t)
+{
+    mp_ptr u = t, v = t + nn, w = t + 2*nn;
+
+    ecm_addmod(u, x0, z0, n, nn);
+    flint_mpn_mulmod_preinvn(u, u, u, nn, n, ninv, norm);
+    ecm_submod(v, x0, z0, n, nn);
+    flint_mpn_mulmod_preinvn(v, v, v, nn, n, ninv, norm);
+    ecm_submod(w, u, v, n, nn); /* 4 x0 z0 */
+
+    flint_mpn_mulmod_preinvn(x, u, v, nn, n, ninv, norm);
+    flint_mpn_mulmod_preinvn(u, w, a24, nn, n, ninv, norm);
+    ecm_addmod(u, u, v, n, nn);
+    flint_mpn_mulmod_preinvn(z, w, u, nn, n, ninv, norm);
+}
+
+/* 
+   (x : z) = P1 + P2, given the difference P1 - P2 = (xd : zd), 
+   t has space for 4nn limbs and (x : z) must not be aliased with (xd : zd)
+*/
+static void
+ecm_add(mp_ptr x, mp_ptr z, mp_srcptr x1, mp_srcptr z1,
+        mp_srcptr x2, mp_srcptr z2, mp_srcptr xd, mp_srcptr zd,
+        mp_srcptr n, mp_srcptr ninv, mp_size_t nn, ulong norm, mp_ptr t)
+{
+    mp_ptr s = t, u = t + nn, v = t + 2*nn, w = t + 3*nn;
+
+    ecm_submod(s, x1, z1, n, nn);
+    ecm_addmod(w, x2, z2, n, nn);
+    flint_mpn_mulmod_preinvn(u, s, w, nn, n, ninv, norm);
+    ecm_addmod(s, x1, z1, n, nn);
+    ecm_submod(w, x2, z2, n, nn);
+    flint_mpn_mulmod_preinvn(v, s, w, nn, n, ninv, norm);
+
+    ecm_addmod(s, u, v, n, nn);
+    flint_mpn_mulmod_preinvn(s, s, s, nn, n, ninv, norm);
+    ecm_submod(w, u, v, n, nn);
+    flint_mpn_mulmod_preinvn(w, w, w, nn, n, ninv, norm);
+
+    flint_mpn_mulmod_preinvn(x, zd, s, nn, n, ninv, norm);
+    flint_mpn_mulmod_preinvn(z, xd, w, nn, n, ninv, norm);
+}
+
+/* 
+   (x : z) = k (x0 : z0) by the Montgomery ladder, for k >= 1, 
+   t has space for 8nn limbs
+*/
+static void
+ecm_mul_ui(mp_ptr x, mp_ptr z, mp_srcptr x0, mp_srcptr z0, ulong k,
+           mp_srcptr a24, mp_srcptr n, mp_srcptr ninv, mp_size_t nn,
+           ulong norm, mp_ptr t)
+{
+    mp_ptr x1 = t + 4*nn, z1 = t + 5*nn, x2 = t + 6*nn, z2 = t + 7*nn;
+    ulong bit;
+
+    mpn_copyi(x1, x0, nn);
+    mpn_copyi(z1, z0, nn);
+
+    if (k > 1)
+    {
+        ecm_double(x2, z2, x0, z0, a24, n, ninv, nn, norm, t);
+
+        bit = ((1UL << FLINT_BIT_COUNT(k)) >> 2);
+
+        while (bit)
+        {
+            if (k & bit)
+            {
+                ecm_add(x1, z1, x2, z2, x1, z1, x0, z0, n, ninv, nn, norm, t);
+                ecm_double(x2, z2, x2, z2, a24, n, ninv, nn, norm, t);
+            } else
+            {
+                ecm_add(x2, z2, x2, z2, x1, z1, x0, z0, n, ninv, nn, norm, t);
+                ecm_double(x1, z1, x1, z1, a24, n, ninv, nn, norm, t);
+            }
+
+            bit >>= 1;
+        }
+    }
+
+    mpn_copyi(x, x1, nn);
+    mpn_copyi(z, z1, nn);
+}
+
+/* set r to the 0 <= x < n shifted left by norm bits */
+static void
+ecm_set_fmpz(mp_ptr r, const fmpz_t x, mp_size_t nn, ulong norm)
+{
+    mpn_zero(r, nn);
+
+    if (!COEFF_IS_MPZ(*x))
+        r[0] = *x;
+    else
+    {
+        __mpz_struct * m = COEFF_TO_PTR(*x);
+        mpn_copyi(r, m->_mp_d, m->_mp_size);
+    }
+
+    if (norm)
+        mpn_lshift(r, r, nn, norm);
+}
+
+/* set g to the gcd of n and the shifted residue x */
+static void
+ecm_gcd(fmpz_t g, mp_srcptr x, const fmpz_t n, mp_size_t nn, 
+        ulong norm, mp_ptr t)
+{
+    __mpz_struct m;
+    mp_size_t xn = nn;
+
+    if (norm)
+        mpn_rshift(t, x, nn, norm);
+    else
+        mpn_copyi(t, x, nn);
+
+    MPN_NORM(t, xn);
+    
+    m._mp_d = t;
+    m._mp_size = xn;
+    m._mp_alloc = nn;
+
+    fmpz_set_mpz(g, &m);
+    fmpz_gcd(g, g, n);
+}
+
+/*
+   Selects a curve and starting point using Suyama's parametrisation,
+   which gives a group order divisible by 12. Returns 1 if successful,
+   otherwise sets g to the gcd of n with the denominator of (A + 2)/4
+   and returns 0.
+*/
+static int
+ecm_select_curve(fmpz_t x, fmpz_t z, fmpz_t a24, fmpz_t g,
+                 const fmpz_t sigma, const fmpz_t n)
+{
+    fmpz_t u, v, w;
+    int ret = 1;
+
+    fmpz_init(u);
+    fmpz_init(v);
+    fmpz_init(w);
+
+    fmpz_mul(u, sigma, sigma);
+    fmpz_sub_ui(u, u, 5);
+    fmpz_mod(u, u, n);
+    fmpz_mul_2exp(v, sigma, 2);
+    fmpz_mod(v, v, n);
+
+    fmpz_mul(x, u, u);
+    fmpz_mul(x, x, u);
+    fmpz_mod(x, x, n);
+    fmpz_mul(z, v, v);
+    fmpz_mul(z, z, v);
+    fmpz_mod(z, z, n);
+
+    /* (v - u)^3 (3u + v) / (16 u^3 v) */
+    fmpz_sub(w, v, u);
+    fmpz_pow_ui(a24, w, 3);
+    fmpz_mul_ui(w, u, 3);
+    fmpz_add(w, w, v);
+    fmpz_mul(a24, a24, w);
+
+    fmpz_mul(w, x, v);
+    fmpz_mul_2exp(w, w, 4);
+    fmpz_mod(w, w, n);
+
+    if (fmpz_is_zero(w))
+    {
+        fmpz_set(g, n);
+        ret = 0;
+    } else
+    {
+        fmpz_gcdinv(g, u, w, n);
+        if (!fmpz_is_one(g))
+            ret = 0;
+        else
+        {
+            fmpz_mul(a24, a24, u);
+            fmpz_mod(a24, a24, n);
+        }
+    }
+
+    fmpz_clear(u);
+    fmpz_clear(v);
+    fmpz_clear(w);
+
+    return ret;
+}
+
+int fmpz_factor_ecm(fmpz_t f, ulong curves, ulong B1, ulong B2,
+                    flint_rand_t state, const fmpz_t n_in)
+{
+    mp_size_t nn = fmpz_size(n_in);
+    mp_ptr x0, z0, x, z, a24, n, ninv, t, bx, bz, acc;
+    mp_ptr xD, zD, xm, zm, xm1, zm1;
+    fmpz_t sigma, fx, fz, fa24, g;
+    ulong norm, bits0, sqrt, pr, k;
+    int curve, check, ret = 0;
+    n_primes_t iter;
+
+    if (fmpz_is_even(n_in))
+    {
+        fmpz_set_ui(f, 2);
+        return 1;
+    }
+
+    if (nn == 1) /* use the single limb version */
+    {
+        mp_limb_t fac;
+
+        ret = n_factor_ecm(&fac, curves, B1, B2, state, fmpz_get_ui(n_in));
+        if (ret)
+            fmpz_set_ui(f, fac);
+
+        return ret;
+    }
+
+    x0   = flint_malloc(nn*sizeof(mp_limb_t));
+    z0   = flint_malloc(nn*sizeof(mp_limb_t));
+    x    = flint_malloc(nn*sizeof(mp_limb_t));
+    z    = flint_malloc(nn*sizeof(mp_limb_t));
+    a24  = flint_malloc(nn*sizeof(mp_limb_t));
+    n    = flint_malloc(nn*sizeof(mp_limb_t));
+    ninv = flint_malloc(nn*sizeof(mp_limb_t));
+    acc  = flint_malloc(nn*sizeof(mp_limb_t));
+    xD   = flint_malloc(6*nn*sizeof(mp_limb_t));
+    zD = xD + nn, xm = xD + 2*nn, zm = xD + 3*nn;
+    xm1 = xD + 4*nn, zm1 = xD + 5*nn;
+    t    = flint_malloc(8*nn*sizeof(mp_limb_t));
+    bx   = flint_malloc((ECM_D/4 + 1)*nn*sizeof(mp_limb_t));
+    bz   = flint_malloc((ECM_D/4 + 1)*nn*sizeof(mp_limb_t));
+
+    fmpz_init(sigma);
+    fmpz_init(fx);
+    fmpz_init(fz);
+    fmpz_init(fa24);
+    fmpz_init(g);
+
+    {
+        mp_srcptr np = COEFF_TO_PTR(*n_in)->_mp_d;
+
+        count_leading_zeros(norm, np[nn - 1]);
+        if (norm)
+            mpn_lshift(n, np, nn, norm);
+        else
+            mpn_copyi(n, np, nn);
+    }
+
+    flint_mpn_preinvn(ninv, n, nn);
+
+    sqrt = n_sqrt(B1);
+    bits0 = FLINT_BIT_COUNT(B1);
+
+    for (curve = 1; curve <= curves; curve++)
+    {
+        fmpz_sub_ui(g, n_in, 7);
+        fmpz_randm(sigma, state, g);
+        fmpz_add_ui(sigma, sigma, 6);
+
+        if (!ecm_select_curve(fx, fz, fa24, g, sigma, n_in))
+        {
+            if (!fmpz_equal(g, n_in))
+            {
+                ret = curve;
+                break;
+            }
+
+            continue;
+        }
+
+        ecm_set_fmpz(x0, fx, nn, norm);
+        ecm_set_fmpz(z0, fz, nn, norm);
+        ecm_set_fmpz(a24, fa24, nn, norm);
+
+        /* 
+           stage 1: multiply by all prime powers up to B1, if all factors
+           of n are found at once, start again taking a gcd after each step
+        */
+        n_primes_init(iter);
+
+        for (check = 0; check < 2; check++)
+        {
+            fmpz_one(g);
+
+            for (pr = n_primes_next(iter); pr <= B1 && fmpz_is_one(g);
+                                           pr = n_primes_next(iter))
+            {
+                if (pr < sqrt)
+                    k = n_pow(pr, bits0/FLINT_BIT_COUNT(pr));
+                else
+                    k = pr;
+
+                ecm_mul_ui(x0, z0, x0, z0, k, a24, n, ninv, nn, norm, t);
+
+                if (check)
+                    ecm_gcd(g, z0, n_in, nn, norm, t);
+            }
+
+            if (!check)
+                ecm_gcd(g, z0, n_in, nn, norm, t);
+
+            if (!fmpz_equal(g, n_in))
+                break;
+
+            n_primes_clear(iter);
+            n_primes_init(iter);
+            ecm_set_fmpz(x0, fx, nn, norm);
+            ecm_set_fmpz(z0, fz, nn, norm);
+        }
+
+        if (fmpz_is_one(g) && B2 > B1)
+        {
+            /* 
+               stage 2: baby steps j P for odd j < D/2, giant steps m D P,
+               a prime p = m D +/- j is detected by X_mD Z_j - X_j Z_mD
+            */
+            ulong m, m0;
+            slong j;
+
+            mpn_copyi(bx, x0, nn);
+            mpn_copyi(bz, z0, nn);
+            ecm_double(x, z, x0, z0, a24, n, ninv, nn, norm, t);
+            ecm_add(bx + nn, bz + nn, x, z, x0, z0, x0, z0,
+                                                   n, ninv, nn, norm, t);
+            for (j = 2; j <= ECM_D/4; j++)
+                ecm_add(bx + j*nn, bz + j*nn, bx + (j - 1)*nn, bz + (j - 1)*nn,
+                     x, z, bx + (j - 2)*nn, bz + (j - 2)*nn,
+                                                   n, ninv, nn, norm, t);
+
+            m0 = (B1 + ECM_D/2)/ECM_D;
+            if (m0 == 0)
+                m0 = 1;
+
+            ecm_mul_ui(xD, zD, x0, z0, ECM_D, a24, n, ninv, nn, norm, t);
+            ecm_mul_ui(xm, zm, x0, z0, m0*ECM_D, a24, n, ninv, nn, norm, t);
+            if (m0 > 1) /* (m0 - 1) D P is not needed if m0 = 1 */
+                ecm_mul_ui(xm1, zm1, x0, z0, (m0 - 1)*ECM_D,
+                                            a24, n, ninv, nn, norm, t);
+
+            m = m0;
+            mpn_zero(acc, nn);
+            acc[0] = (1UL << norm);
+
+            n_primes_jump_after(iter, FLINT_MAX(B1, ECM_D/2));
+
+            for (pr = n_primes_next(iter); pr <= B2; pr = n_primes_next(iter))
+            {
+                ulong mp = (pr + ECM_D/2)/ECM_D;
+
+                while (m < mp)
+                {
+                    /* (m + 1) D P = m D P + D P, difference (m - 1) D P */
+                    if (m == 1)
+                        ecm_double(x, z, xm, zm, a24, n, ninv, nn, norm, t);
+                    else
+                        ecm_add(x, z, xm, zm, xD, zD, xm1, zm1,
+                                                   n, ninv, nn, norm, t);
+                    mpn_copyi(xm1, xm, nn);
+                    mpn_copyi(zm1, zm, nn);
+                    mpn_copyi(xm, x, nn);
+                    mpn_copyi(zm, z, nn);
+                    m++;
+                }
+
+                j = pr - m*ECM_D;
+                if (j < 0)
+                    j = -j;
+                j /= 2;
+
+                flint_mpn_mulmod_preinvn(x, xm, bz + j*nn, nn, n, ninv, norm);
+                flint_mpn_mulmod_preinvn(z, bx + j*nn, zm, nn, n, ninv, norm);
+                ecm_submod(x, x, z, n, nn);
+                flint_mpn_mulmod_preinvn(acc, acc, x, nn, n, ninv, norm);
+            }
+
+            ecm_gcd(g, acc, n_in, nn, norm, t);
+        }
+
+        n_primes_clear(iter);
+
+        if (!fmpz_is_one(g) && !fmpz_equal(g, n_in))
+        {
+            ret = curve;
+            break;
+        }
+    }
+
+    if (ret)
+        fmpz_set(f, g);
+
+    fmpz_clear(sigma);
+    fmpz_clear(fx);
+    fmpz_clear(fz);
+    fmpz_clear(fa24);
+    fmpz_clear(g);
+
+    flint_free(x0);
+    flint_free(z0);
+    flint_free(x);
+    flint_free(z);
+    flint_free(a24);
+    flint_free(n);
+    flint_free(ninv);
+    flint_free(acc);
+    flint_free(xD);
+    flint_free(t);
+    flint_free(bx);
+    flint_free(bz);
+
+    return ret;
+}
@@ -0,0 +1,170 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#undef ulong /* avoid clash with stdlib */
+#include <stdio.h>
+#include <stdlib.h>
+#define ulong mp_limb_t
+
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "fmpz_factor.h"
+#include "ulong_extras.h"
+#include "qsieve.h"
+
+/* 
+   ECM effort before falling back to the quadratic sieve: 
+   {minimum bits of n, B1, curves}, aimed at factors of 15, 20, 25, 30 
+   and 35 digits respectively
+*/
+static const ulong ecm_tune[][3] =
+{
+   {150, 2000, 25}, {210, 11000, 90}, {260, 50000, 300},
+   {300, 250000, 700}, {350, 1000000, 1800}
+};
+
+#define ECM_TUNE_SIZE ((slong) (sizeof(ecm_tune)/(3*sizeof(ulong))))
+
+/* insert p^exp into factor, keeping the primes sorted and distinct */
+static void
+_fmpz_factor_insert(fmpz_factor_t factor, const fmpz_t p, ulong exp)
+{
+    slong i, j;
+
+    for (i = 0; i < factor->num && fmpz_cmp(factor->p + i, p) < 0; i++) ;
+
+    if (i < factor->num && fmpz_equal(factor->p + i, p))
+    {
+        factor->exp[i] += exp;
+        return;
+    }
+
+    _fmpz_factor_fit_length(factor, factor->num + 1);
+
+    for (j = factor->num; j > i; j--)
+    {
+        fmpz_swap(factor->p + j, factor->p + j - 1);
+        factor->exp[j] = factor->exp[j - 1];
+    }
+
+    fmpz_set(factor->p + i, p);
+    factor->exp[i] = exp;
+    factor->num++;
+}
+
+/* 
+   ECM parameter sets below level have already been tried on a multiple
+   of n without finding a factor, so we start from level. The random
+   state is shared by all levels and cofactors, so later ECM runs do not
+   repeat the curves of earlier ones
+*/
+static void
+_fmpz_factor_no_trial(fmpz_factor_t factor, const fmpz_t n, ulong exp,
+                      slong level, flint_rand_t state)
+{
+    fmpz_t f, q;
+    mp_bitcnt_t bits;
+    ulong e;
+
+    if (fmpz_abs_fits_ui(n)) /* single limb, use n_factor */
+    {
+        n_factor_t fac;
+        slong i;
+
+        n_factor_init(&fac);
+        n_factor(&fac, fmpz_get_ui(n), 0);
+
+        fmpz_init(f);
+        for (i = 0; i < fac.num; i++)
+        {
+            fmpz_set_ui(f, fac.p[i]);
+            _fmpz_factor_insert(factor, f, fac.exp[i]*exp);
+        }
+        fmpz_clear(f);
+
+        return;
+    }
+
+    if (fmpz_is_probabprime(n))
+    {
+        _fmpz_factor_insert(factor, n, exp);
+        return;
+    }
+
+    fmpz_init(f);
+    fmpz_init(q);
+
+    /* check for perfect powers */
+    bits = fmpz_bits(n);
+    for (e = 2; e < bits; e = n_nextprime(e, 0))
+    {
+        fmpz_root(f, n, e);
+        fmpz_pow_ui(q, f, e);
+
+        if (fmpz_equal(q, n))
+        {
+            _fmpz_factor_no_trial(factor, f, exp*e, level, state);
+            goto cleanup;
+        }
+    }
+
+    /* strip factors of up to about 35 digits with ECM */
+    for ( ; level < ECM_TUNE_SIZE && bits >= ecm_tune[level][0]; level++)
+    {
+        if (fmpz_factor_ecm(f, ecm_tune[level][2], ecm_tune[level][1],
+                                       100*ecm_tune[level][1], state, n))
+        {
+            fmpz_divexact(q, n, f);
+
+            _fmpz_factor_no_trial(factor, f, exp, level, state);
+            _fmpz_factor_no_trial(factor, q, exp, level, state);
+
+            goto cleanup;
+        }
+    }
+
+    if (!qsieve_factor(f, n))
+    {
+        printf("Exception (fmpz_factor). Unable to split ");
+        fmpz_print(n);
+        printf(".\n");
+        abort();
+    }
+
+    fmpz_divexact(q, n, f);
+
+    _fmpz_factor_no_trial(factor, f, exp, level, state);
+    _fmpz_factor_no_trial(factor, q, exp, level, state);
+
+cleanup:
+    fmpz_clear(f);
+    fmpz_clear(q);
+}
+
+void
+fmpz_factor_no_trial(fmpz_factor_t factor, const fmpz_t n)
+{
+    flint_rand_t state;
+
+    flint_randinit(state);
+    _fmpz_factor_no_trial(factor, n, 1, 0, state);
+    flint_randclear(state);
+}
@@ -36,6 +36,7 @@ void check(fmpz_t n)
 {
     fmpz_factor_t factor;
     fmpz_t m;
+    slong i;
 
     fmpz_factor_init(factor);
     fmpz_init(m);
@@ -43,6 +44,12 @@ void check(fmpz_t n)
     fmpz_factor(factor, n);
     fmpz_factor_expand(m, factor);
 
+    for (i = 0; i < factor->num; i++)
+    {
+        if (!fmpz_is_probabprime(factor->p + i))
+            fmpz_zero(m); /* bases must be primes */
+    }
+
     if (!fmpz_equal(n, m))
     {
         printf("ERROR: factors do not unfactor to original number!\n");
@@ -138,6 +145,41 @@ int main(void)
     fmpz_set_mpz(x, y);
     check(x);
 
+    /* Products of powers of primes with no small factors */
+    {
+        flint_rand_t state;
+        fmpz_t p;
+        int k;
+
+        flint_randinit(state);
+        fmpz_init(p);
+
+        for (i = 0; i < 20; i++)
+        {
+            fmpz_one(x);
+
+            k = n_randint(state, 3) + 1;
+
+            for (j = 0; j < k; j++) /* keep the product below 160 bits */
+            {
+                do
+                {
+                    fmpz_randbits(p, state, n_randint(state, 75/k - 19) + 20);
+                    fmpz_abs(p, p);
+                } while (!fmpz_is_probabprime(p));
+
+                fmpz_pow_ui(p, p, n_randint(state, 2) + 1);
+                fmpz_mul(x, x, p);
+            }
+
+            fmpz_mul_ui(x, x, n_randint(state, 1000) + 1);
+            check(x);
+        }
+
+        fmpz_clear(p);
+        flint_randclear(state);
+    }
+
     fmpz_clear(x);
     mpz_clear(y);
 
@@ -0,0 +1,87 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "fmpz_factor.h"
+#include "ulong_extras.h"
+
+int main(void)
+{
+   int i, result;
+   flint_rand_t state;
+   flint_randinit(state);
+
+   printf("factor_ecm....");
+   fflush(stdout);
+
+   for (i = 0; i < 30 * flint_test_multiplier(); i++)
+   {
+      fmpz_t n, p, q, f, r;
+
+      fmpz_init(n);
+      fmpz_init(p);
+      fmpz_init(q);
+      fmpz_init(f);
+      fmpz_init(r);
+
+      /* a factor of 20 to 40 bits with a large cofactor */
+      fmpz_set_ui(p, n_randprime(state, n_randint(state, 21) + 20, 0));
+
+      do
+      {
+         fmpz_randbits(q, state, n_randint(state, 150) + 50);
+         fmpz_abs(q, q);
+      } while (!fmpz_is_probabprime(q));
+
+      fmpz_mul(n, p, q);
+
+      result = fmpz_factor_ecm(f, 200, 2000, 200000, state, n);
+
+      if (result)
+      {
+         fmpz_mod(r, n, f);
+         result = (fmpz_is_zero(r) && !fmpz_is_one(f) && !fmpz_equal(f, n));
+      }
+
+      if (!result)
+      {
+         printf("FAIL:\n");
+         printf("n = "), fmpz_print(n);
+         printf(", f = "), fmpz_print(f);
+         printf("\n");
+         abort();
+      }
+
+      fmpz_clear(n);
+      fmpz_clear(p);
+      fmpz_clear(q);
+      fmpz_clear(f);
+      fmpz_clear(r);
+   }
+
+   flint_randclear(state);
+
+   printf("PASS\n");
+   return 0;
+}
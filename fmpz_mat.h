@@ -280,6 +280,10 @@ slong fmpz_mat_nullspace(fmpz_mat_t res, const fmpz_mat_t mat);
 
 int fmpz_mat_inv(fmpz_mat_t B, fmpz_t den, const fmpz_mat_t A);
 
+/* Lattice reduction ********************************************************/
+
+void fmpz_mat_lll(fmpz_mat_t A, fmpz * d, ulong num, ulong den);
+
 /* Modular reduction and reconstruction *************************************/
 
 void fmpz_mat_set_nmod_mat(fmpz_mat_t A, const nmod_mat_t Amod);
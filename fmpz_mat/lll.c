@@ -0,0 +1,199 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdlib.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+#include "fmpz_mat.h"
+
+/*
+    Integral LLL, following Algorithm 2.6.7 of Cohen.  We use Cohen's
+    one-based indexing throughout, so that row b_k of the basis is row
+    k - 1 of A and lambda_{k,j} is entry (k - 1, j - 1) of L.
+ */
+
+#define LAMBDA(k, j) fmpz_mat_entry(L, (k) - 1, (j) - 1)
+
+static void
+_fmpz_mat_lll_red(fmpz_mat_t A, fmpz_mat_t L, const fmpz * D, 
+                  slong k, slong l, fmpz_t q, fmpz_t t)
+{
+    slong i;
+
+    fmpz_mul_2exp(t, LAMBDA(k, l), 1);
+    fmpz_abs(t, t);
+
+    if (fmpz_cmp(t, D + l) > 0)
+    {
+        /* q = round(lambda_{k,l} / d_l) */
+        fmpz_mul_2exp(t, LAMBDA(k, l), 1);
+        fmpz_add(t, t, D + l);
+        fmpz_mul_2exp(q, D + l, 1);
+        fmpz_fdiv_q(q, t, q);
+
+        _fmpz_vec_scalar_submul_fmpz(A->rows[k - 1], A->rows[l - 1], A->c, q);
+        fmpz_submul(LAMBDA(k, l), q, D + l);
+        for (i = 1; i < l; i++)
+            fmpz_submul(LAMBDA(k, i), q, LAMBDA(l, i));
+    }
+}
+
+static void
+_fmpz_mat_lll_swap(fmpz_mat_t A, fmpz_mat_t L, fmpz * D, 
+                   slong k, slong kmax, fmpz_t B, fmpz_t t)
+{
+    slong i, j;
+    fmpz * lambda = LAMBDA(k, k - 1);
+
+    fmpz_mat_swap_rows(A, NULL, k - 1, k - 2);
+    for (j = 1; j <= k - 2; j++)
+        fmpz_swap(LAMBDA(k, j), LAMBDA(k - 1, j));
+
+    fmpz_mul(B, D + k - 2, D + k);
+    fmpz_addmul(B, lambda, lambda);
+    fmpz_divexact(B, B, D + k - 1);
+
+    for (i = k + 1; i <= kmax; i++)
+    {
+        fmpz_set(t, LAMBDA(i, k));
+
+        fmpz_mul(LAMBDA(i, k), D + k, LAMBDA(i, k - 1));
+        fmpz_submul(LAMBDA(i, k), lambda, t);
+        fmpz_divexact(LAMBDA(i, k), LAMBDA(i, k), D + k - 1);
+
+        fmpz_mul(LAMBDA(i, k - 1), B, t);
+        fmpz_addmul(LAMBDA(i, k - 1), lambda, LAMBDA(i, k));
+        fmpz_divexact(LAMBDA(i, k - 1), LAMBDA(i, k - 1), D + k);
+    }
+
+    fmpz_set(D + k - 1, B);
+}
+
+void fmpz_mat_lll(fmpz_mat_t A, fmpz * d, ulong num, ulong den)
+{
+    const slong n = A->r;
+    slong i, j, k, l, kmax;
+    fmpz * D;
+    fmpz_mat_t L;
+    fmpz_t q, s, t, u;
+
+    if (n == 0)
+    {
+        if (d != NULL)
+            fmpz_one(d);
+        return;
+    }
+
+    if (num > den || 4 * num <= den)
+    {
+        printf("Exception (fmpz_mat_lll). Require 1/4 < delta <= 1.\n");
+        abort();
+    }
+
+    D = _fmpz_vec_init(n + 1);
+    fmpz_mat_init(L, n, n);
+    fmpz_init(q);
+    fmpz_init(s);
+    fmpz_init(t);
+    fmpz_init(u);
+
+    fmpz_one(D + 0);
+    for (i = 0; i < A->c; i++)
+        fmpz_addmul(D + 1, A->rows[0] + i, A->rows[0] + i);
+
+    if (fmpz_is_zero(D + 1))
+        goto dependent;
+
+    k = 2;
+    kmax = 1;
+
+    while (k <= n)
+    {
+        /* Incremental Gram-Schmidt */
+        if (k > kmax)
+        {
+            kmax = k;
+
+            for (j = 1; j <= k; j++)
+            {
+                fmpz_zero(u);
+                for (i = 0; i < A->c; i++)
+                    fmpz_addmul(u, A->rows[k - 1] + i, A->rows[j - 1] + i);
+
+                for (i = 1; i < j; i++)
+                {
+                    fmpz_mul(u, u, D + i);
+                    fmpz_submul(u, LAMBDA(k, i), LAMBDA(j, i));
+                    fmpz_divexact(u, u, D + i - 1);
+                }
+
+                if (j < k)
+                    fmpz_set(LAMBDA(k, j), u);
+                else if (fmpz_is_zero(u))
+                    goto dependent;
+                else
+                    fmpz_set(D + k, u);
+            }
+        }
+
+        /* Lovasz condition: den d_k d_{k-2} >= num d_{k-1}^2 - den l^2 */
+        for ( ; ; )
+        {
+            _fmpz_mat_lll_red(A, L, D, k, k - 1, q, t);
+
+            fmpz_mul(s, D + k, D + k - 2);
+            fmpz_mul_ui(s, s, den);
+            fmpz_mul(t, D + k - 1, D + k - 1);
+            fmpz_mul_ui(t, t, num);
+            fmpz_mul(u, LAMBDA(k, k - 1), LAMBDA(k, k - 1));
+            fmpz_submul_ui(t, u, den);
+
+            if (fmpz_cmp(s, t) >= 0)
+                break;
+
+            _fmpz_mat_lll_swap(A, L, D, k, kmax, q, t);
+            k = FLINT_MAX(2, k - 1);
+        }
+
+        for (l = k - 2; l >= 1; l--)
+            _fmpz_mat_lll_red(A, L, D, k, l, q, t);
+
+        k++;
+    }
+
+    if (d != NULL)
+        _fmpz_vec_set(d, D, n + 1);
+
+    _fmpz_vec_clear(D, n + 1);
+    fmpz_mat_clear(L);
+    fmpz_clear(q);
+    fmpz_clear(s);
+    fmpz_clear(t);
+    fmpz_clear(u);
+    return;
+
+dependent:
+
+    printf("Exception (fmpz_mat_lll). Rows are linearly dependent.\n");
+    abort();
+}
+
+#undef LAMBDA
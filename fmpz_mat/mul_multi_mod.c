@@ -24,25 +24,132 @@
 ******************************************************************************/
 
 #include "fmpz_mat.h"
+#include "thread_pool.h"
+
+typedef struct
+{
+    slong start;
+    slong stop;
+    fmpz * entries;
+    nmod_mat_t * mod_mats;
+    nmod_mat_t * mod_A;
+    nmod_mat_t * mod_B;
+    slong num_primes;
+    const fmpz_comb_struct * comb;
+}
+_mul_multi_mod_arg_struct;
+
+/* reduces entries [start, stop) modulo all primes */
+static void
+_mod_worker(void * varg)
+{
+    _mul_multi_mod_arg_struct * arg = (_mul_multi_mod_arg_struct *) varg;
+    slong i, j, num_primes = arg->num_primes;
+    fmpz_comb_temp_t comb_temp;
+    mp_limb_t * residues;
+
+    if (arg->start >= arg->stop)
+        return;
+
+    residues = flint_malloc(sizeof(mp_limb_t) * num_primes);
+    fmpz_comb_temp_init(comb_temp, arg->comb);
+
+    for (i = arg->start; i < arg->stop; i++)
+    {
+        fmpz_multi_mod_ui(residues, arg->entries + i, arg->comb, comb_temp);
+        for (j = 0; j < num_primes; j++)
+            arg->mod_mats[j]->entries[i] = residues[j];
+    }
+
+    fmpz_comb_temp_clear(comb_temp);
+    flint_free(residues);
+}
+
+/* multiplies the images modulo primes [start, stop) */
+static void
+_mul_worker(void * varg)
+{
+    _mul_multi_mod_arg_struct * arg = (_mul_multi_mod_arg_struct *) varg;
+    slong i;
+
+    for (i = arg->start; i < arg->stop; i++)
+        nmod_mat_mul(arg->mod_mats[i], arg->mod_A[i], arg->mod_B[i]);
+}
+
+/* reconstructs entries [start, stop) by Chinese remaindering */
+static void
+_crt_worker(void * varg)
+{
+    _mul_multi_mod_arg_struct * arg = (_mul_multi_mod_arg_struct *) varg;
+    slong i, j, num_primes = arg->num_primes;
+    fmpz_comb_temp_t comb_temp;
+    mp_limb_t * residues;
+
+    if (arg->start >= arg->stop)
+        return;
+
+    residues = flint_malloc(sizeof(mp_limb_t) * num_primes);
+    fmpz_comb_temp_init(comb_temp, arg->comb);
+
+    for (i = arg->start; i < arg->stop; i++)
+    {
+        for (j = 0; j < num_primes; j++)
+            residues[j] = arg->mod_mats[j]->entries[i];
+        fmpz_multi_CRT_ui(arg->entries + i, residues,
+                                               arg->comb, comb_temp, 1);
+    }
+
+    fmpz_comb_temp_clear(comb_temp);
+    flint_free(residues);
+}
+
+/*
+    Splits [0, len) evenly over the calling thread and num_workers workers
+    and runs f on each part.
+*/
+static void
+_mul_multi_mod_run(void (*f)(void *), _mul_multi_mod_arg_struct * args,
+            const _mul_multi_mod_arg_struct * proto, slong len,
+            thread_pool_handle * threads, slong num_workers)
+{
+    slong i;
+
+    for (i = 0; i <= num_workers; i++)
+    {
+        args[i] = *proto;
+        args[i].start = (i * len) / (num_workers + 1);
+        args[i].stop = ((i + 1) * len) / (num_workers + 1);
+    }
+
+    for (i = 0; i < num_workers; i++)
+        thread_pool_wake(global_thread_pool, threads[i], f, args + i + 1);
+
+    f(args);
+
+    for (i = 0; i < num_workers; i++)
+        thread_pool_wait(global_thread_pool, threads[i]);
+}
 
 void
 _fmpz_mat_mul_multi_mod(fmpz_mat_t C, const fmpz_mat_t A, const fmpz_mat_t B,
     mp_bitcnt_t bits)
 {
-    slong i, j;
+    slong i;
 
     fmpz_comb_t comb;
-    fmpz_comb_temp_t comb_temp;
 
     slong num_primes;
     mp_bitcnt_t primes_bits;
     mp_limb_t * primes;
-    mp_limb_t * residues;
 
     nmod_mat_t * mod_C;
     nmod_mat_t * mod_A;
     nmod_mat_t * mod_B;
 
+    thread_pool_handle * threads;
+    slong num_workers;
+    _mul_multi_mod_arg_struct proto, * args;
+
     primes_bits = NMOD_MAT_OPTIMAL_MODULUS_BITS;
 
     if (bits < primes_bits)
@@ -62,8 +169,6 @@ _fmpz_mat_mul_multi_mod(fmpz_mat_t C, const fmpz_mat_t A, const fmpz_mat_t B,
     for (i = 1; i < num_primes; i++)
         primes[i] = n_nextprime(primes[i-1], 0);
 
-    residues = flint_malloc(sizeof(mp_limb_t) * num_primes);
-
     mod_A = flint_malloc(sizeof(nmod_mat_t) * num_primes);
     mod_B = flint_malloc(sizeof(nmod_mat_t) * num_primes);
     mod_C = flint_malloc(sizeof(nmod_mat_t) * num_primes);
@@ -75,37 +180,55 @@ _fmpz_mat_mul_multi_mod(fmpz_mat_t C, const fmpz_mat_t A, const fmpz_mat_t B,
     }
 
     fmpz_comb_init(comb, primes, num_primes);
-    fmpz_comb_temp_init(comb_temp, comb);
+
+    num_workers = flint_request_threads(&threads, flint_get_num_threads());
+    args = flint_malloc(sizeof(_mul_multi_mod_arg_struct) * (num_workers + 1));
+
+    proto.num_primes = num_primes;
+    proto.comb = comb;
+    proto.mod_A = mod_A;
+    proto.mod_B = mod_B;
 
     /* Calculate residues of A */
-    for (i = 0; i < A->r * A->c; i++)
-    {
-        fmpz_multi_mod_ui(residues, &A->entries[i], comb, comb_temp);
-        for (j = 0; j < num_primes; j++)
-            mod_A[j]->entries[i] = residues[j];
-    }
+    proto.entries = A->entries;
+    proto.mod_mats = mod_A;
+    _mul_multi_mod_run(_mod_worker, args, &proto, A->r * A->c,
+                                                      threads, num_workers);
 
     /* Calculate residues of B */
-    for (i = 0; i < B->r * B->c; i++)
+    proto.entries = B->entries;
+    proto.mod_mats = mod_B;
+    _mul_multi_mod_run(_mod_worker, args, &proto, B->r * B->c,
+                                                      threads, num_workers);
+
+    /*
+        Multiply. With enough primes each thread takes a share of the primes;
+        otherwise the workers are handed back so that nmod_mat_mul can use
+        them for the individual products.
+    */
+    proto.mod_mats = mod_C;
+    if (num_primes > num_workers)
     {
-        fmpz_multi_mod_ui(residues, &B->entries[i], comb, comb_temp);
-        for (j = 0; j < num_primes; j++)
-            mod_B[j]->entries[i] = residues[j];
+        _mul_multi_mod_run(_mul_worker, args, &proto, num_primes,
+                                                      threads, num_workers);
     }
-
-    /* Multiply */
-    for (i = 0; i < num_primes; i++)
+    else
     {
-        nmod_mat_mul(mod_C[i], mod_A[i], mod_B[i]);
+        flint_give_back_threads(threads, num_workers);
+
+        for (i = 0; i < num_primes; i++)
+            nmod_mat_mul(mod_C[i], mod_A[i], mod_B[i]);
+
+        num_workers = flint_request_threads(&threads, num_workers + 1);
     }
 
     /* Chinese remaindering */
-    for (i = 0; i < C->r * C->c; i++)
-    {
-        for (j = 0; j < num_primes; j++)
-            residues[j] = mod_C[j]->entries[i];
-        fmpz_multi_CRT_ui(&C->entries[i], residues, comb, comb_temp, 1);
-    }
+    proto.entries = C->entries;
+    _mul_multi_mod_run(_crt_worker, args, &proto, C->r * C->c,
+                                                      threads, num_workers);
+
+    flint_give_back_threads(threads, num_workers);
+    flint_free(args);
 
     /* Cleanup */
     for (i = 0; i < num_primes; i++)
@@ -119,10 +242,8 @@ _fmpz_mat_mul_multi_mod(fmpz_mat_t C, const fmpz_mat_t A, const fmpz_mat_t B,
     flint_free(mod_B);
     flint_free(mod_C);
 
-    fmpz_comb_temp_clear(comb_temp);
     fmpz_comb_clear(comb);
 
-    flint_free(residues);
     flint_free(primes);
 }
 
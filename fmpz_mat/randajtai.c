@@ -55,7 +55,7 @@ fmpz_mat_randajtai(fmpz_mat_t mat, flint_rand_t state, double alpha)
         fmpz_add_ui(mat->rows[i] + i, mat->rows[i] + i, 2);
         fmpz_fdiv_q_2exp(mat->rows[i] + i, mat->rows[i] + i, 1);
 
-        for (j = i + 1; j <= d; j++)
+        for (j = i + 1; j < d; j++)
         {
             fmpz_randm(mat->rows[j] + i, state, tmp);
             if (n_randint(state, 2))
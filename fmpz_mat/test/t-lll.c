@@ -0,0 +1,252 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+#include "fmpz_mat.h"
+#include "fmpq.h"
+#include "fmpq_mat.h"
+#include "ulong_extras.h"
+
+/*
+    Checks that the rows of A are size reduced and satisfy the Lovasz
+    condition with delta = num/den, and that d holds the Gram
+    determinants of A, by recomputing the Gram-Schmidt data over Q.
+ */
+static int
+check_reduced(const fmpz_mat_t A, const fmpz * d, ulong num, ulong den)
+{
+    const slong m = A->r;
+    slong i, j, k;
+    fmpq_mat_t mu;
+    fmpq * B;
+    fmpq_t delta, half, s, t;
+    fmpz_t g;
+    int ok = 1;
+
+    fmpq_mat_init(mu, m, m);
+    B = flint_malloc(m * sizeof(fmpq));
+    for (i = 0; i < m; i++)
+        fmpq_init(B + i);
+    fmpq_init(delta);
+    fmpq_init(half);
+    fmpq_init(s);
+    fmpq_init(t);
+    fmpz_init(g);
+
+    fmpq_set_si(delta, num, den);
+    fmpq_set_si(half, 1, 2);
+
+    for (i = 0; i < m && ok; i++)
+    {
+        for (j = 0; j <= i; j++)
+        {
+            fmpz_zero(g);
+            for (k = 0; k < A->c; k++)
+                fmpz_addmul(g, fmpz_mat_entry(A, i, k), fmpz_mat_entry(A, j, k));
+            fmpz_set(fmpq_numref(s), g);
+            fmpz_one(fmpq_denref(s));
+
+            for (k = 0; k < j; k++)
+            {
+                fmpq_mul(t, fmpq_mat_entry(mu, j, k), fmpq_mat_entry(mu, i, k));
+                fmpq_mul(t, t, B + k);
+                fmpq_sub(s, s, t);
+            }
+
+            if (j < i)
+                fmpq_div(fmpq_mat_entry(mu, i, j), s, B + j);
+            else
+                fmpq_set(B + i, s);
+        }
+
+        for (j = 0; j < i; j++)
+        {
+            fmpq_abs(t, fmpq_mat_entry(mu, i, j));
+            ok = ok && (fmpq_cmp(t, half) <= 0);
+        }
+
+        if (i > 0)
+        {
+            fmpq_mul(t, fmpq_mat_entry(mu, i, i - 1), fmpq_mat_entry(mu, i, i - 1));
+            fmpq_sub(t, delta, t);
+            fmpq_mul(t, t, B + i - 1);
+            ok = ok && (fmpq_cmp(B + i, t) >= 0);
+        }
+
+        /* d_{i+1} = d_i B_i */
+        fmpq_mul_fmpz(t, B + i, d + i);
+        ok = ok && fmpz_is_one(fmpq_denref(t)) 
+                && fmpz_equal(fmpq_numref(t), d + i + 1);
+    }
+
+    fmpq_mat_clear(mu);
+    for (i = 0; i < m; i++)
+        fmpq_clear(B + i);
+    flint_free(B);
+    fmpq_clear(delta);
+    fmpq_clear(half);
+    fmpq_clear(s);
+    fmpq_clear(t);
+    fmpz_clear(g);
+
+    return ok;
+}
+
+int
+main(void)
+{
+    flint_rand_t state;
+    slong iter;
+
+    printf("lll....");
+    fflush(stdout);
+
+    flint_randinit(state);
+
+    /* Random full rank matrices, possibly non-square */
+    for (iter = 0; iter < 200 * flint_test_multiplier(); iter++)
+    {
+        fmpz_mat_t A, B, T, G;
+        fmpz * d;
+        fmpz_t det;
+        slong m, n, bits;
+        ulong num, den;
+
+        n = n_randint(state, 12);
+        m = n_randint(state, n + 1);
+        bits = 1 + n_randint(state, 100);
+
+        if (n_randint(state, 2))
+            num = 3, den = 4;
+        else
+            num = 99, den = 100;
+
+        fmpz_mat_init(A, m, n);
+        fmpz_mat_init(B, m, n);
+        fmpz_mat_init(T, n, m);
+        fmpz_mat_init(G, m, m);
+        d = _fmpz_vec_init(m + 1);
+        fmpz_init(det);
+
+        do {
+            fmpz_mat_randtest(A, state, bits);
+        } while (fmpz_mat_rank(A) != m);
+
+        fmpz_mat_set(B, A);
+        fmpz_mat_lll(B, d, num, den);
+
+        /* The Gram determinant is an invariant of the lattice */
+        fmpz_mat_transpose(T, A);
+        fmpz_mat_mul(G, A, T);
+        fmpz_mat_det(det, G);
+
+        if (!fmpz_equal(det, d + m) || !check_reduced(B, d, num, den))
+        {
+            printf("FAIL:\n");
+            printf("m = %ld, n = %ld\n", m, n);
+            fmpz_mat_print_pretty(A), printf("\n\n");
+            fmpz_mat_print_pretty(B), printf("\n\n");
+            abort();
+        }
+
+        fmpz_mat_clear(A);
+        fmpz_mat_clear(B);
+        fmpz_mat_clear(T);
+        fmpz_mat_clear(G);
+        _fmpz_vec_clear(d, m + 1);
+        fmpz_clear(det);
+    }
+
+    /* Square lattices: the reduced basis generates the same lattice */
+    for (iter = 0; iter < 50 * flint_test_multiplier(); iter++)
+    {
+        fmpz_mat_t A, B, Ainv, U;
+        fmpz * d;
+        fmpz_t den;
+        slong i, j, n;
+        int ok;
+
+        n = 1 + n_randint(state, 12);
+
+        fmpz_mat_init(A, n, n);
+        fmpz_mat_init(B, n, n);
+        fmpz_mat_init(Ainv, n, n);
+        fmpz_mat_init(U, n, n);
+        d = _fmpz_vec_init(n + 1);
+        fmpz_init(den);
+
+        switch (n_randint(state, 3))
+        {
+            case 0:
+                fmpz_mat_randajtai(A, state, 0.5);
+                break;
+            case 1:
+                fmpz_mat_randsimdioph(A, state, 
+                    10 + n_randint(state, 50), 60 + n_randint(state, 50));
+                break;
+            default:
+                do {
+                    fmpz_mat_randtest(A, state, 1 + n_randint(state, 100));
+                } while (fmpz_mat_rank(A) != n);
+        }
+
+        fmpz_mat_set(B, A);
+        fmpz_mat_lll(B, d, 99, 100);
+
+        fmpz_mat_inv(Ainv, den, A);
+        fmpz_mat_mul(U, B, Ainv);
+        fmpz_abs(den, den);
+
+        ok = check_reduced(B, d, 99, 100);
+        for (i = 0; i < n; i++)
+            for (j = 0; j < n; j++)
+                ok = ok && fmpz_divisible(fmpz_mat_entry(U, i, j), den);
+
+        fmpz_mat_det(den, A);
+        fmpz_abs(den, den);
+        fmpz_mul(den, den, den);
+        ok = ok && fmpz_equal(den, d + n);
+
+        if (!ok)
+        {
+            printf("FAIL (same lattice):\n");
+            fmpz_mat_print_pretty(A), printf("\n\n");
+            fmpz_mat_print_pretty(B), printf("\n\n");
+            abort();
+        }
+
+        fmpz_mat_clear(A);
+        fmpz_mat_clear(B);
+        fmpz_mat_clear(Ainv);
+        fmpz_mat_clear(U);
+        _fmpz_vec_clear(d, n + 1);
+        fmpz_clear(den);
+    }
+
+    flint_randclear(state);
+    flint_cleanup();
+    printf("PASS\n");
+    return 0;
+}
@@ -47,6 +47,8 @@ int main(void)
     {
         slong m, n, k;
 
+        flint_set_num_threads(1 + n_randint(state, 4));
+
         m = n_randint(state, 50);
         n = n_randint(state, 50);
         k = n_randint(state, 50);
@@ -77,6 +79,8 @@ int main(void)
         fmpz_mat_clear(D);
     }
 
+    flint_set_num_threads(1);
+
     flint_randclear(state);
     flint_cleanup();
     printf("PASS\n");
@@ -40,6 +40,11 @@
  extern "C" {
 #endif
 
+#define FMPZ_MOD_POLY_HGCD_CUTOFF  128  /* HGCD: Basecase -> Recursion */
+#define FMPZ_MOD_POLY_GCD_CUTOFF  256   /* GCD:  Euclidean -> HGCD     */
+
+#define FMPZ_MOD_POLY_DIVREM_NEWTON_CUTOFF  16  /* lenB: Divconquer -> Newton */
+
 /*  Type definitions *********************************************************/
 
 typedef struct
@@ -139,6 +144,9 @@ void fmpz_mod_poly_set(fmpz_mod_poly_t poly1, const fmpz_mod_poly_t poly2);
 
 void fmpz_mod_poly_swap(fmpz_mod_poly_t poly1, fmpz_mod_poly_t poly2);
 
+void fmpz_mod_poly_reverse(fmpz_mod_poly_t res, 
+                           const fmpz_mod_poly_t poly, slong n);
+
 static __inline__ 
 void fmpz_mod_poly_zero(fmpz_mod_poly_t poly)
 {
@@ -267,6 +275,18 @@ void _fmpz_mod_poly_mulmod(fmpz * res, const fmpz * poly1, slong len1,
 void fmpz_mod_poly_mulmod(fmpz_mod_poly_t res, const fmpz_mod_poly_t poly1,
                     const fmpz_mod_poly_t poly2, const fmpz_mod_poly_t f);
 
+void _fmpz_mod_poly_mulmod_preinv(fmpz * res, const fmpz * poly1, slong len1,
+                                  const fmpz * poly2, slong len2, 
+                                  const fmpz * f, slong lenf, 
+                                  const fmpz * finv, slong lenfinv, 
+                                  const fmpz_t p);
+
+void fmpz_mod_poly_mulmod_preinv(fmpz_mod_poly_t res, 
+                                 const fmpz_mod_poly_t poly1,
+                                 const fmpz_mod_poly_t poly2, 
+                                 const fmpz_mod_poly_t f, 
+                                 const fmpz_mod_poly_t finv);
+
 /*  Powering *****************************************************************/
 
 void _fmpz_mod_poly_pow(fmpz *rop, const fmpz *op, slong len, ulong e, 
@@ -295,6 +315,18 @@ fmpz_mod_poly_powmod_ui_binexp(fmpz_mod_poly_t res,
                          const fmpz_mod_poly_t poly, ulong e,
                          const fmpz_mod_poly_t f);
 
+void
+_fmpz_mod_poly_powmod_ui_binexp_preinv(fmpz * res, const fmpz * poly,
+                                       ulong e, const fmpz * f, slong lenf, 
+                                       const fmpz * finv, slong lenfinv, 
+                                       const fmpz_t p);
+
+void
+fmpz_mod_poly_powmod_ui_binexp_preinv(fmpz_mod_poly_t res,
+                                      const fmpz_mod_poly_t poly, ulong e,
+                                      const fmpz_mod_poly_t f, 
+                                      const fmpz_mod_poly_t finv);
+
 void
 _fmpz_mod_poly_powmod_fmpz_binexp(fmpz * res, const fmpz * poly,
                                   const fmpz_t e, const fmpz * f,
@@ -305,6 +337,19 @@ fmpz_mod_poly_powmod_fmpz_binexp(fmpz_mod_poly_t res,
                            const fmpz_mod_poly_t poly, const fmpz_t e,
                            const fmpz_mod_poly_t f);
 
+void
+_fmpz_mod_poly_powmod_fmpz_binexp_preinv(fmpz * res, const fmpz * poly,
+                                         const fmpz_t e, const fmpz * f, 
+                                         slong lenf, const fmpz * finv, 
+                                         slong lenfinv, const fmpz_t p);
+
+void
+fmpz_mod_poly_powmod_fmpz_binexp_preinv(fmpz_mod_poly_t res,
+                                        const fmpz_mod_poly_t poly, 
+                                        const fmpz_t e, 
+                                        const fmpz_mod_poly_t f, 
+                                        const fmpz_mod_poly_t finv);
+
 /*  Division *****************************************************************/
 
 void _fmpz_mod_poly_divrem_basecase(fmpz * Q, fmpz * R, 
@@ -341,19 +386,85 @@ void _fmpz_mod_poly_divrem_divconquer(fmpz * Q, fmpz * R,
 void fmpz_mod_poly_divrem_divconquer(fmpz_mod_poly_t Q, fmpz_mod_poly_t R, 
                                      const fmpz_mod_poly_t A, const fmpz_mod_poly_t B);
 
+void _fmpz_mod_poly_div_newton(fmpz * Q, const fmpz * A, slong lenA, 
+                               const fmpz * B, slong lenB, const fmpz_t invB, 
+                               const fmpz_t p);
+
+void fmpz_mod_poly_div_newton(fmpz_mod_poly_t Q, 
+                              const fmpz_mod_poly_t A, const fmpz_mod_poly_t B);
+
+void _fmpz_mod_poly_divrem_newton(fmpz * Q, fmpz * R, 
+                                  const fmpz * A, slong lenA, 
+                                  const fmpz * B, slong lenB, 
+                                  const fmpz_t invB, const fmpz_t p);
+
+void fmpz_mod_poly_divrem_newton(fmpz_mod_poly_t Q, fmpz_mod_poly_t R, 
+                                 const fmpz_mod_poly_t A, 
+                                 const fmpz_mod_poly_t B);
+
+void _fmpz_mod_poly_div_newton21_preinv(fmpz * Q, const fmpz * A, slong lenA,
+                                        const fmpz * B, slong lenB, 
+                                        const fmpz * Binv, slong lenBinv, 
+                                        const fmpz_t p);
+
+void fmpz_mod_poly_div_newton21_preinv(fmpz_mod_poly_t Q, 
+                                       const fmpz_mod_poly_t A, 
+                                       const fmpz_mod_poly_t B, 
+                                       const fmpz_mod_poly_t Binv);
+
+void _fmpz_mod_poly_divrem_newton21_preinv(fmpz * Q, fmpz * R, 
+                                           const fmpz * A, slong lenA, 
+                                           const fmpz * B, slong lenB, 
+                                           const fmpz * Binv, slong lenBinv, 
+                                           const fmpz_t p);
+
+void fmpz_mod_poly_divrem_newton21_preinv(fmpz_mod_poly_t Q, fmpz_mod_poly_t R,
+                                          const fmpz_mod_poly_t A, 
+                                          const fmpz_mod_poly_t B, 
+                                          const fmpz_mod_poly_t Binv);
+
+/*
+   Newton division inverts the reversed divisor to the length of the 
+   quotient, so it only pays off for divisors which are not too short, 
+   and as p grows, only for quotients not much longer than the divisor.
+*/
+static __inline__
+int _fmpz_mod_poly_divrem_use_newton(slong lenA, slong lenB, const fmpz_t p)
+{
+    const slong lenQ = lenA - lenB + 1, limbs = fmpz_size(p);
+
+    if (lenQ < 64 || lenB < FMPZ_MOD_POLY_DIVREM_NEWTON_CUTOFF)
+        return 0;
+
+    if (limbs <= 1)
+        return 1;
+    else if (limbs == 2)
+        return lenQ <= 32 * lenB;
+    else if (limbs == 3)
+        return lenB >= 32 && lenQ <= 16 * lenB;
+    else
+        return lenB >= 64 && lenQ <= 4 * lenB;
+}
+
 static __inline__
 void _fmpz_mod_poly_divrem(fmpz *Q, fmpz *R, 
                            const fmpz *A, slong lenA, const fmpz *B, slong lenB, 
                            const fmpz_t invB, const fmpz_t p)
 {
-    _fmpz_mod_poly_divrem_divconquer(Q, R, A, lenA, B, lenB, invB, p);
+    if (_fmpz_mod_poly_divrem_use_newton(lenA, lenB, p))
+        _fmpz_mod_poly_divrem_newton(Q, R, A, lenA, B, lenB, invB, p);
+    else
+        _fmpz_mod_poly_divrem_divconquer(Q, R, A, lenA, B, lenB, invB, p);
 }
 
 static __inline__ 
 void fmpz_mod_poly_divrem(fmpz_mod_poly_t Q, fmpz_mod_poly_t R, 
                           const fmpz_mod_poly_t A, const fmpz_mod_poly_t B)
 {
-    fmpz_mod_poly_divrem_divconquer(Q, R, A, B);
+    if (_fmpz_mod_poly_divrem_use_newton(A->length, B->length, &B->p))
+        fmpz_mod_poly_divrem_newton(Q, R, A, B);
+    else
+        fmpz_mod_poly_divrem_divconquer(Q, R, A, B);
 }
 
 void _fmpz_mod_poly_divrem_f(fmpz_t f, fmpz *Q, fmpz *R, 
@@ -377,7 +488,7 @@ void _fmpz_mod_poly_rem(fmpz *R,
        _fmpz_vec_zero(R + lenA, lenB - 1 - lenA);
     } else
     {
-       _fmpz_mod_poly_divrem_divconquer(Q, T, A, lenA, B, lenB, invB, p);
+       _fmpz_mod_poly_divrem(Q, T, A, lenA, B, lenB, invB, p);
        _fmpz_vec_set(R, T, lenB - 1);
     }
 
@@ -417,19 +528,36 @@ void fmpz_mod_poly_gcd_euclidean(fmpz_mod_poly_t G,
                                  const fmpz_mod_poly_t A,
                                  const fmpz_mod_poly_t B);
 
+slong _fmpz_mod_poly_hgcd(fmpz **M, slong *lenM, 
+                          fmpz *A, slong *lenA, fmpz *B, slong *lenB, 
+                          const fmpz *a, slong lena, const fmpz *b, slong lenb, 
+                          const fmpz_t p);
+
+slong _fmpz_mod_poly_gcd_hgcd(fmpz *G, const fmpz *A, slong lenA, 
+                                      const fmpz *B, slong lenB, const fmpz_t p);
+
+void fmpz_mod_poly_gcd_hgcd(fmpz_mod_poly_t G, 
+                            const fmpz_mod_poly_t A, const fmpz_mod_poly_t B);
+
 static __inline__ 
 slong _fmpz_mod_poly_gcd(fmpz *G, const fmpz *A, slong lenA, 
                                  const fmpz *B, slong lenB, 
                                  const fmpz_t invB, const fmpz_t p)
 {
-    return _fmpz_mod_poly_gcd_euclidean(G, A, lenA, B, lenB, invB, p);
+    if (lenA < FMPZ_MOD_POLY_GCD_CUTOFF)
+        return _fmpz_mod_poly_gcd_euclidean(G, A, lenA, B, lenB, invB, p);
+    else
+        return _fmpz_mod_poly_gcd_hgcd(G, A, lenA, B, lenB, p);
 }
 
 static __inline__ 
 void fmpz_mod_poly_gcd(fmpz_mod_poly_t G, 
                        const fmpz_mod_poly_t A, const fmpz_mod_poly_t B)
 {
-    fmpz_mod_poly_gcd_euclidean(G, A, B);
+    if (FLINT_MAX(A->length, B->length) < FMPZ_MOD_POLY_GCD_CUTOFF)
+        fmpz_mod_poly_gcd_euclidean(G, A, B);
+    else
+        fmpz_mod_poly_gcd_hgcd(G, A, B);
 }
 
 slong _fmpz_mod_poly_gcd_euclidean_f(fmpz_t f, fmpz *G, 
@@ -456,19 +584,33 @@ void fmpz_mod_poly_xgcd_euclidean(fmpz_mod_poly_t G,
                              fmpz_mod_poly_t S, fmpz_mod_poly_t T,
                              const fmpz_mod_poly_t A, const fmpz_mod_poly_t B);
 
+slong _fmpz_mod_poly_xgcd_hgcd(fmpz *G, fmpz *S, fmpz *T, 
+                               const fmpz *A, slong lenA, 
+                               const fmpz *B, slong lenB, const fmpz_t p);
+
+void fmpz_mod_poly_xgcd_hgcd(fmpz_mod_poly_t G, 
+                             fmpz_mod_poly_t S, fmpz_mod_poly_t T,
+                             const fmpz_mod_poly_t A, const fmpz_mod_poly_t B);
+
 static __inline__ slong 
 _fmpz_mod_poly_xgcd(fmpz *G, fmpz *S, fmpz *T, 
                     const fmpz *A, slong lenA, const fmpz *B, slong lenB, 
                     const fmpz_t invB, const fmpz_t p)
 {
-    return _fmpz_mod_poly_xgcd_euclidean(G, S, T, A, lenA, B, lenB, invB, p);
+    if (lenA < FMPZ_MOD_POLY_GCD_CUTOFF)
+        return _fmpz_mod_poly_xgcd_euclidean(G, S, T, A, lenA, B, lenB, invB, p);
+    else
+        return _fmpz_mod_poly_xgcd_hgcd(G, S, T, A, lenA, B, lenB, p);
 }
 
 static __inline__ void 
 fmpz_mod_poly_xgcd(fmpz_mod_poly_t G, fmpz_mod_poly_t S, fmpz_mod_poly_t T,
                    const fmpz_mod_poly_t A, const fmpz_mod_poly_t B)
 {
-    fmpz_mod_poly_xgcd_euclidean(G, S, T, A, B);
+    if (FLINT_MAX(A->length, B->length) < FMPZ_MOD_POLY_GCD_CUTOFF)
+        fmpz_mod_poly_xgcd_euclidean(G, S, T, A, B);
+    else
+        fmpz_mod_poly_xgcd_hgcd(G, S, T, A, B);
 }
 
 slong _fmpz_mod_poly_gcdinv(fmpz *G, fmpz *S, 
@@ -583,6 +725,17 @@ void
 fmpz_mod_poly_compose_mod_brent_kung(fmpz_mod_poly_t res, const fmpz_mod_poly_t poly1,
                              const fmpz_mod_poly_t poly2, const fmpz_mod_poly_t poly3);
 
+void
+_fmpz_mod_poly_compose_mod_brent_kung_preinv(fmpz * res, 
+                          const fmpz * poly1, slong len1, const fmpz * poly2, 
+                          const fmpz * poly3, slong len3, 
+                          const fmpz * poly3inv, slong len3inv, const fmpz_t p);
+
+void
+fmpz_mod_poly_compose_mod_brent_kung_preinv(fmpz_mod_poly_t res, 
+                    const fmpz_mod_poly_t poly1, const fmpz_mod_poly_t poly2, 
+                    const fmpz_mod_poly_t poly3, const fmpz_mod_poly_t poly3inv);
+
 void
 _fmpz_mod_poly_compose_mod_horner(fmpz * res, const fmpz * f, slong lenf, const fmpz * g,
                                               const fmpz * h, slong lenh, const fmpz_t p);
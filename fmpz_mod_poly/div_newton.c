@@ -0,0 +1,104 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+#include "fmpz_poly.h"
+#include "fmpz_mod_poly.h"
+
+void _fmpz_mod_poly_div_newton(fmpz * Q, const fmpz * A, slong lenA, 
+                               const fmpz * B, slong lenB, const fmpz_t invB, 
+                               const fmpz_t p)
+{
+    const slong lenQ = lenA - lenB + 1;
+    fmpz * Arev, * Brev, * Binv;
+
+    Arev = _fmpz_vec_init(3 * lenQ);
+    Brev = Arev + lenQ;
+    Binv = Brev + lenQ;
+
+    _fmpz_poly_reverse(Arev, A + (lenA - lenQ), lenQ, lenQ);
+
+    if (lenB >= lenQ)
+        _fmpz_poly_reverse(Brev, B + (lenB - lenQ), lenQ, lenQ);
+    else
+        _fmpz_poly_reverse(Brev, B, lenB, lenB);
+
+    _fmpz_mod_poly_inv_series_newton(Binv, Brev, lenQ, invB, p);
+
+    _fmpz_mod_poly_mullow(Q, Arev, lenQ, Binv, lenQ, p, lenQ);
+
+    _fmpz_poly_reverse(Q, Q, lenQ, lenQ);
+
+    _fmpz_vec_clear(Arev, 3 * lenQ);
+}
+
+void fmpz_mod_poly_div_newton(fmpz_mod_poly_t Q, 
+                              const fmpz_mod_poly_t A, const fmpz_mod_poly_t B)
+{
+    const slong lenA = A->length, lenB = B->length, lenQ = lenA - lenB + 1;
+    fmpz *q;
+    fmpz_t invB;
+
+    if (lenB == 0)
+    {
+        printf("Exception (fmpz_mod_poly_div_newton). Division by zero.\n");
+        abort();
+    }
+
+    if (lenA < lenB)
+    {
+        fmpz_mod_poly_zero(Q);
+        return;
+    }
+
+    fmpz_init(invB);
+    fmpz_invmod(invB, B->coeffs + (lenB - 1), &(B->p));
+
+    if (Q == A || Q == B)
+    {
+        q = _fmpz_vec_init(lenQ);
+    }
+    else
+    {
+        fmpz_mod_poly_fit_length(Q, lenQ);
+        q = Q->coeffs;
+    }
+
+    _fmpz_mod_poly_div_newton(q, A->coeffs, lenA, B->coeffs, lenB, 
+                              invB, &(B->p));
+
+    if (Q == A || Q == B)
+    {
+        _fmpz_vec_clear(Q->coeffs, Q->alloc);
+        Q->coeffs = q;
+        Q->alloc  = lenQ;
+        Q->length = lenQ;
+    }
+    else
+    {
+        _fmpz_mod_poly_set_length(Q, lenQ);
+    }
+
+    fmpz_clear(invB);
+}
@@ -0,0 +1,272 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "fmpz_mod_poly.h"
+#include "ulong_extras.h"
+
+int
+main(void)
+{
+    int i, result;
+    flint_rand_t state;
+
+    printf("compose_mod_brent_kung_preinv....");
+    fflush(stdout);
+
+    flint_randinit(state);
+
+    /* Check result against compose_mod */
+    for (i = 0; i < 1000 * flint_test_multiplier(); i++)
+    {
+        fmpz_t p;
+        fmpz_mod_poly_t a, b, c, cinv, d, e;
+
+        fmpz_init(p);
+        fmpz_set_ui(p, n_randtest_prime(state, 0));
+
+        fmpz_mod_poly_init(a, p);
+        fmpz_mod_poly_init(b, p);
+        fmpz_mod_poly_init(c, p);
+        fmpz_mod_poly_init(cinv, p);
+        fmpz_mod_poly_init(d, p);
+        fmpz_mod_poly_init(e, p);
+
+        fmpz_mod_poly_randtest(a, state, n_randint(state, 40) + 1);
+        fmpz_mod_poly_randtest(b, state, n_randint(state, 40) + 1);
+        fmpz_mod_poly_randtest_not_zero(c, state, n_randint(state, 40) + 1);
+        fmpz_mod_poly_rem(a, a, c);
+        fmpz_mod_poly_reverse(cinv, c, c->length);
+        fmpz_mod_poly_inv_series_newton(cinv, cinv, c->length);
+
+        fmpz_mod_poly_compose_mod_brent_kung_preinv(d, a, b, c, cinv);
+        fmpz_mod_poly_compose_mod(e, a, b, c);
+
+        result = (fmpz_mod_poly_equal(d, e));
+        if (!result)
+        {
+            printf("FAIL #1:\n");
+            printf("p = "), fmpz_print(p), printf("\n\n");
+            printf("a = "), fmpz_mod_poly_print(a), printf("\n\n");
+            printf("b = "), fmpz_mod_poly_print(b), printf("\n\n");
+            printf("c = "), fmpz_mod_poly_print(c), printf("\n\n");
+            printf("d = "), fmpz_mod_poly_print(d), printf("\n\n");
+            printf("e = "), fmpz_mod_poly_print(e), printf("\n\n");
+            abort();
+        }
+
+        fmpz_mod_poly_clear(a);
+        fmpz_mod_poly_clear(b);
+        fmpz_mod_poly_clear(c);
+        fmpz_mod_poly_clear(cinv);
+        fmpz_mod_poly_clear(d);
+        fmpz_mod_poly_clear(e);
+        fmpz_clear(p);
+    }
+
+    /* Check aliasing of res and a */
+    for (i = 0; i < 200 * flint_test_multiplier(); i++)
+    {
+        fmpz_t p;
+        fmpz_mod_poly_t a, b, c, cinv, d;
+
+        fmpz_init(p);
+        fmpz_set_ui(p, n_randtest_prime(state, 0));
+
+        fmpz_mod_poly_init(a, p);
+        fmpz_mod_poly_init(b, p);
+        fmpz_mod_poly_init(c, p);
+        fmpz_mod_poly_init(cinv, p);
+        fmpz_mod_poly_init(d, p);
+
+        fmpz_mod_poly_randtest(a, state, n_randint(state, 40) + 1);
+        fmpz_mod_poly_randtest(b, state, n_randint(state, 40) + 1);
+        fmpz_mod_poly_randtest_not_zero(c, state, n_randint(state, 40) + 1);
+        fmpz_mod_poly_rem(a, a, c);
+        fmpz_mod_poly_reverse(cinv, c, c->length);
+        fmpz_mod_poly_inv_series_newton(cinv, cinv, c->length);
+
+        fmpz_mod_poly_compose_mod_brent_kung_preinv(d, a, b, c, cinv);
+        fmpz_mod_poly_compose_mod_brent_kung_preinv(a, a, b, c, cinv);
+
+        result = (fmpz_mod_poly_equal(d, a));
+        if (!result)
+        {
+            printf("FAIL #2:\n");
+            printf("p = "), fmpz_print(p), printf("\n\n");
+            printf("a = "), fmpz_mod_poly_print(a), printf("\n\n");
+            printf("b = "), fmpz_mod_poly_print(b), printf("\n\n");
+            printf("c = "), fmpz_mod_poly_print(c), printf("\n\n");
+            printf("d = "), fmpz_mod_poly_print(d), printf("\n\n");
+            abort();
+        }
+
+        fmpz_mod_poly_clear(a);
+        fmpz_mod_poly_clear(b);
+        fmpz_mod_poly_clear(c);
+        fmpz_mod_poly_clear(cinv);
+        fmpz_mod_poly_clear(d);
+        fmpz_clear(p);
+    }
+
+    /* Check aliasing of res and b */
+    for (i = 0; i < 200 * flint_test_multiplier(); i++)
+    {
+        fmpz_t p;
+        fmpz_mod_poly_t a, b, c, cinv, d;
+
+        fmpz_init(p);
+        fmpz_set_ui(p, n_randtest_prime(state, 0));
+
+        fmpz_mod_poly_init(a, p);
+        fmpz_mod_poly_init(b, p);
+        fmpz_mod_poly_init(c, p);
+        fmpz_mod_poly_init(cinv, p);
+        fmpz_mod_poly_init(d, p);
+
+        fmpz_mod_poly_randtest(a, state, n_randint(state, 40) + 1);
+        fmpz_mod_poly_randtest(b, state, n_randint(state, 40) + 1);
+        fmpz_mod_poly_randtest_not_zero(c, state, n_randint(state, 40) + 1);
+        fmpz_mod_poly_rem(a, a, c);
+        fmpz_mod_poly_reverse(cinv, c, c->length);
+        fmpz_mod_poly_inv_series_newton(cinv, cinv, c->length);
+
+        fmpz_mod_poly_compose_mod_brent_kung_preinv(d, a, b, c, cinv);
+        fmpz_mod_poly_compose_mod_brent_kung_preinv(b, a, b, c, cinv);
+
+        result = (fmpz_mod_poly_equal(d, b));
+        if (!result)
+        {
+            printf("FAIL #3:\n");
+            printf("p = "), fmpz_print(p), printf("\n\n");
+            printf("a = "), fmpz_mod_poly_print(a), printf("\n\n");
+            printf("b = "), fmpz_mod_poly_print(b), printf("\n\n");
+            printf("c = "), fmpz_mod_poly_print(c), printf("\n\n");
+            printf("d = "), fmpz_mod_poly_print(d), printf("\n\n");
+            abort();
+        }
+
+        fmpz_mod_poly_clear(a);
+        fmpz_mod_poly_clear(b);
+        fmpz_mod_poly_clear(c);
+        fmpz_mod_poly_clear(cinv);
+        fmpz_mod_poly_clear(d);
+        fmpz_clear(p);
+    }
+
+    /* Check aliasing of res and c */
+    for (i = 0; i < 200 * flint_test_multiplier(); i++)
+    {
+        fmpz_t p;
+        fmpz_mod_poly_t a, b, c, cinv, d;
+
+        fmpz_init(p);
+        fmpz_set_ui(p, n_randtest_prime(state, 0));
+
+        fmpz_mod_poly_init(a, p);
+        fmpz_mod_poly_init(b, p);
+        fmpz_mod_poly_init(c, p);
+        fmpz_mod_poly_init(cinv, p);
+        fmpz_mod_poly_init(d, p);
+
+        fmpz_mod_poly_randtest(a, state, n_randint(state, 40) + 1);
+        fmpz_mod_poly_randtest(b, state, n_randint(state, 40) + 1);
+        fmpz_mod_poly_randtest_not_zero(c, state, n_randint(state, 40) + 1);
+        fmpz_mod_poly_rem(a, a, c);
+        fmpz_mod_poly_reverse(cinv, c, c->length);
+        fmpz_mod_poly_inv_series_newton(cinv, cinv, c->length);
+
+        fmpz_mod_poly_compose_mod_brent_kung_preinv(d, a, b, c, cinv);
+        fmpz_mod_poly_compose_mod_brent_kung_preinv(c, a, b, c, cinv);
+
+        result = (fmpz_mod_poly_equal(d, c));
+        if (!result)
+        {
+            printf("FAIL #4:\n");
+            printf("p = "), fmpz_print(p), printf("\n\n");
+            printf("a = "), fmpz_mod_poly_print(a), printf("\n\n");
+            printf("b = "), fmpz_mod_poly_print(b), printf("\n\n");
+            printf("c = "), fmpz_mod_poly_print(c), printf("\n\n");
+            printf("d = "), fmpz_mod_poly_print(d), printf("\n\n");
+            abort();
+        }
+
+        fmpz_mod_poly_clear(a);
+        fmpz_mod_poly_clear(b);
+        fmpz_mod_poly_clear(c);
+        fmpz_mod_poly_clear(cinv);
+        fmpz_mod_poly_clear(d);
+        fmpz_clear(p);
+    }
+
+    /* Check aliasing of res and cinv */
+    for (i = 0; i < 200 * flint_test_multiplier(); i++)
+    {
+        fmpz_t p;
+        fmpz_mod_poly_t a, b, c, cinv, d;
+
+        fmpz_init(p);
+        fmpz_set_ui(p, n_randtest_prime(state, 0));
+
+        fmpz_mod_poly_init(a, p);
+        fmpz_mod_poly_init(b, p);
+        fmpz_mod_poly_init(c, p);
+        fmpz_mod_poly_init(cinv, p);
+        fmpz_mod_poly_init(d, p);
+
+        fmpz_mod_poly_randtest(a, state, n_randint(state, 40) + 1);
+        fmpz_mod_poly_randtest(b, state, n_randint(state, 40) + 1);
+        fmpz_mod_poly_randtest_not_zero(c, state, n_randint(state, 40) + 1);
+        fmpz_mod_poly_rem(a, a, c);
+        fmpz_mod_poly_reverse(cinv, c, c->length);
+        fmpz_mod_poly_inv_series_newton(cinv, cinv, c->length);
+
+        fmpz_mod_poly_compose_mod_brent_kung_preinv(d, a, b, c, cinv);
+        fmpz_mod_poly_compose_mod_brent_kung_preinv(cinv, a, b, c, cinv);
+
+        result = (fmpz_mod_poly_equal(d, cinv));
+        if (!result)
+        {
+            printf("FAIL #5:\n");
+            printf("p = "), fmpz_print(p), printf("\n\n");
+            printf("a = "), fmpz_mod_poly_print(a), printf("\n\n");
+            printf("b = "), fmpz_mod_poly_print(b), printf("\n\n");
+            printf("c = "), fmpz_mod_poly_print(c), printf("\n\n");
+            printf("d = "), fmpz_mod_poly_print(d), printf("\n\n");
+            abort();
+        }
+
+        fmpz_mod_poly_clear(a);
+        fmpz_mod_poly_clear(b);
+        fmpz_mod_poly_clear(c);
+        fmpz_mod_poly_clear(cinv);
+        fmpz_mod_poly_clear(d);
+        fmpz_clear(p);
+    }
+
+    flint_randclear(state);
+    flint_cleanup();
+    printf("PASS\n");
+    return 0;
+}
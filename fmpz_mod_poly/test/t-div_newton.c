@@ -0,0 +1,202 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "fmpz_mod_poly.h"
+#include "ulong_extras.h"
+
+int
+main(void)
+{
+    int i, result;
+    flint_rand_t state;
+
+    printf("div_newton....");
+    fflush(stdout);
+
+    flint_randinit(state);
+
+    /* Check result against div_basecase */
+    for (i = 0; i < 500 * flint_test_multiplier(); i++)
+    {
+        fmpz_t p;
+        fmpz_mod_poly_t a, b, q, r, test;
+
+        fmpz_init(p);
+        fmpz_randtest_unsigned(p, state, 2 * FLINT_BITS);
+        fmpz_add_ui(p, p, 2);
+
+        fmpz_mod_poly_init(a, p);
+        fmpz_mod_poly_init(b, p);
+        fmpz_mod_poly_init(q, p);
+        fmpz_mod_poly_init(r, p);
+        fmpz_mod_poly_init(test, p);
+
+        fmpz_mod_poly_randtest(a, state, n_randint(state, 200));
+        fmpz_mod_poly_randtest_not_zero(b, state, n_randint(state, 200) + 1);
+
+        {
+            fmpz_t d;
+            fmpz *leadB = fmpz_mod_poly_lead(b);
+
+            fmpz_init(d);
+            fmpz_gcd(d, p, leadB);
+            while (!fmpz_is_one(d))
+            {
+                fmpz_divexact(leadB, leadB, d);
+                fmpz_gcd(d, p, leadB);
+            }
+            fmpz_clear(d);
+        }
+
+        fmpz_mod_poly_div_newton(q, a, b);
+        fmpz_mod_poly_divrem_divconquer(test, r, a, b);
+
+        result = (fmpz_mod_poly_equal(q, test));
+        if (!result)
+        {
+            printf("FAIL #1:\n");
+            printf("p = "), fmpz_print(p), printf("\n\n");
+            printf("a = "), fmpz_mod_poly_print(a), printf("\n\n");
+            printf("b = "), fmpz_mod_poly_print(b), printf("\n\n");
+            printf("q = "), fmpz_mod_poly_print(q), printf("\n\n");
+            printf("test = "), fmpz_mod_poly_print(test), printf("\n\n");
+            abort();
+        }
+
+        fmpz_mod_poly_clear(a);
+        fmpz_mod_poly_clear(b);
+        fmpz_mod_poly_clear(q);
+        fmpz_mod_poly_clear(r);
+        fmpz_mod_poly_clear(test);
+        fmpz_clear(p);
+    }
+
+    /* Alias a and q */
+    for (i = 0; i < 100 * flint_test_multiplier(); i++)
+    {
+        fmpz_t p;
+        fmpz_mod_poly_t a, b, q;
+
+        fmpz_init(p);
+        fmpz_randtest_unsigned(p, state, 2 * FLINT_BITS);
+        fmpz_add_ui(p, p, 2);
+
+        fmpz_mod_poly_init(a, p);
+        fmpz_mod_poly_init(b, p);
+        fmpz_mod_poly_init(q, p);
+
+        fmpz_mod_poly_randtest(a, state, n_randint(state, 200));
+        fmpz_mod_poly_randtest_not_zero(b, state, n_randint(state, 200) + 1);
+
+        {
+            fmpz_t d;
+            fmpz *leadB = fmpz_mod_poly_lead(b);
+
+            fmpz_init(d);
+            fmpz_gcd(d, p, leadB);
+            while (!fmpz_is_one(d))
+            {
+                fmpz_divexact(leadB, leadB, d);
+                fmpz_gcd(d, p, leadB);
+            }
+            fmpz_clear(d);
+        }
+
+        fmpz_mod_poly_div_newton(q, a, b);
+        fmpz_mod_poly_div_newton(a, a, b);
+
+        result = (fmpz_mod_poly_equal(q, a));
+        if (!result)
+        {
+            printf("FAIL #2:\n");
+            printf("p = "), fmpz_print(p), printf("\n\n");
+            printf("a = "), fmpz_mod_poly_print(a), printf("\n\n");
+            printf("b = "), fmpz_mod_poly_print(b), printf("\n\n");
+            printf("q = "), fmpz_mod_poly_print(q), printf("\n\n");
+            abort();
+        }
+
+        fmpz_mod_poly_clear(a);
+        fmpz_mod_poly_clear(b);
+        fmpz_mod_poly_clear(q);
+        fmpz_clear(p);
+    }
+
+    /* Alias b and q */
+    for (i = 0; i < 100 * flint_test_multiplier(); i++)
+    {
+        fmpz_t p;
+        fmpz_mod_poly_t a, b, q;
+
+        fmpz_init(p);
+        fmpz_randtest_unsigned(p, state, 2 * FLINT_BITS);
+        fmpz_add_ui(p, p, 2);
+
+        fmpz_mod_poly_init(a, p);
+        fmpz_mod_poly_init(b, p);
+        fmpz_mod_poly_init(q, p);
+
+        fmpz_mod_poly_randtest(a, state, n_randint(state, 200));
+        fmpz_mod_poly_randtest_not_zero(b, state, n_randint(state, 200) + 1);
+
+        {
+            fmpz_t d;
+            fmpz *leadB = fmpz_mod_poly_lead(b);
+
+            fmpz_init(d);
+            fmpz_gcd(d, p, leadB);
+            while (!fmpz_is_one(d))
+            {
+                fmpz_divexact(leadB, leadB, d);
+                fmpz_gcd(d, p, leadB);
+            }
+            fmpz_clear(d);
+        }
+
+        fmpz_mod_poly_div_newton(q, a, b);
+        fmpz_mod_poly_div_newton(b, a, b);
+
+        result = (fmpz_mod_poly_equal(q, b));
+        if (!result)
+        {
+            printf("FAIL #3:\n");
+            printf("p = "), fmpz_print(p), printf("\n\n");
+            printf("a = "), fmpz_mod_poly_print(a), printf("\n\n");
+            printf("b = "), fmpz_mod_poly_print(b), printf("\n\n");
+            printf("q = "), fmpz_mod_poly_print(q), printf("\n\n");
+            abort();
+        }
+
+        fmpz_mod_poly_clear(a);
+        fmpz_mod_poly_clear(b);
+        fmpz_mod_poly_clear(q);
+        fmpz_clear(p);
+    }
+
+    flint_randclear(state);
+    flint_cleanup();
+    printf("PASS\n");
+    return 0;
+}
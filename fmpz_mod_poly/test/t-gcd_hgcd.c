@@ -0,0 +1,162 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "fmpz_mod_poly.h"
+#include "ulong_extras.h"
+
+int
+main(void)
+{
+    int i, result;
+    flint_rand_t state;
+
+    printf("gcd_hgcd....");
+    fflush(stdout);
+
+    flint_randinit(state);
+
+    /* Check aliasing of a and c */
+    for (i = 0; i < 100 * flint_test_multiplier(); i++)
+    {
+        fmpz_t p;
+        fmpz_mod_poly_t a, b, c;
+
+        fmpz_init(p);
+        fmpz_set_ui(p, n_randtest_prime(state, 0));
+
+        fmpz_mod_poly_init(a, p);
+        fmpz_mod_poly_init(b, p);
+        fmpz_mod_poly_init(c, p);
+        fmpz_mod_poly_randtest(a, state, n_randint(state, 600));
+        fmpz_mod_poly_randtest(b, state, n_randint(state, 600));
+
+        fmpz_mod_poly_gcd_hgcd(c, a, b);
+        fmpz_mod_poly_gcd_hgcd(a, a, b);
+
+        result = (fmpz_mod_poly_equal(a, c));
+        if (!result)
+        {
+            printf("FAIL:\n");
+            fmpz_mod_poly_print(a), printf("\n\n");
+            fmpz_mod_poly_print(b), printf("\n\n");
+            fmpz_mod_poly_print(c), printf("\n\n");
+            abort();
+        }
+
+        fmpz_mod_poly_clear(a);
+        fmpz_mod_poly_clear(b);
+        fmpz_mod_poly_clear(c);
+        fmpz_clear(p);
+    }
+
+    /* Check aliasing of b and c */
+    for (i = 0; i < 100 * flint_test_multiplier(); i++)
+    {
+        fmpz_t p;
+        fmpz_mod_poly_t a, b, c;
+
+        fmpz_init(p);
+        fmpz_set_ui(p, n_randtest_prime(state, 0));
+
+        fmpz_mod_poly_init(a, p);
+        fmpz_mod_poly_init(b, p);
+        fmpz_mod_poly_init(c, p);
+        fmpz_mod_poly_randtest(a, state, n_randint(state, 600));
+        fmpz_mod_poly_randtest(b, state, n_randint(state, 600));
+
+        fmpz_mod_poly_gcd_hgcd(c, a, b);
+        fmpz_mod_poly_gcd_hgcd(b, a, b);
+
+        result = (fmpz_mod_poly_equal(b, c));
+        if (!result)
+        {
+            printf("FAIL:\n");
+            fmpz_mod_poly_print(a), printf("\n\n");
+            fmpz_mod_poly_print(b), printf("\n\n");
+            fmpz_mod_poly_print(c), printf("\n\n");
+            abort();
+        }
+
+        fmpz_mod_poly_clear(a);
+        fmpz_mod_poly_clear(b);
+        fmpz_mod_poly_clear(c);
+        fmpz_clear(p);
+    }
+
+    /* 
+        Compare with the Euclidean algorithm, for arguments sharing 
+        a common factor and for moduli of various sizes
+     */
+    for (i = 0; i < 50 * flint_test_multiplier(); i++)
+    {
+        fmpz_t p;
+        fmpz_mod_poly_t a, b, f, g, h;
+
+        fmpz_init(p);
+        do
+        {
+            fmpz_randtest_unsigned(p, state, 200);
+            fmpz_add_ui(p, p, 2);
+        } while (!fmpz_is_probabprime(p));
+
+        fmpz_mod_poly_init(a, p);
+        fmpz_mod_poly_init(b, p);
+        fmpz_mod_poly_init(f, p);
+        fmpz_mod_poly_init(g, p);
+        fmpz_mod_poly_init(h, p);
+        fmpz_mod_poly_randtest(a, state, n_randint(state, 600));
+        fmpz_mod_poly_randtest(b, state, n_randint(state, 600));
+        fmpz_mod_poly_randtest(f, state, n_randint(state, 300));
+        fmpz_mod_poly_mul(a, a, f);
+        fmpz_mod_poly_mul(b, b, f);
+
+        fmpz_mod_poly_gcd_hgcd(g, a, b);
+        fmpz_mod_poly_gcd_euclidean(h, a, b);
+
+        result = (fmpz_mod_poly_equal(g, h));
+        if (!result)
+        {
+            printf("FAIL:\n");
+            printf("p = "), fmpz_print(p), printf("\n\n");
+            printf("a = "), fmpz_mod_poly_print(a), printf("\n\n");
+            printf("b = "), fmpz_mod_poly_print(b), printf("\n\n");
+            printf("g = "), fmpz_mod_poly_print(g), printf("\n\n");
+            printf("h = "), fmpz_mod_poly_print(h), printf("\n\n");
+            abort();
+        }
+
+        fmpz_mod_poly_clear(a);
+        fmpz_mod_poly_clear(b);
+        fmpz_mod_poly_clear(f);
+        fmpz_mod_poly_clear(g);
+        fmpz_mod_poly_clear(h);
+        fmpz_clear(p);
+    }
+
+    flint_randclear(state);
+    flint_cleanup();
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,165 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+#include "fmpz_mod_poly.h"
+#include "ulong_extras.h"
+
+#define __mul(C, lenC, A, lenA, B, lenB)                          \
+do {                                                              \
+    if ((lenA) != 0 && (lenB) != 0)                               \
+    {                                                             \
+        if ((lenA) >= (lenB))                                     \
+            _fmpz_mod_poly_mul((C), (A), (lenA), (B), (lenB), p); \
+        else                                                      \
+            _fmpz_mod_poly_mul((C), (B), (lenB), (A), (lenA), p); \
+        (lenC) = (lenA) + (lenB) - 1;                             \
+    }                                                             \
+    else                                                          \
+    {                                                             \
+        (lenC) = 0;                                               \
+    }                                                             \
+} while (0)
+
+int
+main(void)
+{
+    int i, result;
+    flint_rand_t state;
+    flint_randinit(state);
+
+    printf("hgcd....");
+    fflush(stdout);
+
+    /* 
+       Check that [c,d] = sgnM * M^{-1} [a,b], where M is the 
+       matrix returned by the HGCD of (a, b)
+    */
+    for (i = 0; i < 100 * flint_test_multiplier(); i++)
+    {
+        fmpz_t p;
+        fmpz_mod_poly_t a, b, c, d, c1, d1, s, t;
+
+        fmpz *M[4];
+        slong lenM[4];
+        slong sgnM;
+
+        fmpz_init(p);
+        do
+        {
+            fmpz_randtest_unsigned(p, state, 100);
+            fmpz_add_ui(p, p, 2);
+        } while (!fmpz_is_probabprime(p));
+
+        fmpz_mod_poly_init(a, p);
+        fmpz_mod_poly_init(b, p);
+        fmpz_mod_poly_init(c, p);
+        fmpz_mod_poly_init(d, p);
+        fmpz_mod_poly_init(c1, p);
+        fmpz_mod_poly_init(d1, p);
+        fmpz_mod_poly_init(s, p);
+        fmpz_mod_poly_init(t, p);
+
+        do {
+            fmpz_mod_poly_randtest_not_zero(a, state, n_randint(state, 600) + 1);
+            fmpz_mod_poly_randtest_not_zero(b, state, n_randint(state, 600) + 1);
+        } while (a->length == b->length);
+
+        if (a->length < b->length)
+            fmpz_mod_poly_swap(a, b);
+
+        M[0] = _fmpz_vec_init(a->length);
+        M[1] = _fmpz_vec_init(a->length);
+        M[2] = _fmpz_vec_init(a->length);
+        M[3] = _fmpz_vec_init(a->length);
+
+        fmpz_mod_poly_fit_length(c, a->length);
+        fmpz_mod_poly_fit_length(d, b->length);
+
+        sgnM = _fmpz_mod_poly_hgcd(M, lenM, 
+                        c->coeffs, &(c->length), d->coeffs, &(d->length), 
+                        a->coeffs, a->length, b->coeffs, b->length, p);
+
+        fmpz_mod_poly_fit_length(s, 2 * a->length);
+        fmpz_mod_poly_fit_length(t, 2 * a->length);
+
+        /* [c1,d1] := sgnM * M^{-1} [a,b] */
+        {
+            FMPZ_VEC_SWAP(M[0], lenM[0], M[3], lenM[3]);
+            _fmpz_mod_poly_neg(M[1], M[1], lenM[1], p);
+            _fmpz_mod_poly_neg(M[2], M[2], lenM[2], p);
+
+            __mul(s->coeffs, s->length, M[0], lenM[0], a->coeffs, a->length);
+            __mul(t->coeffs, t->length, M[1], lenM[1], b->coeffs, b->length);
+            fmpz_mod_poly_add(c1, s, t);
+            __mul(s->coeffs, s->length, M[2], lenM[2], a->coeffs, a->length);
+            __mul(t->coeffs, t->length, M[3], lenM[3], b->coeffs, b->length);
+            fmpz_mod_poly_add(d1, s, t);
+        }
+
+        if (sgnM < 0)
+        {
+            fmpz_mod_poly_neg(c1, c1);
+            fmpz_mod_poly_neg(d1, d1);
+        }
+
+        result = (fmpz_mod_poly_equal(c, c1) && fmpz_mod_poly_equal(d, d1));
+        if (!result)
+        {
+            printf("FAIL:\n");
+            printf("p  = "), fmpz_print(p), printf("\n\n");
+            printf("a  = "), fmpz_mod_poly_print(a), printf("\n\n");
+            printf("b  = "), fmpz_mod_poly_print(b), printf("\n\n");
+            printf("c  = "), fmpz_mod_poly_print(c), printf("\n\n");
+            printf("d  = "), fmpz_mod_poly_print(d), printf("\n\n");
+            printf("c1 = "), fmpz_mod_poly_print(c1), printf("\n\n");
+            printf("d1 = "), fmpz_mod_poly_print(d1), printf("\n\n");
+            abort();
+        }
+
+        _fmpz_vec_clear(M[0], a->length);
+        _fmpz_vec_clear(M[1], a->length);
+        _fmpz_vec_clear(M[2], a->length);
+        _fmpz_vec_clear(M[3], a->length);
+
+        fmpz_mod_poly_clear(a);
+        fmpz_mod_poly_clear(b);
+        fmpz_mod_poly_clear(c);
+        fmpz_mod_poly_clear(d);
+        fmpz_mod_poly_clear(c1);
+        fmpz_mod_poly_clear(d1);
+        fmpz_mod_poly_clear(s);
+        fmpz_mod_poly_clear(t);
+
+        fmpz_clear(p);
+    }
+
+    flint_randclear(state);
+    flint_cleanup();
+    printf("PASS\n");
+    return 0;
+}
+
+#undef __mul
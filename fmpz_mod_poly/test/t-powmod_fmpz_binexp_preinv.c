@@ -0,0 +1,227 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "fmpz_mod_poly.h"
+#include "ulong_extras.h"
+
+int
+main(void)
+{
+    int i, result;
+    flint_rand_t state;
+
+    printf("powmod_fmpz_binexp_preinv....");
+    fflush(stdout);
+
+    flint_randinit(state);
+
+    /* Check result against powmod_fmpz_binexp */
+    for (i = 0; i < 200 * flint_test_multiplier(); i++)
+    {
+        fmpz_t p;
+        fmpz_mod_poly_t a, f, finv, res1, res2;
+        fmpz_t e;
+
+        fmpz_init(p);
+        fmpz_set_ui(p, n_randtest_prime(state, 0));
+
+        fmpz_mod_poly_init(a, p);
+        fmpz_mod_poly_init(f, p);
+        fmpz_mod_poly_init(finv, p);
+        fmpz_mod_poly_init(res1, p);
+        fmpz_mod_poly_init(res2, p);
+
+        fmpz_init(e);
+        fmpz_randtest_unsigned(e, state, 100);
+        fmpz_mod_poly_randtest_not_zero(f, state, n_randint(state, 50) + 1);
+        fmpz_mod_poly_randtest(a, state, n_randint(state, 100));
+
+        fmpz_mod_poly_reverse(finv, f, f->length);
+        fmpz_mod_poly_inv_series_newton(finv, finv, f->length);
+
+        fmpz_mod_poly_powmod_fmpz_binexp_preinv(res1, a, e, f, finv);
+        fmpz_mod_poly_powmod_fmpz_binexp(res2, a, e, f);
+
+        result = (fmpz_mod_poly_equal(res1, res2));
+        if (!result)
+        {
+            printf("FAIL #1:\n");
+            printf("p = "), fmpz_print(p), printf("\n\n");
+            printf("a = "), fmpz_mod_poly_print(a), printf("\n\n");
+            printf("f = "), fmpz_mod_poly_print(f), printf("\n\n");
+            printf("res1 = "), fmpz_mod_poly_print(res1), printf("\n\n");
+            printf("res2 = "), fmpz_mod_poly_print(res2), printf("\n\n");
+            abort();
+        }
+
+        fmpz_mod_poly_clear(a);
+        fmpz_mod_poly_clear(f);
+        fmpz_mod_poly_clear(finv);
+        fmpz_mod_poly_clear(res1);
+        fmpz_mod_poly_clear(res2);
+        fmpz_clear(e);
+        fmpz_clear(p);
+    }
+
+    /* Check aliasing of res and a */
+    for (i = 0; i < 50 * flint_test_multiplier(); i++)
+    {
+        fmpz_t p;
+        fmpz_mod_poly_t a, f, finv, res1;
+        fmpz_t e;
+
+        fmpz_init(p);
+        fmpz_set_ui(p, n_randtest_prime(state, 0));
+
+        fmpz_mod_poly_init(a, p);
+        fmpz_mod_poly_init(f, p);
+        fmpz_mod_poly_init(finv, p);
+        fmpz_mod_poly_init(res1, p);
+
+        fmpz_init(e);
+        fmpz_randtest_unsigned(e, state, 100);
+        fmpz_mod_poly_randtest_not_zero(f, state, n_randint(state, 50) + 1);
+        fmpz_mod_poly_randtest(a, state, n_randint(state, 100));
+
+        fmpz_mod_poly_reverse(finv, f, f->length);
+        fmpz_mod_poly_inv_series_newton(finv, finv, f->length);
+
+        fmpz_mod_poly_powmod_fmpz_binexp_preinv(res1, a, e, f, finv);
+        fmpz_mod_poly_powmod_fmpz_binexp_preinv(a, a, e, f, finv);
+
+        result = (fmpz_mod_poly_equal(res1, a));
+        if (!result)
+        {
+            printf("FAIL #2:\n");
+            printf("p = "), fmpz_print(p), printf("\n\n");
+            printf("a = "), fmpz_mod_poly_print(a), printf("\n\n");
+            printf("f = "), fmpz_mod_poly_print(f), printf("\n\n");
+            printf("res1 = "), fmpz_mod_poly_print(res1), printf("\n\n");
+            abort();
+        }
+
+        fmpz_mod_poly_clear(a);
+        fmpz_mod_poly_clear(f);
+        fmpz_mod_poly_clear(finv);
+        fmpz_mod_poly_clear(res1);
+        fmpz_clear(e);
+        fmpz_clear(p);
+    }
+
+    /* Check aliasing of res and f */
+    for (i = 0; i < 50 * flint_test_multiplier(); i++)
+    {
+        fmpz_t p;
+        fmpz_mod_poly_t a, f, finv, res1;
+        fmpz_t e;
+
+        fmpz_init(p);
+        fmpz_set_ui(p, n_randtest_prime(state, 0));
+
+        fmpz_mod_poly_init(a, p);
+        fmpz_mod_poly_init(f, p);
+        fmpz_mod_poly_init(finv, p);
+        fmpz_mod_poly_init(res1, p);
+
+        fmpz_init(e);
+        fmpz_randtest_unsigned(e, state, 100);
+        fmpz_mod_poly_randtest_not_zero(f, state, n_randint(state, 50) + 1);
+        fmpz_mod_poly_randtest(a, state, n_randint(state, 100));
+
+        fmpz_mod_poly_reverse(finv, f, f->length);
+        fmpz_mod_poly_inv_series_newton(finv, finv, f->length);
+
+        fmpz_mod_poly_powmod_fmpz_binexp_preinv(res1, a, e, f, finv);
+        fmpz_mod_poly_powmod_fmpz_binexp_preinv(f, a, e, f, finv);
+
+        result = (fmpz_mod_poly_equal(res1, f));
+        if (!result)
+        {
+            printf("FAIL #3:\n");
+            printf("p = "), fmpz_print(p), printf("\n\n");
+            printf("a = "), fmpz_mod_poly_print(a), printf("\n\n");
+            printf("f = "), fmpz_mod_poly_print(f), printf("\n\n");
+            printf("res1 = "), fmpz_mod_poly_print(res1), printf("\n\n");
+            abort();
+        }
+
+        fmpz_mod_poly_clear(a);
+        fmpz_mod_poly_clear(f);
+        fmpz_mod_poly_clear(finv);
+        fmpz_mod_poly_clear(res1);
+        fmpz_clear(e);
+        fmpz_clear(p);
+    }
+
+    /* Check aliasing of res and finv */
+    for (i = 0; i < 50 * flint_test_multiplier(); i++)
+    {
+        fmpz_t p;
+        fmpz_mod_poly_t a, f, finv, res1;
+        fmpz_t e;
+
+        fmpz_init(p);
+        fmpz_set_ui(p, n_randtest_prime(state, 0));
+
+        fmpz_mod_poly_init(a, p);
+        fmpz_mod_poly_init(f, p);
+        fmpz_mod_poly_init(finv, p);
+        fmpz_mod_poly_init(res1, p);
+
+        fmpz_init(e);
+        fmpz_randtest_unsigned(e, state, 100);
+        fmpz_mod_poly_randtest_not_zero(f, state, n_randint(state, 50) + 1);
+        fmpz_mod_poly_randtest(a, state, n_randint(state, 100));
+
+        fmpz_mod_poly_reverse(finv, f, f->length);
+        fmpz_mod_poly_inv_series_newton(finv, finv, f->length);
+
+        fmpz_mod_poly_powmod_fmpz_binexp_preinv(res1, a, e, f, finv);
+        fmpz_mod_poly_powmod_fmpz_binexp_preinv(finv, a, e, f, finv);
+
+        result = (fmpz_mod_poly_equal(res1, finv));
+        if (!result)
+        {
+            printf("FAIL #4:\n");
+            printf("p = "), fmpz_print(p), printf("\n\n");
+            printf("a = "), fmpz_mod_poly_print(a), printf("\n\n");
+            printf("f = "), fmpz_mod_poly_print(f), printf("\n\n");
+            printf("res1 = "), fmpz_mod_poly_print(res1), printf("\n\n");
+            abort();
+        }
+
+        fmpz_mod_poly_clear(a);
+        fmpz_mod_poly_clear(f);
+        fmpz_mod_poly_clear(finv);
+        fmpz_mod_poly_clear(res1);
+        fmpz_clear(e);
+        fmpz_clear(p);
+    }
+
+    flint_randclear(state);
+    flint_cleanup();
+    printf("PASS\n");
+    return 0;
+}
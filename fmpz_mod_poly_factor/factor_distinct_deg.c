@@ -30,7 +30,7 @@ void
 fmpz_mod_poly_factor_distinct_deg(fmpz_mod_poly_factor_t res,
                                   const fmpz_mod_poly_t poly, slong * const *degs)
 {
-    fmpz_mod_poly_t f, g, s, v, tmp;
+    fmpz_mod_poly_t f, g, s, v, vinv, tmp;
     fmpz_mod_poly_t *h, *H, *I;
     slong i, j, l, m, n, index;
     fmpz_t p;
@@ -49,6 +49,7 @@ fmpz_mod_poly_factor_distinct_deg(fmpz_mod_poly_factor_t res,
     fmpz_mod_poly_init(g, p);
     fmpz_mod_poly_init(s, p);
     fmpz_mod_poly_init(v, p);
+    fmpz_mod_poly_init(vinv, p);
     fmpz_mod_poly_init(tmp, p);
 
     if (!(h = flint_malloc((2 * m + l + 1) * sizeof(fmpz_mod_poly_struct))))
@@ -69,15 +70,22 @@ fmpz_mod_poly_factor_distinct_deg(fmpz_mod_poly_factor_t res,
 
     fmpz_mod_poly_make_monic(v, poly);
 
+    /* precompute the inverse of the reverse of v for Newton division */
+    fmpz_mod_poly_reverse(vinv, v, v->length);
+    fmpz_mod_poly_inv_series_newton(vinv, vinv, v->length);
+
     /* compute baby steps: h[i]=x^{p^i}mod v */
     fmpz_mod_poly_set_coeff_ui(h[0], 1, 1);
+    if (v->length <= 2)
+        fmpz_mod_poly_rem(h[0], h[0], v);
     for (i = 1; i < l + 1; i++)
-        fmpz_mod_poly_powmod_fmpz_binexp(h[i], h[i - 1], p, v);
+        fmpz_mod_poly_powmod_fmpz_binexp_preinv(h[i], h[i - 1], p, v, vinv);
 
     /* compute giant steps: H[i]=x^{p^(li)}mod v */
     fmpz_mod_poly_set(H[0], h[l]);
     for (j = 1; j < m; j++)
-        fmpz_mod_poly_compose_mod(H[j], H[j - 1], H[0], v);
+        fmpz_mod_poly_compose_mod_brent_kung_preinv(H[j], H[j - 1], H[0],
+                                                    v, vinv);
 
     /* compute interval polynomials I[j] = (H_j-h_0)*...*(H_j-h_{l-1}) */
     for (j = 0; j < m; j++)
@@ -86,7 +94,7 @@ fmpz_mod_poly_factor_distinct_deg(fmpz_mod_poly_factor_t res,
         for (i = 0; i < l; i++)
         {
             fmpz_mod_poly_sub(tmp, H[j], h[i]);
-            fmpz_mod_poly_mulmod(I[j], tmp, I[j], v);
+            fmpz_mod_poly_mulmod_preinv(I[j], tmp, I[j], v, vinv);
         }
     }
 
@@ -137,6 +145,7 @@ fmpz_mod_poly_factor_distinct_deg(fmpz_mod_poly_factor_t res,
     fmpz_mod_poly_clear(g);
     fmpz_mod_poly_clear(s);
     fmpz_mod_poly_clear(v);
+    fmpz_mod_poly_clear(vinv);
     fmpz_mod_poly_clear(tmp);
 
     for (i = 0; i < l + 1; i++)
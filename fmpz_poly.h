@@ -64,6 +64,18 @@ typedef struct {
 
 typedef fmpz_poly_factor_struct fmpz_poly_factor_t[1];
 
+typedef struct
+{
+    mp_limb_t ** jj; /* transform of the fixed polynomial */
+    slong len1;      /* maximum length of the other polynomial */
+    slong bits1;     /* maximum bits of its coefficients */
+    slong len2;
+    slong loglen;
+    slong limbs;
+} fmpz_poly_mul_precache_struct;
+
+typedef fmpz_poly_mul_precache_struct fmpz_poly_mul_precache_t[1];
+
 /*  Memory management ********************************************************/
 
 void fmpz_poly_init(fmpz_poly_t poly);
@@ -418,6 +430,55 @@ void _fmpz_poly_mullow_SS(fmpz * output, const fmpz * input1, slong length1,
 void fmpz_poly_mullow_SS(fmpz_poly_t res,
                   const fmpz_poly_t poly1, const fmpz_poly_t poly2, slong n);
 
+void fmpz_poly_mul_SS_precache_init(fmpz_poly_mul_precache_t pre, 
+                           slong len1, slong bits1, const fmpz_poly_t poly2);
+
+void fmpz_poly_mul_precache_clear(fmpz_poly_mul_precache_t pre);
+
+void _fmpz_poly_mullow_SS_precache(fmpz * output, const fmpz * input1, 
+                   slong len1, const fmpz_poly_mul_precache_t pre, slong n);
+
+void fmpz_poly_mullow_SS_precache(fmpz_poly_t res, const fmpz_poly_t poly1, 
+                                  const fmpz_poly_mul_precache_t pre, slong n);
+
+void fmpz_poly_mul_SS_precache(fmpz_poly_t res, const fmpz_poly_t poly1, 
+                                          const fmpz_poly_mul_precache_t pre);
+
+#define FMPZ_POLY_MULTI_MOD_CUTOFF 1000       /* MUL (2-3 threads): -> multi mod */
+#define FMPZ_POLY_MULTI_MOD_THREADED_CUTOFF 100 /* MUL (4+ threads): -> multi mod */
+#define FMPZ_POLY_MULTI_MOD_MAX_LIMBS 100    /* limbs1 + limbs2 for multi mod */
+
+/*
+   The multimodular product splits over the primes and the coefficients,
+   so it only pays for itself once there are threads to share the work.
+   Without the NTT in nmod_poly on 32 bit machines it never does.
+*/
+static __inline__
+int _fmpz_poly_mul_use_multi_mod(slong len2, slong limbs)
+{
+#if FLINT64
+    int threads;
+
+    if (limbs < 2 || limbs > FMPZ_POLY_MULTI_MOD_MAX_LIMBS)
+        return 0;
+
+    threads = flint_get_num_threads();
+
+    if (threads >= 4)
+        return len2 >= FMPZ_POLY_MULTI_MOD_THREADED_CUTOFF;
+    else if (threads >= 2)
+        return len2 >= FMPZ_POLY_MULTI_MOD_CUTOFF;
+#endif
+
+    return 0;
+}
+
+void _fmpz_poly_mul_multi_mod(fmpz * res, const fmpz * poly1, slong len1, 
+                                             const fmpz * poly2, slong len2);
+
+void fmpz_poly_mul_multi_mod(fmpz_poly_t res, 
+                          const fmpz_poly_t poly1, const fmpz_poly_t poly2);
+
 void _fmpz_poly_mul(fmpz * res, const fmpz * poly1, 
                                   slong len1, const fmpz * poly2, slong len2);
 
@@ -25,23 +25,228 @@
 
 #include <gmp.h>
 #include "flint.h"
+#include "ulong_extras.h"
 #include "fmpz.h"
 #include "fmpz_vec.h"
+#include "nmod_vec.h"
+#include "nmod_poly.h"
 #include "fmpz_poly.h"
 #include "mpn_extras.h"
+#include "thread_pool.h"
 
+typedef struct
+{
+    slong start;
+    slong stop;
+    const fmpz * coeffs;
+    mp_ptr * mod_polys;
+    mp_ptr * a;
+    mp_ptr * b;
+    mp_ptr * h;
+    slong * hlen;
+    slong len1;
+    slong len2;
+    slong num_primes;
+    const fmpz_comb_struct * comb;
+    const fmpz * g;
+    int g_pm1;
+    fmpz * res;
+    const fmpz * modulus;
+    const fmpz * P;
+    const fmpz * minv;
+    const fmpz * newmod;
+    const fmpz * newhalf;
+    int first;
+    int changed;
+}
+_gcd_modular_arg_struct;
+
+/* reduces coefficients [start, stop) modulo all primes of the batch */
+static void
+_mod_worker(void * varg)
+{
+    _gcd_modular_arg_struct * arg = (_gcd_modular_arg_struct *) varg;
+    slong i, j, num_primes = arg->num_primes;
+    fmpz_comb_temp_t comb_temp;
+    mp_limb_t * residues;
+
+    if (arg->start >= arg->stop)
+        return;
+
+    residues = flint_malloc(sizeof(mp_limb_t) * num_primes);
+    fmpz_comb_temp_init(comb_temp, arg->comb);
+
+    for (i = arg->start; i < arg->stop; i++)
+    {
+        fmpz_multi_mod_ui(residues, arg->coeffs + i, arg->comb, comb_temp);
+        for (j = 0; j < num_primes; j++)
+            arg->mod_polys[j][i] = residues[j];
+    }
+
+    fmpz_comb_temp_clear(comb_temp);
+    flint_free(residues);
+}
+
+/* 
+   computes the gcd modulo primes [start, stop) of the batch, scaled to
+   have leading coefficient g
+*/
+static void
+_gcd_worker(void * varg)
+{
+    _gcd_modular_arg_struct * arg = (_gcd_modular_arg_struct *) varg;
+    slong j, hlen;
+    mp_limb_t h_inv, g_mod;
+
+    for (j = arg->start; j < arg->stop; j++)
+    {
+        const nmod_t mod = arg->comb->mod[j];
+        mp_ptr h = arg->h[j];
+
+        hlen = _nmod_poly_gcd(h, arg->a[j], arg->len1, 
+                                 arg->b[j], arg->len2, mod);
+
+        if (arg->g_pm1) 
+            _nmod_poly_make_monic(h, h, hlen, mod);
+        else
+        {
+            h_inv = n_invmod(h[hlen - 1], mod.n);
+            g_mod = fmpz_fdiv_ui(arg->g, mod.n);
+            h_inv = n_mulmod2_preinv(h_inv, g_mod, mod.n, mod.ninv);
+            _nmod_vec_scalar_mul_nmod(h, h, hlen, h_inv, mod);
+        }
+
+        arg->hlen[j] = hlen;
+    }
+}
+
+/*
+   lifts coefficients [start, stop) of the images in the batch to the 
+   product P of its primes, then combines them with the coefficients of
+   res, known modulo modulus, to give the symmetric residue modulo 
+   newmod = modulus * P; records whether any coefficient changed
+*/
+static void
+_crt_worker(void * varg)
+{
+    _gcd_modular_arg_struct * arg = (_gcd_modular_arg_struct *) varg;
+    slong i, j, num_primes = arg->num_primes;
+    fmpz_comb_temp_t comb_temp;
+    mp_limb_t * residues;
+    fmpz_t t;
+
+    arg->changed = 0;
+
+    if (arg->start >= arg->stop)
+        return;
+
+    residues = flint_malloc(sizeof(mp_limb_t) * num_primes);
+    fmpz_comb_temp_init(comb_temp, arg->comb);
+    fmpz_init(t);
+
+    for (i = arg->start; i < arg->stop; i++)
+    {
+        for (j = 0; j < num_primes; j++)
+            residues[j] = arg->h[j][i];
+
+        if (arg->first)
+        {
+            fmpz_multi_CRT_ui(arg->res + i, residues, arg->comb, comb_temp, 1);
+            continue;
+        }
+
+        fmpz_multi_CRT_ui(t, residues, arg->comb, comb_temp, 0);
+        fmpz_sub(t, t, arg->res + i);
+        fmpz_mul(t, t, arg->minv);
+        fmpz_mod(t, t, arg->P);
+
+        if (!fmpz_is_zero(t))
+        {
+            arg->changed = 1;
+            fmpz_addmul(arg->res + i, arg->modulus, t);
+            if (fmpz_cmp(arg->res + i, arg->newhalf) > 0)
+                fmpz_sub(arg->res + i, arg->res + i, arg->newmod);
+        }
+    }
+
+    fmpz_clear(t);
+    fmpz_comb_temp_clear(comb_temp);
+    flint_free(residues);
+}
+
+/*
+    Splits [0, len) evenly over the calling thread and num_workers workers
+    and runs f on each part.
+*/
+static void
+_gcd_modular_run(void (*f)(void *), _gcd_modular_arg_struct * args,
+            const _gcd_modular_arg_struct * proto, slong len,
+            thread_pool_handle * threads, slong num_workers)
+{
+    slong i;
+
+    for (i = 0; i <= num_workers; i++)
+    {
+        args[i] = *proto;
+        args[i].start = (i * len) / (num_workers + 1);
+        args[i].stop = ((i + 1) * len) / (num_workers + 1);
+    }
+
+    for (i = 0; i < num_workers; i++)
+        thread_pool_wake(global_thread_pool, threads[i], f, args + i + 1);
+
+    f(args);
+
+    for (i = 0; i < num_workers; i++)
+        thread_pool_wait(global_thread_pool, threads[i]);
+}
+
+/* 
+   Checks whether the primitive part of (res, hlen), normalised to have 
+   positive leading coefficient, divides both A and B and if so replaces
+   (res, hlen) by it.
+*/
+static int
+_gcd_modular_check(fmpz * res, slong hlen, fmpz * T, fmpz * Q, 
+                   const fmpz * A, slong len1, const fmpz * B, slong len2)
+{
+    fmpz_t hc;
+    int ok;
+
+    fmpz_init(hc);
+
+    _fmpz_vec_content(hc, res, hlen);
+    if (fmpz_sgn(res + hlen - 1) < 0)
+        fmpz_neg(hc, hc);
+    _fmpz_vec_scalar_divexact_fmpz(T, res, hlen, hc);
+
+    ok = _fmpz_poly_divides(Q, B, len2, T, hlen) &&
+         _fmpz_poly_divides(Q, A, len1, T, hlen);
+
+    if (ok)
+        _fmpz_vec_set(res, T, hlen);
+
+    fmpz_clear(hc);
+
+    return ok;
+}
 
 void _fmpz_poly_gcd_modular(fmpz * res, const fmpz * poly1, slong len1, 
                                         const fmpz * poly2, slong len2)
 {
-    mp_bitcnt_t bits1, bits2, nb1, nb2, bits_small, pbits, curr_bits = 0, new_bits;   
-    fmpz_t ac, bc, hc, d, g, l, eval_A, eval_B, eval_GCD, modulus;
-    fmpz * A, * B, * Q, * lead_A, * lead_B;
-    mp_ptr a, b, h;
-    mp_limb_t p, h_inv, g_mod;
-    nmod_t mod;
-    slong i, n, n0, unlucky, hlen, bound;
-    int g_pm1;
+    mp_bitcnt_t bits1, bits2, nb1, nb2, bits_small, pbits;
+    fmpz_t ac, bc, d, g, l, eval_A, eval_B, eval_GCD;
+    fmpz_t modulus, P, minv, newmod, newhalf;
+    fmpz * A, * B, * Q, * T, * lead_A, * lead_B;
+    mp_ptr * a, * b, * h, * keep;
+    mp_limb_t p, * primes, * kprimes;
+    slong i, j, k, nkeep, hlen, hmin, bound, unlucky, batch;
+    slong * hlens;
+    fmpz_comb_t comb, kcomb;
+    thread_pool_handle * threads;
+    slong num_workers;
+    _gcd_modular_arg_struct proto, * args;
+    int g_pm1, restart, done;
 
     fmpz_init(ac);
     fmpz_init(bc);
@@ -136,165 +341,216 @@ void _fmpz_poly_gcd_modular(fmpz * res, const fmpz * poly1, slong len1,
     p = (1UL<<pbits);
 
     fmpz_init(modulus);
-    fmpz_init(hc);
+    fmpz_init(P);
+    fmpz_init(minv);
+    fmpz_init(newmod);
+    fmpz_init(newhalf);
 
     Q = _fmpz_vec_init(len1);
-
-    /* make space for polynomials mod p */
-    a = _nmod_vec_init(len1);
-    b = _nmod_vec_init(len2);
-    h = _nmod_vec_init(len2);
+    T = _fmpz_vec_init(len2);
 
     /* zero entire output */
     _fmpz_vec_zero(res, len2);
 
-    n = len2; 
-    /* current bound on length of result 
-      the bound we use is from section 6 of 
-       http://cs.nyu.edu/~yap/book/alge/ftpSite/l4.ps.gz 
+    /* 
+       current bound on length of result, the bound we use is from 
+       section 6 of http://cs.nyu.edu/~yap/book/alge/ftpSite/l4.ps.gz 
     */
-    n0 = len1 - 1;
-    bound = (n0 + 3)*FLINT_MAX(nb1, nb2) + (n0 + 1); /* initialise bound */
+    bound = (len1 + 2)*FLINT_MAX(nb1, nb2) + len1; /* initialise bound */
     unlucky = 0;
 
-    for (;;)
+    num_workers = flint_request_threads(&threads, flint_get_num_threads());
+    args = flint_malloc(sizeof(_gcd_modular_arg_struct) * (num_workers + 1));
+
+    proto.len1 = len1;
+    proto.len2 = len2;
+    proto.g = g;
+    proto.g_pm1 = g_pm1;
+    proto.res = res;
+    proto.modulus = modulus;
+    proto.P = P;
+    proto.minv = minv;
+    proto.newmod = newmod;
+    proto.newhalf = newhalf;
+
+    /* 
+       hlen is the length of the current candidate, which is known modulo 
+       the product modulus of the used primes; hlen = 0 before the first 
+       candidate is found
+    */
+    hlen = 0;
+    done = 0;
+
+    while (!done)
     {
-        /* get new prime and initialise modulus */
-        p = n_nextprime(p, 0);
-        if (fmpz_fdiv_ui(l, p) == 0)
+        /* 
+           one prime per thread, but do not overshoot the bound by too much;
+           larger batches cost more primes than the early termination saves
+        */
+        batch = num_workers + 1;
+        k = (bound - (slong) fmpz_bits(modulus) - unlucky) / pbits + 1;
+        batch = FLINT_MAX(FLINT_MIN(batch, k), 1);
+
+        primes = flint_malloc(2 * sizeof(mp_limb_t) * batch);
+        kprimes = primes + batch;
+        for (k = 0; k < batch; )
         {
-            unlucky += pbits;
-            continue;
+            p = n_nextprime(p, 0);
+            if (fmpz_fdiv_ui(l, p) == 0)
+                unlucky += pbits;
+            else
+                primes[k++] = p;
+        }
+
+        /* make space for polynomials mod the primes */
+        a = flint_malloc(4 * sizeof(mp_ptr) * batch);
+        b = a + batch;
+        h = b + batch;
+        keep = h + batch;
+        a[0] = _nmod_vec_init(batch * (len1 + 2 * len2));
+        for (k = 0; k < batch; k++)
+        {
+            a[k] = a[0] + k * (len1 + 2 * len2);
+            b[k] = a[k] + len1;
+            h[k] = b[k] + len2;
         }
-        nmod_init(&mod, p);
+        hlens = flint_malloc(sizeof(slong) * batch);
+
+        fmpz_comb_init(comb, primes, batch);
+
+        proto.comb = comb;
+        proto.num_primes = batch;
+        proto.a = a;
+        proto.b = b;
+        proto.h = h;
+        proto.hlen = hlens;
+
+        /* reduce A and B modulo the primes of the batch */
+        proto.coeffs = A;
+        proto.mod_polys = a;
+        _gcd_modular_run(_mod_worker, args, &proto, len1, threads, num_workers);
+        proto.coeffs = B;
+        proto.mod_polys = b;
+        _gcd_modular_run(_mod_worker, args, &proto, len2, threads, num_workers);
 
-        /* reduce polynomials modulo p */
-        _fmpz_vec_get_nmod_vec(a, A, len1, mod);
-        _fmpz_vec_get_nmod_vec(b, B, len2, mod);
+        /* compute the gcds over Z/pZ */
+        _gcd_modular_run(_gcd_worker, args, &proto, batch, threads, num_workers);
 
-        /* compute gcd over Z/pZ */
-        hlen = _nmod_poly_gcd(h, a, len1, b, len2, mod);
+        hmin = hlens[0];
+        for (k = 1; k < batch; k++)
+            hmin = FLINT_MIN(hmin, hlens[k]);
 
-        if (hlen == 1) /* gcd is 1 */
+        if (hmin == 1) /* gcd is 1 */
         {
             fmpz_one(res);
             _fmpz_vec_zero(res + 1, len2 - 1);
-            break; 
+            hlen = 1;
+            done = 1;
         }
-
-        if (hlen > n + 1) /* discard this prime */
+        else if (hlen != 0 && hmin > hlen) /* discard all these primes */
         {
-            unlucky += pbits;
-            continue;
-        }
-
-        /* scale new polynomial mod p appropriately */
-        if (g_pm1) _nmod_poly_make_monic(h, h, hlen, mod);
-        else
-        {
-            h_inv = n_invmod(h[hlen - 1], mod.n);
-            g_mod = fmpz_fdiv_ui(g, mod.n);
-            h_inv = n_mulmod2_preinv(h_inv, g_mod, mod.n, mod.ninv);
-            _nmod_vec_scalar_mul_nmod(h, h, hlen, h_inv, mod);
+            unlucky += batch * pbits;
         }
-
-        if (hlen <= n) /* we have a new bound on size of result */
+        else 
         {
-            unlucky += fmpz_bits(modulus);
-            _fmpz_vec_set_nmod_vec(res, h, hlen, mod);
-            _fmpz_vec_zero(res + hlen, len2 - hlen);
+            restart = (hlen == 0 || hmin < hlen);
 
-            if (g_pm1)
+            if (restart) /* we have a new bound on size of result */
             {
-                /* are we done? */
-                if (_fmpz_poly_divides(Q, B, len2, res, hlen) &&
-                    _fmpz_poly_divides(Q, A, len1, res, hlen))
-                break;
+                unlucky += fmpz_bits(modulus);
+                fmpz_one(modulus);
+                _fmpz_vec_zero(res, len2);
+                hlen = hmin;
             }
-            else
-            {
-                if (pbits + unlucky >= bound) /* if we reach the bound with one prime */
-                { 
-                    _fmpz_vec_content(hc, res, hlen);
-
-                   /* divide by content */
-                   _fmpz_vec_scalar_divexact_fmpz(res, res, hlen, hc);
-                   break;
-                }
 
-                if (pbits >= bits_small) /* if one prime is already big enough to check */
+            /* keep only the images of the right degree */
+            for (k = 0, nkeep = 0; k < batch; k++)
+            {
+                if (hlens[k] == hlen)
                 {
-                    /* divide by content */
-                    _fmpz_vec_content(hc, res, hlen);
-
-                    /* correct sign of leading term */
-                    if (fmpz_sgn(res + hlen - 1) < 0)
-                        fmpz_neg(hc, hc);
-
-                    _fmpz_vec_scalar_divexact_fmpz(res, res, hlen, hc);
-
-                    /* are we done? */
-                    if (_fmpz_poly_divides(Q, B, len2, res, hlen) &&
-                        _fmpz_poly_divides(Q, A, len1, res, hlen))
-                        break;
-
-                    /* no, so multiply by content again */
-                    _fmpz_vec_scalar_mul_fmpz(res, res, hlen, hc);
+                    kprimes[nkeep] = primes[k];
+                    keep[nkeep++] = h[k];
                 }
+                else
+                    unlucky += pbits;
             }
 
-            curr_bits = FLINT_ABS(_fmpz_vec_max_bits(res, hlen));
-            fmpz_set_ui(modulus, p);
-            n = hlen - 1; /* if we reach this we have a new bound on length of result */
-            continue;
-        }
+            if (nkeep != batch)
+                fmpz_comb_init(kcomb, kprimes, nkeep);
 
-        _fmpz_poly_CRT_ui(res, res, hlen, modulus, h, hlen, mod.n, mod.ninv, 1);
-        fmpz_mul_ui(modulus, modulus, mod.n);
+            fmpz_one(P);
+            for (k = 0; k < nkeep; k++)
+                fmpz_mul_ui(P, P, kprimes[k]);
 
-        new_bits = _fmpz_vec_max_bits(res, hlen);
-        new_bits = FLINT_ABS(new_bits);
+            fmpz_mul(newmod, modulus, P);
+            fmpz_fdiv_q_2exp(newhalf, newmod, 1);
+            if (!restart)
+                fmpz_invmod(minv, modulus, P);
 
-        if (new_bits == curr_bits || fmpz_bits(modulus) >= bits_small)
-        {
-            if (!g_pm1)
-            {
-                _fmpz_vec_content(hc, res, hlen);
+            /* Chinese remaindering with the previous candidate */
+            proto.comb = (nkeep != batch) ? kcomb : comb;
+            proto.num_primes = nkeep;
+            proto.h = keep;
+            proto.first = restart;
+            _gcd_modular_run(_crt_worker, args, &proto, hlen, 
+                                                    threads, num_workers);
 
-                /* correct sign of leading term */
-                if (fmpz_sgn(res + hlen - 1) < 0)
-                    fmpz_neg(hc, hc);
+            if (nkeep != batch)
+                fmpz_comb_clear(kcomb);
 
-                /* divide by content */
-                _fmpz_vec_scalar_divexact_fmpz(res, res, hlen, hc);      
-            }
+            fmpz_swap(modulus, newmod);
 
             if (fmpz_bits(modulus) + unlucky >= bound)
-                break;
-
-            /* are we done? */
-            if (_fmpz_poly_divides(Q, B, len2, res, hlen) &&
-                _fmpz_poly_divides(Q, A, len1, res, hlen))
-                break;
+            {
+                /* the result is now determined by the bound */
+                if (!g_pm1)
+                {
+                    _fmpz_vec_content(P, res, hlen);
+                    _fmpz_vec_scalar_divexact_fmpz(res, res, hlen, P);
+                }
+                done = 1;
+            }
+            else
+            {
+                /* 
+                   only check by trial division if the images of the new
+                   batch agreed with the previous candidate, or for a new
+                   candidate which is expected to be small enough already
+                */
+                int candidate = 0;
+
+                if (restart)
+                    candidate = g_pm1 || fmpz_bits(modulus) >= bits_small;
+                else
+                {
+                    for (j = 0; j <= num_workers; j++)
+                        candidate |= args[j].changed;
+                    candidate = !candidate;
+                }
 
-            if (!g_pm1) 
-            {            
-                /* no, so multiply by content again */
-                _fmpz_vec_scalar_mul_fmpz(res, res, hlen, hc);
+                if (candidate)
+                    done = _gcd_modular_check(res, hlen, T, Q, 
+                                              A, len1, B, len2);
             }
         }
 
-        curr_bits = new_bits;
+        fmpz_comb_clear(comb);
+        flint_free(hlens);
+        _nmod_vec_clear(a[0]);
+        flint_free(a);
+        flint_free(primes);
     }
 
+    flint_give_back_threads(threads, num_workers);
+    flint_free(args);
+
     fmpz_clear(modulus);
+    fmpz_clear(P);
+    fmpz_clear(minv);
+    fmpz_clear(newmod);
+    fmpz_clear(newhalf);
     fmpz_clear(g); 
     fmpz_clear(l); 
-    fmpz_clear(hc);
-
-    _nmod_vec_clear(a);
-    _nmod_vec_clear(b);
-    _nmod_vec_clear(h); 
 
     /* finally multiply by content */
     _fmpz_vec_scalar_mul_fmpz(res, res, hlen, d);
@@ -303,6 +559,7 @@ void _fmpz_poly_gcd_modular(fmpz * res, const fmpz * poly1, slong len1,
     _fmpz_vec_clear(A, len1);
     _fmpz_vec_clear(B, len2);
     _fmpz_vec_clear(Q, len1);
+    _fmpz_vec_clear(T, len2);
 }
 
 void
@@ -46,6 +46,8 @@ _fmpz_poly_mul(fmpz * res, const fmpz * poly1, slong len1,
 
     if (len1 < 16 && (limbs1 > 12 || limbs2 > 12))
         _fmpz_poly_mul_karatsuba(res, poly1, len1, poly2, len2);
+    else if (_fmpz_poly_mul_use_multi_mod(len2, limbs1 + limbs2))
+        _fmpz_poly_mul_multi_mod(res, poly1, len1, poly2, len2);
     else if (limbs1 + limbs2 <= 8)
         _fmpz_poly_mul_KS(res, poly1, len1, poly2, len2);
     else if ((limbs1+limbs2)/2048 > len1 + len2)
@@ -0,0 +1,146 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "fmpz_poly.h"
+#include "fft.h"
+
+void fmpz_poly_mul_SS_precache_init(fmpz_poly_mul_precache_t pre, 
+                            slong len1, slong bits1, const fmpz_poly_t poly2)
+{
+    slong len2 = poly2->length;
+    slong loglen, loglen2, n, output_bits, limbs, size, i, trunc;
+    slong bits2;
+    mp_limb_t ** jj, * t1, * t2, * s1, * ptr;
+
+    pre->len1 = len1;
+    pre->bits1 = FLINT_ABS(bits1);
+    pre->len2 = len2;
+    pre->jj = NULL;
+
+    if (len1 == 0 || len2 == 0)
+        return;
+
+    loglen  = FLINT_MAX(FLINT_CLOG2(len1 + len2 - 1), 2);
+    loglen2 = FLINT_CLOG2(FLINT_MIN(len1, len2));
+    n = (1L << (loglen - 2));
+
+    bits2 = FLINT_ABS(_fmpz_vec_max_bits(poly2->coeffs, len2));
+
+    /* the product of any admissible poly1 may have either sign */
+    output_bits = pre->bits1 + bits2 + loglen2 + 1;
+
+    /* round up output bits for sqrt2 */
+    output_bits = (((output_bits - 1) >> (loglen - 2)) + 1) << (loglen - 2);
+
+    limbs = (output_bits - 1) / FLINT_BITS + 1;
+    limbs = fft_adjust_limbs(limbs); /* round up limbs for Nussbaumer */
+    size = limbs + 1;
+
+    /* the scratch space may be swapped into jj, so is part of its block */
+    jj = flint_malloc((4*(n + n*size) + 3*size)*sizeof(mp_limb_t));
+    for (i = 0, ptr = (mp_limb_t *) jj + 4*n; i < 4*n; i++, ptr += size) 
+        jj[i] = ptr;
+    t1 = ptr;
+    t2 = t1 + size;
+    s1 = t2 + size;
+
+    _fmpz_vec_get_fft(jj, poly2->coeffs, limbs, len2);
+    for (i = len2; i < 4*n; i++)
+        flint_mpn_zero(jj[i], limbs + 1);
+
+    trunc = FLINT_MAX(len1 + len2 - 1, 2*n + 1);
+
+    fft_precache(jj, loglen - 2, limbs, trunc, &t1, &t2, &s1);
+
+    pre->jj = jj;
+    pre->loglen = loglen;
+    pre->limbs = limbs;
+}
+
+void fmpz_poly_mul_precache_clear(fmpz_poly_mul_precache_t pre)
+{
+    flint_free(pre->jj);
+}
+
+void _fmpz_poly_mullow_SS_precache(fmpz * output, const fmpz * input1, 
+                    slong len1, const fmpz_poly_mul_precache_t pre, slong trunc)
+{
+    slong len_out = len1 + pre->len2 - 1;
+    slong n = (1L << (pre->loglen - 2));
+    slong limbs = pre->limbs, size = limbs + 1, i;
+    mp_limb_t * ptr, * t1, * t2, * tt, * s1, ** ii;
+
+    if (len1 > pre->len1 
+        || FLINT_ABS(_fmpz_vec_max_bits(input1, len1)) > pre->bits1)
+    {
+        printf("Exception (fmpz_poly_mullow_SS_precache). "
+               "Polynomial exceeds the precached bounds.\n");
+        abort();
+    }
+
+    ii = flint_malloc((4*(n + n*size) + 5*size)*sizeof(mp_limb_t));
+    for (i = 0, ptr = (mp_limb_t *) ii + 4*n; i < 4*n; i++, ptr += size) 
+        ii[i] = ptr;
+    t1 = ptr;
+    t2 = t1 + size;
+    s1 = t2 + size;
+    tt = s1 + size;
+
+    _fmpz_vec_get_fft(ii, input1, limbs, len1);
+    for (i = len1; i < 4*n; i++)
+        flint_mpn_zero(ii[i], limbs + 1);
+
+    fft_convolution_precache(ii, pre->jj, pre->loglen - 2, limbs, 
+                      FLINT_MAX(len_out, 2*n + 1), &t1, &t2, &s1, tt); 
+
+    _fmpz_vec_set_fft(output, trunc, ii, limbs, 1); /* write output */
+
+    flint_free(ii); 
+}
+
+void
+fmpz_poly_mullow_SS_precache(fmpz_poly_t res, const fmpz_poly_t poly1, 
+                             const fmpz_poly_mul_precache_t pre, slong n)
+{
+    const slong len1 = poly1->length;
+    const slong len2 = pre->len2;
+
+    if (len1 == 0 || len2 == 0 || n == 0)
+    {
+        fmpz_poly_zero(res);
+        return;
+    }
+
+    n = FLINT_MIN(n, len1 + len2 - 1);
+
+    fmpz_poly_fit_length(res, n);
+    _fmpz_poly_mullow_SS_precache(res->coeffs, poly1->coeffs, len1, pre, n);
+    _fmpz_poly_set_length(res, n);
+    _fmpz_poly_normalise(res);
+}
+
+void
+fmpz_poly_mul_SS_precache(fmpz_poly_t res, const fmpz_poly_t poly1, 
+                          const fmpz_poly_mul_precache_t pre)
+{
+    fmpz_poly_mullow_SS_precache(res, poly1, pre, 
+                                 poly1->length + pre->len2 - 1);
+}
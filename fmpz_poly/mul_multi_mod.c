@@ -0,0 +1,423 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+#include "mpn_extras.h"
+#include "nmod_poly.h"
+#include "fmpz_poly.h"
+#include "thread_pool.h"
+
+#if FLINT64
+
+/*
+   Primes p = c 2^40 + 1 just below 2^62, in decreasing order, so that
+   nmod_poly_mul can multiply modulo each of them with a single NTT for
+   products of length up to 2^40. Each prime exceeds 2^61.
+*/
+#define MULTI_MOD_PRIME_BITS 61
+#define MULTI_MOD_NUM_TABLE_PRIMES 128
+
+static const mp_limb_t _fmpz_poly_multi_mod_primes[MULTI_MOD_NUM_TABLE_PRIMES] =
+{
+    4611615649683210241UL, 4611613450659954689UL, 4611549678985543681UL,
+    4611546380450660353UL, 4611524390218104833UL, 4611496902427410433UL,
+    4611480409752993793UL, 4611468315125088257UL, 4611467215613460481UL,
+    4611458419520438273UL, 4611454021473927169UL, 4611368259566960641UL,
+    4611359463473938433UL, 4611355065427427329UL, 4611277000101855233UL,
+    4611266004985577473UL, 4611253910357671937UL, 4611239616706510849UL,
+    4611200034287910913UL, 4611170347473960961UL, 4611154954311172097UL,
+    4611127466520477697UL, 4611115371892572161UL, 4611105476287922177UL,
+    4611084585566994433UL, 4611041704613511169UL, 4610999923171655681UL,
+    4610990027567005697UL, 4610988928055377921UL, 4610975733915844609UL,
+    4610962539776311297UL, 4610953743683289089UL, 4610939450032128001UL,
+    4610929554427478017UL, 4610874578846089217UL, 4610860285194928129UL,
+    4610815205218189313UL, 4610775622799589377UL, 4610758030613544961UL,
+    4610703055032156161UL, 4610695358450761729UL, 4610656875543789569UL,
+    4610620591660072961UL, 4610606298008911873UL, 4610577710706589697UL,
+    4610557919497289729UL, 4610541426822873089UL, 4610538128287989761UL,
+    4610534829753106433UL, 4610528232683339777UL, 4610510640497295361UL,
+    4610490849287995393UL, 4610472157590323201UL, 4610461162474045441UL,
+    4610439172241489921UL, 4610414982985678849UL, 4610389694218240001UL,
+    4610358907892662273UL, 4610342415218245633UL, 4610336917660106753UL,
+    4610290738171740161UL, 4610274245497323521UL, 4610261051357790209UL,
+    4610254454288023553UL, 4610246757706629121UL, 4610236862101979137UL,
+    4610208274799656961UL, 4610177488474079233UL, 4610167592869429249UL,
+    4610151100195012609UL, 4610131308985712641UL, 4610085129497346049UL,
+    4610079631939207169UL, 4610056542195023873UL, 4610043348055490561UL,
+    4610030153915957249UL, 4610013661241540609UL, 4609977377357824001UL,
+    4609956486636896257UL, 4609930098357829633UL, 4609881719846207489UL,
+    4609850933520629761UL, 4609837739381096449UL, 4609828943288074241UL,
+    4609779465264824321UL, 4609776166729940993UL, 4609765171613663233UL,
+    4609753076985757697UL, 4609748678939246593UL, 4609736584311341057UL,
+    4609729987241574401UL, 4609713494567157761UL, 4609654120939257857UL,
+    4609610140474146817UL, 4609598045846241281UL, 4609590349264846849UL,
+    4609581553171824641UL, 4609560662450896897UL, 4609550766846246913UL,
+    4609534274171830273UL, 4609507885892763649UL, 4609488094683463681UL,
+    4609474900543930369UL, 4609428721055563777UL, 4609403432288124929UL,
+    4609353954264875009UL, 4609326466474180609UL, 4609313272334647297UL,
+    4609271490892791809UL, 4609258296753258497UL, 4609251699683491841UL,
+    4609248401148608513UL, 4609211017753264129UL, 4609204420683497473UL,
+    4609202221660241921UL, 4609194525078847489UL, 4609136250962575361UL,
+    4609121957311414273UL, 4609066981730025473UL, 4608944935939342337UL,
+    4608943836427714561UL, 4608940537892831233UL, 4608938338869575681UL,
+    4608933940823064577UL, 4608897656939347969UL, 4608884462799814657UL,
+    4608875666706792449UL, 4608869069637025793UL
+};
+
+#else
+
+/* there is no NTT on 32 bit machines, so take any primes above 2^30 */
+#define MULTI_MOD_PRIME_BITS (FLINT_BITS - 2)
+
+#endif
+
+typedef struct
+{
+    slong start;
+    slong stop;
+    fmpz * coeffs;
+    mp_ptr * mod_polys;
+    mp_ptr * mod_poly1;
+    mp_ptr * mod_poly2;
+    slong len1;
+    slong len2;
+    slong num_primes;
+    int sign;
+    const fmpz_comb_struct * comb;
+    mp_srcptr M;
+    mp_srcptr Mhalf;
+    mp_srcptr Mi;
+    mp_srcptr c;
+    mp_size_t n;
+}
+_mul_multi_mod_arg_struct;
+
+/* reduces coefficients [start, stop) modulo all primes */
+static void
+_mod_worker(void * varg)
+{
+    _mul_multi_mod_arg_struct * arg = (_mul_multi_mod_arg_struct *) varg;
+    slong i, j, num_primes = arg->num_primes;
+    fmpz_comb_temp_t comb_temp;
+    mp_limb_t * residues;
+
+    if (arg->start >= arg->stop)
+        return;
+
+    residues = flint_malloc(sizeof(mp_limb_t) * num_primes);
+    fmpz_comb_temp_init(comb_temp, arg->comb);
+
+    for (i = arg->start; i < arg->stop; i++)
+    {
+        fmpz_multi_mod_ui(residues, arg->coeffs + i, arg->comb, comb_temp);
+        for (j = 0; j < num_primes; j++)
+            arg->mod_polys[j][i] = residues[j];
+    }
+
+    fmpz_comb_temp_clear(comb_temp);
+    flint_free(residues);
+}
+
+/* multiplies the images modulo primes [start, stop) */
+static void
+_mul_worker(void * varg)
+{
+    _mul_multi_mod_arg_struct * arg = (_mul_multi_mod_arg_struct *) varg;
+    slong i;
+
+    for (i = arg->start; i < arg->stop; i++)
+        _nmod_poly_mul(arg->mod_polys[i], arg->mod_poly1[i], arg->len1,
+                       arg->mod_poly2[i], arg->len2, arg->comb->mod[i]);
+}
+
+/*
+    reconstructs coefficients [start, stop) by Chinese remaindering, as
+    the sum of (r_i c_i mod p_i) M_i reduced modulo M, where M is the
+    product of the primes, M_i = M / p_i and c_i = M_i^{-1} mod p_i
+*/
+static void
+_crt_worker(void * varg)
+{
+    _mul_multi_mod_arg_struct * arg = (_mul_multi_mod_arg_struct *) varg;
+    const mp_size_t n = arg->n;
+    slong i, j, num_primes = arg->num_primes;
+    mp_ptr t, q;
+    mp_limb_t r;
+    __mpz_struct * z;
+
+    if (arg->start >= arg->stop)
+        return;
+
+    t = flint_malloc(sizeof(mp_limb_t) * (n + 3));
+    q = t + n + 1;
+
+    for (i = arg->start; i < arg->stop; i++)
+    {
+        const nmod_t * mod = arg->comb->mod;
+        mp_size_t m = n;
+
+        flint_mpn_zero(t, n + 1);
+        for (j = 0; j < num_primes; j++)
+        {
+            r = n_mulmod2_preinv(arg->mod_polys[j][i], arg->c[j], 
+                                                  mod[j].n, mod[j].ninv);
+            t[n] += mpn_addmul_1(t, arg->Mi + j * n, n, r);
+        }
+
+        z = _fmpz_promote(arg->coeffs + i);
+        if (z->_mp_alloc < n)
+            mpz_realloc2(z, n * FLINT_BITS);
+
+        mpn_tdiv_qr(q, z->_mp_d, 0, t, n + 1, arg->M, n);
+
+        if (arg->sign && mpn_cmp(z->_mp_d, arg->Mhalf, n) > 0)
+        {
+            mpn_sub_n(z->_mp_d, arg->M, z->_mp_d, n);
+            MPN_NORM(z->_mp_d, m);
+            z->_mp_size = -m;
+        }
+        else
+        {
+            MPN_NORM(z->_mp_d, m);
+            z->_mp_size = m;
+        }
+
+        _fmpz_demote_val(arg->coeffs + i);
+    }
+
+    flint_free(t);
+}
+
+/*
+    Splits [0, len) evenly over the calling thread and num_workers workers
+    and runs f on each part.
+*/
+static void
+_mul_multi_mod_run(void (*f)(void *), _mul_multi_mod_arg_struct * args,
+            const _mul_multi_mod_arg_struct * proto, slong len,
+            thread_pool_handle * threads, slong num_workers)
+{
+    slong i;
+
+    for (i = 0; i <= num_workers; i++)
+    {
+        args[i] = *proto;
+        args[i].start = (i * len) / (num_workers + 1);
+        args[i].stop = ((i + 1) * len) / (num_workers + 1);
+    }
+
+    for (i = 0; i < num_workers; i++)
+        thread_pool_wake(global_thread_pool, threads[i], f, args + i + 1);
+
+    f(args);
+
+    for (i = 0; i < num_workers; i++)
+        thread_pool_wait(global_thread_pool, threads[i]);
+}
+
+void
+_fmpz_poly_mul_multi_mod(fmpz * res, const fmpz * poly1, slong len1,
+                                     const fmpz * poly2, slong len2)
+{
+    const slong lenr = len1 + len2 - 1;
+    const int sqr = (poly1 == poly2 && len1 == len2);
+    slong i, bits1, bits2, num_primes;
+    mp_bitcnt_t bits;
+    mp_limb_t * primes, c;
+    mp_ptr * mod_res, * mod_poly1, * mod_poly2;
+    mp_ptr M, Mhalf, Mi, cinv;
+    mp_size_t n;
+    fmpz_comb_t comb;
+    thread_pool_handle * threads;
+    slong num_workers;
+    _mul_multi_mod_arg_struct proto, * args;
+
+    bits1 = _fmpz_vec_max_bits(poly1, len1);
+    bits2 = sqr ? bits1 : _fmpz_vec_max_bits(poly2, len2);
+
+    if (bits1 == 0 || bits2 == 0)
+    {
+        _fmpz_vec_zero(res, lenr);
+        return;
+    }
+
+    proto.sign = (bits1 < 0 || bits2 < 0);
+    bits = FLINT_ABS(bits1) + FLINT_ABS(bits2) 
+         + FLINT_BIT_COUNT(len2) + proto.sign;
+
+    num_primes = (bits + MULTI_MOD_PRIME_BITS - 1) / MULTI_MOD_PRIME_BITS;
+
+    primes = flint_malloc(sizeof(mp_limb_t) * num_primes);
+#if FLINT64
+    for (i = 0; i < FLINT_MIN(num_primes, MULTI_MOD_NUM_TABLE_PRIMES); i++)
+        primes[i] = _fmpz_poly_multi_mod_primes[i];
+    c = (_fmpz_poly_multi_mod_primes[MULTI_MOD_NUM_TABLE_PRIMES - 1] >> 40);
+    for ( ; i < num_primes; i++)
+    {
+        do {
+            c--;
+        } while (!n_is_prime((c << 40) + 1));
+        primes[i] = (c << 40) + 1;
+    }
+#else
+    c = (1UL << MULTI_MOD_PRIME_BITS);
+    for (i = 0; i < num_primes; i++)
+    {
+        c = n_nextprime(c, 0);
+        primes[i] = c;
+    }
+#endif
+
+    mod_res = flint_malloc(sizeof(mp_ptr) * 3 * num_primes);
+    mod_poly1 = mod_res + num_primes;
+    mod_poly2 = mod_poly1 + num_primes;
+
+    mod_res[0] = flint_malloc(sizeof(mp_limb_t) * num_primes
+                                 * (lenr + len1 + (sqr ? 0 : len2)));
+    for (i = 0; i < num_primes; i++)
+    {
+        mod_res[i] = mod_res[0] + i * lenr;
+        mod_poly1[i] = mod_res[0] + num_primes * lenr + i * len1;
+        mod_poly2[i] = sqr ? mod_poly1[i] 
+                 : mod_res[0] + num_primes * (lenr + len1) + i * len2;
+    }
+
+    fmpz_comb_init(comb, primes, num_primes);
+
+    /* Precomputations for the Chinese remaindering */
+    M = flint_malloc(sizeof(mp_limb_t) * (num_primes + 2) * (num_primes + 1));
+    Mhalf = M + num_primes + 1;
+    cinv = Mhalf + num_primes + 1;
+    Mi = cinv + num_primes;
+
+    M[0] = primes[0];
+    for (n = 1, i = 1; i < num_primes; i++)
+    {
+        M[n] = mpn_mul_1(M, M, n, primes[i]);
+        n += (M[n] != 0);
+    }
+
+    mpn_rshift(Mhalf, M, n, 1);
+    for (i = 0; i < num_primes; i++)
+    {
+        mpn_divrem_1(Mi + i * n, 0, M, n, primes[i]);
+        cinv[i] = n_invmod(mpn_mod_1(Mi + i * n, n, primes[i]), primes[i]);
+    }
+
+    num_workers = flint_request_threads(&threads, flint_get_num_threads());
+    args = flint_malloc(sizeof(_mul_multi_mod_arg_struct) * (num_workers + 1));
+
+    proto.num_primes = num_primes;
+    proto.comb = comb;
+    proto.len1 = len1;
+    proto.len2 = len2;
+    proto.mod_poly1 = mod_poly1;
+    proto.mod_poly2 = mod_poly2;
+    proto.M = M;
+    proto.Mhalf = Mhalf;
+    proto.Mi = Mi;
+    proto.c = cinv;
+    proto.n = n;
+
+    /* Reduce the inputs */
+    proto.coeffs = (fmpz *) poly1;
+    proto.mod_polys = mod_poly1;
+    _mul_multi_mod_run(_mod_worker, args, &proto, len1,
+                                                 threads, num_workers);
+    if (!sqr)
+    {
+        proto.coeffs = (fmpz *) poly2;
+        proto.mod_polys = mod_poly2;
+        _mul_multi_mod_run(_mod_worker, args, &proto, len2,
+                                                 threads, num_workers);
+    }
+
+    /* Multiply modulo each prime */
+    proto.mod_polys = mod_res;
+    _mul_multi_mod_run(_mul_worker, args, &proto, num_primes,
+                                                 threads, num_workers);
+
+    /* Chinese remaindering */
+    proto.coeffs = res;
+    _mul_multi_mod_run(_crt_worker, args, &proto, lenr,
+                                                 threads, num_workers);
+
+    flint_give_back_threads(threads, num_workers);
+    flint_free(args);
+
+    fmpz_comb_clear(comb);
+    flint_free(M);
+    flint_free(mod_res[0]);
+    flint_free(mod_res);
+    flint_free(primes);
+}
+
+void
+fmpz_poly_mul_multi_mod(fmpz_poly_t res,
+                        const fmpz_poly_t poly1, const fmpz_poly_t poly2)
+{
+    const slong len1 = poly1->length;
+    const slong len2 = poly2->length;
+    slong rlen;
+
+    if (len1 == 0 || len2 == 0)
+    {
+        fmpz_poly_zero(res);
+        return;
+    }
+
+    rlen = len1 + len2 - 1;
+
+    if (res == poly1 || res == poly2)
+    {
+        fmpz_poly_t t;
+        fmpz_poly_init2(t, rlen);
+        if (len1 >= len2)
+            _fmpz_poly_mul_multi_mod(t->coeffs, poly1->coeffs, len1,
+                                                 poly2->coeffs, len2);
+        else
+            _fmpz_poly_mul_multi_mod(t->coeffs, poly2->coeffs, len2,
+                                                 poly1->coeffs, len1);
+        fmpz_poly_swap(res, t);
+        fmpz_poly_clear(t);
+    }
+    else
+    {
+        fmpz_poly_fit_length(res, rlen);
+        if (len1 >= len2)
+            _fmpz_poly_mul_multi_mod(res->coeffs, poly1->coeffs, len1,
+                                                  poly2->coeffs, len2);
+        else
+            _fmpz_poly_mul_multi_mod(res->coeffs, poly2->coeffs, len2,
+                                                  poly1->coeffs, len1);
+    }
+
+    _fmpz_poly_set_length(res, rlen);
+    _fmpz_poly_normalise(res);
+}
+
+#undef MULTI_MOD_PRIME_BITS
+#if FLINT64
+#undef MULTI_MOD_NUM_TABLE_PRIMES
+#endif
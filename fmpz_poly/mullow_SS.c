@@ -40,6 +40,7 @@ void _fmpz_poly_mullow_SS(fmpz * output, const fmpz * input1, slong len1,
     mp_limb_t * ptr, * t1, * t2, * tt, * s1, ** ii, ** jj;
     slong bits1, bits2;
     int sign = 0;
+    TMP_INIT;
 
     ulong size1 = _fmpz_vec_max_limbs(input1, len1); 
     ulong size2 = _fmpz_vec_max_limbs(input2, len2);
@@ -55,8 +56,10 @@ void _fmpz_poly_mullow_SS(fmpz * output, const fmpz * input1, slong len1,
         limbs = (1L << FLINT_CLOG2(limbs));
     size = limbs + 1;
 
+    TMP_START;
+
     /* allocate space for ffts */
-    ii = flint_malloc((4*(n + n*size) + 5*size)*sizeof(mp_limb_t));
+    ii = TMP_ALLOC((4*(n + n*size) + 5*size)*sizeof(mp_limb_t));
     for (i = 0, ptr = (mp_limb_t *) ii + 4*n; i < 4*n; i++, ptr += size) 
         ii[i] = ptr;
     t1 = ptr;
@@ -66,7 +69,7 @@ void _fmpz_poly_mullow_SS(fmpz * output, const fmpz * input1, slong len1,
 
     if (input1 != input2)
     {
-        jj = flint_malloc(4*(n + n*size)*sizeof(mp_limb_t));
+        jj = TMP_ALLOC(4*(n + n*size)*sizeof(mp_limb_t));
         for (i = 0, ptr = (mp_limb_t *) jj + 4*n; i < 4*n; i++, ptr += size) 
             jj[i] = ptr;
     } else jj = ii;
@@ -104,9 +107,7 @@ void _fmpz_poly_mullow_SS(fmpz * output, const fmpz * input1, slong len1,
 
     _fmpz_vec_set_fft(output, trunc, ii, limbs, sign); /* write output */
 
-    flint_free(ii); 
-    if (input1 != input2) 
-        flint_free(jj);
+    TMP_END;
 }
 
 void
@@ -43,6 +43,8 @@ void _fmpz_poly_sqr(fmpz * res, const fmpz * poly, slong len)
 
     if (len < 16 && limbs > 12)
         _fmpz_poly_sqr_karatsuba(res, poly, len);
+    else if (_fmpz_poly_mul_use_multi_mod(len, 2 * limbs))
+        _fmpz_poly_mul_multi_mod(res, poly, len, poly, len);
     else if (limbs <= 4)
         _fmpz_poly_sqr_KS(res, poly, len);
     else if (limbs/2048 > len)
@@ -193,6 +193,53 @@ main(void)
         fmpz_poly_clear(r);
     }
 
+    /* Check that a == GCD(af, ag) when GCD(f, g) = 1, using several threads */
+    for (i = 0; i < 50 * flint_test_multiplier(); i++)
+    {
+        fmpz_poly_t a, d, f, g;
+
+        fmpz_poly_init(a);
+        fmpz_poly_init(d);
+        fmpz_poly_init(f);
+        fmpz_poly_init(g);
+        fmpz_poly_randtest_not_zero(a, state, n_randint(state, 100) + 1, 
+                                              n_randint(state, 400) + 1);
+        do {
+           fmpz_poly_randtest(f, state, n_randint(state, 100), 
+                                        n_randint(state, 400) + 1);
+           fmpz_poly_randtest(g, state, n_randint(state, 100), 
+                                        n_randint(state, 400) + 1);
+           fmpz_poly_gcd_heuristic(d, f, g);
+        } while (!(d->length == 1 && fmpz_is_one(d->coeffs)));
+
+        fmpz_poly_mul(f, a, f);
+        fmpz_poly_mul(g, a, g);
+
+        flint_set_num_threads(1 + n_randint(state, 4));
+
+        fmpz_poly_gcd_modular(d, f, g);
+
+        if (!_t_gcd_is_canonical(a)) fmpz_poly_neg(a, a);
+
+        result = fmpz_poly_equal(d, a) && _t_gcd_is_canonical(d);
+        if (!result)
+        {
+           printf("FAIL (check a == gcd(af, ag) using threads):\n");
+           printf("f = "), fmpz_poly_print(f), printf("\n");
+           printf("g = "), fmpz_poly_print(g), printf("\n");
+           printf("a = "), fmpz_poly_print(a), printf("\n");
+           printf("d = "), fmpz_poly_print(d), printf("\n");
+           abort();
+        } 
+
+        fmpz_poly_clear(a);
+        fmpz_poly_clear(d);
+        fmpz_poly_clear(f);
+        fmpz_poly_clear(g);
+    }
+
+    flint_set_num_threads(1);
+
     /* Sebastian's test case */
     {
         fmpz_poly_t a, b, d;
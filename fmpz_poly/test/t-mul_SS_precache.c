@@ -0,0 +1,114 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "fmpz_poly.h"
+#include "ulong_extras.h"
+
+int
+main(void)
+{
+    int i, j, result;
+    flint_rand_t state;
+
+    printf("mul_SS_precache....");
+    fflush(stdout);
+
+    flint_randinit(state);
+
+    /* Compare with mul_KS and mullow_KS, reusing each precache */
+    for (i = 0; i < 50 * flint_test_multiplier(); i++)
+    {
+        fmpz_poly_mul_precache_t pre;
+        fmpz_poly_t a, b, c, d;
+        slong len1, bits1, trunc;
+
+        fmpz_poly_init(a);
+        fmpz_poly_init(b);
+        fmpz_poly_init(c);
+        fmpz_poly_init(d);
+
+        len1 = n_randint(state, (i % 10 == 0) ? 600 : 50) + 1;
+        bits1 = n_randint(state, 300) + 1;
+        fmpz_poly_randtest(c, state, n_randint(state, 
+                                      (i % 10 == 0) ? 400 : 50), 200);
+
+        fmpz_poly_mul_SS_precache_init(pre, len1, bits1, c);
+
+        for (j = 0; j < 5; j++)
+        {
+            fmpz_poly_randtest(b, state, n_randint(state, len1 + 1), 
+                                         n_randint(state, bits1) + 1);
+
+            fmpz_poly_mul_KS(a, b, c);
+            fmpz_poly_mul_SS_precache(d, b, pre);
+
+            result = (fmpz_poly_equal(a, d));
+            if (!result)
+            {
+                printf("FAIL (mul):\n");
+                fmpz_poly_print(a), printf("\n\n");
+                fmpz_poly_print(d), printf("\n\n");
+                abort();
+            }
+
+            trunc = n_randint(state, b->length + c->length + 1);
+            fmpz_poly_truncate(a, trunc);
+            fmpz_poly_mullow_SS_precache(d, b, pre, trunc);
+
+            result = (fmpz_poly_equal(a, d));
+            if (!result)
+            {
+                printf("FAIL (mullow):\n");
+                fmpz_poly_print(a), printf("\n\n");
+                fmpz_poly_print(d), printf("\n\n");
+                abort();
+            }
+
+            /* aliasing */
+            fmpz_poly_mullow_SS_precache(b, b, pre, trunc);
+
+            result = (fmpz_poly_equal(a, b));
+            if (!result)
+            {
+                printf("FAIL (aliasing):\n");
+                fmpz_poly_print(a), printf("\n\n");
+                fmpz_poly_print(b), printf("\n\n");
+                abort();
+            }
+        }
+
+        fmpz_poly_mul_precache_clear(pre);
+
+        fmpz_poly_clear(a);
+        fmpz_poly_clear(b);
+        fmpz_poly_clear(c);
+        fmpz_poly_clear(d);
+    }
+
+    flint_randclear(state);
+    flint_cleanup();
+    printf("PASS\n");
+    return 0;
+}
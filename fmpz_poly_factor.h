@@ -69,11 +69,23 @@ void fmpz_poly_factor_zassenhaus_recombination(fmpz_poly_factor_t final_fac,
     
 void fmpz_poly_factor_squarefree(fmpz_poly_factor_t fac, const fmpz_poly_t F);
 
+void _fmpz_poly_factor_mignotte(fmpz_t B, const fmpz *f, slong m);
+
+void fmpz_poly_factor_mignotte(fmpz_t B, const fmpz_poly_t f);
+
 void _fmpz_poly_factor_zassenhaus(fmpz_poly_factor_t final_fac, 
-								  slong exp, const fmpz_poly_t f, slong cutoff);
+		  slong exp, const fmpz_poly_t f, slong cutoff, int use_van_hoeij);
 
 void fmpz_poly_factor_zassenhaus(fmpz_poly_factor_t fac, const fmpz_poly_t G);
 
+void fmpz_poly_factor_van_hoeij(fmpz_poly_factor_t final_fac, 
+    const nmod_poly_factor_t fac, const fmpz_poly_t f, slong exp, ulong p);
+
+void _fmpz_poly_factor(fmpz_poly_factor_t fac, const fmpz_poly_t G,
+                       int use_van_hoeij);
+
+void fmpz_poly_factor(fmpz_poly_factor_t fac, const fmpz_poly_t G);
+
 #ifdef __cplusplus
 }
 #endif
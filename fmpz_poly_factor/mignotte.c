@@ -0,0 +1,99 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+/******************************************************************************
+
+    Copyright (C) 2011 Andy Novocin
+    Copyright (C) 2011 Sebastian Pancratz
+   
+******************************************************************************/
+
+#include "fmpz_poly_factor.h"
+
+/*
+    Let $f$ be a polynomial of degree $m = \deg(f) \geq 2$. 
+    If another polynomial $g$ divides $f$ then, for all 
+    $0 \leq j \leq \deg(g)$, 
+    \begin{equation*}
+    \abs{b_j} \leq \binom{n-1}{j} \abs{f} + \binom{n-1}{j-1} \abs{a_m}
+    \end{equation*}
+    where $\abs{f}$ denotes the $2$-norm of $f$.  This bound 
+    is due to Mignotte, see e.g., Cohen p.\ 134.
+
+    This function sets $B$ such that, for all $0 \leq j \leq \deg(g)$, 
+    $\abs{b_j} \leq B$.
+
+    Consequently, when proceeding with Hensel lifting, we 
+    proceed to choose an $a$ such that $p^a \geq 2 B + 1$, 
+    e.g., $a = \ceil{\log_p(2B + 1)}$.
+
+    Note that the formula degenerates for $j = 0$ and $j = n$ 
+    and so in this case we use that the leading (resp.\ constant) 
+    term of $g$ divides the leading (resp.\ constant) term of $f$.
+ */
+void _fmpz_poly_factor_mignotte(fmpz_t B, const fmpz *f, slong m)
+{
+    slong j;
+    fmpz_t b, f2, lc, s, t;
+
+    fmpz_init(b);
+    fmpz_init(f2);
+    fmpz_init(lc);
+    fmpz_init(s);
+    fmpz_init(t);
+
+    for (j = 0; j <= m; j++)
+        fmpz_addmul(f2, f + j, f + j);
+    fmpz_sqrt(f2, f2);
+    fmpz_add_ui(f2, f2, 1);
+
+    fmpz_abs(lc, f + m);
+
+    fmpz_abs(B, f + 0);
+
+    /*  We have $b = \binom{m-1}{j-1}$ on loop entry and 
+        $b = \binom{m-1}{j}$ on exit. */
+    fmpz_set_ui(b, m-1);
+    for (j = 1; j < m; j++)
+    {
+        fmpz_mul(t, b, lc);
+
+        fmpz_mul_ui(b, b, m - j);
+        fmpz_divexact_ui(b, b, j);
+
+        fmpz_mul(s, b, f2);
+        fmpz_add(s, s, t);
+        if (fmpz_cmp(B, s) < 0)
+            fmpz_set(B, s);
+    }
+
+    if (fmpz_cmp(B, lc) < 0)
+        fmpz_set(B, lc);
+
+    fmpz_clear(b);
+    fmpz_clear(f2);
+    fmpz_clear(lc);
+    fmpz_clear(s);
+    fmpz_clear(t);
+}
+
+void fmpz_poly_factor_mignotte(fmpz_t B, const fmpz_poly_t f)
+{
+    _fmpz_poly_factor_mignotte(B, f->coeffs, f->length - 1);
+}
@@ -0,0 +1,150 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "flint.h"
+#include "arith.h"
+#include "fmpz_poly_factor.h"
+
+static void
+check_product(const fmpz_poly_t f, const fmpz_poly_factor_t fac)
+{
+    fmpz_poly_t h, t;
+    slong j;
+
+    fmpz_poly_init(h);
+    fmpz_poly_init(t);
+
+    fmpz_poly_set_fmpz(h, &fac->c);
+    for (j = 0; j < fac->num; j++)
+    {
+        fmpz_poly_pow(t, fac->p + j, fac->exp[j]);
+        fmpz_poly_mul(h, h, t);
+    }
+
+    if (!fmpz_poly_equal(f, h))
+    {
+        printf("FAIL:\n");
+        printf("f = "), fmpz_poly_print(f), printf("\n\n");
+        printf("h = "), fmpz_poly_print(h), printf("\n\n");
+        printf("fac = "), fmpz_poly_factor_print(fac), printf("\n\n");
+        abort();
+    }
+
+    fmpz_poly_clear(h);
+    fmpz_poly_clear(t);
+}
+
+int
+main(void)
+{
+    int i;
+    flint_rand_t state;
+
+    printf("factor....");
+    fflush(stdout);
+
+    flint_randinit(state);
+
+    /* Random products */
+    for (i = 0; i < 1000 * flint_test_multiplier(); i++)
+    {
+        fmpz_t c;
+        fmpz_poly_t f, g;
+        fmpz_poly_factor_t fac;
+        slong j, n = n_randint(state, 5);
+
+        fmpz_init(c);
+        fmpz_poly_init(f);
+        fmpz_poly_init(g);
+        fmpz_poly_factor_init(fac);
+
+        fmpz_randtest_not_zero(c, state, n_randint(state, 10) + 1);
+        fmpz_poly_set_fmpz(f, c);
+
+        for (j = 0; j < n; j++)
+        {
+            fmpz_poly_randtest(g, state, n_randint(state, 5) + 2, n_randint(state, 40));
+            fmpz_poly_mul(f, f, g);
+        }
+
+        fmpz_poly_factor(fac, f);
+        check_product(f, fac);
+
+        fmpz_clear(c);
+        fmpz_poly_clear(f);
+        fmpz_poly_clear(g);
+        fmpz_poly_factor_clear(fac);
+    }
+
+    /*
+        Products of Swinnerton-Dyer polynomials composed with linear 
+        polynomials, which are irreducible but have many local factors
+     */
+    for (i = 0; i < 20 * flint_test_multiplier(); i++)
+    {
+        fmpz_poly_t f, g, h;
+        fmpz_poly_factor_t fac;
+        slong j, k, n = 1 + n_randint(state, 3);
+
+        fmpz_poly_init(f);
+        fmpz_poly_init(g);
+        fmpz_poly_init(h);
+        fmpz_poly_factor_init(fac);
+
+        fmpz_poly_set_ui(f, 1);
+        for (j = 0; j < n; j++)
+        {
+            arith_swinnerton_dyer_polynomial(g, 2 + n_randint(state, 4));
+
+            fmpz_poly_zero(h);
+            fmpz_poly_set_coeff_si(h, 0, n_randint(state, 7) - 3);
+            fmpz_poly_set_coeff_si(h, 1, 1 + n_randint(state, 3));
+            fmpz_poly_compose(g, g, h);
+
+            fmpz_poly_mul(f, f, g);
+        }
+
+        fmpz_poly_factor(fac, f);
+        check_product(f, fac);
+
+        for (j = k = 0; j < fac->num; j++)
+            k += fac->exp[j];
+
+        if (k != n)
+        {
+            printf("FAIL (number of factors):\n");
+            printf("f = "), fmpz_poly_print(f), printf("\n\n");
+            printf("fac = "), fmpz_poly_factor_print(fac), printf("\n\n");
+            abort();
+        }
+
+        fmpz_poly_clear(f);
+        fmpz_poly_clear(g);
+        fmpz_poly_clear(h);
+        fmpz_poly_factor_clear(fac);
+    }
+
+    flint_randclear(state);
+    flint_cleanup();
+    printf("PASS\n");
+    return 0;
+}
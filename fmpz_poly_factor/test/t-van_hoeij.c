@@ -0,0 +1,144 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "flint.h"
+#include "fmpz_poly_factor.h"
+
+int
+main(void)
+{
+    int i;
+    flint_rand_t state;
+
+    printf("van_hoeij....");
+    fflush(stdout);
+
+    flint_randinit(state);
+
+    /*
+        Compare with Zassenhaus on square-free parts of random products, 
+        using the smallest suitable prime to get many local factors
+     */
+    for (i = 0; i < 1000 * flint_test_multiplier(); i++)
+    {
+        fmpz_poly_t f, g, h;
+        fmpz_poly_factor_t sq, fac1, fac2;
+        slong j, k, n = 1 + n_randint(state, 4);
+
+        fmpz_poly_init(f);
+        fmpz_poly_init(g);
+        fmpz_poly_init(h);
+        fmpz_poly_factor_init(sq);
+        fmpz_poly_factor_init(fac1);
+        fmpz_poly_factor_init(fac2);
+
+        fmpz_poly_set_ui(f, 1);
+        for (j = 0; j < n; j++)
+        {
+            fmpz_poly_randtest(g, state, n_randint(state, 5) + 2, n_randint(state, 40));
+            fmpz_poly_mul(f, f, g);
+        }
+
+        if (f->length == 0)
+            goto cleanup;
+
+        for (k = 0; fmpz_is_zero(f->coeffs + k); k++) ;
+        fmpz_poly_shift_right(f, f, k);
+        fmpz_poly_factor_squarefree(sq, f);
+
+        for (j = 0; j < sq->num; j++)
+        {
+            const fmpz_poly_struct * F = sq->p + j;
+            mp_limb_t p;
+            nmod_poly_t t, d;
+            nmod_poly_factor_t local_fac;
+
+            if (F->length <= 2)
+                continue;
+
+            for (p = 2; ; p = n_nextprime(p, 0))
+            {
+                nmod_poly_init(t, p);
+                nmod_poly_init(d, p);
+                fmpz_poly_get_nmod_poly(t, F);
+                nmod_poly_derivative(d, t);
+                nmod_poly_gcd(d, t, d);
+
+                if (t->length == F->length && nmod_poly_is_one(d))
+                    break;
+
+                nmod_poly_clear(t);
+                nmod_poly_clear(d);
+            }
+
+            nmod_poly_factor_init(local_fac);
+            nmod_poly_factor(local_fac, t);
+
+            fmpz_poly_factor_van_hoeij(fac1, local_fac, F, sq->exp[j], p);
+            _fmpz_poly_factor_zassenhaus(fac2, sq->exp[j], F, 20, 0);
+
+            nmod_poly_factor_clear(local_fac);
+            nmod_poly_clear(t);
+            nmod_poly_clear(d);
+        }
+
+        fmpz_poly_set_ui(g, 1);
+        for (j = 0; j < fac1->num; j++)
+        {
+            fmpz_poly_pow(h, fac1->p + j, fac1->exp[j]);
+            fmpz_poly_mul(g, g, h);
+        }
+
+        fmpz_poly_set_ui(h, 1);
+        for (j = 0; j < sq->num; j++)
+        {
+            if (sq->p[j].length > 2)
+            {
+                fmpz_poly_pow(f, sq->p + j, sq->exp[j]);
+                fmpz_poly_mul(h, h, f);
+            }
+        }
+
+        if (fac1->num != fac2->num || !fmpz_poly_equal(g, h))
+        {
+            printf("FAIL:\n");
+            printf("sq = "), fmpz_poly_factor_print(sq), printf("\n\n");
+            printf("fac1 = "), fmpz_poly_factor_print(fac1), printf("\n\n");
+            printf("fac2 = "), fmpz_poly_factor_print(fac2), printf("\n\n");
+            abort();
+        }
+
+cleanup:
+
+        fmpz_poly_clear(f);
+        fmpz_poly_clear(g);
+        fmpz_poly_clear(h);
+        fmpz_poly_factor_clear(sq);
+        fmpz_poly_factor_clear(fac1);
+        fmpz_poly_factor_clear(fac2);
+    }
+
+    flint_randclear(state);
+    flint_cleanup();
+    printf("PASS\n");
+    return 0;
+}
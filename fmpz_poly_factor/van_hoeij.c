@@ -0,0 +1,447 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdlib.h>
+#include "fmpz_mat.h"
+#include "fmpz_poly_factor.h"
+
+/*
+    We follow van Hoeij's knapsack approach, using the power sums of
+    the roots of the lifted factors as the knapsack data.
+
+    Let $\ell$ be the leading coefficient of $f$ and let $f_1, \ldots, f_r$
+    be the monic lifted factors modulo $P = p^a$.  For every true factor
+    $g$ of $f$, with $g \equiv \ell' \prod_{i \in S} f_i$, the sum
+    $\sum_{i \in S} \ell^j \operatorname{Tr}_j(f_i)$ of the scaled
+    $j$-th power sums is congruent modulo $P$ to an integer $T$ bounded
+    by $B_j = n (\abs{\ell} R)^j$, where $R$ bounds the roots of $f$.
+
+    Dropping the bottom $s_j$ digits of the traces, where $p^{s_j} \geq B_j$,
+    the lattice generated by the rows of $(M \mid M U)$ and 
+    $(0 \mid p^{a - s_j} I)$, where $M$ is the current basis of candidate 
+    vectors and $U$ the truncated traces, contains for each true factor a 
+    vector $(e_S, *)$ whose norm is at most the bound $\beta$ below.  After 
+    LLL reduction, trailing basis vectors whose Gram--Schmidt norm exceeds 
+    $\beta$ can be discarded without losing any of these vectors.  We 
+    repeat until the reduced row echelon form of $M$ describes a partition 
+    of the local factors all of whose parts give true factors of $f$.  At 
+    that point the factors found are irreducible, since each true factor 
+    is a union of parts.
+ */
+
+/* Number of bits of each truncated trace which carry information */
+#define VAN_HOEIJ_MARGIN(r) (2 * (r) + 30)
+
+/*
+    Number of traces added to the lattice in each round; adding them one 
+    at a time keeps LLL working on a nearly reduced basis, which is much 
+    cheaper than reducing several fresh columns at once
+ */
+#define VAN_HOEIJ_TRACES 1
+
+/*
+    Returns $b$ such that all complex roots of $f$ have absolute value at 
+    most $2^b$, using Fujiwara's bound 
+    $2 \max_k \abs{a_{n-k}/a_n}^{1/k}$.
+ */
+static slong _fmpz_poly_root_bound_bits(const fmpz_poly_t f)
+{
+    const slong n = fmpz_poly_degree(f);
+    const slong lb = fmpz_bits(fmpz_poly_lead(f));
+    slong k, b = 0;
+
+    for (k = 1; k <= n; k++)
+    {
+        const fmpz * c = f->coeffs + n - k;
+
+        if (!fmpz_is_zero(c))
+        {
+            slong t = (slong) fmpz_bits(c) - lb + 1;
+
+            if (t > 0)
+                b = FLINT_MAX(b, (t + k - 1) / k);
+        }
+    }
+
+    return b + 1;
+}
+
+/*
+    Returns the least $s$ such that $p^s \geq 2^{bits}$.
+ */
+static slong _fmpz_poly_factor_clog_2exp(slong bits, ulong p)
+{
+    slong s;
+    fmpz_t t;
+
+    fmpz_init(t);
+    fmpz_one(t);
+    fmpz_mul_2exp(t, t, bits);
+    s = fmpz_clog_ui(t, p);
+    fmpz_clear(t);
+
+    return s;
+}
+
+/*
+    Sets the entry $(i, j - j_0)$ of $U$ to 
+    $\floor{(\ell^j \operatorname{Tr}_j(f_i) \bmod P) / p^{s_j}}$ 
+    for $j_0 \leq j < j_0 + N$, where \code{pk[j - j0]} is $p^{s_j}$.
+ */
+static void _fmpz_poly_factor_van_hoeij_traces(fmpz_mat_t U, 
+    const fmpz_poly_factor_t lifted_fac, const fmpz_t lc, 
+    slong j0, slong N, const fmpz * pk, const fmpz_t P)
+{
+    const slong r = lifted_fac->num, J = j0 + N - 1;
+    slong i, j, m;
+    fmpz * ps;
+    fmpz_t lcj, t;
+
+    ps = _fmpz_vec_init(J + 1);
+    fmpz_init(lcj);
+    fmpz_init(t);
+
+    for (i = 0; i < r; i++)
+    {
+        const fmpz * c = lifted_fac->p[i].coeffs;
+        const slong d = fmpz_poly_degree(lifted_fac->p + i);
+
+        /* Newton's identities for the monic factor f_i */
+        for (j = 1; j <= J; j++)
+        {
+            if (j <= d)
+                fmpz_mul_si(t, c + d - j, -j);
+            else
+                fmpz_zero(t);
+
+            for (m = 1; m < j && m <= d; m++)
+                fmpz_submul(t, c + d - m, ps + j - m);
+
+            fmpz_mod(ps + j, t, P);
+        }
+
+        fmpz_one(lcj);
+        for (j = 1; j <= J; j++)
+        {
+            fmpz_mul(lcj, lcj, lc);
+            fmpz_mod(lcj, lcj, P);
+
+            if (j >= j0)
+            {
+                fmpz_mul(t, ps + j, lcj);
+                fmpz_mod(t, t, P);
+                fmpz_fdiv_q(fmpz_mat_entry(U, i, j - j0), t, pk + j - j0);
+            }
+        }
+    }
+
+    _fmpz_vec_clear(ps, J + 1);
+    fmpz_clear(lcj);
+    fmpz_clear(t);
+}
+
+/*
+    If the reduced row echelon form of $M$ is the incidence matrix of a 
+    partition of the local factors and every part gives a factor of $f$, 
+    inserts these factors into \code{final_fac} and returns $1$.  
+    Otherwise returns $0$.
+ */
+static int _fmpz_poly_factor_van_hoeij_check(fmpz_poly_factor_t final_fac, 
+    const fmpz_mat_t M, const fmpz_poly_factor_t lifted_fac, 
+    const fmpz_poly_t f, const fmpz_t P, slong exp)
+{
+    const slong s = M->r, r = M->c;
+    slong i, j, k, *part;
+    fmpz_mat_t R;
+    fmpz_t den;
+    fmpz_poly_t g, q, h;
+    fmpz_poly_factor_t fac;
+    int ok = 1;
+
+    part = flint_malloc(r * sizeof(slong));
+    fmpz_mat_init(R, s, r);
+    fmpz_init(den);
+
+    fmpz_mat_rref(R, den, M);
+
+    for (j = 0; j < r && ok; j++)
+    {
+        part[j] = -1;
+
+        for (i = 0; i < s && ok; i++)
+        {
+            if (!fmpz_is_zero(fmpz_mat_entry(R, i, j)))
+            {
+                ok = (part[j] == -1) && fmpz_equal(fmpz_mat_entry(R, i, j), den);
+                part[j] = i;
+            }
+        }
+    }
+
+    fmpz_mat_clear(R);
+    fmpz_clear(den);
+
+    if (!ok)
+    {
+        flint_free(part);
+        return 0;
+    }
+
+    fmpz_poly_init(g);
+    fmpz_poly_init(q);
+    fmpz_poly_init(h);
+    fmpz_poly_factor_init(fac);
+
+    fmpz_poly_set(h, f);
+
+    for (i = 0; i < s - 1 && ok; i++)
+    {
+        fmpz_poly_set_fmpz(g, fmpz_poly_lead(f));
+
+        for (k = 0; k < r; k++)
+        {
+            if (part[k] == i)
+            {
+                fmpz_poly_mul(g, g, lifted_fac->p + k);
+                fmpz_poly_scalar_smod_fmpz(g, g, P);
+            }
+        }
+
+        fmpz_poly_primitive_part(g, g);
+
+        if ((ok = fmpz_poly_divides(q, h, g)))
+        {
+            fmpz_poly_factor_insert(fac, g, exp);
+            fmpz_poly_swap(h, q);
+        }
+    }
+
+    if (ok)
+    {
+        fmpz_poly_factor_insert(fac, h, exp);
+        fmpz_poly_factor_concat(final_fac, fac);
+    }
+
+    flint_free(part);
+    fmpz_poly_clear(g);
+    fmpz_poly_clear(q);
+    fmpz_poly_clear(h);
+    fmpz_poly_factor_clear(fac);
+
+    return ok;
+}
+
+void fmpz_poly_factor_van_hoeij(fmpz_poly_factor_t final_fac, 
+    const nmod_poly_factor_t fac, const fmpz_poly_t f, slong exp, ulong p)
+{
+    const slong n = fmpz_poly_degree(f), r = fac->num;
+    const fmpz * lc = fmpz_poly_lead(f);
+
+    slong a, i, j, j0, prev, rb, *link;
+    int more = 0;
+    fmpz_poly_t *v, *w;
+    fmpz_poly_factor_t lifted_fac;
+    fmpz_mat_t M;
+    fmpz_t B, P, pp;
+
+    if (r == 1)
+    {
+        fmpz_poly_factor_insert(final_fac, f, exp);
+        return;
+    }
+
+    /* Bits of |lc| times the root bound */
+    rb = _fmpz_poly_root_bound_bits(f) + fmpz_bits(lc);
+
+    fmpz_init(B);
+    fmpz_init(P);
+    fmpz_init_set_ui(pp, p);
+
+    /* Precision needed to recover the factors, cf. Zassenhaus */
+    fmpz_poly_factor_mignotte(B, f);
+    fmpz_mul(B, B, lc);
+    fmpz_abs(B, B);
+    fmpz_mul_2exp(B, B, 1);
+    fmpz_add_ui(B, B, 1);
+    a = fmpz_clog_ui(B, p);
+
+    /* Precision needed for the first round of traces */
+    j = FLINT_MIN(n, VAN_HOEIJ_TRACES);
+    a = FLINT_MAX(a, _fmpz_poly_factor_clog_2exp(FLINT_BIT_COUNT(n) 
+                                     + j * rb + VAN_HOEIJ_MARGIN(r), p));
+
+    link = flint_malloc((2*r - 2) * sizeof(slong));
+    v    = flint_malloc((2*r - 2) * sizeof(fmpz_poly_t));
+    w    = flint_malloc((2*r - 2) * sizeof(fmpz_poly_t));
+
+    for (i = 0; i < 2*r - 2; i++)
+    {
+        fmpz_poly_init(v[i]);
+        fmpz_poly_init(w[i]);
+    }
+
+    fmpz_poly_factor_init(lifted_fac);
+    prev = _fmpz_poly_hensel_start_lift(lifted_fac, link, v, w, f, fac, a);
+    fmpz_pow_ui(P, pp, a);
+
+    fmpz_mat_init(M, r, r);
+    fmpz_mat_one(M);
+
+    j0 = 1;
+
+    for ( ; ; )
+    {
+        const slong s = M->r;
+        slong N, k, need;
+        fmpz *d, *pk;
+        fmpz_mat_t L, U;
+        fmpz_t bound, t;
+
+        if (s == 1)
+        {
+            fmpz_poly_factor_insert(final_fac, f, exp);
+            break;
+        }
+
+        if (_fmpz_poly_factor_van_hoeij_check(final_fac, M, lifted_fac, 
+                                                             f, P, exp))
+            break;
+
+        /* Once all n traces have been used, start again with more precision */
+        if (j0 > n)
+        {
+            j0 = 1;
+            more = 1;
+        }
+
+        N = FLINT_MIN(n - j0 + 1, VAN_HOEIJ_TRACES);
+
+        need = _fmpz_poly_factor_clog_2exp(FLINT_BIT_COUNT(n) 
+                          + (j0 + N - 1) * rb + VAN_HOEIJ_MARGIN(r), p);
+        if (more && need <= a)
+            need = 2 * a;
+        more = 0;
+
+        if (need > a)
+        {
+            prev = _fmpz_poly_hensel_continue_lift(lifted_fac, 
+                                          link, v, w, f, prev, a, need, pp);
+            a = need;
+            fmpz_pow_ui(P, pp, a);
+        }
+
+        pk = _fmpz_vec_init(N);
+        for (k = 0; k < N; k++)
+        {
+            slong sj = _fmpz_poly_factor_clog_2exp(FLINT_BIT_COUNT(n) 
+                                                     + (j0 + k) * rb, p);
+            fmpz_pow_ui(pk + k, pp, sj);
+        }
+
+        fmpz_mat_init(U, r, N);
+        _fmpz_poly_factor_van_hoeij_traces(U, lifted_fac, lc, j0, N, pk, P);
+
+        /* The lattice (M | M U) over (0 | p^{a - s_j} I) */
+        fmpz_mat_init(L, s + N, r + N);
+        for (i = 0; i < s; i++)
+        {
+            for (k = 0; k < r; k++)
+                fmpz_set(fmpz_mat_entry(L, i, k), fmpz_mat_entry(M, i, k));
+
+            for (j = 0; j < N; j++)
+                for (k = 0; k < r; k++)
+                    fmpz_addmul(fmpz_mat_entry(L, i, r + j), 
+                        fmpz_mat_entry(M, i, k), fmpz_mat_entry(U, k, j));
+        }
+        for (j = 0; j < N; j++)
+            fmpz_divexact(fmpz_mat_entry(L, s + j, r + j), P, pk + j);
+
+        d = _fmpz_vec_init(s + N + 1);
+        fmpz_mat_lll(L, d, 99, 100);
+
+        /*
+            Each truncated trace of a true factor is at most 1 + r in 
+            absolute value, so beta^2 = r + N (r + 1)^2.
+         */
+        fmpz_init_set_ui(bound, r + 1);
+        fmpz_mul(bound, bound, bound);
+        fmpz_mul_ui(bound, bound, N);
+        fmpz_add_ui(bound, bound, r);
+
+        fmpz_init(t);
+        for (k = s + N; k > 0; k--)
+        {
+            fmpz_mul(t, bound, d + k - 1);
+            if (fmpz_cmp(d + k, t) <= 0)
+                break;
+        }
+        fmpz_clear(t);
+
+        if (k == 0)
+        {
+            printf("Exception (fmpz_poly_factor_van_hoeij). Lattice is empty.\n");
+            abort();
+        }
+
+        /* Keep the new basis only if it is still linearly independent */
+        {
+            fmpz_mat_t M2;
+
+            fmpz_mat_init(M2, k, r);
+            for (i = 0; i < k; i++)
+                for (j = 0; j < r; j++)
+                    fmpz_set(fmpz_mat_entry(M2, i, j), fmpz_mat_entry(L, i, j));
+
+            if (fmpz_mat_rank(M2) == k)
+            {
+                fmpz_mat_swap(M, M2);
+                j0 += N;
+            }
+            else
+                j0 = n + 1;
+
+            fmpz_mat_clear(M2);
+        }
+
+        _fmpz_vec_clear(pk, N);
+        _fmpz_vec_clear(d, s + N + 1);
+        fmpz_mat_clear(U);
+        fmpz_mat_clear(L);
+        fmpz_clear(bound);
+    }
+
+    for (i = 0; i < 2*r - 2; i++)
+    {
+        fmpz_poly_clear(v[i]);
+        fmpz_poly_clear(w[i]);
+    }
+    flint_free(link);
+    flint_free(v);
+    flint_free(w);
+
+    fmpz_poly_factor_clear(lifted_fac);
+    fmpz_mat_clear(M);
+    fmpz_clear(B);
+    fmpz_clear(P);
+    fmpz_clear(pp);
+}
+
+#undef VAN_HOEIJ_MARGIN
+#undef VAN_HOEIJ_TRACES
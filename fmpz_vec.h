@@ -218,6 +218,15 @@ void _fmpz_vec_scalar_mod_fmpz(fmpz *res, const fmpz *vec, slong len, const fmpz
 
 void _fmpz_vec_scalar_smod_fmpz(fmpz *res, const fmpz *vec, slong len, const fmpz_t p);
 
+/*  Primality and small factors  *********************************************/
+
+#define FLINT_PRIME_TRIAL_BPSW_VEC 64
+
+void _fmpz_vec_factor_trial(fmpz * res, const fmpz * vec, slong len,
+                                                         slong num_primes);
+
+void _fmpz_vec_is_probabprime_BPSW(int * res, const fmpz * vec, slong len);
+
 /*  Gaussian content  ********************************************************/
 
 void _fmpz_vec_content(fmpz_t res, const fmpz * vec, slong len);
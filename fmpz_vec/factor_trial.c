@@ -0,0 +1,127 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+
+void
+_fmpz_vec_factor_trial(fmpz * res, const fmpz * vec, slong len,
+                                                          slong num_primes)
+{
+    const mp_limb_t * primes;
+    fmpz ** tree;
+    slong * size;
+    fmpz * P;
+    fmpz_t t;
+    mp_limb_t hi, lo, c;
+    slong i, j, k, levels, n;
+    mp_bitcnt_t pbits;
+
+    if (len == 0)
+        return;
+
+    fmpz_init(t);
+
+    /* product of the primes, packed into limbs and then multiplied out */
+    primes = n_primes_arr_readonly(num_primes);
+    P = _fmpz_vec_init(num_primes + 1);
+
+    for (i = 0, n = 0; i < num_primes; n++)
+    {
+        c = primes[i++];
+        while (i < num_primes)
+        {
+            umul_ppmm(hi, lo, c, primes[i]);
+            if (hi != 0)
+                break;
+            c = lo;
+            i++;
+        }
+        fmpz_set_ui(P + n, c);
+    }
+
+    _fmpz_vec_prod(P + num_primes, P, n);
+
+    /*
+       Product tree of the absolute values, stopping once the nodes are
+       larger than the product of primes, which is then reduced modulo
+       each top node directly.
+    */
+    pbits = fmpz_bits(P + num_primes);
+
+    levels = 1;
+    for (n = len; n > 1; n = (n + 1) / 2)
+        levels++;
+
+    tree = flint_malloc(levels * sizeof(fmpz *));
+    size = flint_malloc(levels * sizeof(slong));
+
+    size[0] = len;
+    tree[0] = _fmpz_vec_init(len);
+    for (i = 0; i < len; i++)
+        fmpz_abs(tree[0] + i, vec + i);
+
+    for (k = 1; k < levels && fmpz_bits(tree[k - 1]) < pbits; k++)
+    {
+        size[k] = (size[k - 1] + 1) / 2;
+        tree[k] = _fmpz_vec_init(size[k]);
+
+        for (j = 0; j < size[k]; j++)
+        {
+            if (2 * j + 1 < size[k - 1])
+                fmpz_mul(tree[k] + j, tree[k - 1] + 2 * j,
+                                                    tree[k - 1] + 2 * j + 1);
+            else
+                fmpz_set(tree[k] + j, tree[k - 1] + 2 * j);
+        }
+    }
+
+    levels = k;
+
+    /* remainder tree, replacing each node by the product of primes modulo it */
+    for (j = 0; j < size[levels - 1]; j++)
+    {
+        fmpz_mod(t, P + num_primes, tree[levels - 1] + j);
+        fmpz_swap(t, tree[levels - 1] + j);
+    }
+
+    for (k = levels - 2; k >= 0; k--)
+    {
+        for (j = 0; j < size[k]; j++)
+        {
+            fmpz_mod(t, tree[k + 1] + j / 2, tree[k] + j);
+            fmpz_swap(t, tree[k] + j);
+        }
+    }
+
+    for (i = 0; i < len; i++)
+        fmpz_gcd(res + i, tree[0] + i, vec + i);
+
+    for (k = 0; k < levels; k++)
+        _fmpz_vec_clear(tree[k], size[k]);
+
+    flint_free(tree);
+    flint_free(size);
+    _fmpz_vec_clear(P, num_primes + 1);
+    fmpz_clear(t);
+}
@@ -0,0 +1,106 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "mpn_extras.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+#include "thread_pool.h"
+
+typedef struct
+{
+    int * res;
+    const fmpz * vec;
+    slong len;
+    slong start;
+    slong step;
+}
+_BPSW_arg_struct;
+
+static void
+_fmpz_vec_is_probabprime_BPSW_worker(void * varg)
+{
+    _BPSW_arg_struct * arg = (_BPSW_arg_struct *) varg;
+    const fmpz * x;
+    __mpz_struct * z;
+    slong i;
+
+    for (i = arg->start; i < arg->len; i += arg->step)
+    {
+        x = arg->vec + i;
+
+        if (fmpz_sgn(x) <= 0)
+            arg->res[i] = 0;
+        else if (!COEFF_IS_MPZ(*x))
+            arg->res[i] = n_is_probabprime_BPSW(*x);
+        else
+        {
+            z = COEFF_TO_PTR(*x);
+
+            if ((z->_mp_d[0] & 1UL) == 0
+                   || flint_mpn_factor_trial(z->_mp_d, z->_mp_size, 1,
+                                               FLINT_PRIME_TRIAL_BPSW_VEC))
+                arg->res[i] = 0;
+            else
+                arg->res[i] = fmpz_is_probabprime_BPSW(x);
+        }
+    }
+}
+
+void
+_fmpz_vec_is_probabprime_BPSW(int * res, const fmpz * vec, slong len)
+{
+    thread_pool_handle * threads;
+    _BPSW_arg_struct * args;
+    slong i, num_workers;
+
+    /* make sure the shared table exists before the threads read it */
+    n_compute_primes(FLINT_PRIME_TRIAL_BPSW_VEC);
+
+    num_workers = flint_request_threads(&threads,
+                                   FLINT_MIN(flint_get_num_threads(), len));
+
+    args = flint_malloc(sizeof(_BPSW_arg_struct) * (num_workers + 1));
+
+    /* interleave the candidates, so that expensive ones are spread out */
+    for (i = 0; i <= num_workers; i++)
+    {
+        args[i].res = res;
+        args[i].vec = vec;
+        args[i].len = len;
+        args[i].start = i;
+        args[i].step = num_workers + 1;
+    }
+
+    for (i = 0; i < num_workers; i++)
+        thread_pool_wake(global_thread_pool, threads[i],
+                               _fmpz_vec_is_probabprime_BPSW_worker, args + i + 1);
+
+    _fmpz_vec_is_probabprime_BPSW_worker(args);
+
+    for (i = 0; i < num_workers; i++)
+        thread_pool_wait(global_thread_pool, threads[i]);
+
+    flint_give_back_threads(threads, num_workers);
+
+    flint_free(args);
+}
@@ -42,7 +42,7 @@ void _fmpz_vec_set_fft(fmpz * coeffs_m, slong length,
    {   
 		for (i = 0; i < length; i++)
       {
-         mpz_ptr = _fmpz_promote(coeffs_m);
+         mpz_ptr = _fmpz_promote_limbs(coeffs_m, limbs);
          if (mpz_ptr->_mp_alloc < limbs) _mpz_realloc(mpz_ptr, limbs);
 			data = mpz_ptr->_mp_d;
 			
@@ -69,7 +69,7 @@ void _fmpz_vec_set_fft(fmpz * coeffs_m, slong length,
    {
 		for (i = 0; i < length; i++)
       {
-         mpz_ptr = _fmpz_promote(coeffs_m);
+         mpz_ptr = _fmpz_promote_limbs(coeffs_m, limbs);
          if (mpz_ptr->_mp_alloc < limbs) _mpz_realloc(mpz_ptr, limbs);
 			data = mpz_ptr->_mp_d;
 			flint_mpn_copyi(data, coeffs_f[i], limbs); 
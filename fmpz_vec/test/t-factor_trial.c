@@ -0,0 +1,90 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+#include "ulong_extras.h"
+
+int
+main(void)
+{
+    int i, result;
+    flint_rand_t state;
+
+    printf("factor_trial....");
+    fflush(stdout);
+
+    flint_randinit(state);
+
+    for (i = 0; i < 200 * flint_test_multiplier(); i++)
+    {
+        fmpz *a, *g;
+        fmpz_t h;
+        const mp_limb_t * primes;
+        slong j, k, len, num_primes;
+
+        len = n_randint(state, 100);
+        num_primes = n_randint(state, 2000) + 1;
+
+        a = _fmpz_vec_init(len);
+        g = _fmpz_vec_init(len);
+        fmpz_init(h);
+
+        for (j = 0; j < len; j++)
+        {
+            fmpz_randtest_not_zero(a + j, state, n_randint(state, 300) + 1);
+        }
+
+        primes = n_primes_arr_readonly(num_primes);
+
+        _fmpz_vec_factor_trial(g, a, len, num_primes);
+
+        for (j = 0; j < len; j++)
+        {
+            fmpz_one(h);
+            for (k = 0; k < num_primes; k++)
+                if (fmpz_fdiv_ui(a + j, primes[k]) == 0)
+                    fmpz_mul_ui(h, h, primes[k]);
+
+            result = fmpz_equal(g + j, h);
+            if (!result)
+            {
+                printf("FAIL:\n");
+                fmpz_print(a + j); printf("\n");
+                fmpz_print(g + j); printf("\n");
+                fmpz_print(h); printf("\n");
+                abort();
+            }
+        }
+
+        _fmpz_vec_clear(a, len);
+        _fmpz_vec_clear(g, len);
+        fmpz_clear(h);
+    }
+
+    flint_randclear(state);
+    flint_cleanup();
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,90 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+#include "ulong_extras.h"
+
+int
+main(void)
+{
+    int i, result;
+    flint_rand_t state;
+
+    printf("is_probabprime_BPSW....");
+    fflush(stdout);
+
+    flint_randinit(state);
+
+    for (i = 0; i < 100 * flint_test_multiplier(); i++)
+    {
+        fmpz * a;
+        int * r;
+        slong j, len;
+        mpz_t t;
+
+        flint_set_num_threads(1 + n_randint(state, 4));
+
+        len = n_randint(state, 200);
+
+        a = _fmpz_vec_init(len);
+        r = flint_malloc(len * sizeof(int));
+        mpz_init(t);
+
+        for (j = 0; j < len; j++)
+        {
+            fmpz_randtest(a + j, state, n_randint(state, 500) + 1);
+
+            if (n_randint(state, 2) && fmpz_sgn(a + j) > 0)
+            {
+                fmpz_get_mpz(t, a + j);
+                mpz_nextprime(t, t);
+                fmpz_set_mpz(a + j, t);
+            }
+        }
+
+        _fmpz_vec_is_probabprime_BPSW(r, a, len);
+
+        for (j = 0; j < len; j++)
+        {
+            result = (r[j] == fmpz_is_probabprime_BPSW(a + j));
+            if (!result)
+            {
+                printf("FAIL:\n");
+                fmpz_print(a + j); printf("\n");
+                printf("r = %d\n", r[j]);
+                abort();
+            }
+        }
+
+        _fmpz_vec_clear(a, len);
+        flint_free(r);
+        mpz_clear(t);
+    }
+
+    flint_randclear(state);
+    flint_cleanup();
+    printf("PASS\n");
+    return 0;
+}
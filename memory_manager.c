@@ -33,41 +33,220 @@ static void flint_memory_error()
     abort();
 }
 
+/* allocator hooks, process wide */
+
+static void * (* __flint_allocate_func)(size_t) = malloc;
+static void * (* __flint_callocate_func)(size_t, size_t) = calloc;
+static void * (* __flint_reallocate_func)(void *, size_t) = realloc;
+static void (* __flint_free_func)(void *) = free;
+
+void __flint_set_memory_functions(void * (* alloc_func)(size_t),
+     void * (* calloc_func)(size_t, size_t), 
+     void * (* realloc_func)(void *, size_t), void (* free_func)(void *))
+{
+    __flint_allocate_func = alloc_func;
+    __flint_callocate_func = calloc_func;
+    __flint_reallocate_func = realloc_func;
+    __flint_free_func = free_func;
+}
+
+void __flint_get_memory_functions(void * (** alloc_func)(size_t),
+     void * (** calloc_func)(size_t, size_t), 
+     void * (** realloc_func)(void *, size_t), void (** free_func)(void *))
+{
+    *alloc_func = __flint_allocate_func;
+    *calloc_func = __flint_callocate_func;
+    *realloc_func = __flint_reallocate_func;
+    *free_func = __flint_free_func;
+}
+
+/* statistics, per thread */
+
+static FLINT_TLS_PREFIX flint_memory_stats_struct flint_memory_stats;
+
+void flint_get_memory_stats(flint_memory_stats_t stats)
+{
+    *stats = flint_memory_stats;
+}
+
+void flint_reset_memory_stats(void)
+{
+    flint_memory_stats.num_allocs = 0;
+    flint_memory_stats.num_reallocs = 0;
+    flint_memory_stats.num_frees = 0;
+    flint_memory_stats.bytes_allocated = 0;
+    flint_memory_stats.num_stack_allocs = 0;
+    flint_memory_stats.stack_bytes = 0;
+    flint_memory_stats.stack_peak = 0;
+}
+
 void * flint_malloc(size_t size)
 {
-    void * ptr = malloc(size);
+    void * ptr = __flint_allocate_func(size);
 
     if (ptr == NULL)
         flint_memory_error();
 
+    flint_memory_stats.num_allocs++;
+    flint_memory_stats.bytes_allocated += size;
+
     return ptr;
 }
 
 void * flint_realloc(void * ptr, size_t size)
 {
-    void * ptr2 = realloc(ptr, size);
+    void * ptr2;
+
+    if (ptr == NULL)
+        return flint_malloc(size);
+
+    ptr2 = __flint_reallocate_func(ptr, size);
 
     if (ptr2 == NULL)
         flint_memory_error();
 
+    flint_memory_stats.num_reallocs++;
+    flint_memory_stats.bytes_allocated += size;
+
     return ptr2;
 }
 
 void * flint_calloc(size_t num, size_t size)
 {
-    void * ptr = calloc(num, size);
+    void * ptr = __flint_callocate_func(num, size);
 
     if (ptr == NULL)
         flint_memory_error();
 
+    flint_memory_stats.num_allocs++;
+    flint_memory_stats.bytes_allocated += num*size;
+
     return ptr;
 }
 
 void flint_free(void * ptr)
 {
-    free(ptr);
+    if (ptr == NULL)
+        return;
+
+    flint_memory_stats.num_frees++;
+
+    __flint_free_func(ptr);
+}
+
+/* 
+   Stack allocator for temporaries, per thread. Memory is taken from a
+   chain of blocks obtained with flint_malloc. When the stack is released
+   the largest block above the mark is kept as a spare, so that in a loop
+   of calls allocating the same temporaries no block is allocated after
+   the first iteration. Blocks above FLINT_STACK_MAX_SPARE bytes are freed
+   straight away, so that a single large temporary is not held by every
+   thread, in particular by the workers of the thread pool, until
+   flint_cleanup.
+*/
+
+typedef struct flint_stack_block_struct
+{
+    struct flint_stack_block_struct * prev;
+    size_t size;
+    size_t used;
+} flint_stack_block_struct;
+
+#define FLINT_STACK_ALIGN 16
+
+#define FLINT_STACK_ROUND(n) \
+    (((n) + FLINT_STACK_ALIGN - 1) & ~((size_t) FLINT_STACK_ALIGN - 1))
+
+#define FLINT_STACK_HEADER FLINT_STACK_ROUND(sizeof(flint_stack_block_struct))
+
+#define FLINT_STACK_MIN_BLOCK 65536
+
+#define FLINT_STACK_MAX_SPARE (16*FLINT_STACK_MIN_BLOCK)
+
+static FLINT_TLS_PREFIX flint_stack_block_struct * flint_stack_top = NULL;
+static FLINT_TLS_PREFIX flint_stack_block_struct * flint_stack_spare = NULL;
+static FLINT_TLS_PREFIX size_t flint_stack_in_use = 0;
+
+flint_stack_mark_t flint_stack_get_mark(void)
+{
+    flint_stack_mark_t mark;
+
+    mark.block = flint_stack_top;
+    mark.used = (flint_stack_top == NULL) ? 0 : flint_stack_top->used;
+    mark.in_use = flint_stack_in_use;
+
+    return mark;
+}
+
+void * flint_stack_alloc(size_t size)
+{
+    flint_stack_block_struct * b = flint_stack_top;
+    void * ptr;
+
+    size = FLINT_STACK_ROUND(size);
+
+    if (b == NULL || b->used + size > b->size)
+    {
+        if (flint_stack_spare != NULL && flint_stack_spare->size >= size)
+        {
+            b = flint_stack_spare;
+            flint_stack_spare = NULL;
+        } else
+        {
+            size_t bsize = FLINT_MAX(size, FLINT_STACK_MIN_BLOCK);
+
+            if (b != NULL)
+                bsize = FLINT_MAX(bsize, 2*b->size);
+
+            b = flint_malloc(FLINT_STACK_HEADER + bsize);
+            b->size = bsize;
+        }
+
+        b->prev = flint_stack_top;
+        b->used = 0;
+        flint_stack_top = b;
+    }
+
+    ptr = (char *) b + FLINT_STACK_HEADER + b->used;
+    b->used += size;
+
+    flint_stack_in_use += size;
+    flint_memory_stats.num_stack_allocs++;
+    flint_memory_stats.stack_bytes += size;
+    if (flint_stack_in_use > flint_memory_stats.stack_peak)
+        flint_memory_stats.stack_peak = flint_stack_in_use;
+
+    return ptr;
 }
 
+void flint_stack_release(flint_stack_mark_t mark)
+{
+    while (flint_stack_top != mark.block)
+    {
+        flint_stack_block_struct * b = flint_stack_top;
+
+        flint_stack_top = b->prev;
+
+        if (b->size <= FLINT_STACK_MAX_SPARE && (flint_stack_spare == NULL 
+                                    || flint_stack_spare->size < b->size))
+        {
+            flint_free(flint_stack_spare);
+            flint_stack_spare = b;
+        } else
+            flint_free(b);
+    }
+
+    if (flint_stack_top != NULL)
+        flint_stack_top->used = mark.used;
+
+    flint_stack_in_use = mark.in_use;
+}
+
+static void _flint_stack_cleanup(void)
+{
+    flint_free(flint_stack_spare);
+    flint_stack_spare = NULL;
+}
 
 FLINT_TLS_PREFIX size_t flint_num_cleanup_functions = 0;
 
@@ -98,6 +277,7 @@ void flint_cleanup()
 
     mpfr_free_cache();
     _fmpz_cleanup();
+    _flint_stack_cleanup();
 }
 
 
@@ -208,6 +208,45 @@ void flint_mpn_mulmod_preinvn(mp_ptr r,
         mp_srcptr a, mp_srcptr b, mp_size_t n, 
         mp_srcptr d, mp_srcptr dinv, ulong norm);
 
+/*
+   Montgomery arithmetic modulo an odd m of n limbs, with R = 2^(FLINT_BITS n).
+   Residues are kept as a R mod m, in n limbs, fully reduced.
+*/
+
+static __inline__
+mp_limb_t flint_mpn_mont_minv(mp_limb_t m0)
+{
+    mp_limb_t inv = m0; /* correct to 3 bits, as m0 is odd */
+    int i;
+
+    for (i = 3; i < FLINT_BITS; i *= 2)
+        inv *= 2 - m0 * inv;
+
+    return -inv;
+}
+
+void flint_mpn_mont_redc(mp_ptr r, mp_ptr t, 
+                          mp_srcptr m, mp_size_t n, mp_limb_t minv);
+
+static __inline__
+void flint_mpn_mont_mul(mp_ptr r, mp_srcptr a, mp_srcptr b, mp_ptr t,
+                          mp_srcptr m, mp_size_t n, mp_limb_t minv)
+{
+    mpn_mul_n(t, a, b, n);
+    flint_mpn_mont_redc(r, t, m, n, minv);
+}
+
+static __inline__
+void flint_mpn_mont_sqr(mp_ptr r, mp_srcptr a, mp_ptr t,
+                          mp_srcptr m, mp_size_t n, mp_limb_t minv)
+{
+    mpn_sqr(t, a, n);
+    flint_mpn_mont_redc(r, t, m, n, minv);
+}
+
+void flint_mpn_mont_powm(mp_ptr r, mp_srcptr a, mp_srcptr e, mp_size_t en,
+            mp_srcptr one, mp_srcptr m, mp_size_t n, mp_limb_t minv);
+
 int flint_mpn_mulmod_2expp1_basecase(mp_ptr xp, mp_srcptr yp, mp_srcptr zp, int c,
     mp_bitcnt_t b, mp_ptr tp);
 
@@ -0,0 +1,100 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "mpn_extras.h"
+
+#define BIT(e, i) (((e)[(i) / FLINT_BITS] >> ((i) % FLINT_BITS)) & 1)
+
+void flint_mpn_mont_powm(mp_ptr r, mp_srcptr a, mp_srcptr e, mp_size_t en,
+            mp_srcptr one, mp_srcptr m, mp_size_t n, mp_limb_t minv)
+{
+    mp_ptr tab, t;
+    slong i, j, k, l, w, bits;
+    int started;
+    TMP_INIT;
+
+    while (en > 0 && e[en - 1] == 0)
+        en--;
+
+    if (en == 0)
+    {
+        flint_mpn_copyi(r, one, n);
+        return;
+    }
+
+    bits = (en - 1) * FLINT_BITS + FLINT_BIT_COUNT(e[en - 1]);
+
+    if (bits < 8)        k = 1;
+    else if (bits < 25)  k = 2;
+    else if (bits < 81)  k = 3;
+    else if (bits < 241) k = 4;
+    else if (bits < 673) k = 5;
+    else                 k = 6;
+
+    TMP_START;
+    tab = TMP_ALLOC((1L << (k - 1)) * n * sizeof(mp_limb_t));
+    t = TMP_ALLOC(2 * n * sizeof(mp_limb_t));
+
+    /* tab holds a, a^3, a^5, ..., a^(2^k - 1) */
+    flint_mpn_copyi(tab, a, n);
+    if (k > 1)
+    {
+        flint_mpn_mont_sqr(r, a, t, m, n, minv);
+        for (i = 1; i < (1L << (k - 1)); i++)
+            flint_mpn_mont_mul(tab + i * n, tab + (i - 1) * n, r, t, m, n, minv);
+    }
+
+    /* left to right sliding windows */
+    started = 0;
+    for (i = bits - 1; i >= 0; )
+    {
+        if (!BIT(e, i))
+        {
+            flint_mpn_mont_sqr(r, r, t, m, n, minv);
+            i--;
+            continue;
+        }
+
+        j = FLINT_MAX(i - k + 1, 0);
+        while (!BIT(e, j))
+            j++;
+
+        for (w = 0, l = i; l >= j; l--)
+            w = 2 * w + BIT(e, l);
+
+        if (started)
+        {
+            for (l = i; l >= j; l--)
+                flint_mpn_mont_sqr(r, r, t, m, n, minv);
+            flint_mpn_mont_mul(r, r, tab + (w / 2) * n, t, m, n, minv);
+        }
+        else
+        {
+            flint_mpn_copyi(r, tab + (w / 2) * n, n);
+            started = 1;
+        }
+
+        i = j - 1;
+    }
+
+    TMP_END;
+}
@@ -0,0 +1,42 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "mpn_extras.h"
+
+void flint_mpn_mont_redc(mp_ptr r, mp_ptr t, 
+                          mp_srcptr m, mp_size_t n, mp_limb_t minv)
+{
+    mp_limb_t q, cy;
+    mp_size_t i;
+
+    /* clear one limb at a time, parking the carries in the cleared limbs */
+    for (i = 0; i < n; i++)
+    {
+        q = t[i] * minv;
+        t[i] = mpn_addmul_1(t + i, m, n, q);
+    }
+
+    cy = mpn_add_n(r, t + n, t, n);
+
+    if (cy || mpn_cmp(r, m, n) >= 0)
+        mpn_sub_n(r, r, m, n);
+}
@@ -0,0 +1,115 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "mpn_extras.h"
+#include "ulong_extras.h"
+
+int main(void)
+{
+    int i, result;
+    mpz_t a, b, m, r1, r2;
+    gmp_randstate_t st;
+    flint_rand_t state;
+    mp_ptr ap, bp, rp, t;
+    mp_limb_t minv;
+    mp_size_t size;
+
+    printf("mont_mul....");
+    fflush(stdout);
+
+    mpz_init(a);
+    mpz_init(b);
+    mpz_init(m);
+    mpz_init(r1);
+    mpz_init(r2);
+
+    gmp_randinit_default(st);
+    flint_randinit(state);
+
+    for (i = 0; i < 10000; i++)
+    {
+       size = n_randint(state, 40) + 1;
+
+       do {
+          mpz_rrandomb(m, st, size*FLINT_BITS);
+          mpz_setbit(m, 0);
+       } while (mpz_size(m) != size);
+
+       mpz_urandomm(a, st, m);
+       mpz_urandomm(b, st, m);
+
+       ap = flint_calloc(size, sizeof(mp_limb_t));
+       bp = flint_calloc(size, sizeof(mp_limb_t));
+       rp = flint_malloc(size*sizeof(mp_limb_t));
+       t = flint_malloc(2*size*sizeof(mp_limb_t));
+
+       flint_mpn_copyi(ap, a->_mp_d, a->_mp_size);
+       flint_mpn_copyi(bp, b->_mp_d, b->_mp_size);
+       minv = flint_mpn_mont_minv(m->_mp_d[0]);
+
+       if (n_randint(state, 2))
+       {
+          flint_mpn_mont_mul(rp, ap, bp, t, m->_mp_d, size, minv);
+          mpz_mul(r1, a, b);
+       } else
+       {
+          flint_mpn_mont_sqr(rp, ap, t, m->_mp_d, size, minv);
+          mpz_mul(r1, a, a);
+       }
+
+       /* check r R = a b mod m, and r < m */
+       mpz_set_ui(r2, 0);
+       mpz_import(r2, size, -1, sizeof(mp_limb_t), 0, 0, rp);
+       result = (mpz_cmp(r2, m) < 0);
+       mpz_mul_2exp(r2, r2, size*FLINT_BITS);
+       mpz_sub(r2, r2, r1);
+       result = result && mpz_divisible_p(r2, m);
+       if (!result)
+       {
+          printf("FAIL:\n");
+          gmp_printf("%Zd\n", a);
+          gmp_printf("%Zd\n", b);
+          gmp_printf("%Zd\n", m);
+          printf("size = %ld\n", size);
+          abort();
+       }
+
+       flint_free(ap);
+       flint_free(bp);
+       flint_free(rp);
+       flint_free(t);
+    }
+
+    mpz_clear(a);
+    mpz_clear(b);
+    mpz_clear(m);
+    mpz_clear(r1);
+    mpz_clear(r2);
+
+    gmp_randclear(st);
+    flint_randclear(state);
+
+    printf("PASS\n");
+    return 0;
+}
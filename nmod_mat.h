@@ -191,6 +191,17 @@ slong nmod_mat_nullspace(nmod_mat_t X, const nmod_mat_t A);
 /* Strassen multiplication */
 #define NMOD_MAT_MUL_STRASSEN_CUTOFF 256
 
+/* Blocking of the tiled classical multiplication kernels */
+#define NMOD_MAT_MUL_BLOCK_M 64
+#define NMOD_MAT_MUL_BLOCK_K 256
+
+/* Moduli below 2^NMOD_MAT_MUL_DOUBLE_BITS use floating point arithmetic */
+#define NMOD_MAT_MUL_DOUBLE_BITS 26
+
+/* Minimum rows and multiplications per thread in classical multiplication */
+#define NMOD_MAT_MUL_CLASSICAL_THREAD_ROWS 8
+#define NMOD_MAT_MUL_CLASSICAL_THREAD_WORK 200000
+
 /* Cutoff between classical and recursive triangular solving */
 #define NMOD_MAT_SOLVE_TRI_ROWS_CUTOFF 64
 #define NMOD_MAT_SOLVE_TRI_COLS_CUTOFF 64
@@ -28,6 +28,7 @@
 #include "flint.h"
 #include "nmod_mat.h"
 #include "nmod_vec.h"
+#include "thread_pool.h"
 
 /*
 with op = 0, computes D = A*B
@@ -36,8 +37,8 @@ with op = -1, computes D = C - A*B
 */
 
 static __inline__ void
-_nmod_mat_addmul_basic(mp_ptr * D, mp_ptr * const C, mp_ptr * const A,
-    mp_ptr * const B, slong m, slong k, slong n, int op, nmod_t mod, int nlimbs)
+_nmod_mat_addmul_basic(mp_ptr * D, const mp_ptr * C, const mp_ptr * A,
+    const mp_ptr * B, slong m, slong k, slong n, int op, nmod_t mod, int nlimbs)
 {
     slong i, j;
     mp_limb_t c;
@@ -58,25 +59,19 @@ _nmod_mat_addmul_basic(mp_ptr * D, mp_ptr * const C, mp_ptr * const A,
     }
 }
 
+/* Bt is the transpose of B */
 static __inline__ void
-_nmod_mat_addmul_transpose(mp_ptr * D, const mp_ptr * C, const mp_ptr * A,
-    const mp_ptr * B, slong m, slong k, slong n, int op, nmod_t mod, int nlimbs)
+_nmod_mat_addmul_transpose_op(mp_ptr * D, const mp_ptr * C, const mp_ptr * A,
+    mp_srcptr Bt, slong m, slong k, slong n, int op, nmod_t mod, int nlimbs)
 {
-    mp_ptr tmp;
     mp_limb_t c;
     slong i, j;
 
-    tmp = flint_malloc(sizeof(mp_limb_t) * k * n);
-
-    for (i = 0; i < k; i++)
-        for (j = 0; j < n; j++)
-            tmp[j*k + i] = B[i][j];
-
     for (i = 0; i < m; i++)
     {
         for (j = 0; j < n; j++)
         {
-            c = _nmod_vec_dot(A[i], tmp + j*k, k, mod, nlimbs);
+            c = _nmod_vec_dot(A[i], Bt + j*k, k, mod, nlimbs);
 
             if (op == 1)
                 c = nmod_add(C[i][j], c, mod);
@@ -86,26 +81,34 @@ _nmod_mat_addmul_transpose(mp_ptr * D, const mp_ptr * C, const mp_ptr * A,
             D[i][j] = c;
         }
     }
+}
+
+static mp_ptr
+_nmod_mat_transpose_rows(const mp_ptr * B, slong k, slong n)
+{
+    mp_ptr tmp;
+    slong i, j;
 
-    flint_free(tmp);
+    tmp = _nmod_vec_init(k * n);
+
+    for (i = 0; i < k; i++)
+        for (j = 0; j < n; j++)
+            tmp[j*k + i] = B[i][j];
+
+    return tmp;
 }
 
-/* requires nlimbs = 1 */
-void
-_nmod_mat_addmul_packed(mp_ptr * D, const mp_ptr * C, const mp_ptr * A,
-    const mp_ptr * B, slong M, slong N, slong K, int op, nmod_t mod, int nlimbs)
+/* requires nlimbs = 1; Bpack is B packed by _nmod_mat_pack_bits */
+static void
+_nmod_mat_addmul_packed_op(mp_ptr * D, const mp_ptr * C, const mp_ptr * A,
+    mp_srcptr Bpack, slong M, slong N, slong K, int op, nmod_t mod,
+    int pack, int pack_bits)
 {
     slong i, j, k;
     slong Kpack;
-    int pack, pack_bits;
     mp_limb_t c, d, mask;
-    mp_ptr tmp;
-    mp_ptr Aptr, Tptr;
+    mp_srcptr Aptr, Tptr;
 
-    /* bound unreduced entry */
-    c = N * (mod.n-1) * (mod.n-1);
-    pack_bits = FLINT_BIT_COUNT(c);
-    pack = FLINT_BITS / pack_bits;
     Kpack = (K + pack - 1) / pack;
 
     if (pack_bits == FLINT_BITS)
@@ -113,29 +116,13 @@ _nmod_mat_addmul_packed(mp_ptr * D, const mp_ptr * C, const mp_ptr * A,
     else
         mask = (1UL << pack_bits) - 1;
 
-    tmp = _nmod_vec_init(Kpack * N);
-
-    /* pack and transpose B */
-    for (i = 0; i < Kpack; i++)
-    {
-        for (k = 0; k < N; k++)
-        {
-            c = B[k][i * pack];
-
-            for (j = 1; j < pack && i * pack + j < K; j++)
-                c |= B[k][i * pack + j] << (pack_bits * j);
-
-            tmp[i * N + k] = c;
-        }
-    }
-
     /* multiply */
     for (i = 0; i < M; i++)
     {
         for (j = 0; j < Kpack; j++)
         {
             Aptr = A[i];
-            Tptr = tmp + j * N;
+            Tptr = Bpack + j * N;
 
             c = 0;
 
@@ -166,26 +153,485 @@ _nmod_mat_addmul_packed(mp_ptr * D, const mp_ptr * C, const mp_ptr * A,
             }
         }
     }
+}
+
+/* packs and transposes the N x K matrix B, pack entries per limb */
+static mp_ptr
+_nmod_mat_pack_bits(const mp_ptr * B, slong N, slong K, int pack, int pack_bits)
+{
+    slong i, j, k, Kpack;
+    mp_limb_t c;
+    mp_ptr tmp;
+
+    Kpack = (K + pack - 1) / pack;
+    tmp = _nmod_vec_init(Kpack * N);
+
+    for (i = 0; i < Kpack; i++)
+    {
+        for (k = 0; k < N; k++)
+        {
+            c = B[k][i * pack];
+
+            for (j = 1; j < pack && i * pack + j < K; j++)
+                c |= B[k][i * pack + j] << (pack_bits * j);
+
+            tmp[i * N + k] = c;
+        }
+    }
+
+    return tmp;
+}
+
+/* requires nlimbs = 1 */
+void
+_nmod_mat_addmul_packed(mp_ptr * D, const mp_ptr * C, const mp_ptr * A,
+    const mp_ptr * B, slong M, slong N, slong K, int op, nmod_t mod, int nlimbs)
+{
+    int pack, pack_bits;
+    mp_limb_t c;
+    mp_ptr tmp;
 
+    /* bound unreduced entry */
+    c = N * (mod.n-1) * (mod.n-1);
+    pack_bits = FLINT_BIT_COUNT(c);
+    pack = FLINT_BITS / pack_bits;
+
+    tmp = _nmod_mat_pack_bits(B, N, K, pack, pack_bits);
+    _nmod_mat_addmul_packed_op(D, C, A, tmp, M, N, K, op, mod,
+                                                         pack, pack_bits);
     _nmod_vec_clear(tmp);
 }
 
+/*
+    The tiled kernels below work on a copy of B cut into panels of four
+    columns, stored so that the four entries of a panel row are adjacent:
+    entry (i, 4p + j) of B goes to Bp[(p k + i) 4 + j]. Missing columns
+    of the last panel are zero.
+*/
+static mp_ptr
+_nmod_mat_pack_panels(const mp_ptr * B, slong k, slong n)
+{
+    slong i, j, p, np;
+    mp_ptr Bp;
+
+    np = (n + 3) / 4;
+    Bp = _nmod_vec_init(np * k * 4);
+
+    for (p = 0; p < np; p++)
+        for (i = 0; i < k; i++)
+            for (j = 0; j < 4; j++)
+                Bp[(p * k + i) * 4 + j] = (4 * p + j < n) ? B[i][4 * p + j] : 0;
 
+    return Bp;
+}
+
+static double *
+_nmod_mat_pack_panels_d(const mp_ptr * B, slong k, slong n)
+{
+    slong i, j, p, np;
+    double * Bp;
+
+    np = (n + 3) / 4;
+    Bp = flint_malloc(sizeof(double) * np * k * 4);
+
+    for (p = 0; p < np; p++)
+        for (i = 0; i < k; i++)
+            for (j = 0; j < 4; j++)
+                Bp[(p * k + i) * 4 + j] =
+                                (4 * p + j < n) ? (double) B[i][4 * p + j] : 0;
+
+    return Bp;
+}
+
+static __inline__ void
+_nmod_mat_store_entry(mp_ptr * D, const mp_ptr * C, slong i, slong j,
+                                        mp_limb_t d, int op, nmod_t mod)
+{
+    if (op == 1)
+        d = nmod_add(C[i][j], d, mod);
+    else if (op == -1)
+        d = nmod_sub(C[i][j], d, mod);
+
+    D[i][j] = d;
+}
+
+/*
+    Requires nlimbs = 1, so that entire dot products can be accumulated
+    in a single limb. The product is computed in blocks of
+    NMOD_MAT_MUL_BLOCK_M rows by NMOD_MAT_MUL_BLOCK_K inner indices, with
+    a 2 by 4 register tile, and the unreduced sums are kept in a
+    temporary matrix. Each entry is reduced once at the end.
+*/
+static void
+_nmod_mat_addmul_tiled1(mp_ptr * D, const mp_ptr * C, const mp_ptr * A,
+    mp_srcptr Bp, slong m, slong k, slong n, int op, nmod_t mod)
+{
+    slong i, j, p, np, ld, kb, kc, ib, ie, kk;
+    mp_ptr T;
+
+    np = (n + 3) / 4;
+    ld = np * 4;
+
+    T = _nmod_vec_init(m * ld);
+    _nmod_vec_zero(T, m * ld);
+
+    for (kb = 0; kb < k; kb += NMOD_MAT_MUL_BLOCK_K)
+    {
+        kc = FLINT_MIN(NMOD_MAT_MUL_BLOCK_K, k - kb);
+
+        for (ib = 0; ib < m; ib += NMOD_MAT_MUL_BLOCK_M)
+        {
+            ie = FLINT_MIN(ib + NMOD_MAT_MUL_BLOCK_M, m);
+
+            for (p = 0; p < np; p++)
+            {
+                mp_srcptr b = Bp + (p * k + kb) * 4;
+
+                for (i = ib; i + 2 <= ie; i += 2)
+                {
+                    mp_srcptr a0 = A[i] + kb, a1 = A[i + 1] + kb;
+                    mp_ptr t0 = T + i * ld + p * 4, t1 = t0 + ld;
+                    mp_limb_t c00 = t0[0], c01 = t0[1], c02 = t0[2], c03 = t0[3];
+                    mp_limb_t c10 = t1[0], c11 = t1[1], c12 = t1[2], c13 = t1[3];
+
+                    for (kk = 0; kk < kc; kk++)
+                    {
+                        mp_limb_t x0 = a0[kk], x1 = a1[kk];
+                        mp_srcptr bb = b + kk * 4;
+
+                        c00 += x0 * bb[0]; c01 += x0 * bb[1];
+                        c02 += x0 * bb[2]; c03 += x0 * bb[3];
+                        c10 += x1 * bb[0]; c11 += x1 * bb[1];
+                        c12 += x1 * bb[2]; c13 += x1 * bb[3];
+                    }
+
+                    t0[0] = c00; t0[1] = c01; t0[2] = c02; t0[3] = c03;
+                    t1[0] = c10; t1[1] = c11; t1[2] = c12; t1[3] = c13;
+                }
+
+                if (i < ie)
+                {
+                    mp_srcptr a0 = A[i] + kb;
+                    mp_ptr t0 = T + i * ld + p * 4;
+                    mp_limb_t c00 = t0[0], c01 = t0[1], c02 = t0[2], c03 = t0[3];
+
+                    for (kk = 0; kk < kc; kk++)
+                    {
+                        mp_limb_t x0 = a0[kk];
+                        mp_srcptr bb = b + kk * 4;
+
+                        c00 += x0 * bb[0]; c01 += x0 * bb[1];
+                        c02 += x0 * bb[2]; c03 += x0 * bb[3];
+                    }
+
+                    t0[0] = c00; t0[1] = c01; t0[2] = c02; t0[3] = c03;
+                }
+            }
+        }
+    }
+
+    for (i = 0; i < m; i++)
+    {
+        for (j = 0; j < n; j++)
+        {
+            mp_limb_t d;
+            NMOD_RED(d, T[i * ld + j], mod);
+            _nmod_mat_store_entry(D, C, i, j, d, op, mod);
+        }
+    }
+
+    _nmod_vec_clear(T);
+}
+
+/*
+    Requires nlimbs <= 2. As _nmod_mat_addmul_tiled1, but with double limb
+    accumulators and a 1 by 4 register tile. Each entry is reduced once
+    at the end with NMOD2_RED2.
+*/
+static void
+_nmod_mat_addmul_tiled2(mp_ptr * D, const mp_ptr * C, const mp_ptr * A,
+    mp_srcptr Bp, slong m, slong k, slong n, int op, nmod_t mod)
+{
+    slong i, j, p, np, ld, kb, kc, ib, ie, kk;
+    int half = (mod.n <= (1UL << (FLINT_BITS / 2)));
+    mp_ptr T;
+
+    np = (n + 3) / 4;
+    ld = np * 8;
+
+    T = _nmod_vec_init(m * ld);
+    _nmod_vec_zero(T, m * ld);
+
+    for (kb = 0; kb < k; kb += NMOD_MAT_MUL_BLOCK_K)
+    {
+        kc = FLINT_MIN(NMOD_MAT_MUL_BLOCK_K, k - kb);
+
+        for (ib = 0; ib < m; ib += NMOD_MAT_MUL_BLOCK_M)
+        {
+            ie = FLINT_MIN(ib + NMOD_MAT_MUL_BLOCK_M, m);
+
+            for (p = 0; p < np; p++)
+            {
+                mp_srcptr b = Bp + (p * k + kb) * 4;
+
+                for (i = ib; i < ie; i++)
+                {
+                    mp_srcptr a0 = A[i] + kb;
+                    mp_ptr t = T + i * ld + p * 8;
+                    mp_limb_t l0 = t[0], h0 = t[1], l1 = t[2], h1 = t[3];
+                    mp_limb_t l2 = t[4], h2 = t[5], l3 = t[6], h3 = t[7];
+                    mp_limb_t u0, u1, u2, u3, v0, v1, v2, v3;
+
+                    if (half)
+                    {
+                        for (kk = 0; kk < kc; kk++)
+                        {
+                            mp_limb_t x0 = a0[kk];
+                            mp_srcptr bb = b + kk * 4;
+
+                            add_ssaaaa(h0, l0, h0, l0, 0, x0 * bb[0]);
+                            add_ssaaaa(h1, l1, h1, l1, 0, x0 * bb[1]);
+                            add_ssaaaa(h2, l2, h2, l2, 0, x0 * bb[2]);
+                            add_ssaaaa(h3, l3, h3, l3, 0, x0 * bb[3]);
+                        }
+                    }
+                    else
+                    {
+                        for (kk = 0; kk < kc; kk++)
+                        {
+                            mp_limb_t x0 = a0[kk];
+                            mp_srcptr bb = b + kk * 4;
+
+                            umul_ppmm(u0, v0, x0, bb[0]);
+                            umul_ppmm(u1, v1, x0, bb[1]);
+                            umul_ppmm(u2, v2, x0, bb[2]);
+                            umul_ppmm(u3, v3, x0, bb[3]);
+                            add_ssaaaa(h0, l0, h0, l0, u0, v0);
+                            add_ssaaaa(h1, l1, h1, l1, u1, v1);
+                            add_ssaaaa(h2, l2, h2, l2, u2, v2);
+                            add_ssaaaa(h3, l3, h3, l3, u3, v3);
+                        }
+                    }
+
+                    t[0] = l0; t[1] = h0; t[2] = l1; t[3] = h1;
+                    t[4] = l2; t[5] = h2; t[6] = l3; t[7] = h3;
+                }
+            }
+        }
+    }
+
+    for (i = 0; i < m; i++)
+    {
+        for (j = 0; j < n; j++)
+        {
+            mp_limb_t d;
+            mp_srcptr t = T + i * ld + (j / 4) * 8 + (j % 4) * 2;
+            NMOD2_RED2(d, t[1], t[0], mod);
+            _nmod_mat_store_entry(D, C, i, j, d, op, mod);
+        }
+    }
+
+    _nmod_vec_clear(T);
+}
+
+/*
+    Floating point kernel for moduli below 2^NMOD_MAT_MUL_DOUBLE_BITS.
+    Products of reduced entries are exact in a double, so up to kd of them
+    can be summed exactly before the partial sums need reducing.
+*/
+static __inline__ double
+_nmod_mat_reduce_d(double c, double n, double ninv)
+{
+    double q = (double) ((slong) (c * ninv));
+    c -= q * n;
+    if (c >= n)
+        c -= n;
+    else if (c < 0)
+        c += n;
+    return c;
+}
+
+static void
+_nmod_mat_addmul_tiled_d(mp_ptr * D, const mp_ptr * C, const mp_ptr * A,
+    const double * Bp, slong m, slong k, slong n, int op, nmod_t mod)
+{
+    slong i, j, p, np, ld, kb, kc, kd, ib, ie, kk;
+    double * T, * Ad;
+    double dn = (double) mod.n, dninv = 1.0 / (double) mod.n;
+    double nsq = (double) (mod.n - 1) * (double) (mod.n - 1);
+
+    np = (n + 3) / 4;
+    ld = np * 4;
+
+    /* number of products that can be added to a reduced entry exactly */
+    kd = (slong) ((9007199254740992.0 - dn) / nsq);
+    kd = FLINT_MAX(kd, 1);
+    kd = FLINT_MIN(kd, NMOD_MAT_MUL_BLOCK_K);
+
+    T = flint_calloc(m * ld, sizeof(double));
+    Ad = flint_malloc(sizeof(double) * NMOD_MAT_MUL_BLOCK_M * kd);
+
+    for (kb = 0; kb < k; kb += kd)
+    {
+        kc = FLINT_MIN(kd, k - kb);
+
+        for (ib = 0; ib < m; ib += NMOD_MAT_MUL_BLOCK_M)
+        {
+            ie = FLINT_MIN(ib + NMOD_MAT_MUL_BLOCK_M, m);
+
+            for (i = ib; i < ie; i++)
+                for (kk = 0; kk < kc; kk++)
+                    Ad[(i - ib) * kc + kk] = (double) A[i][kb + kk];
+
+            for (p = 0; p < np; p++)
+            {
+                const double * b = Bp + (p * k + kb) * 4;
+
+                for (i = ib; i + 2 <= ie; i += 2)
+                {
+                    const double * a0 = Ad + (i - ib) * kc, * a1 = a0 + kc;
+                    double * t0 = T + i * ld + p * 4, * t1 = t0 + ld;
+                    double c00 = t0[0], c01 = t0[1], c02 = t0[2], c03 = t0[3];
+                    double c10 = t1[0], c11 = t1[1], c12 = t1[2], c13 = t1[3];
+
+                    for (kk = 0; kk < kc; kk++)
+                    {
+                        double x0 = a0[kk], x1 = a1[kk];
+                        const double * bb = b + kk * 4;
+
+                        c00 += x0 * bb[0]; c01 += x0 * bb[1];
+                        c02 += x0 * bb[2]; c03 += x0 * bb[3];
+                        c10 += x1 * bb[0]; c11 += x1 * bb[1];
+                        c12 += x1 * bb[2]; c13 += x1 * bb[3];
+                    }
+
+                    t0[0] = _nmod_mat_reduce_d(c00, dn, dninv);
+                    t0[1] = _nmod_mat_reduce_d(c01, dn, dninv);
+                    t0[2] = _nmod_mat_reduce_d(c02, dn, dninv);
+                    t0[3] = _nmod_mat_reduce_d(c03, dn, dninv);
+                    t1[0] = _nmod_mat_reduce_d(c10, dn, dninv);
+                    t1[1] = _nmod_mat_reduce_d(c11, dn, dninv);
+                    t1[2] = _nmod_mat_reduce_d(c12, dn, dninv);
+                    t1[3] = _nmod_mat_reduce_d(c13, dn, dninv);
+                }
+
+                if (i < ie)
+                {
+                    const double * a0 = Ad + (i - ib) * kc;
+                    double * t0 = T + i * ld + p * 4;
+                    double c00 = t0[0], c01 = t0[1], c02 = t0[2], c03 = t0[3];
+
+                    for (kk = 0; kk < kc; kk++)
+                    {
+                        double x0 = a0[kk];
+                        const double * bb = b + kk * 4;
+
+                        c00 += x0 * bb[0]; c01 += x0 * bb[1];
+                        c02 += x0 * bb[2]; c03 += x0 * bb[3];
+                    }
+
+                    t0[0] = _nmod_mat_reduce_d(c00, dn, dninv);
+                    t0[1] = _nmod_mat_reduce_d(c01, dn, dninv);
+                    t0[2] = _nmod_mat_reduce_d(c02, dn, dninv);
+                    t0[3] = _nmod_mat_reduce_d(c03, dn, dninv);
+                }
+            }
+        }
+    }
+
+    for (i = 0; i < m; i++)
+        for (j = 0; j < n; j++)
+            _nmod_mat_store_entry(D, C, i, j,
+                                    (mp_limb_t) T[i * ld + j], op, mod);
+
+    flint_free(Ad);
+    flint_free(T);
+}
+
+#define _NMOD_MAT_ADDMUL_BASIC 0
+#define _NMOD_MAT_ADDMUL_TRANSPOSE 1
+#define _NMOD_MAT_ADDMUL_PACKED 2
+#define _NMOD_MAT_ADDMUL_TILED1 3
+#define _NMOD_MAT_ADDMUL_TILED2 4
+#define _NMOD_MAT_ADDMUL_TILED_D 5
+
+typedef struct
+{
+    mp_ptr * D;
+    mp_ptr * C;
+    mp_ptr * A;
+    mp_ptr * B;
+    mp_srcptr Bpack;        /* copy of B laid out for the kernel */
+    const double * Bpack_d;
+    slong m;
+    slong k;
+    slong n;
+    int op;
+    nmod_t mod;
+    int nlimbs;
+    int pack;
+    int pack_bits;
+    int algorithm;
+}
+_nmod_mat_addmul_arg_struct;
+
+/* computes the rows of D described by arg */
+static void
+_nmod_mat_addmul_worker(void * varg)
+{
+    _nmod_mat_addmul_arg_struct * arg = (_nmod_mat_addmul_arg_struct *) varg;
+
+    if (arg->m == 0)
+        return;
+
+    switch (arg->algorithm)
+    {
+        case _NMOD_MAT_ADDMUL_BASIC:
+            _nmod_mat_addmul_basic(arg->D, arg->C, arg->A, arg->B,
+                arg->m, arg->k, arg->n, arg->op, arg->mod, arg->nlimbs);
+            break;
+        case _NMOD_MAT_ADDMUL_TRANSPOSE:
+            _nmod_mat_addmul_transpose_op(arg->D, arg->C, arg->A, arg->Bpack,
+                arg->m, arg->k, arg->n, arg->op, arg->mod, arg->nlimbs);
+            break;
+        case _NMOD_MAT_ADDMUL_PACKED:
+            _nmod_mat_addmul_packed_op(arg->D, arg->C, arg->A, arg->Bpack,
+                arg->m, arg->k, arg->n, arg->op, arg->mod,
+                arg->pack, arg->pack_bits);
+            break;
+        case _NMOD_MAT_ADDMUL_TILED1:
+            _nmod_mat_addmul_tiled1(arg->D, arg->C, arg->A, arg->Bpack,
+                arg->m, arg->k, arg->n, arg->op, arg->mod);
+            break;
+        case _NMOD_MAT_ADDMUL_TILED2:
+            _nmod_mat_addmul_tiled2(arg->D, arg->C, arg->A, arg->Bpack,
+                arg->m, arg->k, arg->n, arg->op, arg->mod);
+            break;
+        default:
+            _nmod_mat_addmul_tiled_d(arg->D, arg->C, arg->A, arg->Bpack_d,
+                arg->m, arg->k, arg->n, arg->op, arg->mod);
+    }
+}
 
 void
 _nmod_mat_mul_classical(nmod_mat_t D, const nmod_mat_t C,
                                 const nmod_mat_t A, const nmod_mat_t B, int op)
 {
-    slong m, k, n;
-    int nlimbs;
+    slong m, k, n, i, thread_limit, num_workers;
+    int nlimbs, algorithm, pack = 0, pack_bits = 0;
     nmod_t mod;
+    mp_ptr Bpack = NULL;
+    double * Bpack_d = NULL;
+    thread_pool_handle * threads;
+    _nmod_mat_addmul_arg_struct * args;
 
     mod = A->mod;
     m = A->r;
     k = A->c;
     n = B->c;
 
-    if (k == 0)
+    /* modulo 1 every product is zero, and the kernels below assume n > 1 */
+    if (k == 0 || mod.n == 1)
     {
         if (op == 0)
             nmod_mat_zero(D);
@@ -196,23 +642,87 @@ _nmod_mat_mul_classical(nmod_mat_t D, const nmod_mat_t C,
 
     nlimbs = _nmod_vec_dot_bound_limbs(k, mod);
 
-    if (nlimbs == 1 && m > 10 && k > 10 && n > 10)
+    if (nlimbs == 1)
     {
-        _nmod_mat_addmul_packed(D->rows, (op == 0) ? NULL : C->rows,
-            A->rows, B->rows, m, k, n, op, D->mod, nlimbs);
+        /* bound unreduced entry */
+        mp_limb_t c = k * (mod.n - 1) * (mod.n - 1);
+        pack_bits = FLINT_BIT_COUNT(c);
+        pack = FLINT_BITS / pack_bits;
     }
+
+    if (nlimbs == 1 && pack >= 2 && m > 10 && k > 10 && n > 10)
+        algorithm = _NMOD_MAT_ADDMUL_PACKED;
     else if (m < NMOD_MAT_MUL_TRANSPOSE_CUTOFF
         || n < NMOD_MAT_MUL_TRANSPOSE_CUTOFF
         || k < NMOD_MAT_MUL_TRANSPOSE_CUTOFF)
-    {
-        _nmod_mat_addmul_basic(D->rows, (op == 0) ? NULL : C->rows,
-            A->rows, B->rows, m, k, n, op, D->mod, nlimbs);
-    }
+        algorithm = _NMOD_MAT_ADDMUL_BASIC;
+    else if (mod.n < (1UL << NMOD_MAT_MUL_DOUBLE_BITS))
+        algorithm = _NMOD_MAT_ADDMUL_TILED_D;
+    else if (nlimbs == 1)
+        algorithm = _NMOD_MAT_ADDMUL_TILED1;
+    else if (nlimbs == 2)
+        algorithm = _NMOD_MAT_ADDMUL_TILED2;
     else
+        algorithm = _NMOD_MAT_ADDMUL_TRANSPOSE;
+
+    /* the copy of B is shared by all threads */
+    if (algorithm == _NMOD_MAT_ADDMUL_PACKED)
+        Bpack = _nmod_mat_pack_bits(B->rows, k, n, pack, pack_bits);
+    else if (algorithm == _NMOD_MAT_ADDMUL_TRANSPOSE)
+        Bpack = _nmod_mat_transpose_rows(B->rows, k, n);
+    else if (algorithm == _NMOD_MAT_ADDMUL_TILED1
+          || algorithm == _NMOD_MAT_ADDMUL_TILED2)
+        Bpack = _nmod_mat_pack_panels(B->rows, k, n);
+    else if (algorithm == _NMOD_MAT_ADDMUL_TILED_D)
+        Bpack_d = _nmod_mat_pack_panels_d(B->rows, k, n);
+
+    /* split the rows of D into blocks, one per thread */
+    thread_limit = FLINT_MIN(m / NMOD_MAT_MUL_CLASSICAL_THREAD_ROWS,
+        (slong) (((double) m * k * n) / NMOD_MAT_MUL_CLASSICAL_THREAD_WORK));
+
+    num_workers = flint_request_threads(&threads, thread_limit);
+
+    args = flint_malloc(sizeof(_nmod_mat_addmul_arg_struct)*(num_workers + 1));
+
+    for (i = 0; i <= num_workers; i++)
     {
-        _nmod_mat_addmul_transpose(D->rows, (op == 0) ? NULL : C->rows,
-            A->rows, B->rows, m, k, n, op, D->mod, nlimbs);
+        slong r0 = (i * m) / (num_workers + 1);
+        slong r1 = ((i + 1) * m) / (num_workers + 1);
+
+        args[i].D = D->rows + r0;
+        args[i].C = (op == 0) ? NULL : C->rows + r0;
+        args[i].A = A->rows + r0;
+        args[i].B = B->rows;
+        args[i].Bpack = Bpack;
+        args[i].Bpack_d = Bpack_d;
+        args[i].m = r1 - r0;
+        args[i].k = k;
+        args[i].n = n;
+        args[i].op = op;
+        args[i].mod = mod;
+        args[i].nlimbs = nlimbs;
+        args[i].pack = pack;
+        args[i].pack_bits = pack_bits;
+        args[i].algorithm = algorithm;
     }
+
+    for (i = 0; i < num_workers; i++)
+        thread_pool_wake(global_thread_pool, threads[i],
+                         _nmod_mat_addmul_worker, &args[i + 1]);
+
+    _nmod_mat_addmul_worker(&args[0]);
+
+    for (i = 0; i < num_workers; i++)
+        thread_pool_wait(global_thread_pool, threads[i]);
+
+    flint_give_back_threads(threads, num_workers);
+
+    flint_free(args);
+
+    if (Bpack != NULL)
+        _nmod_vec_clear(Bpack);
+    if (Bpack_d != NULL)
+        flint_free(Bpack_d);
 }
 
 
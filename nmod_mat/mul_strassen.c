@@ -30,6 +30,96 @@
 #include "flint.h"
 #include "nmod_vec.h"
 #include "nmod_mat.h"
+#include "thread_pool.h"
+
+typedef struct
+{
+    nmod_mat_t A;
+    nmod_mat_t B;
+    nmod_mat_t C;
+}
+_nmod_mat_mul_block_arg_struct;
+
+static void
+_nmod_mat_mul_block_worker(void * varg)
+{
+    _nmod_mat_mul_block_arg_struct * arg = (_nmod_mat_mul_block_arg_struct *) varg;
+
+    nmod_mat_mul(arg->C, arg->A, arg->B);
+}
+
+/*
+    Splits C into a grid of at most num_workers + 1 blocks, none of which
+    is smaller than the Strassen cutoff, and multiplies the blocks in
+    parallel. Returns 0 if no useful splitting exists.
+*/
+static int
+_nmod_mat_mul_strassen_threaded(nmod_mat_t C, const nmod_mat_t A,
+          const nmod_mat_t B, thread_pool_handle * threads, slong num_workers)
+{
+    slong a, b, c, i, j, pr, pc, best, rmax, cmax;
+    _nmod_mat_mul_block_arg_struct * args;
+
+    a = A->r;
+    b = A->c;
+    c = B->c;
+
+    rmax = a / NMOD_MAT_MUL_STRASSEN_CUTOFF;
+    cmax = c / NMOD_MAT_MUL_STRASSEN_CUTOFF;
+
+    best = 1;
+    pr = pc = 1;
+    for (i = 1; i <= FLINT_MIN(rmax, num_workers + 1); i++)
+    {
+        j = FLINT_MIN((num_workers + 1) / i, cmax);
+
+        if (i * j > best)
+        {
+            best = i * j;
+            pr = i;
+            pc = j;
+        }
+    }
+
+    if (best == 1)
+        return 0;
+
+    args = flint_malloc(sizeof(_nmod_mat_mul_block_arg_struct) * best);
+
+    for (i = 0; i < pr; i++)
+    {
+        for (j = 0; j < pc; j++)
+        {
+            slong r0 = (i * a) / pr, r1 = ((i + 1) * a) / pr;
+            slong c0 = (j * c) / pc, c1 = ((j + 1) * c) / pc;
+            _nmod_mat_mul_block_arg_struct * arg = args + i * pc + j;
+
+            nmod_mat_window_init(arg->A, A, r0, 0, r1, b);
+            nmod_mat_window_init(arg->B, B, 0, c0, b, c1);
+            nmod_mat_window_init(arg->C, C, r0, c0, r1, c1);
+        }
+    }
+
+    for (i = 1; i < best; i++)
+        thread_pool_wake(global_thread_pool, threads[i - 1],
+                         _nmod_mat_mul_block_worker, args + i);
+
+    _nmod_mat_mul_block_worker(args);
+
+    for (i = 1; i < best; i++)
+        thread_pool_wait(global_thread_pool, threads[i - 1]);
+
+    for (i = 0; i < best; i++)
+    {
+        nmod_mat_window_clear(args[i].A);
+        nmod_mat_window_clear(args[i].B);
+        nmod_mat_window_clear(args[i].C);
+    }
+
+    flint_free(args);
+
+    return 1;
+}
 
 
 void
@@ -43,6 +133,9 @@ nmod_mat_mul_strassen(nmod_mat_t C, const nmod_mat_t A, const nmod_mat_t B)
     nmod_mat_t C11, C12, C21, C22;
     nmod_mat_t X1, X2;
 
+    thread_pool_handle * threads;
+    slong num_workers;
+
     a = A->r;
     b = A->c;
     c = B->c;
@@ -53,6 +146,18 @@ nmod_mat_mul_strassen(nmod_mat_t C, const nmod_mat_t A, const nmod_mat_t B)
         return;
     }
 
+    num_workers = flint_request_threads(&threads,
+        (a / NMOD_MAT_MUL_STRASSEN_CUTOFF) * (c / NMOD_MAT_MUL_STRASSEN_CUTOFF));
+
+    if (num_workers > 0 &&
+        _nmod_mat_mul_strassen_threaded(C, A, B, threads, num_workers))
+    {
+        flint_give_back_threads(threads, num_workers);
+        return;
+    }
+
+    flint_give_back_threads(threads, num_workers);
+
     anr = a / 2;
     anc = b / 2;
     bnr = anc;
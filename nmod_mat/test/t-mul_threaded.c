@@ -0,0 +1,149 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <gmp.h>
+#include "flint.h"
+#include "nmod_mat.h"
+#include "ulong_extras.h"
+
+void
+nmod_mat_mul_check(nmod_mat_t C, const nmod_mat_t A, const nmod_mat_t B)
+{
+    slong i, j, k;
+
+    mp_limb_t s0, s1, s2;
+    mp_limb_t t0, t1;
+
+    for (i = 0; i < A->r; i++)
+    {
+        for (j = 0; j < B->c; j++)
+        {
+            s0 = s1 = s2 = 0UL;
+
+            for (k = 0; k < A->c; k++)
+            {
+                umul_ppmm(t1, t0, A->rows[i][k], B->rows[k][j]);
+                add_sssaaaaaa(s2, s1, s0, s2, s1, s0, 0, t1, t0);
+            }
+
+            NMOD_RED(s2, s2, C->mod);
+            NMOD_RED3(s0, s2, s1, s0, C->mod);
+            C->rows[i][j] = s0;
+        }
+    }
+}
+
+int
+main(void)
+{
+    slong i;
+    flint_rand_t state;
+    flint_randinit(state);
+
+    printf("mul_threaded....");
+    fflush(stdout);
+
+    for (i = 0; i < 20 * flint_test_multiplier(); i++)
+    {
+        nmod_mat_t A, B, C, D;
+        mp_limb_t mod;
+        slong m, k, n;
+        int strassen;
+
+        flint_set_num_threads(1 + n_randint(state, 6));
+
+        strassen = (n_randint(state, 5) == 0);
+
+        if (strassen)
+        {
+            m = 2 * NMOD_MAT_MUL_STRASSEN_CUTOFF + n_randint(state, 10);
+            n = 2 * NMOD_MAT_MUL_STRASSEN_CUTOFF + n_randint(state, 10);
+
+            /* with a long inner dimension every block handed to a worker
+               is itself large enough to recurse into Strassen */
+            if (n_randint(state, 2))
+                k = 2 * NMOD_MAT_MUL_STRASSEN_CUTOFF + n_randint(state, 10);
+            else
+                k = 5 + n_randint(state, 20);
+        }
+        else
+        {
+            m = n_randint(state, 200);
+            k = n_randint(state, 2 * NMOD_MAT_MUL_BLOCK_K + 100);
+            n = n_randint(state, 200);
+        }
+
+        switch (n_randint(state, 4))
+        {
+            case 0:
+                mod = n_randtest_not_zero(state);
+                break;
+            case 1:
+                mod = n_randint(state, 1000) + 2;
+                break;
+            case 2:
+                mod = 1;
+                break;
+            case 3:
+            default:
+                mod = ULONG_MAX - n_randbits(state, 4);
+                break;
+        }
+
+        nmod_mat_init(A, m, k, mod);
+        nmod_mat_init(B, k, n, mod);
+        nmod_mat_init(C, m, n, mod);
+        nmod_mat_init(D, m, n, mod);
+
+        nmod_mat_randtest(A, state);
+        nmod_mat_randtest(B, state);
+        nmod_mat_randtest(C, state);
+
+        if (strassen)
+            nmod_mat_mul_strassen(C, A, B);
+        else
+            nmod_mat_mul_classical(C, A, B);
+
+        nmod_mat_mul_check(D, A, B);
+
+        if (!nmod_mat_equal(C, D))
+        {
+            printf("FAIL: results not equal\n");
+            printf("m = %ld, k = %ld, n = %ld, threads = %d\n",
+                m, k, n, flint_get_num_threads());
+            abort();
+        }
+
+        nmod_mat_clear(A);
+        nmod_mat_clear(B);
+        nmod_mat_clear(C);
+        nmod_mat_clear(D);
+    }
+
+    flint_set_num_threads(1);
+
+    flint_randclear(state);
+
+    printf("PASS\n");
+    return 0;
+}
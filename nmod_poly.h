@@ -49,6 +49,33 @@
 #define NMOD_POLY_GCD_CUTOFF  340       /* GCD:  Euclidean -> HGCD          */
 #define NMOD_POLY_SMALL_GCD_CUTOFF 200  /* GCD (small n): Euclidean -> HGCD */
 
+#define NMOD_POLY_NTT_CUTOFF 8000         /* MUL: KS -> NTT, n >= 2^40      */
+#define NMOD_POLY_SMALL_NTT_CUTOFF 100000 /* MUL (small n): KS -> NTT       */
+#define NMOD_POLY_PRIME_NTT_CUTOFF 400    /* MUL (NTT prime n): KS -> NTT   */
+
+int _nmod_poly_mul_NTT_direct(slong len, nmod_t mod);
+
+static __inline__
+int _nmod_poly_mul_use_NTT(slong len2, slong len_out, nmod_t mod)
+{
+#if FLINT64
+    if (len2 < NMOD_POLY_PRIME_NTT_CUTOFF)
+        return 0;
+
+    if (FLINT_BITS - mod.norm >= 40)
+    {
+        if (len2 >= NMOD_POLY_NTT_CUTOFF)
+            return 1;
+    }
+    else if (len2 >= NMOD_POLY_SMALL_NTT_CUTOFF)
+        return 1;
+
+    return _nmod_poly_mul_NTT_direct(len_out, mod);
+#else
+    return 0;
+#endif
+}
+
 static __inline__
 slong NMOD_DIVREM_BC_ITCH(slong lenA, slong lenB, nmod_t mod)
 {
@@ -467,6 +494,18 @@ void _nmod_poly_mullow_KS(mp_ptr out, mp_srcptr in1, slong len1,
 void nmod_poly_mullow_KS(nmod_poly_t res, const nmod_poly_t poly1, 
                              const nmod_poly_t poly2, mp_bitcnt_t bits, slong n);
 
+void _nmod_poly_mul_NTT(mp_ptr res, mp_srcptr poly1, slong len1, 
+                             mp_srcptr poly2, slong len2, nmod_t mod);
+
+void nmod_poly_mul_NTT(nmod_poly_t res, 
+                         const nmod_poly_t poly1, const nmod_poly_t poly2);
+
+void _nmod_poly_mullow_NTT(mp_ptr res, mp_srcptr poly1, slong len1, 
+                        mp_srcptr poly2, slong len2, slong n, nmod_t mod);
+
+void nmod_poly_mullow_NTT(nmod_poly_t res, const nmod_poly_t poly1, 
+                                         const nmod_poly_t poly2, slong n);
+
 void _nmod_poly_mul(mp_ptr res, mp_srcptr poly1, slong len1, 
                                        mp_srcptr poly2, slong len2, nmod_t mod);
 
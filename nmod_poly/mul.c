@@ -45,6 +45,8 @@ void _nmod_poly_mul(mp_ptr res, mp_srcptr poly1, slong len1,
 
     if (2 * bits + bits2 <= FLINT_BITS && len1 + len2 < 16)
         _nmod_poly_mul_classical(res, poly1, len1, poly2, len2, mod);
+    else if (_nmod_poly_mul_use_NTT(len2, len1 + len2 - 1, mod))
+        _nmod_poly_mul_NTT(res, poly1, len1, poly2, len2, mod);
     else if (bits * len2 > 2000)
         _nmod_poly_mul_KS4(res, poly1, len1, poly2, len2, mod);
     else if (bits * len2 > 200)
@@ -0,0 +1,64 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "nmod_vec.h"
+#include "nmod_poly.h"
+
+void _nmod_poly_mul_NTT(mp_ptr res, mp_srcptr poly1, slong len1, 
+                             mp_srcptr poly2, slong len2, nmod_t mod)
+{
+    _nmod_poly_mullow_NTT(res, poly1, len1, poly2, len2, len1 + len2 - 1, mod);
+}
+
+void nmod_poly_mul_NTT(nmod_poly_t res, 
+                         const nmod_poly_t poly1, const nmod_poly_t poly2)
+{
+    slong len_out;
+
+    if (poly1->length == 0 || poly2->length == 0)
+    {
+        nmod_poly_zero(res);
+        return;
+    }
+
+    len_out = poly1->length + poly2->length - 1;
+
+    if (res == poly1 || res == poly2)
+    {
+        nmod_poly_t temp;
+        nmod_poly_init2_preinv(temp, poly1->mod.n, poly1->mod.ninv, len_out);
+        _nmod_poly_mul_NTT(temp->coeffs, poly1->coeffs, poly1->length,
+                                   poly2->coeffs, poly2->length, poly1->mod);
+        nmod_poly_swap(res, temp);
+        nmod_poly_clear(temp);
+    }
+    else
+    {
+        nmod_poly_fit_length(res, len_out);
+        _nmod_poly_mul_NTT(res->coeffs, poly1->coeffs, poly1->length,
+                                   poly2->coeffs, poly2->length, poly1->mod);
+    }
+
+    res->length = len_out;
+    _nmod_poly_normalise(res);
+}
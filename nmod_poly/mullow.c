@@ -45,6 +45,9 @@ void _nmod_poly_mullow(mp_ptr res, mp_srcptr poly1, slong len1,
 
     if (2 * bits + bits2 <= FLINT_BITS && len1 + len2 < 16)
         _nmod_poly_mullow_classical(res, poly1, len1, poly2, len2, n, mod);
+    else if (_nmod_poly_mul_use_NTT(FLINT_MIN(len2, n),
+                 FLINT_MIN(len1, n) + FLINT_MIN(len2, n) - 1, mod))
+        _nmod_poly_mullow_NTT(res, poly1, len1, poly2, len2, n, mod);
     else
         _nmod_poly_mullow_KS(res, poly1, len1, poly2, len2, 0, n, mod);
 }
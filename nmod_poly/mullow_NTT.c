@@ -0,0 +1,470 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "nmod_vec.h"
+#include "nmod_poly.h"
+
+#if FLINT64
+
+/*
+   Primes p = c 2^50 + 1 with 2^61 < p < 2^62. Their product exceeds
+   2^183, which bounds the coefficients of any product of polynomials
+   with word sized coefficients and lengths up to 2^55.
+*/
+static const mp_limb_t _nmod_poly_NTT_primes[3] =
+{
+    4601552919265804289UL, 4522739925786820609UL, 4500221927649968129UL
+};
+
+#define NTT_PRIME_BITS 61
+
+/* transforms up to this length are done level by level in cache */
+#define NTT_BLOCK 1024
+
+typedef struct
+{
+    nmod_t mod;       /* the prime p */
+    slong L;          /* transform length */
+    mp_ptr w;         /* w[h + j] = y^j for j < h, y of order 2h */
+    mp_ptr wpre;      /* Shoup precomputed quotients of w */
+}
+ntt_struct;
+
+typedef ntt_struct ntt_t[1];
+
+/* Returns floor(w 2^FLINT_BITS / p) for w < p. */
+static __inline__ mp_limb_t
+_ntt_precomp(mp_limb_t w, nmod_t mod)
+{
+    mp_limb_t q, r;
+
+    udiv_qrnnd_preinv(q, r, w << mod.norm, 0, mod.n << mod.norm, mod.ninv);
+    (void) r;
+
+    return q;
+}
+
+/*
+   Returns a w mod p or a w mod p + p given wpre = floor(w 2^64 / p),
+   for any limb a and w < p.
+*/
+static __inline__ mp_limb_t
+_ntt_mulmod_lazy(mp_limb_t a, mp_limb_t w, mp_limb_t wpre, mp_limb_t p)
+{
+    mp_limb_t q, t;
+
+    umul_ppmm(q, t, a, wpre);
+
+    return a * w - q * p;
+}
+
+static __inline__ mp_limb_t
+_ntt_mulmod(mp_limb_t a, mp_limb_t w, mp_limb_t wpre, mp_limb_t p)
+{
+    mp_limb_t r = _ntt_mulmod_lazy(a, w, wpre, p);
+
+    return (r >= p) ? r - p : r;
+}
+
+static void
+_ntt_init(ntt_t T, mp_limb_t p, slong L)
+{
+    mp_limb_t a, x, xpre;
+    slong j, h;
+
+    nmod_init(&T->mod, p);
+    T->L = L;
+    T->w = flint_malloc(sizeof(mp_limb_t) * L);
+    T->wpre = flint_malloc(sizeof(mp_limb_t) * L);
+
+    /* a quadratic nonresidue raised to (p - 1)/L has order exactly L */
+    for (a = 2; n_powmod2_preinv(a, (p - 1) / 2, p, T->mod.ninv) != p - 1; a++) ;
+    x = n_powmod2_preinv(a, (p - 1) / L, p, T->mod.ninv);
+    xpre = _ntt_precomp(x, T->mod);
+
+    h = L / 2;
+    T->w[h] = 1;
+    T->wpre[h] = _ntt_precomp(1, T->mod);
+    for (j = 1; j < h; j++)
+    {
+        T->w[h + j] = _ntt_mulmod(T->w[h + j - 1], x, xpre, p);
+        T->wpre[h + j] = _ntt_precomp(T->w[h + j], T->mod);
+    }
+
+    /* the roots for smaller spans are every other root of the next span */
+    for (h = L / 4; h >= 1; h /= 2)
+    {
+        for (j = 0; j < h; j++)
+        {
+            T->w[h + j] = T->w[2 * h + 2 * j];
+            T->wpre[h + j] = T->wpre[2 * h + 2 * j];
+        }
+    }
+}
+
+static void
+_ntt_clear(ntt_t T)
+{
+    flint_free(T->w);
+    flint_free(T->wpre);
+}
+
+/*
+   One level of the decimation in frequency transform: butterflies of
+   span m over each of the len / m blocks of a. Entries are kept in
+   [0, 2p) throughout, as in Harvey's lazy butterflies.
+*/
+static void
+_ntt_dif_level(mp_ptr a, slong len, slong m, const ntt_t T)
+{
+    const mp_limb_t p2 = 2 * T->mod.n, p = T->mod.n;
+    const slong h = m / 2;
+    mp_srcptr w = T->w + h, wpre = T->wpre + h;
+    mp_limb_t u, v;
+    slong s, j;
+
+    for (s = 0; s < len; s += m)
+    {
+        mp_ptr b = a + s, c = a + s + h;
+
+        u = b[0];
+        v = c[0];
+        b[0] = (u + v >= p2) ? u + v - p2 : u + v;
+        c[0] = (u >= v) ? u - v : u - v + p2;
+
+        for (j = 1; j < h; j++)
+        {
+            u = b[j];
+            v = c[j];
+            b[j] = (u + v >= p2) ? u + v - p2 : u + v;
+            c[j] = _ntt_mulmod_lazy(u - v + p2, w[j], wpre[j], p);
+        }
+    }
+}
+
+/*
+   One level of the inverse decimation in time transform. The twiddle
+   y^(-j) of span m is -y^(m/2 - j), which is read from the forward table.
+*/
+static void
+_ntt_dit_level(mp_ptr a, slong len, slong m, const ntt_t T)
+{
+    const mp_limb_t p2 = 2 * T->mod.n, p = T->mod.n;
+    const slong h = m / 2;
+    mp_srcptr w = T->w + h, wpre = T->wpre + h;
+    mp_limb_t u, t;
+    slong s, j;
+
+    for (s = 0; s < len; s += m)
+    {
+        mp_ptr b = a + s, c = a + s + h;
+
+        u = b[0];
+        t = c[0];
+        b[0] = (u + t >= p2) ? u + t - p2 : u + t;
+        c[0] = (u >= t) ? u - t : u - t + p2;
+
+        for (j = 1; j < h; j++)
+        {
+            u = b[j];
+            t = _ntt_mulmod_lazy(c[j], w[h - j], wpre[h - j], p);
+            b[j] = (u >= t) ? u - t : u - t + p2;
+            c[j] = (u + t >= p2) ? u + t - p2 : u + t;
+        }
+    }
+}
+
+/* Forward transform of length m, natural order in, bit reversed out. */
+static void
+_ntt_fft(mp_ptr a, slong m, const ntt_t T)
+{
+    slong k;
+
+    if (m <= NTT_BLOCK)
+    {
+        for (k = m; k >= 2; k /= 2)
+            _ntt_dif_level(a, m, k, T);
+    }
+    else
+    {
+        _ntt_dif_level(a, m, m, T);
+        _ntt_fft(a, m / 2, T);
+        _ntt_fft(a + m / 2, m / 2, T);
+    }
+}
+
+/* Inverse transform without scaling, bit reversed in, natural order out. */
+static void
+_ntt_ifft(mp_ptr a, slong m, const ntt_t T)
+{
+    slong k;
+
+    if (m <= NTT_BLOCK)
+    {
+        for (k = 2; k <= m; k *= 2)
+            _ntt_dit_level(a, m, k, T);
+    }
+    else
+    {
+        _ntt_ifft(a, m / 2, T);
+        _ntt_ifft(a + m / 2, m / 2, T);
+        _ntt_dit_level(a, m, m, T);
+    }
+}
+
+static void
+_ntt_load(mp_ptr a, mp_srcptr poly, slong len, const ntt_t T, nmod_t mod)
+{
+    if (mod.n <= T->mod.n)
+        flint_mpn_copyi(a, poly, len);
+    else
+        _nmod_vec_reduce(a, poly, len, T->mod);
+
+    flint_mpn_zero(a + len, T->L - len);
+}
+
+/*
+   Sets r to the cyclic convolution of length T->L of the inputs,
+   reduced modulo p. The array t is used as scratch space unless sqr
+   is set, in which case the inputs must be equal.
+*/
+static void
+_ntt_convolve(mp_ptr r, mp_ptr t, mp_srcptr poly1, slong len1,
+               mp_srcptr poly2, slong len2, int sqr, const ntt_t T, nmod_t mod)
+{
+    const mp_limb_t p = T->mod.n;
+    mp_limb_t Linv, Linvpre, hi, lo, u, v;
+    slong i;
+
+    _ntt_load(r, poly1, len1, T, mod);
+    _ntt_fft(r, T->L, T);
+
+    if (sqr)
+        t = r;
+    else
+    {
+        _ntt_load(t, poly2, len2, T, mod);
+        _ntt_fft(t, T->L, T);
+    }
+
+    Linv = n_invmod(T->L % p, p);
+    Linvpre = _ntt_precomp(Linv, T->mod);
+
+    for (i = 0; i < T->L; i++)
+    {
+        u = (r[i] >= p) ? r[i] - p : r[i];
+        v = (t[i] >= p) ? t[i] - p : t[i];
+        umul_ppmm(hi, lo, u, v);
+        NMOD_RED2(u, hi, lo, T->mod);
+        r[i] = _ntt_mulmod_lazy(u, Linv, Linvpre, p);
+    }
+
+    _ntt_ifft(r, T->L, T);
+
+    for (i = 0; i < T->L; i++)
+        r[i] = (r[i] >= p) ? r[i] - p : r[i];
+}
+
+int _nmod_poly_mul_NTT_direct(slong len, nmod_t mod)
+{
+    mp_limb_t L = 1UL << FLINT_CLOG2(FLINT_MAX(len, 2));
+
+    return mod.n < (1UL << 62) && ((mod.n - 1) & (L - 1)) == 0
+                               && n_is_prime(mod.n);
+}
+
+void _nmod_poly_mullow_NTT(mp_ptr res, mp_srcptr poly1, slong len1, 
+                        mp_srcptr poly2, slong len2, slong n, nmod_t mod)
+{
+    mp_ptr r[3], t;
+    mp_limb_t p0, p1, p2;
+    nmod_t P1, P2;
+    slong i, L, np, bits;
+    int sqr = (poly1 == poly2 && len1 == len2);
+    ntt_t T;
+
+    len1 = FLINT_MIN(len1, n);
+    len2 = FLINT_MIN(len2, n);
+
+    L = 1L << FLINT_CLOG2(FLINT_MAX(len1 + len2 - 1, 2));
+
+    if (_nmod_poly_mul_NTT_direct(len1 + len2 - 1, mod))
+    {
+        r[0] = _nmod_vec_init(L);
+        t = sqr ? NULL : _nmod_vec_init(L);
+
+        _ntt_init(T, mod.n, L);
+        _ntt_convolve(r[0], t, poly1, len1, poly2, len2, sqr, T, mod);
+        _ntt_clear(T);
+
+        flint_mpn_copyi(res, r[0], n);
+
+        _nmod_vec_clear(r[0]);
+        if (!sqr)
+            _nmod_vec_clear(t);
+
+        return;
+    }
+
+    bits = 2 * FLINT_BIT_COUNT(mod.n - 1)
+         + FLINT_CLOG2(FLINT_MIN(len1, len2));
+    np = FLINT_MAX(1, (bits + NTT_PRIME_BITS - 1) / NTT_PRIME_BITS);
+
+    t = sqr ? NULL : _nmod_vec_init(L);
+    for (i = 0; i < np; i++)
+    {
+        r[i] = _nmod_vec_init(L);
+
+        _ntt_init(T, _nmod_poly_NTT_primes[i], L);
+        _ntt_convolve(r[i], t, poly1, len1, poly2, len2, sqr, T, mod);
+        _ntt_clear(T);
+    }
+    if (!sqr)
+        _nmod_vec_clear(t);
+
+    p0 = _nmod_poly_NTT_primes[0];
+    p1 = _nmod_poly_NTT_primes[1];
+    p2 = _nmod_poly_NTT_primes[2];
+    nmod_init(&P1, p1);
+    nmod_init(&P2, p2);
+
+    /* reconstruct x = r0 + p0 t1 + p0 p1 t2 and reduce it modulo n */
+    if (np == 1)
+    {
+        _nmod_vec_reduce(res, r[0], n, mod);
+    }
+    else if (np == 2)
+    {
+        const mp_limb_t c1 = n_invmod(p0 - p1, p1);
+        const mp_limb_t c1pre = _ntt_precomp(c1, P1);
+        mp_limb_t u, t1, m0;
+
+        NMOD_RED(m0, p0, mod);
+
+        for (i = 0; i < n; i++)
+        {
+            u = (r[0][i] >= p1) ? r[0][i] - p1 : r[0][i];
+            t1 = _ntt_mulmod(r[1][i] - u + p1, c1, c1pre, p1);
+            NMOD_RED(u, r[0][i], mod);
+            NMOD_RED(t1, t1, mod);
+            res[i] = nmod_add(u, nmod_mul(t1, m0, mod), mod);
+        }
+    }
+    else
+    {
+        const mp_limb_t c1 = n_invmod(p0 - p1, p1);
+        const mp_limb_t c1pre = _ntt_precomp(c1, P1);
+        const mp_limb_t q0 = p0 - p2;
+        const mp_limb_t q0pre = _ntt_precomp(q0, P2);
+        const mp_limb_t c2 = n_invmod(nmod_mul(q0, p1 - p2, P2), p2);
+        const mp_limb_t c2pre = _ntt_precomp(c2, P2);
+        mp_limb_t u, v, t1, t2, m0, m01;
+
+        NMOD_RED(m0, p0, mod);
+        NMOD_RED(m01, p1, mod);
+        m01 = nmod_mul(m0, m01, mod);
+
+        for (i = 0; i < n; i++)
+        {
+            u = (r[0][i] >= p1) ? r[0][i] - p1 : r[0][i];
+            t1 = _ntt_mulmod(r[1][i] - u + p1, c1, c1pre, p1);
+
+            /* v = r0 + p0 t1 mod p2 */
+            u = (r[0][i] >= p2) ? r[0][i] - p2 : r[0][i];
+            v = _ntt_mulmod(t1, q0, q0pre, p2) + u;
+            v = (v >= p2) ? v - p2 : v;
+            t2 = _ntt_mulmod(r[2][i] - v + p2, c2, c2pre, p2);
+
+            NMOD_RED(u, r[0][i], mod);
+            NMOD_RED(t1, t1, mod);
+            NMOD_RED(t2, t2, mod);
+            res[i] = nmod_add(nmod_add(u, nmod_mul(t1, m0, mod), mod),
+                              nmod_mul(t2, m01, mod), mod);
+        }
+    }
+
+    for (i = 0; i < np; i++)
+        _nmod_vec_clear(r[i]);
+}
+
+#else
+
+/* the transform primes need 64 bit limbs, so we fall back to KS */
+
+int _nmod_poly_mul_NTT_direct(slong len, nmod_t mod)
+{
+    return 0;
+}
+
+void _nmod_poly_mullow_NTT(mp_ptr res, mp_srcptr poly1, slong len1, 
+                        mp_srcptr poly2, slong len2, slong n, nmod_t mod)
+{
+    len1 = FLINT_MIN(len1, n);
+    len2 = FLINT_MIN(len2, n);
+
+    if (len1 >= len2)
+        _nmod_poly_mullow_KS(res, poly1, len1, poly2, len2, 0, n, mod);
+    else
+        _nmod_poly_mullow_KS(res, poly2, len2, poly1, len1, 0, n, mod);
+}
+
+#endif
+
+void nmod_poly_mullow_NTT(nmod_poly_t res, const nmod_poly_t poly1, 
+                                         const nmod_poly_t poly2, slong n)
+{
+    slong len1, len2, len_out;
+
+    len1 = poly1->length;
+    len2 = poly2->length;
+
+    if (len1 == 0 || len2 == 0 || n == 0)
+    {
+        nmod_poly_zero(res);
+        return;
+    }
+
+    len_out = len1 + len2 - 1;
+    if (n > len_out)
+        n = len_out;
+
+    if (res == poly1 || res == poly2)
+    {
+        nmod_poly_t temp;
+        nmod_poly_init2_preinv(temp, poly1->mod.n, poly1->mod.ninv, n);
+        _nmod_poly_mullow_NTT(temp->coeffs, poly1->coeffs, len1,
+                                  poly2->coeffs, len2, n, poly1->mod);
+        nmod_poly_swap(res, temp);
+        nmod_poly_clear(temp);
+    }
+    else
+    {
+        nmod_poly_fit_length(res, n);
+        _nmod_poly_mullow_NTT(res->coeffs, poly1->coeffs, len1,
+                                  poly2->coeffs, len2, n, poly1->mod);
+    }
+
+    res->length = n;
+    _nmod_poly_normalise(res);
+}
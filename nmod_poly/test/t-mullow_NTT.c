@@ -0,0 +1,173 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "nmod_vec.h"
+#include "nmod_poly.h"
+#include "ulong_extras.h"
+
+/* moduli for which the transform is done directly modulo n */
+static const mp_limb_t ntt_primes[] =
+{
+#if FLINT64
+    7681UL, 12289UL, 998244353UL, 4611686018326724609UL
+#else
+    7681UL, 12289UL, 998244353UL, 2013265921UL
+#endif
+};
+
+static mp_limb_t
+random_modulus(flint_rand_t state)
+{
+    if (n_randint(state, 4) == 0)
+        return ntt_primes[n_randint(state, 4)];
+    else
+        return n_randtest_not_zero(state);
+}
+
+static slong
+random_length(flint_rand_t state)
+{
+    if (n_randint(state, 20) == 0)
+        return n_randint(state, 3000);
+    else
+        return n_randint(state, 50);
+}
+
+int
+main(void)
+{
+    int i, result;
+    flint_rand_t state;
+    flint_randinit(state);
+
+    printf("mullow_NTT....");
+    fflush(stdout);
+
+    /* Check aliasing of a and b */
+    for (i = 0; i < 200 * flint_test_multiplier(); i++)
+    {
+        nmod_poly_t a, b, c;
+        mp_limb_t n = random_modulus(state);
+        slong trunc = 0;
+
+        nmod_poly_init(a, n);
+        nmod_poly_init(b, n);
+        nmod_poly_init(c, n);
+        nmod_poly_randtest(b, state, random_length(state));
+        nmod_poly_randtest(c, state, random_length(state));
+
+        if (b->length > 0 && c->length > 0)
+            trunc = n_randint(state, b->length + c->length);
+
+        nmod_poly_mullow_NTT(a, b, c, trunc);
+        nmod_poly_mullow_NTT(b, b, c, trunc);
+
+        result = (nmod_poly_equal(a, b));
+        if (!result)
+        {
+            printf("FAIL:\n");
+            nmod_poly_print(a), printf("\n\n");
+            nmod_poly_print(b), printf("\n\n");
+            abort();
+        }
+
+        nmod_poly_clear(a);
+        nmod_poly_clear(b);
+        nmod_poly_clear(c);
+    }
+
+    /* Check aliasing of a and c */
+    for (i = 0; i < 200 * flint_test_multiplier(); i++)
+    {
+        nmod_poly_t a, b, c;
+        mp_limb_t n = random_modulus(state);
+        slong trunc = 0;
+
+        nmod_poly_init(a, n);
+        nmod_poly_init(b, n);
+        nmod_poly_init(c, n);
+        nmod_poly_randtest(b, state, random_length(state));
+        nmod_poly_randtest(c, state, random_length(state));
+
+        if (b->length > 0 && c->length > 0)
+            trunc = n_randint(state, b->length + c->length);
+
+        nmod_poly_mullow_NTT(a, b, c, trunc);
+        nmod_poly_mullow_NTT(c, b, c, trunc);
+
+        result = (nmod_poly_equal(a, c));
+        if (!result)
+        {
+            printf("FAIL:\n");
+            nmod_poly_print(a), printf("\n\n");
+            nmod_poly_print(c), printf("\n\n");
+            abort();
+        }
+
+        nmod_poly_clear(a);
+        nmod_poly_clear(b);
+        nmod_poly_clear(c);
+    }
+
+    /* Compare with mullow_KS */
+    for (i = 0; i < 200 * flint_test_multiplier(); i++)
+    {
+        nmod_poly_t a1, a2, b, c;
+        mp_limb_t n = random_modulus(state);
+        slong trunc = 0;
+
+        nmod_poly_init(a1, n);
+        nmod_poly_init(a2, n);
+        nmod_poly_init(b, n);
+        nmod_poly_init(c, n);
+        nmod_poly_randtest(b, state, random_length(state));
+        nmod_poly_randtest(c, state, random_length(state));
+
+        if (b->length > 0 && c->length > 0)
+            trunc = n_randint(state, b->length + c->length);
+
+        nmod_poly_mullow_KS(a1, b, c, 0, trunc);
+        nmod_poly_mullow_NTT(a2, b, c, trunc);
+
+        result = (nmod_poly_equal(a1, a2));
+        if (!result)
+        {
+            printf("FAIL:\n");
+            printf("n = %lu, trunc = %ld\n", n, trunc);
+            nmod_poly_print(a1), printf("\n\n");
+            nmod_poly_print(a2), printf("\n\n");
+            abort();
+        }
+
+        nmod_poly_clear(a1);
+        nmod_poly_clear(a2);
+        nmod_poly_clear(b);
+        nmod_poly_clear(c);
+    }
+
+    flint_randclear(state);
+
+    printf("PASS\n");
+    return 0;
+}
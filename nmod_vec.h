@@ -245,6 +245,36 @@ void _nmod_vec_scalar_addmul_nmod(mp_ptr res, mp_srcptr vec,
                             slong len, mp_limb_t c, nmod_t mod);
 
 
+#if HAVE_AVX2 && FLINT_BITS == 64
+#define NMOD_VEC_AVX2 1
+#else
+#define NMOD_VEC_AVX2 0
+#endif
+
+/* minimum length for which the AVX2 kernels are used */
+#define NMOD_VEC_AVX2_CUTOFF 8
+
+#if NMOD_VEC_AVX2
+
+int _nmod_vec_avx2_available(void);
+
+void _nmod_vec_reduce_avx2(mp_ptr res, mp_srcptr vec, 
+                                        slong len, nmod_t mod);
+
+void _nmod_vec_add_avx2(mp_ptr res, mp_srcptr vec1, 
+                        mp_srcptr vec2, slong len, nmod_t mod);
+
+void _nmod_vec_sub_avx2(mp_ptr res, mp_srcptr vec1, 
+                        mp_srcptr vec2, slong len, nmod_t mod);
+
+void _nmod_vec_scalar_mul_nmod_avx2(mp_ptr res, mp_srcptr vec, 
+                            slong len, mp_limb_t c, nmod_t mod);
+
+void _nmod_vec_scalar_addmul_nmod_avx2(mp_ptr res, mp_srcptr vec, 
+                            slong len, mp_limb_t c, nmod_t mod);
+
+#endif
+
 int _nmod_vec_dot_bound_limbs(slong len, nmod_t mod);
 
 
@@ -34,6 +34,15 @@ void _nmod_vec_add(mp_ptr res, mp_srcptr vec1,
 {
    slong i;
 
+#if NMOD_VEC_AVX2
+   if (len >= NMOD_VEC_AVX2_CUTOFF && mod.norm >= 2
+                                 && _nmod_vec_avx2_available())
+   {
+      _nmod_vec_add_avx2(res, vec1, vec2, len, mod);
+      return;
+   }
+#endif
+
    if (mod.norm)
    {
 	  for (i = 0 ; i < len; i++)
@@ -0,0 +1,277 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include <stdlib.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "nmod_vec.h"
+
+#if NMOD_VEC_AVX2
+
+#include <immintrin.h>
+
+#define AVX2_TARGET __attribute__((target("avx2,fma")))
+
+int _nmod_vec_avx2_available(void)
+{
+    /* racing threads all store the same value, so no lock is needed */
+    static int available = -1;
+
+    if (available == -1)
+    {
+        __builtin_cpu_init();
+        available = __builtin_cpu_supports("avx2")
+                 && __builtin_cpu_supports("fma");
+    }
+
+    return available;
+}
+
+/* Returns r - n in the lanes where r >= n. Requires r < 2^63. */
+static __inline__ AVX2_TARGET __m256i
+_avx2_reduce_once(__m256i r, __m256i n)
+{
+    return _mm256_blendv_epi8(_mm256_sub_epi64(r, n), r,
+                                          _mm256_cmpgt_epi64(n, r));
+}
+
+/*
+   Returns a*c mod n using Shoup's trick, where w = floor(c 2^32 / n).
+   Requires a < 2^32 and c < n < 2^32.
+*/
+static __inline__ AVX2_TARGET __m256i
+_avx2_mulmod_shoup32(__m256i a, __m256i c, __m256i w, __m256i n)
+{
+    __m256i q, r;
+
+    q = _mm256_srli_epi64(_mm256_mul_epu32(a, w), 32);
+    r = _mm256_sub_epi64(_mm256_mul_epu32(a, c), _mm256_mul_epu32(q, n));
+
+    return _avx2_reduce_once(r, n);
+}
+
+/* Exact conversions between integers below 2^52 and doubles. */
+static __inline__ AVX2_TARGET __m256d
+_avx2_u52_to_pd(__m256i a)
+{
+    const __m256d magic = _mm256_set1_pd(4503599627370496.0);
+
+    a = _mm256_or_si256(a, _mm256_castpd_si256(magic));
+    return _mm256_sub_pd(_mm256_castsi256_pd(a), magic);
+}
+
+static __inline__ AVX2_TARGET __m256i
+_avx2_pd_to_u52(__m256d a)
+{
+    const __m256d magic = _mm256_set1_pd(4503599627370496.0);
+
+    return _mm256_xor_si256(_mm256_castpd_si256(_mm256_add_pd(a, magic)),
+                            _mm256_castpd_si256(magic));
+}
+
+/*
+   Returns a*c mod n, where a, c < n < 2^50 are held exactly in doubles
+   and ninv is 1/n rounded to a double. The high part of the product
+   is divided by n using ninv, which gives a quotient out by at most one,
+   and the low part of the product is recovered exactly with an fma.
+*/
+static __inline__ AVX2_TARGET __m256d
+_avx2_mulmod_d(__m256d a, __m256d c, __m256d n, __m256d ninv)
+{
+    __m256d h, l, q, r;
+
+    h = _mm256_mul_pd(a, c);
+    l = _mm256_fmsub_pd(a, c, h);
+    q = _mm256_round_pd(_mm256_mul_pd(h, ninv),
+                          _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+    r = _mm256_add_pd(_mm256_fnmadd_pd(q, n, h), l);
+
+    r = _mm256_sub_pd(r, _mm256_and_pd(n, _mm256_cmp_pd(r, n, _CMP_GE_OQ)));
+    r = _mm256_add_pd(r, _mm256_and_pd(n,
+                       _mm256_cmp_pd(r, _mm256_setzero_pd(), _CMP_LT_OQ)));
+
+    return r;
+}
+
+#define LOAD(p) _mm256_loadu_si256((const __m256i *) (p))
+#define STORE(p, x) _mm256_storeu_si256((__m256i *) (p), (x))
+
+AVX2_TARGET void
+_nmod_vec_add_avx2(mp_ptr res, mp_srcptr vec1,
+                                  mp_srcptr vec2, slong len, nmod_t mod)
+{
+    const __m256i n = _mm256_set1_epi64x(mod.n);
+    slong i;
+
+    for (i = 0; i + 4 <= len; i += 4)
+        STORE(res + i, _avx2_reduce_once(
+                           _mm256_add_epi64(LOAD(vec1 + i), LOAD(vec2 + i)), n));
+
+    for ( ; i < len; i++)
+        res[i] = _nmod_add(vec1[i], vec2[i], mod);
+}
+
+AVX2_TARGET void
+_nmod_vec_sub_avx2(mp_ptr res, mp_srcptr vec1,
+                                  mp_srcptr vec2, slong len, nmod_t mod)
+{
+    const __m256i n = _mm256_set1_epi64x(mod.n);
+    __m256i a, b;
+    slong i;
+
+    for (i = 0; i + 4 <= len; i += 4)
+    {
+        a = LOAD(vec1 + i);
+        b = LOAD(vec2 + i);
+        a = _mm256_add_epi64(_mm256_sub_epi64(a, b),
+                             _mm256_and_si256(n, _mm256_cmpgt_epi64(b, a)));
+        STORE(res + i, a);
+    }
+
+    for ( ; i < len; i++)
+        res[i] = _nmod_sub(vec1[i], vec2[i], mod);
+}
+
+AVX2_TARGET void
+_nmod_vec_scalar_mul_nmod_avx2(mp_ptr res, mp_srcptr vec,
+                                  slong len, mp_limb_t c, nmod_t mod)
+{
+    slong i;
+
+    if (c >= mod.n)
+        NMOD_RED(c, c, mod);
+
+    if (mod.n < (1UL << 32))
+    {
+        const __m256i n = _mm256_set1_epi64x(mod.n);
+        const __m256i cc = _mm256_set1_epi64x(c);
+        const __m256i w = _mm256_set1_epi64x((c << 32) / mod.n);
+
+        for (i = 0; i + 4 <= len; i += 4)
+            STORE(res + i, _avx2_mulmod_shoup32(LOAD(vec + i), cc, w, n));
+    }
+    else
+    {
+        const __m256d n = _mm256_set1_pd((double) mod.n);
+        const __m256d ninv = _mm256_set1_pd(1.0 / (double) mod.n);
+        const __m256d cd = _mm256_set1_pd((double) c);
+
+        for (i = 0; i + 4 <= len; i += 4)
+            STORE(res + i, _avx2_pd_to_u52(_avx2_mulmod_d(
+                                 _avx2_u52_to_pd(LOAD(vec + i)), cd, n, ninv)));
+    }
+
+    for ( ; i < len; i++)
+        res[i] = n_mulmod2_preinv(vec[i], c, mod.n, mod.ninv);
+}
+
+AVX2_TARGET void
+_nmod_vec_scalar_addmul_nmod_avx2(mp_ptr res, mp_srcptr vec,
+                                  slong len, mp_limb_t c, nmod_t mod)
+{
+    const __m256i n = _mm256_set1_epi64x(mod.n);
+    __m256i t;
+    slong i;
+
+    if (c >= mod.n)
+        NMOD_RED(c, c, mod);
+
+    if (mod.n < (1UL << 32))
+    {
+        const __m256i cc = _mm256_set1_epi64x(c);
+        const __m256i w = _mm256_set1_epi64x((c << 32) / mod.n);
+
+        for (i = 0; i + 4 <= len; i += 4)
+        {
+            t = _avx2_mulmod_shoup32(LOAD(vec + i), cc, w, n);
+            STORE(res + i, _avx2_reduce_once(
+                                   _mm256_add_epi64(LOAD(res + i), t), n));
+        }
+    }
+    else
+    {
+        const __m256d nd = _mm256_set1_pd((double) mod.n);
+        const __m256d ninv = _mm256_set1_pd(1.0 / (double) mod.n);
+        const __m256d cd = _mm256_set1_pd((double) c);
+
+        for (i = 0; i + 4 <= len; i += 4)
+        {
+            t = _avx2_pd_to_u52(_avx2_mulmod_d(
+                               _avx2_u52_to_pd(LOAD(vec + i)), cd, nd, ninv));
+            STORE(res + i, _avx2_reduce_once(
+                                   _mm256_add_epi64(LOAD(res + i), t), n));
+        }
+    }
+
+    for ( ; i < len; i++)
+        res[i] = _nmod_add(res[i],
+                       n_mulmod2_preinv(vec[i], c, mod.n, mod.ninv), mod);
+}
+
+/*
+   Each word is split as x = hi 2^32 + lo, and hi 2^32 is reduced
+   by a modular multiplication by 2^32 mod n.
+*/
+AVX2_TARGET void
+_nmod_vec_reduce_avx2(mp_ptr res, mp_srcptr vec, slong len, nmod_t mod)
+{
+    const __m256i n = _mm256_set1_epi64x(mod.n);
+    const __m256i mask = _mm256_set1_epi64x(0xffffffffUL);
+    __m256i x, hi, lo;
+    slong i;
+
+    if (mod.n < (1UL << 32))
+    {
+        const mp_limb_t c = (1UL << 32) % mod.n;
+        const __m256i cc = _mm256_set1_epi64x(c);
+        const __m256i w = _mm256_set1_epi64x((c << 32) / mod.n);
+        const __m256i one = _mm256_set1_epi64x(1);
+        const __m256i w1 = _mm256_set1_epi64x((1UL << 32) / mod.n);
+
+        for (i = 0; i + 4 <= len; i += 4)
+        {
+            x = LOAD(vec + i);
+            hi = _avx2_mulmod_shoup32(_mm256_srli_epi64(x, 32), cc, w, n);
+            lo = _avx2_mulmod_shoup32(_mm256_and_si256(x, mask), one, w1, n);
+            STORE(res + i, _avx2_reduce_once(_mm256_add_epi64(hi, lo), n));
+        }
+    }
+    else
+    {
+        const __m256d nd = _mm256_set1_pd((double) mod.n);
+        const __m256d ninv = _mm256_set1_pd(1.0 / (double) mod.n);
+        const __m256d cd = _mm256_set1_pd((double) ((1UL << 32) % mod.n));
+
+        for (i = 0; i + 4 <= len; i += 4)
+        {
+            x = LOAD(vec + i);
+            hi = _avx2_pd_to_u52(_avx2_mulmod_d(
+                 _avx2_u52_to_pd(_mm256_srli_epi64(x, 32)), cd, nd, ninv));
+            lo = _mm256_and_si256(x, mask);
+            STORE(res + i, _avx2_reduce_once(_mm256_add_epi64(hi, lo), n));
+        }
+    }
+
+    for ( ; i < len; i++)
+        NMOD_RED(res[i], vec[i], mod);
+}
+
+#endif
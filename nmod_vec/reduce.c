@@ -32,6 +32,16 @@
 void _nmod_vec_reduce(mp_ptr res, mp_srcptr vec, slong len, nmod_t mod)
 {
    slong i;
+
+#if NMOD_VEC_AVX2
+   if (len >= NMOD_VEC_AVX2_CUTOFF && mod.n > 1 && mod.norm >= FLINT_BITS - 50
+                                 && _nmod_vec_avx2_available())
+   {
+      _nmod_vec_reduce_avx2(res, vec, len, mod);
+      return;
+   }
+#endif
+
    for (i = 0 ; i < len; i++)
 	  NMOD_RED(res[i], vec[i], mod);
 }
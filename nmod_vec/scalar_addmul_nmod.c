@@ -32,6 +32,15 @@
 void _nmod_vec_scalar_addmul_nmod(mp_ptr res, mp_srcptr vec, 
 				             slong len, mp_limb_t c, nmod_t mod)
 {
+#if NMOD_VEC_AVX2
+   if (len >= NMOD_VEC_AVX2_CUTOFF && mod.norm >= FLINT_BITS - 50
+                                 && _nmod_vec_avx2_available())
+   {
+      _nmod_vec_scalar_addmul_nmod_avx2(res, vec, len, c, mod);
+      return;
+   }
+#endif
+
     if (mod.norm >= FLINT_BITS/2) /* addmul will fit in a limb */
     {
         mpn_addmul_1(res, vec, len, c);
@@ -0,0 +1,150 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "nmod_vec.h"
+#include "ulong_extras.h"
+
+#if NMOD_VEC_AVX2
+
+static mp_limb_t
+_random_modulus(flint_rand_t state, mp_bitcnt_t max_bits)
+{
+    static const mp_limb_t edge[] = {
+        2UL, 3UL, 4294967291UL, 4294967295UL, 4294967296UL, 4294967297UL,
+        1125899906842597UL, 1125899906842623UL, 1125899906842624UL - 2
+    };
+
+    mp_limb_t n;
+
+    if (n_randint(state, 4) == 0)
+    {
+        n = edge[n_randint(state, sizeof(edge) / sizeof(edge[0]))];
+        if (FLINT_BIT_COUNT(n) <= max_bits)
+            return n;
+    }
+
+    n = n_randbits(state, n_randint(state, max_bits) + 1);
+
+    return FLINT_MAX(n, 2UL);
+}
+
+int
+main(void)
+{
+    int i, j;
+    flint_rand_t state;
+    flint_randinit(state);
+
+    printf("avx2....");
+    fflush(stdout);
+
+    if (!_nmod_vec_avx2_available())
+    {
+        flint_randclear(state);
+        printf("SKIPPED\n");
+        return 0;
+    }
+
+    for (i = 0; i < 10000; i++)
+    {
+        slong len = n_randint(state, 200) + 1;
+        int op = n_randint(state, 5);
+        mp_limb_t n, c;
+        nmod_t mod;
+
+        mp_ptr a = _nmod_vec_init(len);
+        mp_ptr b = _nmod_vec_init(len);
+        mp_ptr r1 = _nmod_vec_init(len);
+        mp_ptr r2 = _nmod_vec_init(len);
+
+        n = _random_modulus(state, op <= 1 ? 62 : 50);
+        nmod_init(&mod, n);
+        c = n_randint(state, n);
+
+        _nmod_vec_randtest(a, state, len, mod);
+        _nmod_vec_randtest(b, state, len, mod);
+        flint_mpn_copyi(r1, b, len);
+        flint_mpn_copyi(r2, b, len);
+
+        switch (op)
+        {
+            case 0:
+                _nmod_vec_add_avx2(r1, a, b, len, mod);
+                for (j = 0; j < len; j++)
+                    r2[j] = n_addmod(a[j], b[j], n);
+                break;
+            case 1:
+                _nmod_vec_sub_avx2(r1, a, b, len, mod);
+                for (j = 0; j < len; j++)
+                    r2[j] = n_submod(a[j], b[j], n);
+                break;
+            case 2:
+                _nmod_vec_scalar_mul_nmod_avx2(r1, a, len, c, mod);
+                for (j = 0; j < len; j++)
+                    r2[j] = n_mulmod2_preinv(a[j], c, n, mod.ninv);
+                break;
+            case 3:
+                _nmod_vec_scalar_addmul_nmod_avx2(r1, a, len, c, mod);
+                for (j = 0; j < len; j++)
+                    r2[j] = n_addmod(r2[j],
+                                n_mulmod2_preinv(a[j], c, n, mod.ninv), n);
+                break;
+            default:
+                for (j = 0; j < len; j++)
+                    a[j] = n_randtest(state);
+                _nmod_vec_reduce_avx2(r1, a, len, mod);
+                for (j = 0; j < len; j++)
+                    r2[j] = n_mod2_preinv(a[j], n, mod.ninv);
+                break;
+        }
+
+        if (!_nmod_vec_equal(r1, r2, len))
+        {
+            printf("FAIL:\n");
+            printf("op = %d, len = %ld, n = %lu, c = %lu\n", op, len, n, c);
+            abort();
+        }
+
+        _nmod_vec_clear(a);
+        _nmod_vec_clear(b);
+        _nmod_vec_clear(r1);
+        _nmod_vec_clear(r2);
+    }
+
+    flint_randclear(state);
+
+    printf("PASS\n");
+    return 0;
+}
+
+#else
+
+int
+main(void)
+{
+    printf("avx2....SKIPPED\n");
+    return 0;
+}
+
+#endif
@@ -29,6 +29,7 @@
 #include <gmp.h>
 #include "flint.h"
 #include "fmpz.h"
+#include "thread_pool.h"
 
 #ifdef __cplusplus
  extern "C" {
@@ -78,6 +79,52 @@ typedef struct la_col_t /* matrix column */
 	slong orig;         /* Original relation number */
 } la_col_t;
 
+#define QS_MERGE_MAX_WEIGHT 8 /* heaviest rows merged away by filtering */
+#define QS_MERGE_DENSE_COST 32 /* cost of the dense operations of Lanczos 
+                                  per column, relative to a nonzero entry */
+#define QS_LA_MAX_THREADS 16 /* most threads used by block Lanczos */
+
+/*
+   Polynomial data and relation buffer used by a single sieving thread 
+   in qsieve_factor
+*/
+typedef struct qs_poly_s
+{
+   fmpz_t A; /* coefficient A */
+   fmpz_t B; /* coefficient B */
+   fmpz_t C; /* coefficient C */
+
+   mp_limb_t * A_ind; /* indices of factor base primes dividing A */
+   mp_limb_t * A_modp; /* (A/p) mod p for each prime p dividing A */
+   fmpz * A_divp; /* A/p for each prime p dividing A */
+   fmpz * B_terms; /* as for qsieve_ll, but multiprecision */
+
+   mp_limb_t * A_inv; /* A^(-1) mod p */
+   mp_limb_t ** A_inv2B; /* A_inv2B[j][i] = 2*B_terms[j]*A^(-1) mod p */
+
+   mp_limb_t * soln1; /* first root of poly */
+   mp_limb_t * soln2; /* second root of poly */
+   mp_limb_t * posn1; /* next sieve position for first root */
+   mp_limb_t * posn2; /* next sieve position for second root */
+
+   unsigned char * sieve; /* sieve block of CACHE_SIZE bytes */
+
+   /* relations found by this thread which are not yet inserted */
+   slong * small; /* small_primes exponents for each relation */
+   fac_t * factor; /* max_factors factors for each relation */
+   slong * num_factors; /* number of factors of each relation */
+   mp_limb_t * lp; /* two large primes for each relation, 1 if absent */
+   fmpz * Y; /* Y value of each relation */
+   slong num_rels; /* number of relations in the buffer */
+} qs_poly_s;
+
+typedef qs_poly_s qs_poly_t[1];
+
+#define QS_POLY_RELS 64 /* relations buffered by a thread before insertion */
+
+#define QS_LP_MULT 64 /* large primes are at most QS_LP_MULT times the largest FB prime */
+#define QS_DLP_BITS 260 /* bits of n from which two large primes are allowed */
+
 typedef struct qs_s
 {
    mp_limb_t hi; /* Number to factor */
@@ -98,7 +145,8 @@ typedef struct qs_s
 
    int * sqrts; /* square roots of kn mod factor base primes */
 
-   char sieve_bits; /* number of bits to exceed in sieve */
+   slong sieve_bits; /* number of bits to exceed in sieve */
+   slong sieve_fill; /* initial value of each sieve entry */
 
    /******************
      Polynomial data
@@ -136,6 +184,27 @@ typedef struct qs_s
    slong high; /* end of range for middle factor */
 
 
+   /*********************************************
+     Multi-limb polynomial data (qsieve_factor)
+   *********************************************/
+
+   fmpz_t n; /* number to factor */
+
+   fmpz_t target_A_mp; /* approximate target value for A */
+
+   slong A_low; /* start of range of factor base indices for factors of A */
+   slong A_high; /* end of range of factor base indices for factors of A */
+
+   flint_rand_t state; /* random state used to choose factors of A */
+
+   qs_poly_s * poly; /* data for each sieving thread */
+   slong num_handles; /* number of worker threads, one fewer than polys */
+   thread_pool_handle * handles; /* worker threads */
+
+#if HAVE_PTHREAD
+   pthread_mutex_t mutex; /* protects state and the relation data */
+#endif
+
    /*********************
      Relations data
    **********************/
@@ -155,6 +224,37 @@ typedef struct qs_s
 
    slong num_factors; /* number of factors found in a relation */
 
+   /*********************
+     Large prime data
+   **********************/
+
+   mp_limb_t lp_bound; /* largest prime allowed in a partial relation */
+   slong lp_bits; /* maximum bits of the cofactor of a partial relation */
+   int dlp; /* whether partials with two large primes are kept */
+   mp_bitcnt_t dlp_bits; /* bits of kn from which dlp is set */
+
+   slong num_partials; /* number of partial relations */
+   slong partials_alloc; /* space for partial relations */
+   slong * partial_off; /* offset of each partial in partial_data */
+   slong * partial_data; /* factors of partials, in the format of relation */
+   slong partial_len; /* number of entries of partial_data used */
+   slong partial_data_alloc; /* space for partial_data */
+   fmpz * partial_Y; /* Y values of partials */
+   slong * partial_edge; /* vertices joined by each partial, 0 is the prime 1 */
+   char * partial_tree; /* whether each partial is an edge of the forest */
+   slong partials_combined; /* partials already combined into relations */
+
+   mp_limb_t * lp_hash; /* hash table of large primes, 0 if empty */
+   slong * lp_hash_vertex; /* vertex of each large prime in lp_hash */
+   slong lp_hash_alloc; /* size of hash table, a power of 2 */
+
+   mp_limb_t * vertex_prime; /* large prime of each vertex */
+   slong * vertex_parent; /* union-find forest on the vertices */
+   slong num_vertices; /* number of vertices, including 0 */
+   slong vertices_alloc; /* space for vertices */
+
+   slong num_cycles; /* number of cycles not yet combined into relations */
+
    /*********************
      Linear algebra data
    **********************/
@@ -212,6 +312,56 @@ static const mp_limb_t qsieve_ll_tune[][5] =
 /* number of entries in the tuning table */
 #define QS_LL_TUNE_SIZE (sizeof(qsieve_ll_tune)/(5*sizeof(mp_limb_t)))
 
+/*
+   Tuning parameters { bits, qsort_rels, fb_primes, small_primes, sieve_size }
+   for qsieve_factor, with the same meaning as for qsieve_ll_factor, 
+   except that the second entry is only used as the number of relations 
+   to accumulate before sorting. The sieve interval is [-M, M] where 
+   sieve_size = 2M.
+*/
+static const mp_limb_t qsieve_tune[][5] =
+{
+    {0, 50, 60, 4, 8192 },
+    {50, 50, 80, 5, 12288 },
+    {60, 50, 100, 5, 16384 },
+    {70, 50, 140, 6, 20480 },
+    {80, 50, 180, 6, 24576 },
+    {90, 50, 240, 7, 32768 },
+    {100, 100, 300, 7, 40960 },
+    {110, 100, 400, 7, 49152 },
+    {120, 100, 500, 8, 57344 },
+    {130, 100, 650, 8, 65536 },
+    {140, 100, 1000, 9, 65536 },
+    {150, 100, 1500, 9, 98304 },
+    {160, 150, 2600, 10, 98304 },
+    {170, 150, 4000, 10, 131072 },
+    {180, 150, 5000, 11, 131072 },
+    {190, 150, 6000, 11, 163840 },
+    {200, 200, 7500, 12, 163840 },
+    {210, 200, 9000, 12, 196608 },
+    {220, 300, 11000, 13, 196608 },
+    {230, 300, 13000, 14, 229376 },
+    {240, 400, 16000, 15, 229376 },
+    {250, 400, 19000, 16, 262144 },
+    {260, 500, 23000, 17, 262144 },
+    {270, 600, 27000, 18, 327680 },
+    {280, 700, 32000, 19, 327680 },
+    {290, 800, 38000, 20, 393216 },
+    {300, 900, 44000, 20, 393216 },
+    {310, 1000, 51000, 21, 458752 },
+    {320, 1200, 58000, 22, 458752 },
+    {330, 1400, 65000, 22, 524288 }
+};
+
+/* number of entries in the tuning table */
+#define QS_TUNE_SIZE (sizeof(qsieve_tune)/(5*sizeof(mp_limb_t)))
+
+/* 
+   In qsieve_factor the factor base starts with the multiplier k, 2 and
+   -1 (stored as 1). Sieving primes start at index QS_FB_START.
+*/
+#define QS_FB_START 3
+
 #define P_GOODNESS 100 /* within what factor of target_A must A be */
 #define P_GOODNESS2 200 /* within what factor of target_A must A be when s = 2 */
 
@@ -245,6 +395,38 @@ slong qsieve_ll_insert_relation(qs_t qs_inf, fmpz_t Y);
 
 mp_limb_t qsieve_ll_factor(mp_limb_t hi, mp_limb_t lo);
 
+void qsieve_init(qs_t qs_inf, const fmpz_t n);
+
+void qsieve_clear(qs_t qs_inf);
+
+mp_limb_t qsieve_knuth_schroeppel(qs_t qs_inf);
+
+mp_limb_t qsieve_primes_init(qs_t qs_inf);
+
+void qsieve_poly_init(qs_t qs_inf);
+
+void qsieve_poly_clear(qs_t qs_inf);
+
+void qsieve_compute_poly_data(qs_t qs_inf, qs_poly_t poly);
+
+void qsieve_compute_C(qs_t qs_inf, qs_poly_t poly);
+
+void qsieve_do_sieving(qs_t qs_inf, qs_poly_t poly, slong start, slong len);
+
+slong qsieve_evaluate_candidate(qs_t qs_inf, slong i, 
+                                 slong sieve_bits, qs_poly_t poly);
+
+slong qsieve_evaluate_sieve(qs_t qs_inf, qs_poly_t poly, 
+                                                 slong start, slong len);
+
+slong qsieve_insert_relations(qs_t qs_inf, qs_poly_t poly, int * done);
+
+slong qsieve_collect_relations(qs_t qs_inf, qs_poly_t poly);
+
+int _qsieve_factor(fmpz_t factor, const fmpz_t n, mp_bitcnt_t dlp_bits);
+
+int qsieve_factor(fmpz_t factor, const fmpz_t n);
+
 static __inline__ void insert_col_entry(la_col_t * col, slong entry)
 {
    if (((col->weight >> 4) << 4) == col->weight) /* need more space */
@@ -296,9 +478,23 @@ uint64_t get_null_entry(uint64_t * nullrows, slong i, slong l);
 
 void reduce_matrix(qs_t qs_inf, slong * nrows, slong * ncols, la_col_t * cols);
 
+void qsieve_filter_matrix(qs_t qs_inf, slong * nrows, slong * ncols, 
+                                            la_col_t * cols, la_col_t * rels);
+
+uint64_t * qsieve_expand_nullspace(qs_t qs_inf, uint64_t * nullrows, 
+                                               slong * ncols, la_col_t * rels);
+
 uint64_t * block_lanczos(flint_rand_t state, slong nrows, slong dense_rows, 
                                                        slong ncols, la_col_t *B);
 
+void qsieve_partials_init(qs_t qs_inf);
+
+void qsieve_partials_clear(qs_t qs_inf);
+
+void qsieve_insert_partial(qs_t qs_inf, fmpz_t Y, mp_limb_t L1, mp_limb_t L2);
+
+slong qsieve_combine_partials(qs_t qs_inf);
+
 void qsieve_ll_square_root(fmpz_t X, fmpz_t Y, qs_t qs_inf,
                              uint64_t * nullrows, slong ncols, slong l, fmpz_t N);
 
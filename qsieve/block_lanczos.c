@@ -43,6 +43,7 @@ The following modifications were made by William Hart:
 #include "flint.h"
 #include "ulong_extras.h"
 #include "qsieve.h"
+#include "thread_pool.h"
 
 #define BIT(x) (((uint64_t)(1)) << (x))
 
@@ -562,6 +563,157 @@ void mul_trans_MxN_Nx64(slong dense_rows, slong ncols,
 	}
 }
 
+/*-------------------------------------------------------------------*/
+typedef struct {
+	la_col_t *A;
+	uint64_t *x;
+	uint64_t *b;
+	uint64_t **bufs;
+	slong start;
+	slong stop;
+	slong num_bufs;
+} la_mul_arg_t;
+
+static void mul_MxN_Nx64_worker(void *arg_ptr) {
+
+	/* accumulate the product of the columns start to stop
+	   of A by x[] into b[], which is assumed to be zero */
+
+	la_mul_arg_t *arg = (la_mul_arg_t *)arg_ptr;
+	uint64_t *b = arg->b;
+	slong i, j;
+
+	for (i = arg->start; i < arg->stop; i++) {
+		la_col_t *col = arg->A + i;
+		slong *row_entries = col->data;
+		uint64_t tmp = arg->x[i];
+
+		for (j = 0; j < col->weight; j++) {
+			b[row_entries[j]] ^= tmp;
+		}
+	}
+}
+
+static void mul_MxN_Nx64_sum_worker(void *arg_ptr) {
+
+	/* add the entries start to stop of the partial
+	   products in bufs[] to b[] */
+
+	la_mul_arg_t *arg = (la_mul_arg_t *)arg_ptr;
+	slong i, j;
+
+	for (j = 0; j < arg->num_bufs; j++) {
+		uint64_t *buf = arg->bufs[j];
+		for (i = arg->start; i < arg->stop; i++)
+			arg->b[i] ^= buf[i];
+	}
+}
+
+static void mul_trans_MxN_Nx64_worker(void *arg_ptr) {
+
+	/* entries start to stop of the product of the
+	   transpose of A by x[] */
+
+	la_mul_arg_t *arg = (la_mul_arg_t *)arg_ptr;
+	slong i, j;
+
+	for (i = arg->start; i < arg->stop; i++) {
+		la_col_t *col = arg->A + i;
+		slong *row_entries = col->data;
+		uint64_t accum = 0;
+
+		for (j = 0; j < col->weight; j++) {
+			accum ^= arg->x[row_entries[j]];
+		}
+		arg->b[i] = accum;
+	}
+}
+
+/*-------------------------------------------------------------------*/
+static void mul_MxN_Nx64_threaded(slong vsize, slong dense_rows,
+		slong ncols, la_col_t *A, uint64_t *x, uint64_t *b,
+		thread_pool_handle *handles, slong num_handles,
+		slong *split, uint64_t **bufs) {
+
+	/* As mul_MxN_Nx64, with the columns split between
+	   num_handles + 1 threads at the indices in split[].
+	   Each helper thread accumulates its columns into its
+	   own buffer in bufs[], then the buffers are summed
+	   with the rows split evenly between the threads */
+
+	la_mul_arg_t args[QS_LA_MAX_THREADS + 1];
+	slong i;
+
+	if (num_handles == 0 || dense_rows) {
+		mul_MxN_Nx64(vsize, dense_rows, ncols, A, x, b);
+		return;
+	}
+
+	for (i = 0; i <= num_handles; i++) {
+		args[i].A = A;
+		args[i].x = x;
+		args[i].b = (i == 0) ? b : bufs[i - 1];
+		args[i].start = split[i];
+		args[i].stop = split[i + 1];
+		memset(args[i].b, 0, vsize * sizeof(uint64_t));
+	}
+
+	for (i = 0; i < num_handles; i++)
+		thread_pool_wake(global_thread_pool, handles[i],
+				mul_MxN_Nx64_worker, args + i + 1);
+	mul_MxN_Nx64_worker(args);
+	for (i = 0; i < num_handles; i++)
+		thread_pool_wait(global_thread_pool, handles[i]);
+
+	for (i = 0; i <= num_handles; i++) {
+		args[i].b = b;
+		args[i].bufs = bufs;
+		args[i].num_bufs = num_handles;
+		args[i].start = (vsize * i) / (num_handles + 1);
+		args[i].stop = (vsize * (i + 1)) / (num_handles + 1);
+	}
+
+	for (i = 0; i < num_handles; i++)
+		thread_pool_wake(global_thread_pool, handles[i],
+				mul_MxN_Nx64_sum_worker, args + i + 1);
+	mul_MxN_Nx64_sum_worker(args);
+	for (i = 0; i < num_handles; i++)
+		thread_pool_wait(global_thread_pool, handles[i]);
+}
+
+/*-------------------------------------------------------------------*/
+static void mul_trans_MxN_Nx64_threaded(slong dense_rows, 
+		slong ncols, la_col_t *A, uint64_t *x, uint64_t *b,
+		thread_pool_handle *handles, slong num_handles,
+		slong *split) {
+
+	/* As mul_trans_MxN_Nx64, with the columns split between
+	   num_handles + 1 threads at the indices in split[] */
+
+	la_mul_arg_t args[QS_LA_MAX_THREADS + 1];
+	slong i;
+
+	if (num_handles == 0 || dense_rows) {
+		mul_trans_MxN_Nx64(dense_rows, ncols, A, x, b);
+		return;
+	}
+
+	for (i = 0; i <= num_handles; i++) {
+		args[i].A = A;
+		args[i].x = x;
+		args[i].b = b;
+		args[i].start = split[i];
+		args[i].stop = split[i + 1];
+	}
+
+	for (i = 0; i < num_handles; i++)
+		thread_pool_wake(global_thread_pool, handles[i],
+				mul_trans_MxN_Nx64_worker, args + i + 1);
+	mul_trans_MxN_Nx64_worker(args);
+	for (i = 0; i < num_handles; i++)
+		thread_pool_wait(global_thread_pool, handles[i]);
+}
+
 /*-----------------------------------------------------------------------*/
 static void transpose_vector(slong ncols, uint64_t *v, uint64_t **trans) {
 
@@ -719,11 +871,15 @@ uint64_t * block_lanczos(flint_rand_t state, slong nrows,
 	uint64_t *d, *e, *f, *f2;
 	uint64_t *tmp;
 	slong s[2][64];
-	slong i, iter;
+	slong i, j, iter;
 	slong n = ncols;
 	slong dim0, dim1;
 	uint64_t mask0, mask1;
 	slong vsize;
+	thread_pool_handle *handles;
+	slong num_handles, total, weight;
+	slong split[QS_LA_MAX_THREADS + 2];
+	uint64_t *bufs[QS_LA_MAX_THREADS];
 
 	/* allocate all of the size-n variables. Note that because
 	   B has been preprocessed to ignore singleton rows, the
@@ -754,6 +910,29 @@ uint64_t * block_lanczos(flint_rand_t state, slong nrows,
 	f = (uint64_t *)flint_malloc(64 * sizeof(uint64_t));
 	f2 = (uint64_t *)flint_malloc(64 * sizeof(uint64_t));
 
+	/* the sparse matrix multiplications are split between
+	   threads, each taking columns of about the same total
+	   weight */
+
+	num_handles = flint_request_threads(&handles, 
+			FLINT_MIN(flint_get_num_threads(), QS_LA_MAX_THREADS));
+
+	for (i = total = 0; i < ncols; i++)
+		total += B[i].weight;
+
+	split[0] = 0;
+	for (i = weight = 0, j = 1; i < ncols; i++) {
+		weight += B[i].weight;
+		while (j <= num_handles && 
+				weight * (num_handles + 1) >= total * j)
+			split[j++] = i + 1;
+	}
+	while (j <= num_handles + 1)
+		split[j++] = ncols;
+
+	for (i = 0; i < num_handles; i++)
+		bufs[i] = (uint64_t *)flint_malloc(vsize * sizeof(uint64_t));
+
 	/* The iterations computes v[0], vt_a_v[0],
 	   vt_a2_v[0], s[0] and winv[0]. Subscripts larger
 	   than zero represent past versions of these
@@ -787,8 +966,10 @@ uint64_t * block_lanczos(flint_rand_t state, slong nrows,
 #endif
 
 	memcpy(x, v[0], vsize * sizeof(uint64_t));
-	mul_MxN_Nx64(vsize, dense_rows, ncols, B, v[0], scratch);
-	mul_trans_MxN_Nx64(dense_rows, ncols, B, scratch, v[0]);
+	mul_MxN_Nx64_threaded(vsize, dense_rows, ncols, B, v[0], scratch,
+			handles, num_handles, split, bufs);
+	mul_trans_MxN_Nx64_threaded(dense_rows, ncols, B, scratch, v[0],
+			handles, num_handles, split);
 	memcpy(v0, v[0], vsize * sizeof(uint64_t));
 
 	/* perform the iteration */
@@ -800,8 +981,10 @@ uint64_t * block_lanczos(flint_rand_t state, slong nrows,
 		   version of B, or B'B (apostrophe means 
 		   transpose). Use "A" to refer to B'B  */
 
-		mul_MxN_Nx64(vsize, dense_rows, ncols, B, v[0], scratch);
-		mul_trans_MxN_Nx64(dense_rows, ncols, B, scratch, vnext);
+		mul_MxN_Nx64_threaded(vsize, dense_rows, ncols, B, v[0], 
+				scratch, handles, num_handles, split, bufs);
+		mul_trans_MxN_Nx64_threaded(dense_rows, ncols, B, scratch, 
+				vnext, handles, num_handles, split);
 
 		/* compute v0'*A*v0 and (A*v0)'(A*v0) */
 
@@ -911,8 +1094,11 @@ uint64_t * block_lanczos(flint_rand_t state, slong nrows,
 
 	/* free unneeded storage */
 
-    
-    flint_free(vnext);
+	for (i = 0; i < num_handles; i++)
+		flint_free(bufs[i]);
+	flint_give_back_threads(handles, num_handles);
+
+	flint_free(vnext);
 	flint_free(scratch);
 	flint_free(v0);
 	flint_free(vt_a_v[0]);
@@ -0,0 +1,45 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "qsieve.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+
+void qsieve_clear(qs_t qs_inf)
+{
+    fmpz_clear(qs_inf->n);
+
+    fmpz_clear(qs_inf->target_A_mp);
+
+    qsieve_poly_clear(qs_inf);
+
+    qsieve_partials_clear(qs_inf);
+
+    flint_randclear(qs_inf->state);
+
+#if HAVE_PTHREAD
+    pthread_mutex_destroy(&qs_inf->mutex);
+#endif
+
+    qsieve_ll_clear(qs_inf); /* clear the data shared with qsieve_ll */
+}
@@ -0,0 +1,555 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#undef ulong /* avoid clash with stdlib */
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#define ulong mp_limb_t
+
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "qsieve.h"
+
+/*
+   Sieve the block [start, start + len) of the sieve interval, where len is 
+   at most CACHE_SIZE. The next position of each root beyond the block is 
+   kept in posn1 and posn2, so that successive blocks can be sieved in 
+   order, starting with start = 0.
+*/
+void qsieve_do_sieving(qs_t qs_inf, qs_poly_t poly, slong start, slong len)
+{
+   slong num_primes = qs_inf->num_primes;
+   mp_limb_t * soln1 = poly->soln1;
+   mp_limb_t * soln2 = poly->soln2;
+   mp_limb_t * posn1 = poly->posn1;
+   mp_limb_t * posn2 = poly->posn2;
+   prime_t * factor_base = qs_inf->factor_base;
+   unsigned char * sieve = poly->sieve;
+   unsigned char * end = sieve + len;
+   mp_limb_t stop = start + len;
+   register unsigned char * pos1;
+   register unsigned char * pos2;
+   register unsigned char * bound;  
+   mp_limb_t p;
+   slong size;
+   slong diff;
+   slong pind;
+
+   memset(sieve, qs_inf->sieve_fill, len);
+   memset(end, 255, sizeof(ulong)); /* sentinel for evaluate_sieve */
+
+   for (pind = qs_inf->small_primes; pind < num_primes; pind++) 
+   {
+      if (soln2[pind] == -1) continue; /* don't sieve with A factors */
+
+      if (start == 0)
+      {
+         posn1[pind] = soln1[pind];
+         posn2[pind] = soln2[pind];
+      }
+
+      p = factor_base[pind].p;
+      size = factor_base[pind].size;
+
+      if (p >= CACHE_SIZE) /* each root hits the block at most once */
+      {
+         if (posn1[pind] < stop)
+         {
+            sieve[posn1[pind] - start] += size;
+            posn1[pind] += p;
+         }
+
+         if (posn2[pind] < stop)
+         {
+            sieve[posn2[pind] - start] += size;
+            posn2[pind] += p;
+         }
+
+         continue;
+      }
+
+      if (posn1[pind] <= posn2[pind])
+      {
+         pos1 = sieve + (posn1[pind] - start);
+         pos2 = sieve + (posn2[pind] - start);
+      } else
+      {
+         pos1 = sieve + (posn2[pind] - start);
+         pos2 = sieve + (posn1[pind] - start);
+      }
+
+      diff = pos2 - pos1; /* 0 <= diff < p */
+      bound = end - diff; /* pos2 is in the block iff pos1 < bound */
+
+      while (bound - pos1 > (slong) p)  
+      {  
+         (*pos1) += size, (*(pos1 + diff)) += size, pos1 += p;
+         (*pos1) += size, (*(pos1 + diff)) += size, pos1 += p;
+      }
+
+      while (bound - pos1 > 0)
+      { 
+         (*pos1) += size, (*(pos1 + diff)) += size, pos1 += p;
+      }
+
+      pos2 = pos1 + diff;
+
+      if (end - pos1 > 0)
+      { 
+         (*pos1) += size;
+         pos1 += p;
+      } 
+
+      posn1[pind] = (pos1 - sieve) + start;
+      posn2[pind] = (pos2 - sieve) + start;
+   }
+}
+
+/*
+   Given the cofactor res > 1 left after trial division by the factor base,
+   check whether it is a large prime in (pmax, lp_bound] or, if two large
+   primes are allowed, a product of two such primes. If so, sets L1 and L2
+   to the large primes, with L2 = 1 for a single large prime, and returns
+   1, otherwise returns 0.
+*/
+static int
+_qsieve_large_primes(mp_limb_t * L1, mp_limb_t * L2, qs_t qs_inf, 
+                                                           const fmpz_t res)
+{
+   mp_limb_t pmax = qs_inf->factor_base[qs_inf->num_primes - 1].p;
+   mp_limb_t r, f;
+
+   if (fmpz_bits(res) > qs_inf->lp_bits)
+      return 0;
+
+   r = fmpz_get_ui(res);
+
+   if (r <= pmax) /* cannot be a prime outside the factor base */
+      return 0;
+
+   if (r <= qs_inf->lp_bound)
+   {
+      if (!n_is_prime(r))
+         return 0;
+
+      *L1 = r;
+
+      return 1;
+   }
+
+   if (!qs_inf->dlp || n_is_prime(r))
+      return 0;
+
+   f = n_factor_SQUFOF(r, 4096);
+
+   if (f == 0 || f == 1 || f == r)
+      return 0;
+
+   r /= f;
+
+   if (f <= pmax || f > qs_inf->lp_bound || r <= pmax || r > qs_inf->lp_bound
+      || f == r || !n_is_prime(f) || !n_is_prime(r))
+      return 0;
+
+   *L1 = FLINT_MAX(f, r);
+   *L2 = FLINT_MIN(f, r);
+
+   return 1;
+}
+
+/*
+   Check whether the entry at index i of the sieve interval, with sieve 
+   value sieve_bits, gives a relation, either full or partial, i.e. with
+   one or two large primes outside the factor base. Relations are stored in the buffer
+   of poly, which is inserted when full. Returns the number of new 
+   relations merged into the matrix.
+*/
+slong qsieve_evaluate_candidate(qs_t qs_inf, slong i, 
+                                 slong sieve_bits, qs_poly_t poly)
+{
+   slong bits, exp, extra_bits, found_bits;
+   mp_limb_t modp, prime, L1, L2;
+   slong num_primes = qs_inf->num_primes;
+   slong small_primes = qs_inf->small_primes;
+   prime_t * factor_base = qs_inf->factor_base;
+   fac_t * factor = poly->factor + poly->num_rels*qs_inf->max_factors;
+   mp_limb_t * soln1 = poly->soln1;
+   mp_limb_t * soln2 = poly->soln2;
+   mp_limb_t * A_ind = poly->A_ind;
+   slong * small = poly->small + poly->num_rels*small_primes;
+   int done;
+   mp_limb_t pinv;
+   slong num_factors = 0, num_small = 0;
+   slong relations = 0;
+   slong j;
+
+   fmpz_t X, Y, res, p;
+   fmpz_init(X); 
+   fmpz_init(Y); 
+   fmpz_init(res); 
+   fmpz_init(p); 
+
+   fmpz_set_si(X, i - qs_inf->sieve_size/2); /* X */
+
+#if (QS_DEBUG & 32)
+   printf("i = "); fmpz_print(X); printf("\n");
+#endif
+
+   fmpz_mul(Y, X, poly->A);
+   fmpz_add(Y, Y, poly->B); /* Y = AX + B */
+   fmpz_add(res, Y, poly->B);
+   fmpz_mul(res, res, X);
+   fmpz_add(res, res, poly->C); /* res = AX^2 + 2BX + C = (Y^2 - kn)/A */
+
+   if (fmpz_sgn(res) < 0) /* the sign is the factor base "prime" -1 */
+   {
+      fmpz_neg(res, res);
+      small[2] = 1;
+      num_small++;
+   } else
+      small[2] = 0;
+
+   bits = fmpz_bits(res);
+   bits -= BITS_ADJUST;
+   extra_bits = 0;
+
+   exp = fmpz_val2(res); /* divide out by powers of 2 */
+   fmpz_tdiv_q_2exp(res, res, exp);
+
+#if (QS_DEBUG & 8)
+   if (exp) printf("2^%ld ", exp);
+#endif
+
+   extra_bits += exp;
+   small[1] = exp;
+   if (exp) num_small++;
+
+   if (factor_base[0].p != 1) /* divide out powers of the multiplier */
+   {
+      fmpz_set_ui(p, factor_base[0].p);
+      exp = fmpz_remove(res, res, p);
+      if (exp) 
+      {
+         extra_bits += exp*qs_inf->factor_base[0].size;
+         num_small++;
+      }
+      small[0] = exp;
+
+#if (QS_DEBUG & 8)
+      if (exp) printf("%d^%ld ", factor_base[0].p, exp); 
+#endif
+   } else small[0] = 0;
+
+   for (j = QS_FB_START; j < small_primes; j++) /* pull out small primes */
+   {
+      prime = factor_base[j].p;
+      pinv = factor_base[j].pinv;
+      modp = n_mod2_preinv(i, prime, pinv);
+      if ((modp == soln1[j]) || (modp == soln2[j]))
+      {
+         fmpz_set_ui(p, prime);
+         exp = fmpz_remove(res, res, p);
+         if (exp) 
+         {
+            extra_bits += qs_inf->factor_base[j].size;
+            num_small++;
+         }
+         small[j] = exp;
+
+#if (QS_DEBUG & 8)
+         if (exp) 
+         {
+             fmpz_print(p);
+             printf("^%ld ", exp); 
+         }
+#endif
+      } else small[j] = 0;
+   }
+
+   sieve_bits -= qs_inf->sieve_fill;
+
+   if (extra_bits + sieve_bits > bits - qs_inf->lp_bits)
+   {
+      /* factors of A, which are not sieved with */
+      for (j = 0; j < qs_inf->s; j++)
+      {
+         fmpz_set_ui(p, factor_base[A_ind[j]].p);
+         exp = fmpz_remove(res, res, p);
+         factor[num_factors].ind = A_ind[j];
+         factor[num_factors++].exp = exp + 1; 
+
+#if (QS_DEBUG & 8)
+         fmpz_print(p);
+         printf("^%ld ", exp + 1); 
+#endif
+      }
+
+      /* pull out remaining primes, until all sieve contributions are found */
+      found_bits = 0;
+      for (j = small_primes; j < num_primes && found_bits < sieve_bits; j++) 
+      {
+         if (soln2[j] == -1) /* factor of A */
+            continue;
+
+         prime = factor_base[j].p;
+         pinv = factor_base[j].pinv;
+         modp = n_mod2_preinv(i, prime, pinv);
+
+         if ((modp == soln1[j]) || (modp == soln2[j]))
+         {
+            fmpz_set_ui(p, prime);
+            exp = fmpz_remove(res, res, p);
+#if (QS_DEBUG & 8)
+            if (exp) 
+            {
+                fmpz_print(p);
+                printf("^%ld ", exp); 
+            }
+#endif
+            if (exp) 
+            {
+               if (num_factors + num_small + 1 >= qs_inf->max_factors)
+                  goto cleanup; /* relation has too many factors to store */
+
+               found_bits += qs_inf->factor_base[j].size;
+               factor[num_factors].ind = j;
+               factor[num_factors++].exp = exp; 
+            }
+         }
+      }
+
+      L1 = L2 = 1;
+
+      if (!fmpz_is_one(res)) /* check for a partial relation */
+      {
+         if (!_qsieve_large_primes(&L1, &L2, qs_inf, res))
+            goto cleanup;
+      }
+
+      /* We've found a full or partial relation */
+      {
+         poly->num_factors[poly->num_rels] = num_factors;
+         poly->lp[2*poly->num_rels] = L1;
+         poly->lp[2*poly->num_rels + 1] = L2;
+         fmpz_set(poly->Y + poly->num_rels, Y);
+         poly->num_rels++;
+
+         if (poly->num_rels == QS_POLY_RELS) /* buffer is full */
+            relations += qsieve_insert_relations(qs_inf, poly, &done);
+      }
+   }
+
+#if (QS_DEBUG & 8)
+   printf("\n");
+#endif
+
+cleanup:
+   fmpz_clear(X);
+   fmpz_clear(Y);
+   fmpz_clear(res);
+   fmpz_clear(p);
+
+   return relations;
+}
+
+/*
+   Evaluate the candidates in the block [start, start + len) of the sieve 
+   interval, which has just been sieved into poly->sieve.
+*/
+slong qsieve_evaluate_sieve(qs_t qs_inf, qs_poly_t poly, 
+                                                 slong start, slong len)
+{
+   unsigned char * sieve = poly->sieve;
+   slong i = 0, j = 0;
+   ulong * sieve2 = (ulong *) sieve;
+   slong bits = qs_inf->sieve_bits;
+   slong rels = 0;
+
+#if (QS_DEBUG & 16)
+   slong stats_limit;
+   for (i = 0; i < 256; i++)
+       qs_inf->sieve_tally[i] = 0;
+#endif
+
+#if (QS_DEBUG & 4)
+   if (start == 0)
+   {
+      fmpz_print(poly->A); printf("X^2+2*");
+      fmpz_print(poly->B); printf("X+");
+      fmpz_print(poly->C); printf("\n");
+   }
+#endif
+
+   while (j < len/sizeof(ulong))
+   {
+       /* entries exceeding sieve_bits have the top bit set */
+#if FLINT64
+       while ((sieve2[j] & 0x8080808080808080UL) == 0) 
+#else
+       while ((sieve2[j] & 0x80808080UL) == 0) 
+#endif
+       {
+#if (QS_DEBUG & 16)
+           for (i = j*sizeof(ulong); i < (j+1)*sizeof(ulong) && i < len; i++)
+               qs_inf->sieve_tally[(int)sieve[i]]++;
+#endif
+           j++;
+       }
+
+       i = j*sizeof(ulong);
+
+       while (i < (j+1)*sizeof(ulong) && i < len)
+       {
+#if (QS_DEBUG & 16)
+           qs_inf->sieve_tally[(int)sieve[i]]++;
+#endif
+           if (sieve[i] > bits) 
+               rels += qsieve_evaluate_candidate(qs_inf, start + i, 
+                                                      sieve[i], poly);
+
+           i++;
+       }
+       j++;
+   }
+
+#if (QS_DEBUG & 16)
+   for (stats_limit = 255; stats_limit >= 0; stats_limit--)
+       if (qs_inf->sieve_tally[stats_limit] != 0)
+           break;
+
+   for (i = 0; i <= stats_limit; i++)
+   {
+       if ((i % 16) == 0)
+           printf("|%ld:", i);
+       printf(" %ld", qs_inf->sieve_tally[i]);
+   }
+   printf("|\n");
+   printf("Total of %ld relations for this sieve block\n", rels);
+#endif
+
+   return rels;
+}
+
+static void
+qsieve_update_offsets(int poly_add, mp_limb_t * poly_corr, 
+                                            qs_t qs_inf, qs_poly_t poly)
+{
+   slong num_primes = qs_inf->num_primes;
+   mp_limb_t * soln1 = poly->soln1;
+   mp_limb_t * soln2 = poly->soln2;
+   prime_t * factor_base = qs_inf->factor_base;
+   mp_limb_t p, correction;
+   slong pind;
+
+   for (pind = QS_FB_START; pind < num_primes; pind++) 
+   {
+      if (soln2[pind] == -1) continue; /* factor of A */
+
+      p = factor_base[pind].p;
+      correction = (poly_add ? p - poly_corr[pind] : poly_corr[pind]);
+      soln1[pind] += correction;
+      if (soln1[pind] >= p) soln1[pind] -= p;
+      soln2[pind] += correction;
+      if (soln2[pind] >= p) soln2[pind] -= p; 
+   }
+}  
+
+/*
+   Sieve the whole interval for the current polynomial, one block of at
+   most CACHE_SIZE bytes at a time, then insert the relations found. 
+   Sets done if enough relations have been found.
+*/
+static slong
+qsieve_sieve_poly(qs_t qs_inf, qs_poly_t poly, int * done)
+{
+   slong start, len, relations = 0;
+
+   for (start = 0; start < qs_inf->sieve_size; start += CACHE_SIZE)
+   {
+      len = FLINT_MIN(CACHE_SIZE, qs_inf->sieve_size - start);
+
+      qsieve_do_sieving(qs_inf, poly, start, len);
+
+      relations += qsieve_evaluate_sieve(qs_inf, poly, start, len);
+   }
+
+   relations += qsieve_insert_relations(qs_inf, poly, done);
+
+   return relations;
+}
+
+/*
+   Compute a new A coefficient and sieve with each of the 2^(s - 1) 
+   polynomials with that A, returning the number of new relations merged
+   into the matrix. Only the data in poly is written to, apart from the
+   insertion of relations and the choice of A, which are done under the
+   mutex. Thus several threads can collect relations at once, each with
+   its own poly.
+*/
+slong qsieve_collect_relations(qs_t qs_inf, qs_poly_t poly)
+{
+   slong s = qs_inf->s;
+   mp_limb_t ** A_inv2B = poly->A_inv2B;
+   fmpz * B_terms = poly->B_terms;
+
+   mp_limb_t * poly_corr;
+   slong relations = 0;
+   slong poly_index, j;
+   int poly_add, done = 0;
+
+   qsieve_compute_poly_data(qs_inf, poly);
+
+   for (poly_index = 1; poly_index < (1L<<(s - 1)); poly_index++)
+   {
+      for (j = 0; j < s; j++)
+         if (((poly_index >> j) & 1UL) != 0UL) break;
+
+      poly_add = ((poly_index >> j) & 2);
+
+      poly_corr = A_inv2B[j];
+
+      relations += qsieve_sieve_poly(qs_inf, poly, &done);
+
+      qsieve_update_offsets(poly_add, poly_corr, qs_inf, poly);
+
+      if (poly_add) 
+      {
+         fmpz_add(poly->B, poly->B, B_terms + j);
+         fmpz_add(poly->B, poly->B, B_terms + j);
+      } else
+      {
+         fmpz_sub(poly->B, poly->B, B_terms + j);
+         fmpz_sub(poly->B, poly->B, B_terms + j);
+      }
+
+      qsieve_compute_C(qs_inf, poly);
+
+      if (done)
+          break;
+   }
+
+   if (!done)
+       relations += qsieve_sieve_poly(qs_inf, poly, &done);
+
+   return relations;
+}
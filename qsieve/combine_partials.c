@@ -0,0 +1,259 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#undef ulong /* avoid clash with stdlib */
+#include <string.h>
+#include <stdlib.h>
+#define ulong mp_limb_t
+
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "qsieve.h"
+
+static int
+_qsieve_slong_cmp(const void * a, const void * b)
+{
+   slong x = *((slong *) a);
+   slong y = *((slong *) b);
+
+   return (x > y) - (x < y);
+}
+
+/*
+   Combine the cycles of partial relations found since the last call into
+   full relations and insert them into the matrix. Each partial relation 
+   which is not an edge of the spanning forest closes a cycle with the 
+   path in the forest between its vertices, which is found by breadth 
+   first search. Along a cycle every large prime occurs twice, so the 
+   product of the relations of the cycle, with Y divided by the large 
+   primes, is a full relation. Relations with too many factors to store 
+   are discarded. Returns the number of new relations merged into the 
+   matrix.
+*/
+slong qsieve_combine_partials(qs_t qs_inf)
+{
+   slong nv = qs_inf->num_vertices;
+   slong ne = qs_inf->num_partials;
+   slong * edge = qs_inf->partial_edge;
+   slong small_primes = qs_inf->small_primes;
+   slong target = qs_inf->num_primes + qs_inf->extra_rels;
+   slong * off, * adj, * par_v, * par_e, * depth, * queue;
+   slong * cycle, * exps, * touched;
+   slong relations = 0;
+   slong e, i, j, k, a, b, len, num_touched, fac_num, head, tail;
+   int odd;
+   fmpz_t Y, L;
+
+   /* adjacency lists of the forest */
+   off = flint_calloc(nv + 1, sizeof(slong));
+   adj = flint_malloc(2*ne*sizeof(slong));
+   par_v = flint_malloc(4*nv*sizeof(slong));
+   par_e = par_v + nv;
+   depth = par_e + nv;
+   queue = depth + nv;
+
+   for (e = 0; e < ne; e++)
+   {
+      if (qs_inf->partial_tree[e])
+      {
+         off[edge[2*e] + 1]++;
+         off[edge[2*e + 1] + 1]++;
+      }
+   }
+
+   for (i = 0; i < nv; i++)
+      off[i + 1] += off[i];
+
+   for (e = 0; e < ne; e++)
+   {
+      if (qs_inf->partial_tree[e])
+      {
+         adj[off[edge[2*e]]++] = e;
+         adj[off[edge[2*e + 1]]++] = e;
+      }
+   }
+
+   for (i = nv; i > 0; i--) /* restore offsets */
+      off[i] = off[i - 1];
+   off[0] = 0;
+
+   /* breadth first search, to find parents and depths in the forest */
+   for (i = 0; i < nv; i++)
+      depth[i] = -1;
+
+   for (i = 0; i < nv; i++)
+   {
+      if (depth[i] != -1)
+         continue;
+
+      depth[i] = 0;
+      par_v[i] = i;
+      par_e[i] = -1;
+      queue[0] = i;
+
+      for (head = 0, tail = 1; head < tail; head++)
+      {
+         a = queue[head];
+
+         for (j = off[a]; j < off[a + 1]; j++)
+         {
+            e = adj[j];
+            b = edge[2*e] ^ edge[2*e + 1] ^ a; /* other end of the edge */
+
+            if (depth[b] == -1)
+            {
+               depth[b] = depth[a] + 1;
+               par_v[b] = a;
+               par_e[b] = e;
+               queue[tail++] = b;
+            }
+         }
+      }
+   }
+
+   flint_free(adj);
+   flint_free(off);
+
+   /* combine the relations along each cycle */
+   cycle = flint_malloc((nv + 1)*sizeof(slong));
+   exps = flint_calloc(qs_inf->num_primes, sizeof(slong));
+   touched = flint_malloc(qs_inf->num_primes*sizeof(slong));
+
+   fmpz_init(Y);
+   fmpz_init(L);
+
+   for (e = qs_inf->partials_combined; e < ne; e++)
+   {
+      if (qs_inf->partial_tree[e])
+         continue;
+
+      if (qs_inf->columns >= target 
+       || qs_inf->num_relations >= qs_inf->buffer_size)
+         break;
+
+      a = edge[2*e];
+      b = edge[2*e + 1];
+      len = 0;
+      cycle[len++] = e;
+
+      /* product of the large primes of the cycle, each counted once */
+      fmpz_set_ui(L, qs_inf->vertex_prime[a]);
+      fmpz_mul_ui(L, L, qs_inf->vertex_prime[b]);
+
+      while (a != b)
+      {
+         if (depth[a] >= depth[b])
+         {
+            cycle[len++] = par_e[a];
+            a = par_v[a];
+            if (a != b)
+               fmpz_mul_ui(L, L, qs_inf->vertex_prime[a]);
+         } else
+         {
+            cycle[len++] = par_e[b];
+            b = par_v[b];
+            if (a != b)
+               fmpz_mul_ui(L, L, qs_inf->vertex_prime[b]);
+         }
+      }
+
+      /* sum the exponents and multiply the Y values */
+      num_touched = 0;
+      fmpz_one(Y);
+
+      for (i = 0; i < len; i++)
+      {
+         slong * data = qs_inf->partial_data + qs_inf->partial_off[cycle[i]];
+
+         for (j = 0; j < data[0]; j++)
+         {
+            k = data[2*j + 1];
+            if (exps[k] == 0)
+               touched[num_touched++] = k;
+            exps[k] += data[2*j + 2];
+         }
+
+         fmpz_mul(Y, Y, qs_inf->partial_Y + cycle[i]);
+         fmpz_mod(Y, Y, qs_inf->n);
+      }
+
+      qsort(touched, num_touched, sizeof(slong), _qsieve_slong_cmp);
+
+      for (i = 0; i < small_primes; i++)
+         qs_inf->small[i] = 0;
+
+      fac_num = 0;
+      odd = 0;
+      for (i = 0; i < num_touched; i++)
+      {
+         j = touched[i];
+
+         if (j < small_primes)
+            qs_inf->small[j] = exps[j];
+         else if (fac_num < qs_inf->max_factors)
+         {
+            qs_inf->factor[fac_num].ind = j;
+            qs_inf->factor[fac_num].exp = exps[j];
+            fac_num++;
+         }
+
+         odd |= (exps[j] & 1);
+         exps[j] = 0;
+      }
+
+      /* number of entries of the relation, as per qsieve_ll_insert_relation */
+      for (i = 0, j = fac_num; i < small_primes; i++)
+      {
+         if (qs_inf->small[i])
+            j++;
+      }
+
+      /* skip squares and relations with too many factors */
+      if (!odd || j >= qs_inf->max_factors)
+         continue;
+
+      fmpz_mod(L, L, qs_inf->n);
+      if (!fmpz_invmod(L, L, qs_inf->n))
+         continue;
+
+      fmpz_mul(Y, Y, L);
+      fmpz_mod(Y, Y, qs_inf->n);
+
+      qs_inf->num_factors = fac_num;
+      relations += qsieve_ll_insert_relation(qs_inf, Y);
+   }
+
+   relations += qsieve_ll_merge_relations(qs_inf);
+
+   fmpz_clear(Y);
+   fmpz_clear(L);
+
+   flint_free(cycle);
+   flint_free(exps);
+   flint_free(touched);
+   flint_free(par_v);
+
+   qs_inf->partials_combined = ne;
+   qs_inf->num_cycles = 0;
+
+   return relations;
+}
@@ -0,0 +1,211 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#undef ulong /* avoid clash with stdlib */
+#include <stdlib.h>
+#include <stdio.h>
+#define ulong mp_limb_t
+
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "qsieve.h"
+
+/*
+   Choose s distinct factor base primes whose product A is close to 
+   target_A. All but one of the primes are chosen at random from the 
+   range [low, high) and the final one is the factor base prime which 
+   brings the product closest to the target. The random state is shared
+   by all sieving threads, so the caller must hold the mutex.
+*/
+void qsieve_compute_A(qs_t qs_inf, qs_poly_t poly)
+{
+   slong s = qs_inf->s;
+   slong rand_factors = (s == 1 ? 1 : s - 1); /* factors chosen at random */
+   slong low = qs_inf->A_low;
+   slong span = qs_inf->A_high - qs_inf->A_low;
+   slong small_primes = qs_inf->small_primes;
+   slong num_primes = qs_inf->num_primes;
+   mp_limb_t * A_ind = poly->A_ind;
+   prime_t * factor_base = qs_inf->factor_base;
+   fmpz_t rem;
+   mp_limb_t q;
+   slong i, j, lo, hi, mid;
+
+   fmpz_init(rem);
+
+   while (1)
+   {
+      fmpz_one(poly->A);
+
+      for (i = 0; i < rand_factors; i++)
+      {
+         do
+         {
+            A_ind[i] = low + n_randint(qs_inf->state, span);
+            for (j = 0; j < i && A_ind[j] != A_ind[i]; j++) ;
+         } while (j < i);
+
+         fmpz_mul_ui(poly->A, poly->A, factor_base[A_ind[i]].p);
+      }
+
+      if (s == 1)
+         break;
+
+      /* size of the final factor, which must be in the factor base */
+      fmpz_cdiv_q(rem, qs_inf->target_A_mp, poly->A);
+      if (fmpz_cmp_ui(rem, factor_base[num_primes - 1].p) > 0 
+         || fmpz_cmp_ui(rem, factor_base[small_primes].p) < 0)
+         continue;
+
+      q = fmpz_get_ui(rem);
+
+      lo = small_primes;
+      hi = num_primes - 1;
+      while (lo < hi) /* find the first prime that is at least q */
+      {
+         mid = (lo + hi)/2;
+         if (factor_base[mid].p < q)
+            lo = mid + 1;
+         else
+            hi = mid;
+      }
+
+      if (lo > small_primes && q - factor_base[lo - 1].p < factor_base[lo].p - q)
+         lo--;
+
+      for (j = 0; j < s - 1 && A_ind[j] != lo; j++) ;
+      if (j < s - 1) /* final prime has already been used */
+         continue;
+
+      A_ind[s - 1] = lo;
+      fmpz_mul_ui(poly->A, poly->A, factor_base[lo].p);
+      break;
+   }
+
+   fmpz_clear(rem);
+
+#if (QS_DEBUG & 2)
+   printf("A = "); fmpz_print(poly->A); 
+   printf(", target A = "); fmpz_print(qs_inf->target_A_mp); printf("\n");
+#endif
+}
+
+void qsieve_compute_B_terms(qs_t qs_inf, qs_poly_t poly)
+{
+   slong s = qs_inf->s;
+   mp_limb_t * A_ind = poly->A_ind;
+   mp_limb_t * A_modp = poly->A_modp;
+   fmpz * A_divp = poly->A_divp;
+   fmpz * B_terms = poly->B_terms;
+   prime_t * factor_base = qs_inf->factor_base;
+   mp_limb_t p, temp, pinv;
+   slong i;
+
+   fmpz_zero(poly->B);
+
+   for (i = 0; i < s; i++)
+   {
+      p = factor_base[A_ind[i]].p;
+      pinv = factor_base[A_ind[i]].pinv;
+      fmpz_divexact_ui(A_divp + i, poly->A, p);
+      A_modp[i] = fmpz_fdiv_ui(A_divp + i, p);
+      temp = n_invmod(A_modp[i], p);
+      temp = n_mulmod2_preinv(temp, qs_inf->sqrts[A_ind[i]], p, pinv);
+      if (temp > p/2) temp = p - temp; /* take the smaller square root */
+      fmpz_mul_ui(B_terms + i, A_divp + i, temp);
+      fmpz_add(poly->B, poly->B, B_terms + i);
+   }
+}
+
+void qsieve_compute_off_adj(qs_t qs_inf, qs_poly_t poly)
+{
+   slong num_primes = qs_inf->num_primes;
+   mp_limb_t * A_inv = poly->A_inv;
+   mp_limb_t ** A_inv2B = poly->A_inv2B;
+   fmpz * B_terms = poly->B_terms;
+   mp_limb_t * soln1 = poly->soln1;
+   mp_limb_t * soln2 = poly->soln2;
+   int * sqrts = qs_inf->sqrts;
+   prime_t * factor_base = qs_inf->factor_base;
+   slong s = qs_inf->s;
+   mp_limb_t p, temp, pinv, b, M;
+   slong i, j;
+
+   for (i = QS_FB_START; i < num_primes; i++) /* skip k, 2 and -1 */
+   {
+      p = factor_base[i].p;
+      pinv = factor_base[i].pinv;
+
+      temp = fmpz_fdiv_ui(poly->A, p);
+      if (temp == 0) /* p is a factor of A, don't sieve with it */
+      {
+         soln1[i] = -1;
+         soln2[i] = -1;
+         continue;
+      }
+
+      A_inv[i] = n_invmod(temp, p);
+
+      for (j = 0; j < s; j++)
+      {
+         temp = fmpz_fdiv_ui(B_terms + j, p);
+         temp = n_mulmod2_preinv(temp, A_inv[i], p, pinv);
+         A_inv2B[j][i] = n_addmod(temp, temp, p);
+      }
+
+      /* roots of Q(x) are A^(-1)(+/-sqrt(kn) - B) + M mod p */
+      b = fmpz_fdiv_ui(poly->B, p);
+      M = n_mod2_preinv(qs_inf->sieve_size/2, p, pinv);
+
+      temp = n_submod(sqrts[i], b, p);
+      temp = n_mulmod2_preinv(temp, A_inv[i], p, pinv);
+      soln1[i] = n_addmod(temp, M, p);
+
+      temp = n_submod(p - sqrts[i], b, p);
+      temp = n_mulmod2_preinv(temp, A_inv[i], p, pinv);
+      soln2[i] = n_addmod(temp, M, p);
+   }
+}
+
+void qsieve_compute_C(qs_t qs_inf, qs_poly_t poly)
+{
+   fmpz_mul(poly->C, poly->B, poly->B);
+   fmpz_sub(poly->C, poly->C, qs_inf->kn);
+   fmpz_divexact(poly->C, poly->C, poly->A);
+}
+
+void qsieve_compute_poly_data(qs_t qs_inf, qs_poly_t poly)
+{
+#if HAVE_PTHREAD
+   pthread_mutex_lock(&qs_inf->mutex);
+#endif
+
+   qsieve_compute_A(qs_inf, poly);
+
+#if HAVE_PTHREAD
+   pthread_mutex_unlock(&qs_inf->mutex);
+#endif
+
+   qsieve_compute_B_terms(qs_inf, poly);
+   qsieve_compute_off_adj(qs_inf, poly);
+   qsieve_compute_C(qs_inf, poly);
+}
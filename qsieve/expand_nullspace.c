@@ -0,0 +1,84 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#undef ulong /* avoid clash with stdlib */
+#include <stdlib.h>
+#define ulong mp_limb_t
+
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "qsieve.h"
+
+/*
+   Given nullspace vectors nullrows of the ncols columns of the matrix 
+   computed by qsieve_filter_matrix, with rels[i] the relations summed in
+   column i, return the same vectors in terms of the relations. The 
+   columns of qs_inf->matrix are replaced by one column per relation, 
+   with the relation number in its orig field and no entries, as needed 
+   by qsieve_ll_square_root, and ncols is set to the number of them. The
+   entries of rels are freed.
+*/
+uint64_t * qsieve_expand_nullspace(qs_t qs_inf, uint64_t * nullrows, 
+                                               slong * ncols, la_col_t * rels)
+{
+   la_col_t * matrix = qs_inf->matrix;
+   slong * pos = flint_malloc(qs_inf->num_relations*sizeof(slong));
+   uint64_t * vecs;
+   slong i, k, r, num = 0, total = 0;
+
+   for (i = 0; i < *ncols; i++)
+      total += rels[i].weight;
+
+   vecs = flint_calloc(FLINT_MAX(total, 1), sizeof(uint64_t));
+
+   for (r = 0; r < qs_inf->num_relations; r++)
+      pos[r] = -1;
+
+   for (i = 0; i < *ncols; i++)
+   {
+      for (k = 0; k < rels[i].weight; k++)
+      {
+         r = rels[i].data[k];
+
+         if (pos[r] == -1)
+            pos[r] = num++;
+
+         vecs[pos[r]] ^= nullrows[i];
+      }
+
+      free_col(rels + i);
+      clear_col(rels + i);
+      free_col(matrix + i);
+      clear_col(matrix + i);
+   }
+
+   for (r = 0; r < qs_inf->num_relations; r++)
+   {
+      if (pos[r] != -1)
+         matrix[pos[r]].orig = r;
+   }
+
+   *ncols = num;
+
+   flint_free(pos);
+
+   return vecs;
+}
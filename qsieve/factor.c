@@ -0,0 +1,313 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#undef ulong /* avoid clash with stdlib */
+#include <stdio.h>
+#define ulong mp_limb_t
+
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "qsieve.h"
+#include "fmpz.h"
+#include "thread_pool.h"
+
+typedef struct
+{
+    qs_s * qs_inf;
+    qs_poly_s * poly;
+    slong rels;
+} _qsieve_collect_arg_struct;
+
+static void
+_qsieve_collect_worker(void * arg_ptr)
+{
+    _qsieve_collect_arg_struct * arg = (_qsieve_collect_arg_struct *) arg_ptr;
+
+    arg->rels = qsieve_collect_relations(arg->qs_inf, arg->poly);
+}
+
+/* 
+   Find a nontrivial factor of n, using the self-initialising quadratic 
+   sieve. Assumes n is odd, not prime and not a perfect power. Returns 1
+   and sets factor if a factor is found, otherwise returns 0. Partial
+   relations with two large primes are kept once kn has dlp_bits bits.
+*/
+int _qsieve_factor(fmpz_t factor, const fmpz_t n, mp_bitcnt_t dlp_bits)
+{
+    qs_t qs_inf;
+    mp_limb_t small_factor;
+    slong rels_found = 0;
+    _qsieve_collect_arg_struct * args;
+    slong ncols, nrows, i, count;
+    uint64_t * nullrows, * vecs;
+    la_col_t * rels;
+    uint64_t mask;
+    flint_rand_t state;
+    fmpz_t X, Y;
+    int found = 0;
+
+    /************************************************************************
+        INITIALISATION:
+
+        Initialise the qs_t structure. 
+    ************************************************************************/
+#if QS_DEBUG
+    printf("\nStart:\n");
+#endif
+
+    qsieve_init(qs_inf, n);
+    qs_inf->dlp_bits = dlp_bits;
+
+#if QS_DEBUG
+    printf("Factoring "); fmpz_print(n); printf(" of %ld bits\n", qs_inf->bits);
+#endif
+
+    /************************************************************************
+        KNUTH SCHROEPPEL:
+
+        Try to compute a multiplier k such that there are a lot of small primes
+        which are quadratic residues modulo kn. If a small factor of n is found
+        during this process it is returned.
+    ************************************************************************/
+#if QS_DEBUG
+    printf("\nKnuth-Schroeppel:\n");
+#endif
+
+    small_factor = qsieve_knuth_schroeppel(qs_inf); 
+    if (small_factor) 
+        goto small;
+
+    /* compute kn */
+    fmpz_mul_ui(qs_inf->kn, n, qs_inf->k);
+
+    /* refine qs_inf->bits */
+    qs_inf->bits = fmpz_bits(qs_inf->kn);
+
+    /************************************************************************
+        COMPUTE FACTOR BASE:
+
+        Compute the factor base primes and the sieve parameters. If a small 
+        factor of n is found during this process it is returned.
+    ************************************************************************/
+#if QS_DEBUG
+    printf("\nCompute factor base:\n");
+#endif
+
+    small_factor = qsieve_primes_init(qs_inf);
+    if (small_factor) 
+        goto small;
+
+    /************************************************************************
+        INITIALISE POLYNOMIAL AND RELATION/LINALG DATA:
+
+        Create space for all the polynomial, relations and matrix information
+    ************************************************************************/
+#if QS_DEBUG
+    printf("\nInitialise poly, relations and linear algebra:\n");
+#endif
+
+    qsieve_ll_linalg_init(qs_inf);
+
+    qsieve_partials_init(qs_inf);
+
+    qs_inf->num_handles = flint_request_threads(&qs_inf->handles, 
+                                                 flint_get_num_threads());
+
+    qsieve_poly_init(qs_inf);
+
+    /************************************************************************
+        SIEVE:
+
+        Sieve for relations. Each thread sieves with its own A coefficient,
+        roots and sieve block, merging relations under the mutex. Once the
+        full relations and the cycles among the partial relations suffice,
+        the partial relations are combined into full relations.
+    ************************************************************************/
+#if QS_DEBUG
+    printf("\nSieve:\n");
+#endif
+
+    args = flint_malloc((qs_inf->num_handles + 1)*sizeof(_qsieve_collect_arg_struct));
+
+    for (i = 0; i <= qs_inf->num_handles; i++)
+    {
+        args[i].qs_inf = qs_inf;
+        args[i].poly = qs_inf->poly + i;
+    }
+
+    while (rels_found < qs_inf->num_primes + qs_inf->extra_rels)
+    {
+        if (rels_found + qs_inf->num_cycles >= qs_inf->num_primes + qs_inf->extra_rels)
+        {
+            rels_found += qsieve_combine_partials(qs_inf);
+            continue;
+        }
+
+        for (i = 0; i < qs_inf->num_handles; i++)
+            thread_pool_wake(global_thread_pool, qs_inf->handles[i], 
+                                      _qsieve_collect_worker, args + i + 1);
+
+        _qsieve_collect_worker(args);
+
+        for (i = 0; i < qs_inf->num_handles; i++)
+            thread_pool_wait(global_thread_pool, qs_inf->handles[i]);
+
+        for (i = 0; i <= qs_inf->num_handles; i++)
+            rels_found += args[i].rels;
+
+        rels_found += qsieve_ll_merge_relations(qs_inf);
+
+#if (QS_DEBUG & 128)
+        printf("%ld/%ld relations, %ld partials, %ld cycles.\n", rels_found, 
+               qs_inf->num_primes + qs_inf->extra_rels, qs_inf->num_partials,
+               qs_inf->num_cycles);
+#endif
+    }
+
+    flint_free(args);
+
+    flint_give_back_threads(qs_inf->handles, qs_inf->num_handles);
+    qs_inf->handles = NULL;
+
+    /************************************************************************
+        FILTER MATRIX:
+
+        Remove singletons and cliques and merge rows of small weight, 
+        recording the relations making up each remaining column
+    ************************************************************************/
+
+    ncols = qs_inf->num_primes + qs_inf->extra_rels;
+    nrows = qs_inf->num_primes;
+
+#if QS_DEBUG
+    printf("Filter matrix:\n");
+#endif
+
+    rels = flint_malloc(ncols*sizeof(la_col_t));
+
+    qsieve_filter_matrix(qs_inf, &nrows, &ncols, qs_inf->matrix, rels); 
+
+    /************************************************************************
+        BLOCK LANCZOS:
+
+        Find extra_rels nullspace vectors (if they exist)
+    ************************************************************************/
+
+#if QS_DEBUG
+    printf("Block lanczos:\n");
+#endif
+
+    flint_randinit(state); /* initialise the random generator */
+
+    do /* repeat block lanczos until it succeeds */
+    {
+        nullrows = block_lanczos(state, nrows, 0, ncols, qs_inf->matrix);
+    } while (nullrows == NULL); 
+
+    /* express the nullspace vectors in terms of the relations */
+    vecs = qsieve_expand_nullspace(qs_inf, nullrows, &ncols, rels);
+    flint_free(nullrows);
+    flint_free(rels);
+    nullrows = vecs;
+
+    for (i = 0, mask = 0; i < ncols; i++) /* create mask of nullspace vectors */
+        mask |= nullrows[i];
+
+#if QS_DEBUG
+    for (i = count = 0; i < 64; i++) /* count nullspace vectors found */
+    {
+        if (mask & ((uint64_t)(1) << i))
+            count++;
+    }
+
+    printf("%ld nullspace vectors found\n", count);
+#endif
+
+    flint_randclear(state); /* clean up random state */
+
+    /************************************************************************
+        SQUARE ROOT:
+
+        Compute the square root and take the GCD of X-Y with N
+    ************************************************************************/
+
+#if QS_DEBUG
+    printf("Square root:\n");
+#endif
+
+    fmpz_init(X);
+    fmpz_init(Y);
+
+    for (count = 0; count < 64; count++)
+    {
+        if (mask & ((uint64_t)(1) << count))
+        {
+            qsieve_ll_square_root(X, Y, qs_inf, nullrows, ncols, count, qs_inf->n); 
+            fmpz_sub(X, X, Y);
+            fmpz_gcd(X, X, qs_inf->n);
+
+            if (fmpz_cmp(X, qs_inf->n) != 0 && !fmpz_is_one(X)) /* have a factor */
+            {
+                fmpz_set(factor, X);
+                found = 1;
+                break;
+            }
+        }
+    }
+
+    fmpz_clear(X);
+    fmpz_clear(Y);
+    flint_free(nullrows);
+
+    /************************************************************************
+        CLEAN UP:
+
+        Free all used memory
+    ************************************************************************/
+
+#if QS_DEBUG
+    printf("\nClean up:\n");
+#endif
+
+    qsieve_clear(qs_inf);
+
+#if QS_DEBUG
+    printf("\nDone.\n");
+#endif
+
+    return found;
+
+small:
+
+#if QS_DEBUG
+    printf("Found small factor %ld\n", small_factor);
+#endif
+
+    fmpz_set_ui(factor, small_factor);
+    qsieve_clear(qs_inf);
+
+    return 1;
+}
+
+int qsieve_factor(fmpz_t factor, const fmpz_t n)
+{
+    return _qsieve_factor(factor, n, QS_DLP_BITS);
+}
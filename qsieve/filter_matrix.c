@@ -0,0 +1,404 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#undef ulong /* avoid clash with stdlib */
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#define ulong mp_limb_t
+
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "qsieve.h"
+
+static int
+_qsieve_slong_cmp(const void * a, const void * b)
+{
+   slong x = *((slong *) a);
+   slong y = *((slong *) b);
+
+   return (x > y) - (x < y);
+}
+
+/* set c to c + p over GF(2), where both have sorted entries */
+static void
+_qsieve_col_add(la_col_t * c, la_col_t * p)
+{
+   slong * data = flint_malloc((c->weight + p->weight)*sizeof(slong));
+   slong i = 0, j = 0, k = 0;
+
+   while (i < c->weight && j < p->weight)
+   {
+      if (c->data[i] < p->data[j])
+         data[k++] = c->data[i++];
+      else if (c->data[i] > p->data[j])
+         data[k++] = p->data[j++];
+      else
+         i++, j++; /* entries cancel */
+   }
+
+   while (i < c->weight)
+      data[k++] = c->data[i++];
+
+   while (j < p->weight)
+      data[k++] = p->data[j++];
+
+   free_col(c);
+
+   if (k == 0)
+   {
+      flint_free(data);
+      clear_col(c);
+   } else
+   {
+      c->data = data;
+      c->weight = k;
+   }
+}
+
+/* delete column i, updating the row counts */
+static void
+_qsieve_kill_col(la_col_t * cols, la_col_t * rels, char * dead, 
+                                                    slong * counts, slong i)
+{
+   slong k;
+
+   for (k = 0; k < cols[i].weight; k++)
+      counts[cols[i].data[k]]--;
+
+   free_col(cols + i);
+   clear_col(cols + i);
+   free_col(rels + i);
+   clear_col(rels + i);
+   dead[i] = 1;
+}
+
+static int
+_qsieve_weight_cmp(const void * a, const void * b)
+{
+   slong x = ((la_col_t *) a)->weight;
+   slong y = ((la_col_t *) b)->weight;
+
+   return (x > y) - (x < y);
+}
+
+/*
+   Filter the nrows x ncols matrix given by cols, before block Lanczos.
+   Columns containing a singleton row are deleted. Excess columns, beyond
+   extra_rels more than the number of nonzero rows, are removed as 
+   cliques, i.e. pairs of columns sharing a row of weight 2, which frees
+   that row, and then by deleting the heaviest columns. Finally rows of 
+   small weight are merged away, by adding the lightest column containing 
+   the row to the others and deleting it, as long as this is expected to
+   reduce the cost of block Lanczos, which is roughly proportional to the
+   number of columns times the sum of the number of nonzero entries and 
+   QS_MERGE_DENSE_COST times the number of columns. Each step is iterated
+   to convergence.
+
+   On return rels[i] contains the relation numbers (the orig fields of 
+   the original columns) whose sum gives column i, ncols is updated and 
+   the rows are renumbered so that nrows of them are nonzero. The data 
+   of the deleted columns is freed.
+*/
+void qsieve_filter_matrix(qs_t qs_inf, slong * nrows, slong * ncols, 
+                                             la_col_t * cols, la_col_t * rels)
+{
+   slong n = *ncols, R = *nrows;
+   slong live_cols, live_rows, excess, weight, merges, c, i, j, k, r, p;
+   slong * counts, * off, * entries, * pair;
+   char * dead, * dirty;
+   la_col_t * sorted;
+   int changed;
+#if (QS_DEBUG & 128)
+   slong rows0, cols0, weight0;
+#endif
+
+   counts = flint_calloc(R, sizeof(slong));
+   dead = flint_calloc(n, sizeof(char));
+   dirty = flint_calloc(n, sizeof(char));
+   off = flint_malloc((R + 1)*sizeof(slong));
+
+   for (i = 0; i < n; i++)
+   {
+      qsort(cols[i].data, cols[i].weight, sizeof(slong), _qsieve_slong_cmp);
+
+      for (k = 0; k < cols[i].weight; k++)
+         counts[cols[i].data[k]]++;
+
+      rels[i].weight = 0;
+      insert_col_entry(rels + i, cols[i].orig);
+   }
+
+   live_cols = n;
+
+#if (QS_DEBUG & 128)
+   for (i = rows0 = 0; i < R; i++)
+      if (counts[i]) rows0++;
+   for (i = weight0 = 0; i < n; i++)
+      weight0 += cols[i].weight;
+   cols0 = n;
+#endif
+
+   do 
+   {
+      changed = 0;
+
+      /* delete columns containing a singleton row, to convergence */
+      do
+      {
+         c = live_cols;
+
+         for (i = 0; i < n; i++)
+         {
+            if (dead[i])
+               continue;
+
+            for (k = 0; k < cols[i].weight; k++)
+            {
+               if (counts[cols[i].data[k]] < 2)
+                  break;
+            }
+
+            if (k < cols[i].weight || cols[i].weight == 0)
+            {
+               _qsieve_kill_col(cols, rels, dead, counts, i);
+               live_cols--;
+            }
+         }
+      } while (c != live_cols);
+
+      for (i = live_rows = 0; i < R; i++)
+      {
+         if (counts[i])
+            live_rows++;
+      }
+
+      excess = live_cols - live_rows - qs_inf->extra_rels;
+
+      /* remove excess columns as cliques of two columns */
+      if (excess > 0)
+      {
+         pair = flint_malloc(2*R*sizeof(slong));
+
+         for (r = 0; r < 2*R; r++)
+            pair[r] = -1;
+
+         for (i = 0; i < n; i++)
+         {
+            if (dead[i])
+               continue;
+
+            for (k = 0; k < cols[i].weight; k++)
+            {
+               r = cols[i].data[k];
+               if (counts[r] == 2)
+                  pair[2*r + (pair[2*r] != -1)] = i;
+            }
+         }
+
+         for (r = 0; r < R && excess > 0; r++)
+         {
+            /* rows of weight 2 when the pairs were found */
+            if (pair[2*r + 1] != -1 && !dead[pair[2*r]] && !dead[pair[2*r + 1]])
+            {
+               _qsieve_kill_col(cols, rels, dead, counts, pair[2*r]);
+               _qsieve_kill_col(cols, rels, dead, counts, pair[2*r + 1]);
+               live_cols -= 2;
+               excess--;
+               changed = 1;
+            }
+         }
+
+         flint_free(pair);
+
+         if (changed)
+            continue;
+
+         /* no cliques left, delete the heaviest columns */
+         sorted = flint_malloc(live_cols*sizeof(la_col_t));
+
+         for (i = j = 0; i < n; i++)
+         {
+            if (!dead[i])
+            {
+               sorted[j].weight = cols[i].weight;
+               sorted[j++].orig = i;
+            }
+         }
+
+         qsort(sorted, live_cols, sizeof(la_col_t), _qsieve_weight_cmp);
+
+         for (j = live_cols - excess; j < live_cols; j++)
+            _qsieve_kill_col(cols, rels, dead, counts, sorted[j].orig);
+
+         live_cols -= excess;
+         changed = 1;
+
+         flint_free(sorted);
+
+         continue;
+      }
+
+      /* merge rows of small weight */
+      for (i = weight = 0; i < n; i++)
+         weight += cols[i].weight;
+
+      for (r = 0; r < R; r++)
+         off[r + 1] = (counts[r] >= 2 && counts[r] <= QS_MERGE_MAX_WEIGHT) 
+                    ? counts[r] : 0;
+
+      for (r = off[0] = 0; r < R; r++)
+         off[r + 1] += off[r];
+
+      entries = flint_malloc(off[R]*sizeof(slong));
+
+      for (i = 0; i < n; i++)
+      {
+         if (dead[i])
+            continue;
+
+         for (k = 0; k < cols[i].weight; k++)
+         {
+            r = cols[i].data[k];
+            if (counts[r] >= 2 && counts[r] <= QS_MERGE_MAX_WEIGHT)
+               entries[off[r]++] = i;
+         }
+      }
+
+      for (r = R; r > 0; r--) /* restore offsets */
+         off[r] = off[r - 1];
+      off[0] = 0;
+
+      memset(dirty, 0, n);
+      merges = 0;
+
+      for (c = 2; c <= QS_MERGE_MAX_WEIGHT; c++)
+      {
+         for (r = 0; r < R; r++)
+         {
+            if (off[r + 1] - off[r] != c)
+               continue;
+
+            /* columns changed in this pass have stale row lists */
+            for (k = off[r]; k < off[r + 1]; k++)
+            {
+               if (dirty[entries[k]])
+                  break;
+            }
+
+            if (k < off[r + 1])
+               continue;
+
+            p = entries[off[r]];
+            for (k = off[r] + 1; k < off[r + 1]; k++)
+            {
+               if (cols[entries[k]].weight < cols[p].weight)
+                  p = entries[k];
+            }
+
+            /* 
+               the merge removes a column and adds about c - 1 times the 
+               weight of the pivot, less the cancelled entries
+            */
+            if ((c - 1)*(cols[p].weight - 2)*live_cols 
+                   > weight + 2*QS_MERGE_DENSE_COST*live_cols)
+               continue;
+
+            for (k = off[r]; k < off[r + 1]; k++)
+            {
+               i = entries[k];
+               dirty[i] = 1;
+
+               if (i != p)
+               {
+                  weight -= cols[i].weight;
+                  _qsieve_col_add(cols + i, cols + p);
+                  _qsieve_col_add(rels + i, rels + p);
+                  weight += cols[i].weight;
+               }
+            }
+
+            weight -= cols[p].weight;
+            free_col(cols + p);
+            clear_col(cols + p);
+            free_col(rels + p);
+            clear_col(rels + p);
+            dead[p] = 1;
+            live_cols--;
+            merges++;
+         }
+      }
+
+      flint_free(entries);
+
+      if (merges)
+      {
+         /* recompute the row counts */
+         memset(counts, 0, R*sizeof(slong));
+         for (i = 0; i < n; i++)
+         {
+            for (k = 0; k < cols[i].weight; k++)
+               counts[cols[i].data[k]]++;
+         }
+
+         changed = 1;
+      }
+   } while (changed);
+
+   /* renumber the nonzero rows */
+   for (r = live_rows = 0; r < R; r++)
+      off[r] = counts[r] ? live_rows++ : -1;
+
+   /* move the remaining columns to the front */
+   for (i = j = 0; i < n; i++)
+   {
+      if (dead[i])
+         continue;
+
+      for (k = 0; k < cols[i].weight; k++)
+         cols[i].data[k] = off[cols[i].data[k]];
+
+      if (i != j)
+      {
+         copy_col(cols + j, cols + i);
+         copy_col(rels + j, rels + i);
+         clear_col(cols + i);
+         clear_col(rels + i);
+      }
+
+      j++;
+   }
+
+#if (QS_DEBUG & 128)
+   for (i = weight = 0; i < j; i++)
+      weight += cols[i].weight;
+   printf("filter %ld x %ld (weight %ld) to %ld x %ld (weight %ld)\n",
+          rows0, cols0, weight0, live_rows, j, weight);
+#endif
+
+   *nrows = live_rows;
+   *ncols = j;
+
+   flint_free(counts);
+   flint_free(dead);
+   flint_free(dirty);
+   flint_free(off);
+}
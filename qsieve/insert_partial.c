@@ -0,0 +1,195 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#undef ulong /* avoid clash with stdlib */
+#include <string.h>
+#include <stdlib.h>
+#define ulong mp_limb_t
+
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "qsieve.h"
+
+/* root of the tree of the union-find forest containing v */
+static slong
+_qsieve_find(slong * parent, slong v)
+{
+   while (parent[v] != v)
+   {
+      parent[v] = parent[parent[v]]; /* path halving */
+      v = parent[v];
+   }
+
+   return v;
+}
+
+static slong
+_qsieve_hash(mp_limb_t L, slong alloc)
+{
+   return ((L ^ (L >> 16))*2654435761UL) & (alloc - 1);
+}
+
+/* 
+   Return the vertex of the graph corresponding to the large prime L, 
+   adding a new vertex if L has not been seen before.
+*/
+static slong
+_qsieve_lp_vertex(qs_t qs_inf, mp_limb_t L)
+{
+   slong h, i, v;
+
+   h = _qsieve_hash(L, qs_inf->lp_hash_alloc);
+   while (qs_inf->lp_hash[h] != 0)
+   {
+      if (qs_inf->lp_hash[h] == L)
+         return qs_inf->lp_hash_vertex[h];
+
+      h = (h + 1) & (qs_inf->lp_hash_alloc - 1);
+   }
+
+   v = qs_inf->num_vertices;
+
+   if (v == qs_inf->vertices_alloc)
+   {
+      qs_inf->vertices_alloc *= 2;
+      qs_inf->vertex_prime = flint_realloc(qs_inf->vertex_prime, 
+                                   qs_inf->vertices_alloc*sizeof(mp_limb_t));
+      qs_inf->vertex_parent = flint_realloc(qs_inf->vertex_parent, 
+                                   qs_inf->vertices_alloc*sizeof(slong));
+   }
+
+   qs_inf->vertex_prime[v] = L;
+   qs_inf->vertex_parent[v] = v;
+   qs_inf->num_vertices++;
+
+   qs_inf->lp_hash[h] = L;
+   qs_inf->lp_hash_vertex[h] = v;
+
+   if (2*qs_inf->num_vertices > qs_inf->lp_hash_alloc) /* rehash */
+   {
+      qs_inf->lp_hash_alloc *= 2;
+      flint_free(qs_inf->lp_hash);
+      flint_free(qs_inf->lp_hash_vertex);
+      qs_inf->lp_hash = flint_calloc(qs_inf->lp_hash_alloc, sizeof(mp_limb_t));
+      qs_inf->lp_hash_vertex = flint_malloc(qs_inf->lp_hash_alloc*sizeof(slong));
+
+      for (i = 1; i < qs_inf->num_vertices; i++)
+      {
+         h = _qsieve_hash(qs_inf->vertex_prime[i], qs_inf->lp_hash_alloc);
+         while (qs_inf->lp_hash[h] != 0)
+            h = (h + 1) & (qs_inf->lp_hash_alloc - 1);
+
+         qs_inf->lp_hash[h] = qs_inf->vertex_prime[i];
+         qs_inf->lp_hash_vertex[h] = i;
+      }
+   }
+
+   return v;
+}
+
+/*
+   Store the partial relation given by Y and the factors in qs_inf->small 
+   and qs_inf->factor, whose cofactor is the product of the large primes 
+   L1 and L2 (with L2 = 1 for a single large prime). The relation is an 
+   edge joining the vertices of L1 and L2 in the graph of large primes. 
+   Using the union-find structure, the edge either joins two trees of a 
+   spanning forest of the graph, or closes a new cycle. Must be called 
+   under the mutex.
+*/
+void qsieve_insert_partial(qs_t qs_inf, fmpz_t Y, mp_limb_t L1, mp_limb_t L2)
+{
+   slong * small = qs_inf->small;
+   fac_t * factor = qs_inf->factor;
+   slong num = qs_inf->num_partials;
+   slong * data;
+   slong i, fac_num, u, v;
+
+   if (num == qs_inf->partials_alloc)
+   {
+      qs_inf->partials_alloc *= 2;
+      qs_inf->partial_off = flint_realloc(qs_inf->partial_off,
+                                    qs_inf->partials_alloc*sizeof(slong));
+      qs_inf->partial_edge = flint_realloc(qs_inf->partial_edge,
+                                    2*qs_inf->partials_alloc*sizeof(slong));
+      qs_inf->partial_tree = flint_realloc(qs_inf->partial_tree,
+                                    qs_inf->partials_alloc*sizeof(char));
+      qs_inf->partial_Y = flint_realloc(qs_inf->partial_Y,
+                                    qs_inf->partials_alloc*sizeof(fmpz));
+      for (i = num; i < qs_inf->partials_alloc; i++)
+         fmpz_init(qs_inf->partial_Y + i);
+   }
+
+   if (qs_inf->partial_len + 2*qs_inf->max_factors > qs_inf->partial_data_alloc)
+   {
+      qs_inf->partial_data_alloc *= 2;
+      qs_inf->partial_data = flint_realloc(qs_inf->partial_data,
+                                    qs_inf->partial_data_alloc*sizeof(slong));
+   }
+
+   /* factors in the format of a relation, as per qsieve_ll_insert_relation */
+   data = qs_inf->partial_data + qs_inf->partial_len;
+   fac_num = 0;
+
+   for (i = 0; i < qs_inf->small_primes; i++)
+   {
+      if (small[i])
+      {
+         data[2*fac_num + 1] = i;
+         data[2*fac_num + 2] = small[i];
+         fac_num++;
+      }
+   }
+
+   for (i = 0; i < qs_inf->num_factors; i++)
+   {
+      data[2*fac_num + 1] = factor[i].ind;
+      data[2*fac_num + 2] = factor[i].exp;
+      fac_num++;
+   }
+
+   data[0] = fac_num;
+
+   qs_inf->partial_off[num] = qs_inf->partial_len;
+   qs_inf->partial_len += 2*fac_num + 1;
+   fmpz_set(qs_inf->partial_Y + num, Y);
+
+   u = _qsieve_lp_vertex(qs_inf, L1);
+   v = (L2 == 1) ? 0 : _qsieve_lp_vertex(qs_inf, L2);
+
+   qs_inf->partial_edge[2*num] = u;
+   qs_inf->partial_edge[2*num + 1] = v;
+   qs_inf->num_partials++;
+
+   /* 
+      an edge joining two vertices of the same tree closes a cycle, 
+      otherwise it joins the trees and becomes an edge of the forest
+   */
+   u = _qsieve_find(qs_inf->vertex_parent, u);
+   v = _qsieve_find(qs_inf->vertex_parent, v);
+
+   qs_inf->partial_tree[num] = (u != v);
+
+   if (u == v)
+      qs_inf->num_cycles++;
+   else
+      qs_inf->vertex_parent[u] = v;
+}
@@ -0,0 +1,87 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#undef ulong /* avoid clash with stdlib */
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#define ulong mp_limb_t
+
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "qsieve.h"
+
+/*
+   Insert the relations buffered in poly into the matrix, under the mutex,
+   and empty the buffer. Partial relations are added to the graph of large
+   primes instead. Relations are discarded if enough have already been 
+   found. Sets done to 1 if enough relations and cycles of partial 
+   relations have been found, otherwise to 0. Returns the number of new relations merged into the
+   matrix.
+*/
+slong qsieve_insert_relations(qs_t qs_inf, qs_poly_t poly, int * done)
+{
+   slong small_primes = qs_inf->small_primes;
+   slong max_factors = qs_inf->max_factors;
+   slong target = qs_inf->num_primes + qs_inf->extra_rels;
+   slong relations = 0;
+   slong r;
+
+#if HAVE_PTHREAD
+   pthread_mutex_lock(&qs_inf->mutex);
+#endif
+
+   for (r = 0; r < poly->num_rels && qs_inf->columns < target; r++)
+   {
+      memcpy(qs_inf->small, poly->small + r*small_primes, 
+                                         small_primes*sizeof(slong));
+      memcpy(qs_inf->factor, poly->factor + r*max_factors, 
+                                   poly->num_factors[r]*sizeof(fac_t));
+      qs_inf->num_factors = poly->num_factors[r];
+
+      if (poly->lp[2*r] != 1)
+      {
+         qsieve_insert_partial(qs_inf, poly->Y + r, 
+                                       poly->lp[2*r], poly->lp[2*r + 1]);
+         continue;
+      }
+
+      relations += qsieve_ll_insert_relation(qs_inf, poly->Y + r);
+
+      if (qs_inf->num_relations >= qs_inf->buffer_size)
+      {
+         printf("Error: too many duplicate relations!\n");
+         printf("s = %ld, bits = %ld\n", qs_inf->s, qs_inf->bits);
+         abort();
+      }
+   }
+
+   poly->num_rels = 0;
+
+   *done = (qs_inf->columns + qs_inf->num_cycles >= target);
+
+#if HAVE_PTHREAD
+   pthread_mutex_unlock(&qs_inf->mutex);
+#endif
+
+   return relations;
+}
@@ -34,7 +34,8 @@ void qsieve_ll_linalg_init(qs_t qs_inf)
     slong i;
     
     qs_inf->extra_rels = 64; /* number of opportunities to factor n */
-    qs_inf->max_factors = 30; /* maximum number of factors a relation can have */
+    /* maximum number of factors a relation can have */
+    qs_inf->max_factors = 30 + qs_inf->s + qs_inf->small_primes;
 
     /* allow as many dups as relations */
     qs_inf->buffer_size = 2*(qs_inf->num_primes + qs_inf->extra_rels + qs_inf->qsort_rels);
@@ -0,0 +1,46 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+#include "qsieve.h"
+
+void qsieve_partials_clear(qs_t qs_inf)
+{
+   if (qs_inf->partial_Y == NULL)
+      return;
+
+   _fmpz_vec_clear(qs_inf->partial_Y, qs_inf->partials_alloc);
+   flint_free(qs_inf->partial_off);
+   flint_free(qs_inf->partial_edge);
+   flint_free(qs_inf->partial_tree);
+   flint_free(qs_inf->partial_data);
+   flint_free(qs_inf->lp_hash);
+   flint_free(qs_inf->lp_hash_vertex);
+   flint_free(qs_inf->vertex_prime);
+   flint_free(qs_inf->vertex_parent);
+
+   qs_inf->partial_Y = NULL;
+   qs_inf->num_partials = 0;
+   qs_inf->num_cycles = 0;
+}
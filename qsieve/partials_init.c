@@ -0,0 +1,63 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#undef ulong /* avoid clash with stdlib */
+#include <stdlib.h>
+#define ulong mp_limb_t
+
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+#include "qsieve.h"
+
+/*
+   Initialise an empty store of partial relations and an empty graph of 
+   large primes, consisting only of the vertex 0, which stands for the 
+   prime 1. Requires max_factors to have been computed.
+*/
+void qsieve_partials_init(qs_t qs_inf)
+{
+   qs_inf->partials_alloc = 1024;
+   qs_inf->partial_off = flint_malloc(qs_inf->partials_alloc*sizeof(slong));
+   qs_inf->partial_edge = flint_malloc(2*qs_inf->partials_alloc*sizeof(slong));
+   qs_inf->partial_tree = flint_malloc(qs_inf->partials_alloc*sizeof(char));
+   qs_inf->partial_Y = _fmpz_vec_init(qs_inf->partials_alloc);
+   qs_inf->num_partials = 0;
+   qs_inf->partials_combined = 0;
+
+   qs_inf->partial_data_alloc = 8*qs_inf->max_factors*qs_inf->partials_alloc;
+   qs_inf->partial_data = flint_malloc(qs_inf->partial_data_alloc*sizeof(slong));
+   qs_inf->partial_len = 0;
+
+   qs_inf->lp_hash_alloc = 2048;
+   qs_inf->lp_hash = flint_calloc(qs_inf->lp_hash_alloc, sizeof(mp_limb_t));
+   qs_inf->lp_hash_vertex = flint_malloc(qs_inf->lp_hash_alloc*sizeof(slong));
+
+   qs_inf->vertices_alloc = 1024;
+   qs_inf->vertex_prime = flint_malloc(qs_inf->vertices_alloc*sizeof(mp_limb_t));
+   qs_inf->vertex_parent = flint_malloc(qs_inf->vertices_alloc*sizeof(slong));
+   qs_inf->vertex_prime[0] = 1;
+   qs_inf->vertex_parent[0] = 0;
+   qs_inf->num_vertices = 1;
+
+   qs_inf->num_cycles = 0;
+}
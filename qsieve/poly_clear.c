@@ -0,0 +1,63 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+#include "qsieve.h"
+
+void qsieve_poly_clear(qs_t qs_inf)
+{
+   slong s = qs_inf->s;
+   slong i;
+
+   if (qs_inf->poly == NULL)
+      return;
+
+   for (i = 0; i <= qs_inf->num_handles; i++)
+   {
+      qs_poly_s * poly = qs_inf->poly + i;
+
+      fmpz_clear(poly->A);
+      fmpz_clear(poly->B);
+      fmpz_clear(poly->C);
+
+      flint_free(poly->A_ind);
+      _fmpz_vec_clear(poly->A_divp, s);
+      _fmpz_vec_clear(poly->B_terms, s);
+
+      flint_free(poly->A_inv);
+      flint_free(poly->A_inv2B[0]);
+      flint_free(poly->A_inv2B);
+
+      flint_free(poly->sieve);
+
+      flint_free(poly->small);
+      flint_free(poly->factor);
+      flint_free(poly->num_factors);
+      flint_free(poly->lp);
+      _fmpz_vec_clear(poly->Y, QS_POLY_RELS);
+   }
+
+   flint_free(qs_inf->poly);
+   qs_inf->poly = NULL;
+}
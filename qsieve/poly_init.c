@@ -0,0 +1,76 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+#include "qsieve.h"
+
+/* 
+   Allocate the polynomial data, roots, sieve block and relation buffer
+   for each of the num_handles + 1 sieving threads. Requires the factor
+   base and max_factors to have been computed.
+*/
+void qsieve_poly_init(qs_t qs_inf)
+{
+   slong num_primes = qs_inf->num_primes;
+   slong s = qs_inf->s; /* number of prime factors in A coeff */
+   slong num_polys = qs_inf->num_handles + 1;
+   slong i, j;
+
+   qs_inf->poly = flint_malloc(num_polys*sizeof(qs_poly_s));
+
+   for (i = 0; i < num_polys; i++)
+   {
+      qs_poly_s * poly = qs_inf->poly + i;
+
+      fmpz_init(poly->A);
+      fmpz_init(poly->B);
+      fmpz_init(poly->C);
+
+      poly->A_ind = flint_malloc(2*s*sizeof(mp_limb_t));
+      poly->A_modp = poly->A_ind + s;
+      poly->A_divp = _fmpz_vec_init(s);
+      poly->B_terms = _fmpz_vec_init(s);
+
+      poly->A_inv = flint_malloc(5*num_primes*sizeof(mp_limb_t));
+      poly->soln1 = poly->A_inv + num_primes;
+      poly->soln2 = poly->soln1 + num_primes;
+      poly->posn1 = poly->soln2 + num_primes;
+      poly->posn2 = poly->posn1 + num_primes;
+
+      poly->A_inv2B = flint_malloc(s*sizeof(mp_limb_t *));
+      poly->A_inv2B[0] = flint_malloc(num_primes*s*sizeof(mp_limb_t));
+      for (j = 1; j < s; j++)
+         poly->A_inv2B[j] = poly->A_inv2B[j - 1] + num_primes;
+
+      /* extra limb is a sentinel for evaluate_sieve */
+      poly->sieve = flint_malloc(CACHE_SIZE + sizeof(ulong));
+
+      poly->small = flint_malloc(QS_POLY_RELS*qs_inf->small_primes*sizeof(slong));
+      poly->factor = flint_malloc(QS_POLY_RELS*qs_inf->max_factors*sizeof(fac_t));
+      poly->num_factors = flint_malloc(QS_POLY_RELS*sizeof(slong));
+      poly->lp = flint_malloc(2*QS_POLY_RELS*sizeof(mp_limb_t));
+      poly->Y = _fmpz_vec_init(QS_POLY_RELS);
+      poly->num_rels = 0;
+   }
+}
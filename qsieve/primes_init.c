@@ -0,0 +1,223 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "qsieve.h"
+
+static prime_t *
+qsieve_compute_factor_base(mp_limb_t * small_factor, qs_t qs_inf, slong num_primes)
+{
+    mp_limb_t p, nmod, nmod2;
+    mp_limb_t pinv;
+    mp_limb_t k = qs_inf->k;
+    slong num = qs_inf->num_primes;
+    slong fb_prime;
+    prime_t * factor_base;
+    int * sqrts;
+    int kron;
+
+    /* (re)allocate space for factor base */
+    if (num == 0)
+        factor_base = (prime_t *) flint_malloc(num_primes*sizeof(prime_t));
+    else
+        factor_base = (prime_t *) flint_realloc(qs_inf->factor_base, 
+                                          num_primes*sizeof(prime_t));
+    qs_inf->factor_base = factor_base;
+
+    /* allocate space for square roots kn mod factor base primes */
+    if (num == 0)
+        sqrts = flint_malloc(sizeof(int)*num_primes);
+    else
+        sqrts = flint_realloc(qs_inf->sqrts, sizeof(int)*num_primes);
+    qs_inf->sqrts = sqrts;
+
+    qs_inf->num_primes = num_primes;
+
+    if (num == 0) /* leave space for k, 2 and -1 */
+    {
+        p = 2;
+        num = QS_FB_START;
+    } else
+        p = factor_base[num - 1].p;
+
+    for (fb_prime = num; fb_prime < num_primes; )
+    {
+        p = n_nextprime(p, 0);
+        pinv = n_preinvert_limb(p);
+        nmod = fmpz_fdiv_ui(qs_inf->n, p); /* n mod p */
+        if (nmod == 0) 
+        {
+            *small_factor = p;
+            return factor_base;
+        }
+
+        nmod2 = n_mulmod2_preinv(nmod, k, p, pinv); /* kn mod p */
+        if (nmod2 == 0) /* don't sieve with factors of multiplier */
+            continue;
+
+        nmod = nmod2; /* save nmod2 */
+
+        kron = 1; /* n mod p is even, not handled by n_jacobi */
+        while ((nmod2 % 2) == 0) 
+        {
+            if ((p % 8) == 3 || (p % 8) == 5) kron *= -1;
+            nmod2 /= 2;
+        }
+
+        kron *= n_jacobi(nmod2, p); 
+        if (kron == 1) /* kn is a quadratic residue mod p (and hence a FB prime) */
+        {
+            factor_base[fb_prime].p = p;
+            factor_base[fb_prime].pinv = pinv;
+            factor_base[fb_prime].size = FLINT_BIT_COUNT(p);
+            sqrts[fb_prime] = n_sqrtmod(nmod, p);
+            fb_prime++;
+        }
+    }
+
+    *small_factor = 0;
+    return factor_base;
+}
+
+/*
+   Compute the factor base, the sieve parameters and the range of factor
+   base primes from which the factors of the A coefficients are chosen.
+   If a small factor of n is found it is returned, otherwise zero is 
+   returned.
+*/
+mp_limb_t qsieve_primes_init(qs_t qs_inf)
+{
+    slong num_primes;
+    slong i, s, fact, span, M, T;
+    fmpz_t temp;
+    mp_limb_t k = qs_inf->k;
+    mp_limb_t small_factor = 0;
+
+    prime_t * factor_base;
+
+    /* determine which index in the tuning table n corresponds to */
+    for (i = 1; i < QS_TUNE_SIZE; i++)
+    {
+        if (qsieve_tune[i][0] > qs_inf->bits)
+            break;
+    }
+    i--;
+
+    qs_inf->sieve_size = qsieve_tune[i][4]; /* size of sieve to use */
+    qs_inf->small_primes = qsieve_tune[i][3]; /* number of primes to not sieve with */
+    num_primes = qsieve_tune[i][2]; /* number of factor base primes */
+    qs_inf->qsort_rels = qsieve_tune[i][1]; /* number of relations to accumulate before sorting */
+
+    M = qs_inf->sieve_size/2;
+
+    qs_inf->num_primes = 0; /* start with 0 primes */
+    factor_base = qsieve_compute_factor_base(&small_factor, qs_inf, num_primes); /* build up FB */
+    if (small_factor)
+        return small_factor;
+
+    fmpz_init(temp);
+
+    /* A should be about sqrt(2kn)/M */
+    fmpz_mul_2exp(temp, qs_inf->kn, 1);
+    fmpz_sqrt(temp, temp);
+    fmpz_tdiv_q_ui(qs_inf->target_A_mp, temp, M);
+
+    /* number of prime factors of A, each of roughly 11 bits */
+    s = (fmpz_bits(qs_inf->target_A_mp) + 5)/11;
+    if (s < 1)
+        s = 1;
+
+    fmpz_root(temp, qs_inf->target_A_mp, s);
+
+    while (1)
+    {
+        fact = QS_FB_START;
+        while (fact < num_primes && fmpz_cmp_ui(temp, factor_base[fact].p) > 0)
+            fact++;
+
+        span = num_primes/s/s/2;
+        if (span < 6*s + 16) span = 6*s + 16; /* make sure we have plenty of primes to choose from */
+
+        qs_inf->A_low = fact - span/2;
+        if (qs_inf->A_low < qs_inf->small_primes) 
+            qs_inf->A_low = qs_inf->small_primes;
+
+        qs_inf->A_high = qs_inf->A_low + span;
+        if (qs_inf->A_high <= num_primes - 2) /* we have enough primes */
+            break;
+
+        num_primes = (slong) (1.1 * (double) num_primes);
+        factor_base = qsieve_compute_factor_base(&small_factor, qs_inf, num_primes); /* increase size of FB */
+        if (small_factor)
+        {
+            fmpz_clear(temp);
+            return small_factor;
+        }
+    }
+
+    fmpz_clear(temp);
+
+    qs_inf->s = s;
+
+    /*
+       Sieve entries start at sieve_fill and have the logarithms of the 
+       sieve primes added. An entry exceeding sieve_bits is a candidate.
+       The threshold is the size of Q(x)/A near the ends of the interval, 
+       less an allowance for the primes we don't sieve with, rounding 
+       and the fact that |Q(x)/A| is usually smaller than its maximum.
+       It is lowered further so that partial relations with a single
+       large prime are found by the sieve. Partial relations with two large
+       primes are only looked for among the same candidates.
+    */
+    qs_inf->lp_bound = QS_LP_MULT*factor_base[num_primes - 1].p;
+    if (qs_inf->lp_bound > (1UL << (FLINT_BITS/2 - 1)))
+       qs_inf->lp_bound = (1UL << (FLINT_BITS/2 - 1));
+    qs_inf->dlp = (qs_inf->bits >= qs_inf->dlp_bits);
+    qs_inf->lp_bits = FLINT_BIT_COUNT(qs_inf->lp_bound);
+
+    T = FLINT_BIT_COUNT(M) + (qs_inf->bits - 1)/2
+      - qs_inf->lp_bits - qs_inf->small_primes;
+
+    if (qs_inf->dlp)
+       qs_inf->lp_bits *= 2;
+    qs_inf->sieve_fill = FLINT_MAX(0, 127 - T);
+    qs_inf->sieve_bits = T + qs_inf->sieve_fill;
+
+#if (QS_DEBUG & 2)
+    printf("Using %ld factor base primes\n", qs_inf->num_primes);
+    printf("low = FB[%ld], high = FB[%ld], number of A factors = %ld, target A = ", 
+           qs_inf->A_low, qs_inf->A_high, s);
+    fmpz_print(qs_inf->target_A_mp); printf("\n");
+#endif
+
+    /* consider k, 2 and -1 as factor base primes */
+    factor_base[0].p = k;
+    factor_base[0].pinv = n_preinvert_limb(k);
+    factor_base[0].size = FLINT_BIT_COUNT(k);
+    factor_base[1].p = 2;
+    factor_base[1].size = 2;
+    factor_base[2].p = 1; /* -1 contributes nothing to the square root */
+    factor_base[2].size = 0;
+
+    return 0;
+}
@@ -0,0 +1,142 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "qsieve.h"
+
+void randprime(fmpz_t p, flint_rand_t state, mp_bitcnt_t bits)
+{
+   do
+   {
+      fmpz_randbits(p, state, bits);
+      fmpz_abs(p, p);
+   } while (!fmpz_is_probabprime(p));
+}
+
+int main(void)
+{
+   int i, result;
+   flint_rand_t state;
+   fmpz_t n, p, q, f;
+
+   printf("factor....");
+   fflush(stdout);
+
+   flint_randinit(state);
+
+   fmpz_init(n);
+   fmpz_init(p);
+   fmpz_init(q);
+   fmpz_init(f);
+
+   for (i = 0; i < 20; i++) /* Test random n = p*q */
+   {
+      mp_bitcnt_t bits = n_randint(state, 40) + 36;
+
+      do
+      {
+         randprime(p, state, bits);
+         randprime(q, state, bits + n_randint(state, 10));
+      } while (fmpz_equal(p, q));
+
+      fmpz_mul(n, p, q);
+
+      flint_set_num_threads(1 + n_randint(state, 4));
+
+      result = qsieve_factor(f, n);
+
+      result = result && fmpz_divisible(n, f) && !fmpz_is_one(f) 
+                      && !fmpz_equal(f, n);
+      if (!result)
+      {
+          printf("FAIL:\n");
+          fmpz_print(n); printf(" = "); fmpz_print(p); printf(" * ");
+          fmpz_print(q); printf("\n");
+          printf("f = "); fmpz_print(f); printf("\n");
+          abort();
+      }
+   }
+
+   /* Test the double large prime variation, forcing it on small n */
+   for (i = 0; i < 10; i++)
+   {
+      mp_bitcnt_t bits = n_randint(state, 30) + 50;
+
+      do
+      {
+         randprime(p, state, bits);
+         randprime(q, state, bits + n_randint(state, 10));
+      } while (fmpz_equal(p, q));
+
+      fmpz_mul(n, p, q);
+
+      flint_set_num_threads(1 + n_randint(state, 4));
+
+      result = _qsieve_factor(f, n, 0);
+
+      result = result && fmpz_divisible(n, f) && !fmpz_is_one(f) 
+                      && !fmpz_equal(f, n);
+      if (!result)
+      {
+          printf("FAIL (dlp):\n");
+          fmpz_print(n); printf(" = "); fmpz_print(p); printf(" * ");
+          fmpz_print(q); printf("\n");
+          printf("f = "); fmpz_print(f); printf("\n");
+          abort();
+      }
+   }
+
+   flint_set_num_threads(1);
+
+   for (i = 0; i < 5; i++) /* Test n with three factors */
+   {
+      fmpz_set_ui(n, n_randprime(state, 20 + n_randint(state, 20), 0));
+      fmpz_mul_ui(n, n, n_randprime(state, 30, 0));
+      randprime(p, state, 40);
+      fmpz_mul(n, n, p);
+
+      result = qsieve_factor(f, n);
+
+      result = result && fmpz_divisible(n, f) && !fmpz_is_one(f) 
+                      && !fmpz_equal(f, n);
+      if (!result)
+      {
+          printf("FAIL:\n");
+          printf("n = "); fmpz_print(n); printf("\n");
+          printf("f = "); fmpz_print(f); printf("\n");
+          abort();
+      }
+   }
+
+   fmpz_clear(n);
+   fmpz_clear(p);
+   fmpz_clear(q);
+   fmpz_clear(f);
+
+   flint_randclear(state);
+   flint_cleanup();
+   printf("PASS\n");
+   return 0;
+}
@@ -0,0 +1,237 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+
+static size_t hook_allocs = 0;
+static size_t hook_frees = 0;
+
+static void * hook_malloc(size_t size)
+{
+   hook_allocs++;
+   return malloc(size);
+}
+
+static void * hook_calloc(size_t num, size_t size)
+{
+   hook_allocs++;
+   return calloc(num, size);
+}
+
+static void * hook_realloc(void * ptr, size_t size)
+{
+   return realloc(ptr, size);
+}
+
+static void hook_free(void * ptr)
+{
+   hook_frees++;
+   free(ptr);
+}
+
+int main(void)
+{
+   int i, j, result;
+   flint_rand_t state;
+   flint_memory_stats_t stats;
+   void * (* alloc_func)(size_t);
+   void * (* calloc_func)(size_t, size_t);
+   void * (* realloc_func)(void *, size_t);
+   void (* free_func)(void *);
+
+   flint_randinit(state);
+
+   printf("memory_manager....");
+   fflush(stdout);
+
+   /* allocator hooks and counters */
+   __flint_get_memory_functions(&alloc_func, &calloc_func, 
+                                &realloc_func, &free_func);
+   __flint_set_memory_functions(hook_malloc, hook_calloc, 
+                                hook_realloc, hook_free);
+   flint_reset_memory_stats();
+
+   for (i = 0; i < 1000; i++)
+   {
+      size_t size = n_randint(state, 1000) + 1;
+      unsigned char * p = flint_malloc(size);
+      unsigned char * q = flint_calloc(size, 1);
+
+      for (j = 0; j < size; j++)
+      {
+         if (q[j] != 0)
+         {
+            printf("FAIL:\n");
+            printf("flint_calloc did not zero memory\n");
+            abort();
+         }
+         p[j] = (unsigned char) j;
+      }
+
+      p = flint_realloc(p, 2*size);
+
+      for (j = 0; j < size; j++)
+      {
+         if (p[j] != (unsigned char) j)
+         {
+            printf("FAIL:\n");
+            printf("flint_realloc did not preserve data\n");
+            abort();
+         }
+      }
+
+      flint_free(p);
+      flint_free(q);
+   }
+
+   flint_get_memory_stats(stats);
+
+   result = (hook_allocs == 2000 && hook_frees == 2000 
+          && stats->num_allocs == 2000 && stats->num_reallocs == 1000 
+          && stats->num_frees == 2000);
+   if (!result)
+   {
+      printf("FAIL:\n");
+      printf("hook_allocs = %lu, hook_frees = %lu\n", 
+             (ulong) hook_allocs, (ulong) hook_frees);
+      printf("num_allocs = %lu, num_reallocs = %lu, num_frees = %lu\n", 
+             (ulong) stats->num_allocs, (ulong) stats->num_reallocs, 
+             (ulong) stats->num_frees);
+      abort();
+   }
+
+   __flint_set_memory_functions(alloc_func, calloc_func, 
+                                realloc_func, free_func);
+
+   /* nested stack regions */
+   for (i = 0; i < 1000; i++)
+   {
+      mp_ptr a, b, c;
+      slong na = n_randint(state, 10000) + 1;
+      slong nb = n_randint(state, 100000) + 1;
+      slong nc = n_randint(state, 100) + 1;
+      flint_stack_mark_t mark;
+      TMP_INIT;
+
+      TMP_START;
+
+      a = TMP_ALLOC(na*sizeof(mp_limb_t));
+      for (j = 0; j < na; j++)
+         a[j] = j;
+
+      mark = flint_stack_get_mark();
+
+      b = flint_stack_alloc(nb*sizeof(mp_limb_t));
+      c = flint_stack_alloc(nc*sizeof(mp_limb_t));
+      for (j = 0; j < nb; j++)
+         b[j] = -j;
+      for (j = 0; j < nc; j++)
+         c[j] = 2*j;
+
+      if (((ulong) b) % sizeof(mp_limb_t) != 0 
+          || ((ulong) c) % sizeof(mp_limb_t) != 0)
+      {
+         printf("FAIL:\n");
+         printf("stack allocation not aligned\n");
+         abort();
+      }
+
+      flint_stack_release(mark);
+
+      b = TMP_ALLOC(nb*sizeof(mp_limb_t));
+      for (j = 0; j < nb; j++)
+         b[j] = 3*j;
+
+      for (j = 0; j < na; j++)
+      {
+         if (a[j] != j)
+         {
+            printf("FAIL:\n");
+            printf("stack allocation overwritten\n");
+            abort();
+         }
+      }
+
+      TMP_END;
+   }
+
+   /* a loop of identical regions allocates no blocks after the first */
+   flint_reset_memory_stats();
+
+   for (i = 0; i < 100; i++)
+   {
+      mp_ptr a, b;
+      TMP_INIT;
+
+      TMP_START;
+      a = TMP_ALLOC(10000*sizeof(mp_limb_t));
+      b = TMP_ALLOC(20000*sizeof(mp_limb_t));
+      a[0] = b[0] = 0;
+      TMP_END;
+   }
+
+   flint_get_memory_stats(stats);
+
+   result = (stats->num_allocs <= 2 && stats->num_stack_allocs == 200
+          && stats->stack_peak >= 30000*sizeof(mp_limb_t));
+   if (!result)
+   {
+      printf("FAIL:\n");
+      printf("num_allocs = %lu, num_stack_allocs = %lu, stack_peak = %lu\n", 
+             (ulong) stats->num_allocs, (ulong) stats->num_stack_allocs, 
+             (ulong) stats->stack_peak);
+      abort();
+   }
+
+   /* large blocks are not kept after the stack is released */
+   flint_reset_memory_stats();
+
+   for (i = 0; i < 10; i++)
+   {
+      mp_ptr a;
+      TMP_INIT;
+
+      TMP_START;
+      a = TMP_ALLOC(1000000*sizeof(mp_limb_t));
+      a[0] = 0;
+      TMP_END;
+   }
+
+   flint_get_memory_stats(stats);
+
+   result = (stats->num_allocs == 10 && stats->num_frees == 10);
+   if (!result)
+   {
+      printf("FAIL:\n");
+      printf("num_allocs = %lu, num_frees = %lu\n", 
+             (ulong) stats->num_allocs, (ulong) stats->num_frees);
+      abort();
+   }
+
+   flint_randclear(state);
+   flint_cleanup();
+
+   printf("PASS\n");
+   return 0;
+}
@@ -0,0 +1,113 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#undef ulong /* interferes with system includes */
+#include <stdlib.h>
+#define ulong mp_limb_t
+
+#include "flint.h"
+
+#if HAVE_PTHREAD
+#undef ulong
+#include <pthread.h>
+#define ulong mp_limb_t
+#endif
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+typedef struct
+{
+#if HAVE_PTHREAD
+    pthread_t pth;
+    pthread_mutex_t mutex;
+    pthread_cond_t sleep1;   /* signalled when work arrives */
+    pthread_cond_t sleep2;   /* signalled when work is done */
+#endif
+    volatile int available;
+    volatile int working;
+    volatile int exit;
+    void (* volatile fxn)(void *);
+    void * volatile fxnarg;
+}
+thread_pool_entry_struct;
+
+typedef thread_pool_entry_struct thread_pool_entry_t[1];
+
+typedef struct
+{
+#if HAVE_PTHREAD
+    pthread_mutex_t mutex;
+#endif
+    slong length;
+    thread_pool_entry_struct * tdata;
+}
+thread_pool_struct;
+
+typedef thread_pool_struct thread_pool_t[1];
+
+typedef slong thread_pool_handle;
+
+extern thread_pool_t global_thread_pool;
+extern int global_thread_pool_initialized;
+
+/* Memory management *********************************************************/
+
+void _thread_pool_start_workers(thread_pool_t T, slong size);
+
+void _thread_pool_stop_workers(thread_pool_t T);
+
+void thread_pool_init(thread_pool_t T, slong size);
+
+void thread_pool_clear(thread_pool_t T);
+
+slong thread_pool_get_size(thread_pool_t T);
+
+int thread_pool_set_size(thread_pool_t T, slong new_size);
+
+/* Scheduling ****************************************************************/
+
+slong thread_pool_request(thread_pool_t T,
+                          thread_pool_handle * out, slong requested);
+
+void thread_pool_wake(thread_pool_t T, thread_pool_handle i,
+                      void (*f)(void *), void * a);
+
+void thread_pool_wait(thread_pool_t T, thread_pool_handle i);
+
+void thread_pool_give_back(thread_pool_t T, thread_pool_handle i);
+
+void * _thread_pool_idle_loop(void * varg);
+
+/* Interface to the global pool **********************************************/
+
+slong flint_request_threads(thread_pool_handle ** handles, slong thread_limit);
+
+void flint_give_back_threads(thread_pool_handle * handles, slong num_handles);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
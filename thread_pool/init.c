@@ -0,0 +1,63 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include "thread_pool.h"
+
+void _thread_pool_start_workers(thread_pool_t T, slong size)
+{
+#if HAVE_PTHREAD
+    slong i;
+
+    T->length = FLINT_MAX(size, 0);
+    T->tdata = NULL;
+
+    if (T->length == 0)
+        return;
+
+    T->tdata = flint_malloc(sizeof(thread_pool_entry_struct) * T->length);
+
+    for (i = 0; i < T->length; i++)
+    {
+        thread_pool_entry_struct * D = T->tdata + i;
+
+        pthread_mutex_init(&D->mutex, NULL);
+        pthread_cond_init(&D->sleep1, NULL);
+        pthread_cond_init(&D->sleep2, NULL);
+        D->available = 1;
+        D->working = 0;
+        D->exit = 0;
+        D->fxn = NULL;
+        D->fxnarg = NULL;
+
+        pthread_create(&D->pth, NULL, _thread_pool_idle_loop, D);
+    }
+#else
+    T->length = 0;
+    T->tdata = NULL;
+#endif
+}
+
+void thread_pool_init(thread_pool_t T, slong size)
+{
+#if HAVE_PTHREAD
+    pthread_mutex_init(&T->mutex, NULL);
+#endif
+    _thread_pool_start_workers(T, size);
+}
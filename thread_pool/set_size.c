@@ -0,0 +1,56 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include "thread_pool.h"
+
+int thread_pool_set_size(thread_pool_t T, slong new_size)
+{
+    slong i;
+
+    new_size = FLINT_MAX(new_size, 0);
+
+#if HAVE_PTHREAD
+    pthread_mutex_lock(&T->mutex);
+#endif
+
+    /* workers cannot be replaced while somebody holds them */
+    for (i = 0; i < T->length; i++)
+    {
+        if (!T->tdata[i].available)
+        {
+#if HAVE_PTHREAD
+            pthread_mutex_unlock(&T->mutex);
+#endif
+            return 0;
+        }
+    }
+
+    if (new_size != T->length)
+    {
+        _thread_pool_stop_workers(T);
+        _thread_pool_start_workers(T, new_size);
+    }
+
+#if HAVE_PTHREAD
+    pthread_mutex_unlock(&T->mutex);
+#endif
+
+    return 1;
+}
@@ -0,0 +1,123 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "thread_pool.h"
+#include "ulong_extras.h"
+
+typedef struct
+{
+    mp_limb_t start;
+    mp_limb_t stop;
+    mp_limb_t sum;
+}
+sum_arg_struct;
+
+void sum_worker(void * varg)
+{
+    sum_arg_struct * arg = (sum_arg_struct *) varg;
+    mp_limb_t j;
+
+    arg->sum = 0;
+    for (j = arg->start; j < arg->stop; j++)
+        arg->sum += j;
+}
+
+int
+main(void)
+{
+    slong i, j;
+    flint_rand_t state;
+    flint_randinit(state);
+
+    printf("thread_pool....");
+    fflush(stdout);
+
+    for (i = 0; i < 100 * flint_test_multiplier(); i++)
+    {
+        thread_pool_handle * threads;
+        sum_arg_struct * args;
+        slong num_workers, limit;
+        mp_limb_t n, total;
+
+        flint_set_num_threads(1 + n_randint(state, 8));
+        limit = n_randint(state, 10);
+
+        num_workers = flint_request_threads(&threads, limit);
+
+        if (num_workers < 0 || num_workers >= FLINT_MAX(limit, 1)
+                            || num_workers >= flint_get_num_threads())
+        {
+            printf("FAIL (number of workers):\n");
+            printf("limit = %ld, num_workers = %ld, threads = %d\n",
+                limit, num_workers, flint_get_num_threads());
+            abort();
+        }
+
+        n = n_randint(state, 100000);
+        args = flint_malloc(sizeof(sum_arg_struct) * (num_workers + 1));
+
+        for (j = 0; j <= num_workers; j++)
+        {
+            args[j].start = (j * n) / (num_workers + 1);
+            args[j].stop = ((j + 1) * n) / (num_workers + 1);
+        }
+
+        for (j = 0; j < num_workers; j++)
+            thread_pool_wake(global_thread_pool, threads[j],
+                             sum_worker, args + j + 1);
+
+        sum_worker(args);
+
+        for (j = 0; j < num_workers; j++)
+            thread_pool_wait(global_thread_pool, threads[j]);
+
+        flint_give_back_threads(threads, num_workers);
+
+        total = 0;
+        for (j = 0; j <= num_workers; j++)
+            total += args[j].sum;
+
+        if (n != 0 && total != (n * (n - 1)) / 2)
+        {
+            printf("FAIL (sum):\n");
+            printf("n = %lu, total = %lu\n", n, total);
+            abort();
+        }
+
+        flint_free(args);
+    }
+
+    flint_set_num_threads(1);
+
+    if (thread_pool_get_size(global_thread_pool) != 0)
+    {
+        printf("FAIL (pool size)\n");
+        abort();
+    }
+
+    flint_randclear(state);
+
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,38 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include "thread_pool.h"
+
+void thread_pool_wake(thread_pool_t T, thread_pool_handle i,
+                      void (*f)(void *), void * a)
+{
+    thread_pool_entry_struct * D = T->tdata + i;
+
+#if HAVE_PTHREAD
+    pthread_mutex_lock(&D->mutex);
+    D->fxn = f;
+    D->fxnarg = a;
+    D->working = 1;
+    pthread_cond_signal(&D->sleep1);
+    pthread_mutex_unlock(&D->mutex);
+#else
+    f(a);
+#endif
+}
@@ -24,9 +24,17 @@
 ******************************************************************************/
 
 #include "flint.h"
+#include "thread_pool.h"
 
 FLINT_TLS_PREFIX int _flint_num_threads = 1;
 
+thread_pool_t global_thread_pool;
+int global_thread_pool_initialized = 0;
+
+#if HAVE_PTHREAD
+static pthread_mutex_t _global_thread_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
 int flint_get_num_threads()
 {
     return _flint_num_threads;
@@ -34,6 +42,61 @@ int flint_get_num_threads()
 
 void flint_set_num_threads(int num_threads)
 {
+    if (num_threads < 1)
+        num_threads = 1;
+
     _flint_num_threads = num_threads;
+
+#if HAVE_PTHREAD
+    pthread_mutex_lock(&_global_thread_pool_lock);
+#endif
+
+    /*
+       The calling thread takes part in the work, so the shared pool
+       holds num_threads - 1 workers. If the pool is currently in use
+       it keeps its old size and requests are simply capped.
+    */
+    if (!global_thread_pool_initialized)
+    {
+        thread_pool_init(global_thread_pool, num_threads - 1);
+        global_thread_pool_initialized = 1;
+    }
+    else
+    {
+        thread_pool_set_size(global_thread_pool, num_threads - 1);
+    }
+
+#if HAVE_PTHREAD
+    pthread_mutex_unlock(&_global_thread_pool_lock);
+#endif
 }
 
+slong flint_request_threads(thread_pool_handle ** handles, slong thread_limit)
+{
+    slong num_workers = 0;
+
+    *handles = NULL;
+
+    thread_limit = FLINT_MIN(thread_limit, flint_get_num_threads());
+
+    if (global_thread_pool_initialized && thread_limit > 1)
+    {
+        *handles = (thread_pool_handle *)
+                     flint_malloc((thread_limit - 1)*sizeof(thread_pool_handle));
+        num_workers = thread_pool_request(global_thread_pool,
+                                                 *handles, thread_limit - 1);
+    }
+
+    return num_workers;
+}
+
+void flint_give_back_threads(thread_pool_handle * handles, slong num_handles)
+{
+    slong i;
+
+    for (i = 0; i < num_handles; i++)
+        thread_pool_give_back(global_thread_pool, handles[i]);
+
+    if (handles != NULL)
+        flint_free(handles);
+}
@@ -32,6 +32,10 @@
 #include <gmp.h>
 #include "flint.h"
 
+#if HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
 #ifdef __cplusplus
  extern "C" {
 #endif
@@ -64,6 +68,8 @@ typedef struct {
 #define FLINT_FACTOR_SQUFOF_ITERS 50000
 #define FLINT_FACTOR_ONE_LINE_MAX (1UL<<39)
 #define FLINT_FACTOR_ONE_LINE_ITERS 40000
+#define FLINT_FACTOR_ECM_B1 2000
+#define FLINT_FACTOR_ECM_CURVES 200
 
 #define FLINT_PRIME_PI_ODD_LOOKUP_CUTOFF 311
 
@@ -120,16 +126,119 @@ n_primes_next(n_primes_t iter)
     }
 }
 
+/*
+   Segmented sieve of Eratosthenes over the wheel mod 30. Byte i of a 
+   segment stands for the integers lo + 30*i + r with r one of 1, 7, 11, 
+   13, 17, 19, 23, 29, in that order from the lowest bit. Sieving primes 
+   keep the position of their next multiple from one segment to the next.
+*/
+
+typedef struct
+{
+    unsigned int p;      /* sieving prime */
+    unsigned int i;      /* byte of the next multiple, relative to the segment */
+    unsigned char w;     /* position of the cofactor on the wheel */
+    unsigned char c;     /* position of p on the wheel */
+}
+n_sieve_prime_struct;
+
+typedef struct
+{
+    mp_limb_t a;
+    mp_limb_t b;
+    mp_limb_t lo;        /* integer represented by byte 0, a multiple of 30 */
+    slong len;           /* bytes in the current segment */
+    slong alloc;
+    slong i;             /* current byte */
+    unsigned int bits;   /* bits of the current byte not yet returned */
+    unsigned int small;  /* which of 2, 3, 5 remain to be returned */
+    int last;            /* the current segment is the last one */
+    unsigned char * seg;
+
+    n_sieve_prime_struct * primes;
+    slong num;
+    slong primes_alloc;
+    n_primes_t iter;     /* source of sieving primes */
+    mp_limb_t next_p;    /* next sieving prime, not yet in use */
+}
+n_sieve_struct;
+
+typedef n_sieve_struct n_sieve_t[1];
+
+#define FLINT_SIEVE_THREAD_CUTOFF 16777216
+
+/* residue represented by the lowest set bit of a byte */
+extern const unsigned char _n_sieve_lowest[256];
+
+void n_sieve_init(n_sieve_t s, mp_limb_t a, mp_limb_t b);
+
+void n_sieve_clear(n_sieve_t s);
+
+int _n_sieve_next_segment(n_sieve_t s);
+
+static __inline__ mp_limb_t
+n_sieve_next(n_sieve_t s)
+{
+    unsigned int t;
+
+    if (s->small != 0)
+    {
+        t = (s->small & 1) ? 0 : ((s->small & 2) ? 1 : 2);
+        s->small &= s->small - 1;
+        return 2 + t + (t == 2);
+    }
+
+    while (s->bits == 0)
+    {
+        s->i++;
+        if (s->i >= s->len && !_n_sieve_next_segment(s))
+            return 0;
+        s->bits = s->seg[s->i];
+    }
+
+    t = _n_sieve_lowest[s->bits];
+    s->bits &= s->bits - 1;
+
+    return s->lo + 30 * s->i + t;
+}
+
+ulong n_primes_count_range(mp_limb_t a, mp_limb_t b);
+
+slong n_primes_range(mp_limb_t * res, mp_limb_t a, mp_limb_t b);
+
 extern const unsigned int flint_primes_small[];
 
-extern FLINT_TLS_PREFIX mp_limb_t * _flint_primes[FLINT_BITS];
-extern FLINT_TLS_PREFIX double * _flint_prime_inverses[FLINT_BITS];
-extern FLINT_TLS_PREFIX int _flint_primes_used;
+/* 
+   The prime tables are shared by all threads. They only grow, a new table
+   being published by a release store to _flint_primes_used after the 
+   pointers are set, under _flint_primes_lock.
+*/
+extern mp_limb_t * _flint_primes[FLINT_BITS];
+extern double * _flint_prime_inverses[FLINT_BITS];
+extern int _flint_primes_used;
+extern void * _flint_primes_map; /* memory mapped table, if any */
+extern size_t _flint_primes_map_size;
+
+#if HAVE_PTHREAD
+extern pthread_mutex_t _flint_primes_lock;
+#endif
+
+static __inline__
+int _n_primes_used(void)
+{
+    return __atomic_load_n(&_flint_primes_used, __ATOMIC_ACQUIRE);
+}
+
+void _n_primes_install(int m, mp_limb_t * primes, double * inverses);
 
 void n_compute_primes(ulong num_primes);
 
 void n_cleanup_primes(void);
 
+int n_primes_table_save(const char * filename, ulong num_primes);
+
+int n_primes_table_load(const char * filename);
+
 const mp_limb_t * n_primes_arr_readonly(ulong n);
 const double * n_prime_inverses_arr_readonly(ulong n);
 
@@ -352,6 +461,9 @@ void n_factor(n_factor_t * factors, mp_limb_t n, int proved);
 
 mp_limb_t n_factor_pp1(mp_limb_t n, ulong B1, ulong c);
 
+int n_factor_ecm(mp_limb_t * f, ulong curves, ulong B1, ulong B2,
+                 flint_rand_t state, mp_limb_t n);
+
 int n_is_squarefree(mp_limb_t n);
 
 int n_moebius_mu(mp_limb_t n);
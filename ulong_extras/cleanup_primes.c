@@ -23,24 +23,52 @@
 
 ******************************************************************************/
 
+#if !defined (__WIN32) || defined(__CYGWIN__)
+#include <sys/mman.h>
+#endif
 #include <gmp.h>
 #include "flint.h"
 #include "ulong_extras.h"
 
+/*
+   Frees the shared prime tables. Called automatically at exit. Must not 
+   be called while another thread uses the tables.
+*/
 void
 n_cleanup_primes()
 {
     int i;
 
+#if HAVE_PTHREAD
+    pthread_mutex_lock(&_flint_primes_lock);
+#endif
+
     for (i = 0; i < _flint_primes_used; i++)
     {
         if (i < _flint_primes_used - 1 && _flint_primes[i] == _flint_primes[i+1])
             continue;
 
+        if (_flint_primes_map != NULL 
+            && (char *) _flint_prime_inverses[i] >= (char *) _flint_primes_map
+            && (char *) _flint_prime_inverses[i] < (char *) _flint_primes_map 
+                                                   + _flint_primes_map_size)
+            continue; /* part of the memory mapped table */
+
         flint_free(_flint_primes[i]);
         flint_free(_flint_prime_inverses[i]);
     }
 
-    _flint_primes_used = 0;
-}
+#if !defined (__WIN32) || defined(__CYGWIN__)
+    if (_flint_primes_map != NULL)
+        munmap(_flint_primes_map, _flint_primes_map_size);
+#endif
 
+    _flint_primes_map = NULL;
+    _flint_primes_map_size = 0;
+
+    __atomic_store_n(&_flint_primes_used, 0, __ATOMIC_RELEASE);
+
+#if HAVE_PTHREAD
+    pthread_mutex_unlock(&_flint_primes_lock);
+#endif
+}
@@ -50,47 +50,86 @@ const unsigned int flint_primes_small[] =
 };
 
 
-/* _flint_primes[i] holds an array of 2^i primes */
-FLINT_TLS_PREFIX mp_limb_t * _flint_primes[FLINT_BITS];
-FLINT_TLS_PREFIX double * _flint_prime_inverses[FLINT_BITS];
-FLINT_TLS_PREFIX int _flint_primes_used = 0;
+/* _flint_primes[i] holds an array of at least 2^i primes */
+mp_limb_t * _flint_primes[FLINT_BITS];
+double * _flint_prime_inverses[FLINT_BITS];
+int _flint_primes_used = 0;
+void * _flint_primes_map = NULL;
+size_t _flint_primes_map_size = 0;
+
+#if HAVE_PTHREAD
+pthread_mutex_t _flint_primes_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+static int _flint_primes_registered = 0;
+
+/*
+   Make the arrays of 2^m primes and inverses the tables for all sizes not 
+   yet computed, up to 2^m. Must be called under _flint_primes_lock, with 
+   m at least _flint_primes_used. The arrays are never moved, so that 
+   pointers to the tables remain valid for all threads.
+*/
+void
+_n_primes_install(int m, mp_limb_t * primes, double * inverses)
+{
+    int i;
+
+    if (!_flint_primes_registered)
+    {
+        atexit(n_cleanup_primes);
+        _flint_primes_registered = 1;
+    }
+
+    for (i = m; i >= _flint_primes_used; i--)
+    {
+        _flint_primes[i] = primes;
+        _flint_prime_inverses[i] = inverses;
+    }
+
+    __atomic_store_n(&_flint_primes_used, m + 1, __ATOMIC_RELEASE);
+}
 
 void
 n_compute_primes(ulong num_primes)
 {
-    int i, m;
+    slong i;
+    int m;
     ulong num_computed;
+    mp_limb_t * primes;
+    double * inverses;
 
     m = FLINT_CLOG2(num_primes);
 
-    if (_flint_primes_used == 0)
-    {
-        flint_register_cleanup_function(n_cleanup_primes);
-    }
+    if (m < _n_primes_used())
+        return;
 
-    if (m >= _flint_primes_used)
+#if HAVE_PTHREAD
+    pthread_mutex_lock(&_flint_primes_lock);
+#endif
+
+    if (m >= _flint_primes_used) /* not computed by another thread */
     {
-        n_primes_t iter;
+        n_sieve_t s;
+        mp_limb_t lo, hi;
 
         num_computed = 1UL << m;
-        _flint_primes[m] = flint_malloc(sizeof(mp_limb_t) * num_computed);
-        _flint_prime_inverses[m] = flint_malloc(sizeof(double) * num_computed);
+        primes = flint_malloc(sizeof(mp_limb_t) * num_computed);
+        inverses = flint_malloc(sizeof(double) * num_computed);
+
+        n_nth_prime_bounds(&lo, &hi, num_computed);
 
-        n_primes_init(iter);
+        n_sieve_init(s, 0, FLINT_MAX(hi, 30));
         for (i = 0; i < num_computed; i++)
         {
-            _flint_primes[m][i] = n_primes_next(iter);
-            _flint_prime_inverses[m][i] = n_precompute_inverse(_flint_primes[m][i]);
+            primes[i] = n_sieve_next(s);
+            inverses[i] = n_precompute_inverse(primes[i]);
         }
-        n_primes_clear(iter);
+        n_sieve_clear(s);
 
-        /* copy to lower power-of-two slots */
-        for (i = m - 1; i >= _flint_primes_used; i--)
-        {
-            _flint_primes[i] = _flint_primes[m];
-            _flint_prime_inverses[i] = _flint_prime_inverses[m];
-        }
-        _flint_primes_used = m + 1;
+        _n_primes_install(m, primes, inverses);
     }
-}
 
+#if HAVE_PTHREAD
+    pthread_mutex_unlock(&_flint_primes_lock);
+#endif
+}
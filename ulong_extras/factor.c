@@ -36,6 +36,20 @@ int is_prime(mp_limb_t n, int proved)
     return proved ? n_is_prime(n) : n_is_probabprime(n);
 }
 
+/* fallback for when SQUFOF fails */
+static int _n_factor_ecm(mp_limb_t * f, mp_limb_t n)
+{
+   flint_rand_t state;
+   int ret;
+
+   flint_randinit(state);
+   ret = n_factor_ecm(f, FLINT_FACTOR_ECM_CURVES, FLINT_FACTOR_ECM_B1,
+                                    100*FLINT_FACTOR_ECM_B1, state, n);
+   flint_randclear(state);
+
+   return ret;
+}
+
 void n_factor(n_factor_t * factors, mp_limb_t n, int proved)
 {
    ulong factor_arr[FLINT_MAX_FACTORS_IN_LIMB];
@@ -77,7 +91,8 @@ void n_factor(n_factor_t * factors, mp_limb_t n, int proved)
                  (factor < FLINT_FACTOR_ONE_LINE_MAX) &&
 #endif
                  (cofactor = n_factor_one_line(factor, FLINT_FACTOR_ONE_LINE_ITERS))) 
-              || (cofactor = n_factor_SQUFOF(factor, FLINT_FACTOR_SQUFOF_ITERS)))
+              || (cofactor = n_factor_SQUFOF(factor, FLINT_FACTOR_SQUFOF_ITERS))
+              || _n_factor_ecm(&cofactor, factor))
 				{
 					exp_arr[factors_left] = exp_arr[factors_left - 1];
                factor_arr[factors_left] = cofactor;
@@ -0,0 +1,308 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#undef ulong /* prevent clash with stdlib */
+#include <stdlib.h>
+#define ulong mp_limb_t
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+
+/*
+   Arithmetic on Montgomery curves B y^2 = x^3 + A x^2 + x, using only
+   the projective coordinates (X : Z). All residues are stored shifted
+   left by norm, so that n_mulmod_preinv can be used with the normalised
+   modulus.
+*/
+
+#define ECM_D 210 /* giant step size for stage 2 */
+
+/* (x : z) = 2 (x0 : z0), where a24 = (A + 2)/4 */
+static void
+n_ecm_double(mp_limb_t * x, mp_limb_t * z, mp_limb_t x0, mp_limb_t z0,
+             mp_limb_t a24, mp_limb_t n, mp_limb_t ninv, ulong norm)
+{
+    mp_limb_t u, v, w;
+
+    u = n_addmod(x0, z0, n);
+    u = n_mulmod_preinv(u, u, n, ninv, norm);
+    v = n_submod(x0, z0, n);
+    v = n_mulmod_preinv(v, v, n, ninv, norm);
+    w = n_submod(u, v, n); /* 4 x0 z0 */
+
+    *x = n_mulmod_preinv(u, v, n, ninv, norm);
+    u = n_mulmod_preinv(w, a24, n, ninv, norm);
+    u = n_addmod(u, v, n);
+    *z = n_mulmod_preinv(w, u, n, ninv, norm);
+}
+
+/* (x : z) = P1 + P2, given the difference P1 - P2 = (xd : zd) */
+static void
+n_ecm_add(mp_limb_t * x, mp_limb_t * z, mp_limb_t x1, mp_limb_t z1,
+          mp_limb_t x2, mp_limb_t z2, mp_limb_t xd, mp_limb_t zd,
+          mp_limb_t n, mp_limb_t ninv, ulong norm)
+{
+    mp_limb_t u, v, s, t;
+
+    u = n_mulmod_preinv(n_submod(x1, z1, n), n_addmod(x2, z2, n),
+                                                          n, ninv, norm);
+    v = n_mulmod_preinv(n_addmod(x1, z1, n), n_submod(x2, z2, n),
+                                                          n, ninv, norm);
+    s = n_addmod(u, v, n);
+    s = n_mulmod_preinv(s, s, n, ninv, norm);
+    t = n_submod(u, v, n);
+    t = n_mulmod_preinv(t, t, n, ninv, norm);
+
+    *x = n_mulmod_preinv(zd, s, n, ninv, norm);
+    *z = n_mulmod_preinv(xd, t, n, ninv, norm);
+}
+
+/* (x : z) = k (x0 : z0) by the Montgomery ladder, for k >= 1 */
+static void
+n_ecm_mul_ui(mp_limb_t * x, mp_limb_t * z, mp_limb_t x0, mp_limb_t z0,
+             ulong k, mp_limb_t a24, mp_limb_t n, mp_limb_t ninv, ulong norm)
+{
+    mp_limb_t x1 = x0, z1 = z0, x2, z2;
+    ulong bit;
+
+    if (k == 1)
+    {
+        *x = x0;
+        *z = z0;
+        return;
+    }
+
+    n_ecm_double(&x2, &z2, x0, z0, a24, n, ninv, norm);
+
+    bit = ((1UL << FLINT_BIT_COUNT(k)) >> 2);
+
+    while (bit)
+    {
+        if (k & bit)
+        {
+            n_ecm_add(&x1, &z1, x2, z2, x1, z1, x0, z0, n, ninv, norm);
+            n_ecm_double(&x2, &z2, x2, z2, a24, n, ninv, norm);
+        } else
+        {
+            n_ecm_add(&x2, &z2, x2, z2, x1, z1, x0, z0, n, ninv, norm);
+            n_ecm_double(&x1, &z1, x1, z1, a24, n, ninv, norm);
+        }
+
+        bit >>= 1;
+    }
+
+    *x = x1;
+    *z = z1;
+}
+
+/*
+   Selects a curve and starting point using Suyama's parametrisation,
+   which gives a group order divisible by 12. Returns 1 if successful,
+   otherwise returns the gcd of n with the denominator of (A + 2)/4.
+   The outputs are not shifted by norm.
+*/
+static mp_limb_t
+n_ecm_select_curve(mp_limb_t * x, mp_limb_t * z, mp_limb_t * a24,
+                   mp_limb_t sigma, mp_limb_t n, mp_limb_t ninv)
+{
+    mp_limb_t u, v, w, t, g;
+
+    u = n_mulmod2_preinv(sigma, sigma, n, ninv);
+    u = n_submod(u, 5 % n, n);
+    v = n_mulmod2_preinv(sigma, 4 % n, n, ninv);
+
+    *x = n_mulmod2_preinv(n_mulmod2_preinv(u, u, n, ninv), u, n, ninv);
+    *z = n_mulmod2_preinv(n_mulmod2_preinv(v, v, n, ninv), v, n, ninv);
+
+    /* (v - u)^3 (3u + v) / (16 u^3 v) */
+    w = n_submod(v, u, n);
+    t = n_mulmod2_preinv(n_mulmod2_preinv(w, w, n, ninv), w, n, ninv);
+    w = n_addmod(n_addmod(u, u, n), n_addmod(u, v, n), n);
+    t = n_mulmod2_preinv(t, w, n, ninv);
+
+    w = n_mulmod2_preinv(*x, v, n, ninv);
+    w = n_mulmod2_preinv(w, 16 % n, n, ninv);
+
+    g = n_gcdinv(&w, w, n);
+    if (g != 1)
+        return g;
+
+    *a24 = n_mulmod2_preinv(t, w, n, ninv);
+
+    return 1;
+}
+
+int n_factor_ecm(mp_limb_t * f, ulong curves, ulong B1, ulong B2,
+                 flint_rand_t state, mp_limb_t n)
+{
+    mp_limb_t x0, z0, xs, zs, x, z, a24, ninv, ninv2, sigma, g;
+    mp_limb_t bx[ECM_D/4 + 1], bz[ECM_D/4 + 1];
+    ulong norm, bits0, sqrt, pr, k;
+    int curve, check;
+    n_primes_t iter;
+
+    if ((n % 2) == 0)
+    {
+        *f = 2;
+        return 1;
+    }
+
+    ninv2 = n_preinvert_limb(n);
+
+    count_leading_zeros(norm, n);
+    n <<= norm;
+    ninv = n_preinvert_limb(n);
+
+    sqrt = n_sqrt(B1);
+    bits0 = FLINT_BIT_COUNT(B1);
+
+    for (curve = 1; curve <= curves; curve++)
+    {
+        sigma = n_randint(state, (n >> norm) - 7) + 6;
+
+        g = n_ecm_select_curve(&x0, &z0, &a24, sigma, n >> norm, ninv2);
+        if (g != 1)
+        {
+            if (g != (n >> norm))
+            {
+                *f = g;
+                return curve;
+            }
+
+            continue;
+        }
+
+        x0 <<= norm;
+        z0 <<= norm;
+        a24 <<= norm;
+
+        /* 
+           stage 1: multiply by all prime powers up to B1, if all factors
+           of n are found at once, start again taking a gcd after each step
+        */
+        xs = x0;
+        zs = z0;
+        n_primes_init(iter);
+
+        for (check = 0; check < 2; check++)
+        {
+            g = 1;
+
+            for (pr = n_primes_next(iter); pr <= B1 && g == 1;
+                                           pr = n_primes_next(iter))
+            {
+                if (pr < sqrt)
+                    k = n_pow(pr, bits0/FLINT_BIT_COUNT(pr));
+                else
+                    k = pr;
+
+                n_ecm_mul_ui(&x0, &z0, x0, z0, k, a24, n, ninv, norm);
+
+                if (check)
+                    g = n_gcd(n >> norm, z0 >> norm);
+            }
+
+            if (!check)
+                g = n_gcd(n >> norm, z0 >> norm);
+
+            if (g != (n >> norm))
+                break;
+
+            n_primes_clear(iter);
+            n_primes_init(iter);
+            x0 = xs;
+            z0 = zs;
+        }
+
+        if (g == 1 && B2 > B1)
+        {
+            /* 
+               stage 2: baby steps j P for odd j < D/2, giant steps m D P,
+               a prime p = m D +/- j is detected by X_mD Z_j - X_j Z_mD
+            */
+            mp_limb_t xD, zD, xm, zm, xm1, zm1, acc, t;
+            ulong m, m0;
+            slong j;
+
+            bx[0] = x0;
+            bz[0] = z0;
+            n_ecm_double(&x, &z, x0, z0, a24, n, ninv, norm);
+            n_ecm_add(bx + 1, bz + 1, x, z, x0, z0, x0, z0, n, ninv, norm);
+            for (j = 2; j <= ECM_D/4; j++)
+                n_ecm_add(bx + j, bz + j, bx[j - 1], bz[j - 1], x, z,
+                                   bx[j - 2], bz[j - 2], n, ninv, norm);
+
+            m0 = (B1 + ECM_D/2)/ECM_D;
+            if (m0 == 0)
+                m0 = 1;
+
+            n_ecm_mul_ui(&xD, &zD, x0, z0, ECM_D, a24, n, ninv, norm);
+            n_ecm_mul_ui(&xm, &zm, x0, z0, m0*ECM_D, a24, n, ninv, norm);
+            xm1 = zm1 = 0; /* (m0 - 1) D P is not needed if m0 = 1 */
+            if (m0 > 1)
+                n_ecm_mul_ui(&xm1, &zm1, x0, z0, (m0 - 1)*ECM_D,
+                                                      a24, n, ninv, norm);
+
+            m = m0;
+            acc = (1UL << norm);
+
+            n_primes_jump_after(iter, FLINT_MAX(B1, ECM_D/2));
+
+            for (pr = n_primes_next(iter); pr <= B2; pr = n_primes_next(iter))
+            {
+                ulong mp = (pr + ECM_D/2)/ECM_D;
+
+                while (m < mp)
+                {
+                    /* (m + 1) D P = m D P + D P, difference (m - 1) D P */
+                    if (m == 1)
+                        n_ecm_double(&x, &z, xm, zm, a24, n, ninv, norm);
+                    else
+                        n_ecm_add(&x, &z, xm, zm, xD, zD, xm1, zm1,
+                                                           n, ninv, norm);
+                    xm1 = xm, zm1 = zm;
+                    xm = x, zm = z;
+                    m++;
+                }
+
+                j = pr - m*ECM_D;
+                if (j < 0)
+                    j = -j;
+                j /= 2;
+
+                t = n_submod(n_mulmod_preinv(xm, bz[j], n, ninv, norm),
+                             n_mulmod_preinv(bx[j], zm, n, ninv, norm), n);
+                acc = n_mulmod_preinv(acc, t, n, ninv, norm);
+            }
+
+            g = n_gcd(n >> norm, acc >> norm);
+        }
+
+        n_primes_clear(iter);
+
+        if (g != 1 && g != (n >> norm))
+        {
+            *f = g;
+            return curve;
+        }
+    }
+
+    return 0;
+}
@@ -40,8 +40,9 @@ const unsigned char FLINT_PRIME_PI_ODD_LOOKUP[] =
 
 ulong n_prime_pi(mp_limb_t n)
 {
-    ulong low, mid, high;
+    ulong low, mid, high, num;
     const mp_limb_t * primes;
+    int m;
 
     if (n < FLINT_PRIME_PI_ODD_LOOKUP_CUTOFF)
     {
@@ -50,8 +51,20 @@ ulong n_prime_pi(mp_limb_t n)
         return FLINT_PRIME_PI_ODD_LOOKUP[(n-1)/2];
     }
 
+    m = _n_primes_used();
+
+    /* beyond the cached table, count the remaining primes with a sieve */
+    if (m == 0)
+        return n_primes_count_range(0, n);
+
+    num = 1UL << (m - 1);
+    primes = _flint_primes[m - 1];
+
+    if (n >= primes[num - 1])
+        return num + n_primes_count_range(primes[num - 1] + 1, n);
+
     n_prime_pi_bounds(&low, &high, n);
-    primes = n_primes_arr_readonly(high + 1);
+    high = FLINT_MIN(high, num);
 
     while (low < high)
     {
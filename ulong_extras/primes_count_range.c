@@ -0,0 +1,126 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <string.h>
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "thread_pool.h"
+
+#ifdef POPCNT_INTRINSICS
+static __inline__ ulong _popcount(mp_limb_t x)
+{
+    return __builtin_popcountl(x);
+}
+#else
+static __inline__ ulong _popcount(mp_limb_t x)
+{
+    ulong c;
+    for (c = 0; x != 0; x &= x - 1)
+        c++;
+    return c;
+}
+#endif
+
+typedef struct
+{
+    mp_limb_t a;
+    mp_limb_t b;
+    ulong count;
+}
+_count_arg_struct;
+
+static void
+_n_primes_count_worker(void * varg)
+{
+    _count_arg_struct * arg = (_count_arg_struct *) varg;
+    n_sieve_t s;
+    mp_limb_t x;
+    ulong c;
+    slong j;
+
+    n_sieve_init(s, arg->a, arg->b);
+
+    c = _popcount(s->small);
+
+    while (_n_sieve_next_segment(s))
+    {
+        for (j = 0; j + sizeof(mp_limb_t) <= s->len; j += sizeof(mp_limb_t))
+        {
+            memcpy(&x, s->seg + j, sizeof(mp_limb_t));
+            c += _popcount(x);
+        }
+
+        for ( ; j < s->len; j++)
+            c += _popcount(s->seg[j]);
+    }
+
+    n_sieve_clear(s);
+
+    arg->count = c;
+}
+
+ulong
+n_primes_count_range(mp_limb_t a, mp_limb_t b)
+{
+    thread_pool_handle * threads;
+    _count_arg_struct * args;
+    slong i, num_workers;
+    mp_limb_t step;
+    ulong count;
+
+    if (a > b)
+        return 0;
+
+    threads = NULL;
+    num_workers = 0;
+    if (b - a >= FLINT_SIEVE_THREAD_CUTOFF)
+        num_workers = flint_request_threads(&threads, FLINT_MIN(
+            flint_get_num_threads(), (b - a) / FLINT_SIEVE_THREAD_CUTOFF + 1));
+
+    args = flint_malloc(sizeof(_count_arg_struct) * (num_workers + 1));
+
+    /* disjoint intervals, the last one ending at b */
+    step = (b - a) / (num_workers + 1);
+    for (i = 0; i <= num_workers; i++)
+    {
+        args[i].a = a + i * step;
+        args[i].b = (i == num_workers) ? b : a + (i + 1) * step - 1;
+    }
+
+    for (i = 0; i < num_workers; i++)
+        thread_pool_wake(global_thread_pool, threads[i],
+                                      _n_primes_count_worker, args + i + 1);
+
+    _n_primes_count_worker(args);
+
+    for (i = 0; i < num_workers; i++)
+        thread_pool_wait(global_thread_pool, threads[i]);
+
+    flint_give_back_threads(threads, num_workers);
+
+    count = 0;
+    for (i = 0; i <= num_workers; i++)
+        count += args[i].count;
+
+    flint_free(args);
+
+    return count;
+}
@@ -0,0 +1,115 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <string.h>
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+#include "thread_pool.h"
+
+typedef struct
+{
+    mp_limb_t a;
+    mp_limb_t b;
+    mp_limb_t * res;
+    slong num;
+    slong alloc; /* -1 if res is known to be large enough */
+}
+_range_arg_struct;
+
+static void
+_n_primes_range_worker(void * varg)
+{
+    _range_arg_struct * arg = (_range_arg_struct *) varg;
+    n_sieve_t s;
+    mp_limb_t p;
+
+    n_sieve_init(s, arg->a, arg->b);
+
+    arg->num = 0;
+    while ((p = n_sieve_next(s)) != 0)
+    {
+        if (arg->num == arg->alloc)
+        {
+            arg->alloc = FLINT_MAX(2 * arg->alloc, 1024);
+            arg->res = flint_realloc(arg->res, arg->alloc * sizeof(mp_limb_t));
+        }
+
+        arg->res[arg->num++] = p;
+    }
+
+    n_sieve_clear(s);
+}
+
+slong
+n_primes_range(mp_limb_t * res, mp_limb_t a, mp_limb_t b)
+{
+    thread_pool_handle * threads;
+    _range_arg_struct * args;
+    slong i, num, num_workers;
+    mp_limb_t step;
+
+    if (a > b)
+        return 0;
+
+    threads = NULL;
+    num_workers = 0;
+    if (b - a >= FLINT_SIEVE_THREAD_CUTOFF)
+        num_workers = flint_request_threads(&threads, FLINT_MIN(
+            flint_get_num_threads(), (b - a) / FLINT_SIEVE_THREAD_CUTOFF + 1));
+
+    args = flint_malloc(sizeof(_range_arg_struct) * (num_workers + 1));
+
+    /*
+       disjoint intervals, the last one ending at b; the first writes
+       straight into res, the others into buffers of their own
+    */
+    step = (b - a) / (num_workers + 1);
+    for (i = 0; i <= num_workers; i++)
+    {
+        args[i].a = a + i * step;
+        args[i].b = (i == num_workers) ? b : a + (i + 1) * step - 1;
+        args[i].res = (i == 0) ? res : NULL;
+        args[i].alloc = (i == 0) ? -1 : 0;
+    }
+
+    for (i = 0; i < num_workers; i++)
+        thread_pool_wake(global_thread_pool, threads[i],
+                                      _n_primes_range_worker, args + i + 1);
+
+    _n_primes_range_worker(args);
+
+    for (i = 0; i < num_workers; i++)
+        thread_pool_wait(global_thread_pool, threads[i]);
+
+    flint_give_back_threads(threads, num_workers);
+
+    num = args[0].num;
+    for (i = 1; i <= num_workers; i++)
+    {
+        memcpy(res + num, args[i].res, args[i].num * sizeof(mp_limb_t));
+        num += args[i].num;
+        flint_free(args[i].res);
+    }
+
+    flint_free(args);
+
+    return num;
+}
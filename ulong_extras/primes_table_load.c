@@ -0,0 +1,107 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#undef ulong /* prevent clash with standard library */
+#include <stdio.h>
+#if !defined (__WIN32) || defined(__CYGWIN__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#define ulong mp_limb_t
+
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+
+int
+n_primes_table_load(const char * filename)
+{
+#if !defined (__WIN32) || defined(__CYGWIN__)
+    int fd, m, ret = 0;
+    struct stat st;
+    size_t size;
+    void * map;
+    mp_limb_t * header, count;
+
+    fd = open(filename, O_RDONLY);
+    if (fd < 0)
+        return 0;
+
+    if (fstat(fd, &st) != 0 || st.st_size < 4*sizeof(mp_limb_t))
+    {
+        close(fd);
+        return 0;
+    }
+
+    size = st.st_size;
+    map = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (map == MAP_FAILED)
+        return 0;
+
+    header = (mp_limb_t *) map;
+    count = header[1];
+
+    /* bound count by the file size first, so that the size cannot wrap */
+    if (header[0] != FLINT_BITS || header[2] != sizeof(double) 
+        || count == 0 || (count & (count - 1)) != 0
+        || count > (size - 4*sizeof(mp_limb_t))
+                   / (sizeof(double) + sizeof(mp_limb_t))
+        || size != 4*sizeof(mp_limb_t) 
+                 + count*(sizeof(double) + sizeof(mp_limb_t))
+        || header[4 + count*sizeof(double)/sizeof(mp_limb_t)] != 2)
+    {
+        munmap(map, size);
+        return 0;
+    }
+
+    m = FLINT_CLOG2(count);
+
+#if HAVE_PTHREAD
+    pthread_mutex_lock(&_flint_primes_lock);
+#endif
+
+    if (m < _flint_primes_used) /* the tables are already large enough */
+    {
+        munmap(map, size);
+        ret = 1;
+    } else if (_flint_primes_map == NULL)
+    {
+        _flint_primes_map = map;
+        _flint_primes_map_size = size;
+
+        _n_primes_install(m, header + 4 + count*sizeof(double)/sizeof(mp_limb_t),
+                                                 (double *) (header + 4));
+        ret = 1;
+    } else
+        munmap(map, size);
+
+#if HAVE_PTHREAD
+    pthread_mutex_unlock(&_flint_primes_lock);
+#endif
+
+    return ret;
+#else
+    return 0;
+#endif
+}
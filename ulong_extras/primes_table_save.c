@@ -0,0 +1,66 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#undef ulong /* prevent clash with standard library */
+#include <stdio.h>
+#define ulong mp_limb_t
+
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+
+/*
+   The file consists of a header of four limbs, FLINT_BITS, the number of 
+   primes 2^m, sizeof(double) and zero, followed by the 2^m inverses and 
+   then the 2^m primes.
+*/
+int
+n_primes_table_save(const char * filename, ulong num_primes)
+{
+    mp_limb_t header[4];
+    int m, ok;
+    FILE * file;
+
+    if (num_primes < 1)
+        num_primes = 1;
+
+    m = FLINT_CLOG2(num_primes);
+    n_compute_primes(num_primes);
+
+    header[0] = FLINT_BITS;
+    header[1] = 1UL << m;
+    header[2] = sizeof(double);
+    header[3] = 0;
+
+    file = fopen(filename, "wb");
+    if (file == NULL)
+        return 0;
+
+    ok = (fwrite(header, sizeof(mp_limb_t), 4, file) == 4)
+      && (fwrite(_flint_prime_inverses[m], sizeof(double), header[1], file) 
+                                                                 == header[1])
+      && (fwrite(_flint_primes[m], sizeof(mp_limb_t), header[1], file) 
+                                                                 == header[1]);
+
+    if (fclose(file) != 0)
+        ok = 0;
+
+    return ok;
+}
@@ -0,0 +1,68 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+
+void
+n_sieve_init(n_sieve_t s, mp_limb_t a, mp_limb_t b)
+{
+    mp_limb_t root;
+
+    s->a = a;
+    s->b = b;
+    s->lo = a - a % 30;
+    s->len = 0;
+    s->i = 0;
+    s->bits = 0;
+    s->small = 0;
+    s->last = (a > b);
+
+    if (a <= 2 && b >= 2)
+        s->small |= 1;
+    if (a <= 3 && b >= 3)
+        s->small |= 2;
+    if (a <= 5 && b >= 5)
+        s->small |= 4;
+
+    /*
+       Segments fit in the L1 cache when the sieving primes are small,
+       and grow with the square root of b so that the large sieving primes
+       are not all visited for every segment.
+    */
+    s->alloc = FLINT_SIEVE_SIZE / 2;
+    root = n_sqrt(b);
+    while (s->alloc < (1L << 22) && root / 30 > s->alloc)
+        s->alloc *= 2;
+    if (!s->last && (b - s->lo) / 30 + 1 < s->alloc)
+        s->alloc = (b - s->lo) / 30 + 1;
+
+    s->seg = s->last ? NULL : flint_malloc(s->alloc);
+
+    s->num = 0;
+    s->primes_alloc = 0;
+    s->primes = NULL;
+
+    n_primes_init(s->iter);
+    do {
+        s->next_p = n_primes_next(s->iter);
+    } while (s->next_p < 7);
+}
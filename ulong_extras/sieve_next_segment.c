@@ -0,0 +1,239 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <string.h>
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+
+const unsigned char _n_sieve_lowest[256] =
+{
+     0,  1,  7,  1, 11,  1,  7,  1, 13,  1,  7,  1, 11,  1,  7,  1,
+    17,  1,  7,  1, 11,  1,  7,  1, 13,  1,  7,  1, 11,  1,  7,  1,
+    19,  1,  7,  1, 11,  1,  7,  1, 13,  1,  7,  1, 11,  1,  7,  1,
+    17,  1,  7,  1, 11,  1,  7,  1, 13,  1,  7,  1, 11,  1,  7,  1,
+    23,  1,  7,  1, 11,  1,  7,  1, 13,  1,  7,  1, 11,  1,  7,  1,
+    17,  1,  7,  1, 11,  1,  7,  1, 13,  1,  7,  1, 11,  1,  7,  1,
+    19,  1,  7,  1, 11,  1,  7,  1, 13,  1,  7,  1, 11,  1,  7,  1,
+    17,  1,  7,  1, 11,  1,  7,  1, 13,  1,  7,  1, 11,  1,  7,  1,
+    29,  1,  7,  1, 11,  1,  7,  1, 13,  1,  7,  1, 11,  1,  7,  1,
+    17,  1,  7,  1, 11,  1,  7,  1, 13,  1,  7,  1, 11,  1,  7,  1,
+    19,  1,  7,  1, 11,  1,  7,  1, 13,  1,  7,  1, 11,  1,  7,  1,
+    17,  1,  7,  1, 11,  1,  7,  1, 13,  1,  7,  1, 11,  1,  7,  1,
+    23,  1,  7,  1, 11,  1,  7,  1, 13,  1,  7,  1, 11,  1,  7,  1,
+    17,  1,  7,  1, 11,  1,  7,  1, 13,  1,  7,  1, 11,  1,  7,  1,
+    19,  1,  7,  1, 11,  1,  7,  1, 13,  1,  7,  1, 11,  1,  7,  1,
+    17,  1,  7,  1, 11,  1,  7,  1, 13,  1,  7,  1, 11,  1,  7,  1
+};
+
+static const unsigned char _n_sieve_residue[8] = {1, 7, 11, 13, 17, 19, 23, 29};
+
+static const unsigned char _n_sieve_gap[8] = {6, 4, 2, 4, 2, 4, 6, 2};
+
+/* position on the wheel of each residue mod 30, 8 if not prime to 30 */
+static const unsigned char _n_sieve_pos[30] =
+{
+    8, 0, 8, 8, 8, 8, 8, 1, 8, 8, 8, 2, 8, 3, 8, 8, 8, 4, 8, 5, 8, 8, 8, 6,
+    8, 8, 8, 8, 8, 7
+};
+
+/*
+   For p = 30k + r and a cofactor q at position w on the wheel, the multiple
+   p*q is marked by _n_sieve_bit[pos(r)][w], and moving q to the next
+   position moves the byte on by k*gap[w] + _n_sieve_carry[pos(r)][w].
+*/
+static const unsigned char _n_sieve_bit[8][8] =
+{
+    {  1,   2,   4,   8,  16,  32,  64, 128},
+    {  2,  32,  16,   1, 128,   8,   4,  64},
+    {  4,  16,   1,  64,   2, 128,   8,  32},
+    {  8,   1,  64,  32,   4,   2, 128,  16},
+    { 16, 128,   2,   4,  32,  64,   1,   8},
+    { 32,   8, 128,   2,  64,   1,  16,   4},
+    { 64,   4,   8, 128,   1,  16,  32,   2},
+    {128,  64,  32,  16,   8,   4,   2,   1}
+};
+
+static const unsigned char _n_sieve_carry[8][8] =
+{
+    {0, 0, 0, 0, 0, 0, 0, 1},
+    {1, 1, 1, 0, 1, 1, 1, 1},
+    {2, 2, 0, 2, 0, 2, 2, 1},
+    {3, 1, 1, 2, 1, 1, 3, 1},
+    {3, 3, 1, 2, 1, 3, 3, 1},
+    {4, 2, 2, 2, 2, 2, 4, 1},
+    {5, 3, 1, 4, 1, 3, 5, 1},
+    {6, 4, 2, 4, 2, 4, 6, 1}
+};
+
+static void
+_n_sieve_add_prime(n_sieve_t s, mp_limb_t p)
+{
+    n_sieve_prime_struct * P;
+    mp_limb_t q, r, d;
+
+    if (s->num == s->primes_alloc)
+    {
+        s->primes_alloc = FLINT_MAX(2 * s->primes_alloc, 64);
+        s->primes = flint_realloc(s->primes,
+                             s->primes_alloc * sizeof(n_sieve_prime_struct));
+    }
+
+    /* first multiple p*q >= max(lo, p^2) with q prime to 30, d = p*q - lo */
+    r = s->lo % p;
+    q = s->lo / p + (r != 0);
+    d = (r == 0) ? 0 : p - r;
+
+    if (q < p)
+    {
+        d += (p - q) * p;
+        q = p;
+    }
+
+    while (_n_sieve_pos[q % 30] == 8)
+    {
+        q++;
+        d += p;
+    }
+
+    P = s->primes + s->num;
+    P->p = p;
+    P->i = d / 30;
+    P->w = _n_sieve_pos[q % 30];
+    P->c = _n_sieve_pos[p % 30];
+    s->num++;
+}
+
+static void
+_n_sieve_mark(unsigned char * seg, mp_limb_t len, n_sieve_prime_struct * P)
+{
+    mp_limb_t i, k, p, o, off[8];
+    unsigned char mask[8];
+    const unsigned char * bit, * carry;
+    int j, w;
+
+    i = P->i;
+
+    if (i >= len)
+    {
+        P->i = i - len;
+        return;
+    }
+
+    p = P->p;
+    k = p / 30;
+    w = P->w;
+    bit = _n_sieve_bit[P->c];
+    carry = _n_sieve_carry[P->c];
+
+    /* a whole turn of the wheel marks eight bytes at fixed offsets */
+    if (p < len)
+    {
+        o = 0;
+        for (j = 0; j < 8; j++)
+        {
+            off[j] = o;
+            mask[j] = ~bit[(w + j) & 7];
+            o += k * _n_sieve_gap[(w + j) & 7] + carry[(w + j) & 7];
+        }
+
+        for ( ; i + off[7] < len; i += p)
+        {
+            seg[i + off[0]] &= mask[0];
+            seg[i + off[1]] &= mask[1];
+            seg[i + off[2]] &= mask[2];
+            seg[i + off[3]] &= mask[3];
+            seg[i + off[4]] &= mask[4];
+            seg[i + off[5]] &= mask[5];
+            seg[i + off[6]] &= mask[6];
+            seg[i + off[7]] &= mask[7];
+        }
+    }
+
+    while (i < len)
+    {
+        seg[i] &= ~bit[w];
+        i += k * _n_sieve_gap[w] + carry[w];
+        w = (w + 1) & 7;
+    }
+
+    P->i = i - len;
+    P->w = w;
+}
+
+int
+_n_sieve_next_segment(n_sieve_t s)
+{
+    mp_limb_t hi, n, r;
+    slong j;
+
+    if (s->last)
+    {
+        s->i = s->len = 0;
+        s->bits = 0;
+        return 0;
+    }
+
+    s->lo += 30 * s->len;
+    n = (s->b - s->lo) / 30 + 1;
+
+    if (n <= s->alloc)
+    {
+        s->len = n;
+        s->last = 1;
+        hi = s->b;
+    } else
+    {
+        s->len = s->alloc;
+        hi = s->lo + 30 * s->len - 1;
+    }
+
+    n = n_sqrt(hi);
+    while (s->next_p <= n)
+    {
+        _n_sieve_add_prime(s, s->next_p);
+        s->next_p = n_primes_next(s->iter);
+    }
+
+    memset(s->seg, 0xff, s->len);
+
+    for (j = 0; j < s->num; j++)
+        _n_sieve_mark(s->seg, s->len, s->primes + j);
+
+    if (s->lo == 0)
+        s->seg[0] &= ~1; /* 1 is not prime */
+
+    if (s->lo < s->a)
+    {
+        for (j = 0; j < 8 && _n_sieve_residue[j] < s->a - s->lo; j++)
+            s->seg[0] &= ~(1 << j);
+    }
+
+    if (s->last)
+    {
+        r = s->b - s->lo - 30 * (s->len - 1);
+        for (j = 7; j >= 0 && _n_sieve_residue[j] > r; j--)
+            s->seg[s->len - 1] &= ~(1 << j);
+    }
+
+    s->i = 0;
+
+    return 1;
+}
@@ -29,6 +29,37 @@
 #include <gmp.h>
 #include "flint.h"
 #include "ulong_extras.h"
+#include "thread_pool.h"
+
+typedef struct
+{
+    const mp_limb_t * ref_primes;
+    slong lim;
+    ulong seed;
+    int ok;
+}
+primes_arg_struct;
+
+void primes_worker(void * varg)
+{
+    primes_arg_struct * arg = (primes_arg_struct *) varg;
+    flint_rand_t state;
+    slong j, n;
+
+    flint_randinit(state);
+    state->__randval = arg->seed;
+    state->__randval2 = arg->seed ^ 0x5bd1e995UL;
+
+    arg->ok = 1;
+    for (j = 0; j < 100; j++)
+    {
+        n = n_randint(state, arg->lim);
+        if (n_primes_arr_readonly(n + 1)[n] != arg->ref_primes[n])
+            arg->ok = 0;
+    }
+
+    flint_randclear(state);
+}
 
 int main()
 {
@@ -78,6 +109,49 @@ int main()
         }
     }
 
+    /* several threads growing the shared table at once */
+    for (i = 0; i < 10; i++)
+    {
+        thread_pool_handle * threads;
+        primes_arg_struct * args;
+        slong j, num_workers;
+
+        n_cleanup_primes();
+
+        flint_set_num_threads(1 + n_randint(state, 8));
+        num_workers = flint_request_threads(&threads, flint_get_num_threads());
+        args = flint_malloc(sizeof(primes_arg_struct) * (num_workers + 1));
+
+        for (j = 0; j <= num_workers; j++)
+        {
+            args[j].ref_primes = ref_primes;
+            args[j].lim = lim;
+            args[j].seed = n_randlimb(state);
+        }
+
+        for (j = 0; j < num_workers; j++)
+            thread_pool_wake(global_thread_pool, threads[j], primes_worker, &args[j]);
+
+        primes_worker(&args[num_workers]);
+
+        for (j = 0; j < num_workers; j++)
+            thread_pool_wait(global_thread_pool, threads[j]);
+
+        flint_give_back_threads(threads, num_workers);
+
+        for (j = 0; j <= num_workers; j++)
+        {
+            if (!args[j].ok)
+            {
+                printf("FAIL (threaded):\n");
+                printf("i = %ld, j = %ld\n", i, j);
+                abort();
+            }
+        }
+
+        flint_free(args);
+    }
+
     flint_free(ref_primes);
     flint_free(ref_inverses);
     flint_randclear(state);
@@ -0,0 +1,67 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+
+int main(void)
+{
+   int i, result;
+   flint_rand_t state;
+   flint_randinit(state);
+
+   printf("factor_ecm....");
+   fflush(stdout);
+
+   for (i = 0; i < 1000 * flint_test_multiplier(); i++)
+   {
+      mp_limb_t p, q, n, f = 0;
+      ulong bits = n_randint(state, FLINT_BITS/2 - 7) + 8;
+
+      /* n = p q with p at most half the bits of n */
+      p = n_randprime(state, bits, 0);
+      do
+      {
+         q = n_randprime(state, 
+                n_randint(state, FLINT_BITS - 2*bits + 1) + bits, 0);
+      } while (q == p);
+      n = p*q;
+
+      result = n_factor_ecm(&f, 200, 1000, 50000, state, n);
+      
+      if (result)
+         result = (f != 1 && f != n && (n % f) == 0);
+
+      if (!result)
+      {
+         printf("FAIL:\n");
+         printf("n = %lu, p = %lu, q = %lu, f = %lu\n", n, p, q, f); 
+         abort();
+      }
+   }
+
+   flint_randclear(state);
+
+   printf("PASS\n");
+   return 0;
+}
@@ -0,0 +1,93 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+
+int main(void)
+{
+    flint_rand_t state;
+    slong i;
+    ulong c;
+
+    printf("primes_count_range....");
+    fflush(stdout);
+
+    flint_randinit(state);
+
+    for (i = 0; i < 1000 * flint_test_multiplier(); i++)
+    {
+        n_primes_t iter;
+        mp_limb_t a, b, p;
+        ulong c1, c2;
+
+        flint_set_num_threads(1 + n_randint(state, 4));
+
+        a = n_randtest(state) % 1000000000UL;
+        if (i % 10 == 0 && a > 0)
+            b = a - 1;
+        else
+            b = a + n_randint(state, 100000);
+
+        c1 = n_primes_count_range(a, b);
+
+        c2 = 0;
+        n_primes_init(iter);
+        if (a > 0)
+            n_primes_jump_after(iter, a - 1);
+        while ((p = n_primes_next(iter)) <= b)
+            c2++;
+        n_primes_clear(iter);
+
+        if (c1 != c2)
+        {
+            printf("FAIL:\n");
+            printf("a = %lu, b = %lu, c1 = %lu, c2 = %lu\n", a, b, c1, c2);
+            abort();
+        }
+    }
+
+    /* known values, large enough to be split between threads */
+    flint_set_num_threads(4);
+
+    c = n_primes_count_range(0, 100000000);
+    if (c != 5761455)
+    {
+        printf("FAIL:\n");
+        printf("pi(10^8) = %lu\n", c);
+        abort();
+    }
+
+    c = n_primes_count_range(1000000000000UL, 1000100000000UL);
+    if (c != 3618282)
+    {
+        printf("FAIL:\n");
+        printf("pi(10^12 + 10^8) - pi(10^12) = %lu\n", c);
+        abort();
+    }
+
+    flint_randclear(state);
+    flint_cleanup();
+    printf("PASS\n");
+    return 0;
+}
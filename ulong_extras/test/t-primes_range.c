@@ -0,0 +1,81 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+
+int main(void)
+{
+    flint_rand_t state;
+    slong i, j;
+
+    printf("primes_range....");
+    fflush(stdout);
+
+    flint_randinit(state);
+
+    for (i = 0; i < 20 * flint_test_multiplier(); i++)
+    {
+        n_sieve_t s;
+        mp_limb_t a, b, p, * res;
+        slong num;
+
+        flint_set_num_threads(1 + n_randint(state, 4));
+
+        a = n_randtest(state) % 10000000000UL;
+        if (n_randint(state, 4) == 0)
+            b = a + FLINT_SIEVE_THREAD_CUTOFF + n_randint(state, 30000000);
+        else
+            b = a + n_randint(state, 1000000);
+
+        res = flint_malloc(sizeof(mp_limb_t) * n_primes_count_range(a, b));
+
+        num = n_primes_range(res, a, b);
+
+        n_sieve_init(s, a, b);
+        for (j = 0; (p = n_sieve_next(s)) != 0; j++)
+        {
+            if (j >= num || res[j] != p)
+            {
+                printf("FAIL:\n");
+                printf("a = %lu, b = %lu, j = %ld, p = %lu\n", a, b, j, p);
+                abort();
+            }
+        }
+        n_sieve_clear(s);
+
+        if (j != num)
+        {
+            printf("FAIL (count):\n");
+            printf("a = %lu, b = %lu, j = %ld, num = %ld\n", a, b, j, num);
+            abort();
+        }
+
+        flint_free(res);
+    }
+
+    flint_randclear(state);
+    flint_cleanup();
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,147 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+
+int main()
+{
+    slong i, j, lim = 100000;
+    flint_rand_t state;
+    n_primes_t pg;
+    mp_limb_t * ref_primes;
+    const char * filename = "primes_table_load_test.bin";
+    FILE * file;
+
+    printf("primes_table_load....");
+    fflush(stdout);
+    flint_randinit(state);
+
+    ref_primes = flint_malloc(sizeof(mp_limb_t) * 2 * lim);
+
+    n_primes_init(pg);
+    for (i = 0; i < 2 * lim; i++)
+        ref_primes[i] = n_primes_next(pg);
+    n_primes_clear(pg);
+
+    for (i = 0; i < 20; i++)
+    {
+        slong n;
+        const mp_limb_t * primes;
+        const double * inverses;
+
+        n = n_randint(state, lim) + 1;
+
+        n_cleanup_primes();
+
+        if (!n_primes_table_save(filename, n))
+        {
+            printf("FAIL:\n");
+            printf("could not save table of %ld primes\n", n);
+            abort();
+        }
+
+        n_cleanup_primes();
+
+        if (!n_primes_table_load(filename))
+        {
+            printf("FAIL:\n");
+            printf("could not load table of %ld primes\n", n);
+            abort();
+        }
+
+        primes = n_primes_arr_readonly(n);
+        inverses = n_prime_inverses_arr_readonly(n);
+
+        for (j = 0; j < n; j++)
+        {
+            if (primes[j] != ref_primes[j] 
+                || inverses[j] != n_precompute_inverse(ref_primes[j]))
+            {
+                printf("FAIL:\n");
+                printf("n = %ld, j = %ld, p1 = %lu, p2 = %lu\n", 
+                       n, j, primes[j], ref_primes[j]);
+                abort();
+            }
+        }
+
+        /* grow beyond the loaded table */
+        primes = n_primes_arr_readonly(2 * n);
+
+        for (j = 0; j < 2 * n; j++)
+        {
+            if (primes[j] != ref_primes[j])
+            {
+                printf("FAIL:\n");
+                printf("n = %ld, j = %ld, p1 = %lu, p2 = %lu\n", 
+                       2 * n, j, primes[j], ref_primes[j]);
+                abort();
+            }
+        }
+    }
+
+    /* a file which is not a table is rejected */
+    file = fopen(filename, "wb");
+    fprintf(file, "not a table of primes");
+    fclose(file);
+
+    n_cleanup_primes();
+
+    if (n_primes_table_load(filename))
+    {
+        printf("FAIL:\n");
+        printf("invalid table loaded\n");
+        abort();
+    }
+
+    /* a header whose count makes the expected size wrap around */
+    {
+        mp_limb_t header[4];
+
+        header[0] = FLINT_BITS;
+        header[1] = 1UL << (FLINT_BITS - 4);
+        header[2] = sizeof(double);
+        header[3] = 0;
+
+        file = fopen(filename, "wb");
+        fwrite(header, sizeof(mp_limb_t), 4, file);
+        fclose(file);
+    }
+
+    n_cleanup_primes();
+
+    if (n_primes_table_load(filename))
+    {
+        printf("FAIL:\n");
+        printf("table with overflowing count loaded\n");
+        abort();
+    }
+
+    remove(filename);
+
+    flint_free(ref_primes);
+    flint_randclear(state);
+    flint_cleanup();
+    printf("PASS\n");
+    return 0;
+}
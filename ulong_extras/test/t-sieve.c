@@ -0,0 +1,92 @@
+/*=============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+=============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "ulong_extras.h"
+
+int main(void)
+{
+    flint_rand_t state;
+    slong i;
+
+    printf("sieve....");
+    fflush(stdout);
+
+    flint_randinit(state);
+
+    for (i = 0; i < 200 * flint_test_multiplier(); i++)
+    {
+        n_sieve_t s;
+        n_primes_t iter;
+        mp_limb_t a, b, p, q;
+
+        switch (i % 3)
+        {
+            case 0:
+                a = n_randint(state, 100);
+                b = a + n_randint(state, 1000);
+                break;
+            case 1:
+                a = n_randint(state, 10000000);
+                b = a + n_randint(state, 3000000);
+                break;
+            default:
+                a = n_randtest(state) % (1UL << 40);
+                b = a + n_randint(state, 100000);
+        }
+
+        n_sieve_init(s, a, b);
+
+        n_primes_init(iter);
+        if (a > 0)
+            n_primes_jump_after(iter, a - 1);
+        q = n_primes_next(iter);
+
+        while ((p = n_sieve_next(s)) != 0)
+        {
+            if (p != q)
+            {
+                printf("FAIL:\n");
+                printf("a = %lu, b = %lu, p = %lu, q = %lu\n", a, b, p, q);
+                abort();
+            }
+
+            q = n_primes_next(iter);
+        }
+
+        if (q <= b || n_sieve_next(s) != 0)
+        {
+            printf("FAIL (end of range):\n");
+            printf("a = %lu, b = %lu, q = %lu\n", a, b, q);
+            abort();
+        }
+
+        n_sieve_clear(s);
+        n_primes_clear(iter);
+    }
+
+    flint_randclear(state);
+    flint_cleanup();
+    printf("PASS\n");
+    return 0;
+}